@@ -44,69 +44,381 @@ namespace FluxAudio {
         }
     }
     //--------------------------------------------------------------------------
-    bool AudioInstance::Play() {
-        if (!resource || !stream || badData || !isInitialized ) return false;
+    // Payload of a resource as seen by a decoder. Mapped and in memory data is
+    // read directly, on the read on demand backend ranges are fetched from the
+    // file unless the decoder needs it contiguous. The file stays alive with
+    // the view, in memory data is guarded by closing the stream with wait.
+    //--------------------------------------------------------------------------
+    struct ResourceView {
+        std::shared_ptr<FluxMappedFile> file;
+        const uint8_t* data = nullptr;   // nullptr: read from file
+        size_t offset = 0;
+        size_t size = 0;
+
+        ResourceView(ResourceData& resource, bool contiguous)
+            : file(resource.mFile), offset(resource.mDataOffset), size(resource.getSize()) {
+            if (contiguous || !resource.isStreamed()) data = resource.getData();
+        }
+        size_t read(size_t pos, void* dst, size_t len) const {
+            if (pos >= size) return 0;
+            len = std::min(len, size - pos);
+            if (data) {
+                std::memcpy(dst, data + pos, len);
+                return len;
+            }
+            return file->read(offset + pos, dst, len);
+        }
+    };
+    //--------------------------------------------------------------------------
+    // Decoders for the DecodeService. They run on the decode thread.
+    //--------------------------------------------------------------------------
+    class InstanceDecoder : public DecodeService::Decoder {
+    protected:
+        uint32_t mChannels = 0;
+        uint32_t mSampleRate = 0;
+        virtual uint32_t decode(float* out, uint32_t frames) = 0;
+    public:
+        std::function<void(const float*, size_t)> OnAudioProcess = nullptr;
+
+        uint32_t getChannels() const override { return mChannels; }
+        uint32_t getSampleRate() const override { return mSampleRate; }
+
+        uint32_t read(float* out, uint32_t frames) override {
+            uint32_t framesRead = decode(out, frames);
+            if (framesRead && OnAudioProcess) OnAudioProcess(out, (size_t)framesRead * mChannels);
+            return framesRead;
+        }
+    };
+    //--------------------------------------------------------------------------
+    class WavDecoder : public InstanceDecoder {
+        ResourceView mView;
+        size_t mPos = 0;
+        size_t mFrameBytes;
+        std::vector<uint8_t> mReadBuffer;
+        SDL_AudioSpec mSrcSpec;
+        SDL_AudioSpec mDstSpec;
+    public:
+        WavDecoder(ResourceView view, const SDL_AudioSpec& srcSpec)
+            : mView(std::move(view)), mSrcSpec(srcSpec) {
+            mDstSpec = srcSpec;
+            mDstSpec.format = SDL_AUDIO_F32;
+            mDstSpec.channels = std::min(srcSpec.channels, 2);
+            mFrameBytes = SDL_AUDIO_BYTESIZE(srcSpec.format) * srcSpec.channels;
+            mChannels = mDstSpec.channels;
+            mSampleRate = mDstSpec.freq;
+        }
+        uint32_t decode(float* out, uint32_t frames) override {
+            if (mFrameBytes == 0 || mPos >= mView.size) return 0;
+            size_t bytes = std::min((size_t)frames * mFrameBytes, mView.size - mPos);
+
+            const uint8_t* src = mView.data ? mView.data + mPos : nullptr;
+            if (!src) {
+                mReadBuffer.resize(bytes);
+                bytes = mView.read(mPos, mReadBuffer.data(), bytes);
+                src = mReadBuffer.data();
+            }
+            bytes -= bytes % mFrameBytes;
+            if (bytes == 0) return 0;
 
-        SDL_ClearAudioStream(stream);
+            Uint8* tempDst = nullptr;
+            int outLen = 0;
+            if (!SDL_ConvertAudioSamples(&mSrcSpec, src, (int)bytes, &mDstSpec, &tempDst, &outLen))
+                return 0;
+            uint32_t framesOut = (uint32_t)(outLen / (int)(sizeof(float) * mChannels));
+            std::memcpy(out, tempDst, (size_t)framesOut * mChannels * sizeof(float));
+            SDL_free(tempDst);
+            mPos += bytes;
+            return framesOut;
+        }
+        bool rewind() override { mPos = 0; return true; }
+    };
+    //--------------------------------------------------------------------------
+    // stb_vorbis needs the whole file in memory, on the read on demand backend
+    // it is loaded on the first open
+    class OggDecoder : public InstanceDecoder {
+        ResourceView mView;
+        stb_vorbis* mVorbis = nullptr;
+    public:
+        OggDecoder(ResourceView view) : mView(std::move(view)) {
+            if (!mView.data) return;
+            int error;
+            mVorbis = stb_vorbis_open_memory(mView.data, (int)mView.size, &error, nullptr);
+            if (!mVorbis) return;
+            stb_vorbis_info info = stb_vorbis_get_info(mVorbis);
+            mChannels = (uint32_t)info.channels;
+            mSampleRate = info.sample_rate;
+        }
+        ~OggDecoder() override { if (mVorbis) stb_vorbis_close(mVorbis); }
+        bool isValid() const { return mVorbis != nullptr; }
+        uint32_t decode(float* out, uint32_t frames) override {
+            int samplesRead = stb_vorbis_get_samples_float_interleaved(mVorbis, (int)mChannels, out, (int)(frames * mChannels));
+            return samplesRead > 0 ? (uint32_t)samplesRead : 0;
+        }
+        bool rewind() override { return stb_vorbis_seek_start(mVorbis) != 0; }
+    };
+    //--------------------------------------------------------------------------
+    class MaDecoder : public InstanceDecoder {
+        ResourceView mView;
+        size_t mPos = 0;    // read on demand only
+        ma_decoder mDecoder;
+        bool mValid = false;
+
+        static ma_result onRead(ma_decoder* decoder, void* out, size_t bytes, size_t* bytesRead) {
+            MaDecoder* self = (MaDecoder*)decoder->pUserData;
+            *bytesRead = self->mView.read(self->mPos, out, bytes);
+            self->mPos += *bytesRead;
+            return (*bytesRead == 0 && bytes > 0) ? MA_AT_END : MA_SUCCESS;
+        }
+        static ma_result onSeek(ma_decoder* decoder, ma_int64 offset, ma_seek_origin origin) {
+            MaDecoder* self = (MaDecoder*)decoder->pUserData;
+            ma_int64 pos = offset;
+            if (origin == ma_seek_origin_current) pos += (ma_int64)self->mPos;
+            else if (origin == ma_seek_origin_end) pos += (ma_int64)self->mView.size;
+            if (pos < 0 || pos > (ma_int64)self->mView.size) return MA_BAD_SEEK;
+            self->mPos = (size_t)pos;
+            return MA_SUCCESS;
+        }
+        bool init(const ma_decoder_config& config) {
+            mPos = 0;
+            if (mView.data)
+                return ma_decoder_init_memory(mView.data, mView.size, &config, &mDecoder) == MA_SUCCESS;
+            return ma_decoder_init(onRead, onSeek, this, &config, &mDecoder) == MA_SUCCESS;
+        }
+    public:
+        MaDecoder(ResourceView view) : mView(std::move(view)) {
+            ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, 0);
+            if (!init(config)) return;
+            if (mDecoder.outputChannels > 2) {
+                // the mixer takes mono or stereo, let miniaudio downmix
+                ma_decoder_uninit(&mDecoder);
+                config = ma_decoder_config_init(ma_format_f32, 2, 0);
+                if (!init(config)) return;
+            }
+            mChannels = mDecoder.outputChannels;
+            mSampleRate = mDecoder.outputSampleRate;
+            mValid = true;
+        }
+        ~MaDecoder() override { if (mValid) ma_decoder_uninit(&mDecoder); }
+        MaDecoder(const MaDecoder&) = delete;
+        void operator=(const MaDecoder&) = delete;
+
+        bool isValid() const { return mValid; }
+        uint64_t getLength() {
+            ma_uint64 totalFrames = 0;
+            ma_decoder_get_length_in_pcm_frames(&mDecoder, &totalFrames);
+            return totalFrames;
+        }
+        uint32_t decode(float* out, uint32_t frames) override {
+            ma_uint64 framesRead = 0;
+            ma_decoder_read_pcm_frames(&mDecoder, out, frames, &framesRead);
+            return (uint32_t)framesRead;
+        }
+        bool rewind() override { return ma_decoder_seek_to_pcm_frame(&mDecoder, 0) == MA_SUCCESS; }
+    };
+    //--------------------------------------------------------------------------
+    #ifdef AUDIO_PORT_SFX
+    // own generator, the one of the instance stays on the main thread
+    class SfxDecoder : public InstanceDecoder {
+        SFXGeneratorStereo mGen;
+        bool mValid = false;
+        uint32_t mPos = 0;
+        uint32_t mLength = 0;
+    public:
+        SfxDecoder(const std::vector<uint8_t>& data) {
+            mValid = mGen.LoadFromMemory(data);
+            mChannels = 2;
+            mSampleRate = 44100;
+            mLength = (uint32_t)std::max(0, mGen.getSyntFrames());
+            rewind();
+        }
+        bool isValid() const { return mValid; }
+        uint32_t decode(float* out, uint32_t frames) override {
+            if (!mGen.mState.playing_sample || mPos >= mLength) return 0;
+            uint32_t framesToRead = std::min(frames, mLength - mPos);
+            mGen.SynthSample((int)framesToRead, out);
+            mPos += framesToRead;
+            return framesToRead;
+        }
+        bool rewind() override { mGen.PlaySample(); mPos = 0; return true; }
+    };
+    #endif
+    //--------------------------------------------------------------------------
+    // plays a decoded buffer of the PcmCache
+    class BufferDecoder : public InstanceDecoder {
+        std::shared_ptr<const SampleBuffer> mBuffer;
+        uint32_t mPos = 0;
+    public:
+        BufferDecoder(std::shared_ptr<const SampleBuffer> buffer) : mBuffer(std::move(buffer)) {
+            mChannels = mBuffer->channels;
+            mSampleRate = mBuffer->sampleRate;
+        }
+        uint32_t decode(float* out, uint32_t frames) override {
+            uint32_t framesToRead = std::min(frames, mBuffer->frames - mPos);
+            std::memcpy(out, mBuffer->data.data() + (size_t)mPos * mChannels, (size_t)framesToRead * mChannels * sizeof(float));
+            mPos += framesToRead;
+            return framesToRead;
+        }
+        bool rewind() override { mPos = 0; return true; }
+    };
+    //--------------------------------------------------------------------------
+    // first play of a short sound: the source is decoded on the decode thread
+    // as usual and recorded on the way, a complete first pass goes into the
+    // PcmCache. Later plays get a BufferDecoder.
+    class CachingDecoder : public InstanceDecoder {
+        std::unique_ptr<DecodeService::Decoder> mSource;
+        std::string mKey;
+        std::shared_ptr<SampleBuffer> mBuffer;  // nullptr: not recording
+    public:
+        CachingDecoder(std::unique_ptr<DecodeService::Decoder> source, std::string key, double duration)
+            : mSource(std::move(source)), mKey(std::move(key)) {
+            mChannels = mSource->getChannels();
+            mSampleRate = mSource->getSampleRate();
+            if (mChannels == 0) return;
+            mBuffer = std::make_shared<SampleBuffer>();
+            mBuffer->channels = mChannels;
+            mBuffer->sampleRate = mSampleRate;
+            mBuffer->data.reserve(((size_t)(duration * mSampleRate) + DecodeService::CHUNK_FRAMES) * mChannels);
+        }
+        uint32_t decode(float* out, uint32_t frames) override {
+            const uint32_t framesRead = mSource->read(out, frames);
+            if (!mBuffer) return framesRead;
+            if (framesRead) {
+                mBuffer->data.insert(mBuffer->data.end(), out, out + (size_t)framesRead * mChannels);
+                return framesRead;
+            }
+            // end of the first pass
+            mBuffer->frames = (uint32_t)(mBuffer->data.size() / mChannels);
+            mBuffer->data.shrink_to_fit();
+            if (mBuffer->frames)
+                AudioResourceManager.getPcmCache().put(mKey, std::move(mBuffer));
+            mBuffer.reset();
+            return 0;
+        }
+        bool rewind() override {
+            mBuffer.reset(); // rewound before the end, the recording is incomplete
+            return mSource->rewind();
+        }
+    };
+    //--------------------------------------------------------------------------
+    std::unique_ptr<DecodeService::Decoder> AudioInstance::createSourceDecoder(bool withCallback) {
+        std::unique_ptr<InstanceDecoder> decoder;
         switch (resource->fileType) {
-            case AudioType::WAV: {
-                mSamplePos = 0;
+            case AudioType::WAV:
+                decoder = std::make_unique<WavDecoder>(ResourceView(*resource, false), srcSpec);
                 break;
-            }
             case AudioType::OGG: {
-                if (!vorbisDecoder) return false;
-                stb_vorbis_seek_start(vorbisDecoder);
+                auto ogg = std::make_unique<OggDecoder>(ResourceView(*resource, true));
+                if (ogg->isValid()) decoder = std::move(ogg);
                 break;
             }
-
             case AudioType::MP3:
-            case AudioType::FLAC:
-            {
-                if (!maDecoder.pBackend) return false;
-                ma_result res = ma_decoder_seek_to_pcm_frame(&maDecoder, 0);
-                if (res != MA_SUCCESS) {
-                    Log("[error] Audio: MP3/FLAC Seek failed (%s)", resource->fileName.c_str());
-                    if (OnFatalError) OnFatalError("MP3/FLAC Seek failed!");
-                    return false;
-                }
-                mSamplePos = 0;
+            case AudioType::FLAC: {
+                auto ma = std::make_unique<MaDecoder>(ResourceView(*resource, false));
+                if (ma->isValid()) decoder = std::move(ma);
                 break;
             }
-
             #ifdef AUDIO_PORT_SFX
             case AudioType::SFX: {
-                if (!mSFXGen) return false;
-                mSFXGen->PlaySample();
-                mSamplePos = 0;
+                auto sfx = std::make_unique<SfxDecoder>(resource->mRawData);
+                if (sfx->isValid()) decoder = std::move(sfx);
                 break;
             }
             #endif
-
             default:
-                return false;
+                break;
+        }
+        if (decoder && withCallback) decoder->OnAudioProcess = OnAudioProcess;
+        return decoder;
+    }
+    //--------------------------------------------------------------------------
+    std::unique_ptr<DecodeService::Decoder> AudioInstance::createDecoder() {
+        // short sounds are decoded once and then played from the cache, the
+        // decoding itself always runs on the decode thread
+        PcmCache& cache = AudioResourceManager.getPcmCache();
+        if (cache.isEnabled() && mSampleDuration > 0.0 && mSampleDuration <= ResourceManager::PCM_CACHE_MAX_SEC) {
+            if (std::shared_ptr<const SampleBuffer> buffer = cache.get(resource->fileName)) {
+                auto decoder = std::make_unique<BufferDecoder>(buffer);
+                decoder->OnAudioProcess = OnAudioProcess;
+                return decoder;
+            }
+            std::unique_ptr<DecodeService::Decoder> source = createSourceDecoder(false);
+            if (!source) return nullptr;
+            auto decoder = std::make_unique<CachingDecoder>(std::move(source), resource->fileName, mSampleDuration);
+            decoder->OnAudioProcess = OnAudioProcess;
+            return decoder;
+        }
+        return createSourceDecoder(true);
+    }
+    //--------------------------------------------------------------------------
+    void AudioInstance::closeStream(bool wait) {
+        if (mVoice) {
+            AudioManager.getMixer().stop(mVoice);
+            mVoice = 0;
+        }
+        if (mDecodeStream) {
+            AudioManager.getDecodeService().close(mDecodeStream, wait);
+            mDecodeStream = 0;
+        }
+        mPaused = false;
+    }
+    //--------------------------------------------------------------------------
+    bool AudioInstance::Play() {
+        if (!resource || badData || !isInitialized ) return false;
+
+        closeStream();
+        mRing.reset();
+
+        std::unique_ptr<DecodeService::Decoder> decoder = createDecoder();
+        if (!decoder) {
+            Log("[error] Audio: Failed to create a decoder (%s)", resource->fileName.c_str());
+            if (OnFatalError) OnFatalError("Failed to create a decoder!");
+            return false;
+        }
+        const uint32_t rate = decoder->getSampleRate();
+
+        DecodeService::Stream decodeStream = AudioManager.getDecodeService().open(std::move(decoder), doLoop);
+        if (!decodeStream.id) return false;
+        mDecodeStream = decodeStream.id;
+
+        VoiceParams params;
+        params.gain = volume;
+        params.positional = usePosition;
+        params.x = position.x;
+        params.y = position.y;
+        mSentPosition = position;
+        mVoice = AudioManager.getMixer().playStream(decodeStream.ring, rate, params);
+        if (!mVoice) {
+            Log("[error] Audio: no free voice for %s", resource->fileName.c_str());
+            closeStream();
+            return false;
         }
 
-        AudioManager.bindStream(stream);
+        mRing = decodeStream.ring;
+        mSentLoop = doLoop;
+        mSentVolume = volume;
         isPlaying = true;
         return isPlaying;
     }
     //--------------------------------------------------------------------------
     bool AudioInstance::Stop() {
-        if (!resource || !stream || badData || !isInitialized ) return false;
+        if (!resource || badData || !isInitialized ) return false;
         if (!isPlaying) return false;
 
         isPlaying = false;
-
-        return AudioManager.unBindStream(stream);
+        mPaused = true;
+        AudioManager.getMixer().setPaused(mVoice, true);
+        return true;
     }
     //--------------------------------------------------------------------------
     bool AudioInstance::Resume() {
-        if (!resource || !stream || badData || !isInitialized ) return false;
-        if (isPlaying) return false;
-
-        isPlaying=true;
-        return AudioManager.bindStream(stream);
+        if (!resource || badData || !isInitialized ) return false;
+        if (isPlaying || !mPaused) return false;
 
+        if (!AudioManager.getMixer().isPlaying(mVoice)) return false;
+        mPaused = false;
+        isPlaying = true;
+        AudioManager.getMixer().setPaused(mVoice, false);
+        return true;
     }
     //--------------------------------------------------------------------------
     bool AudioInstance::Initialize(std::string fileName){
@@ -127,23 +439,7 @@ namespace FluxAudio {
                 srcSpec = resource->wavSrcSpec;
                 dstSpec = srcSpec;
                 dstSpec.format = SDL_AUDIO_F32;
-
-
-                //NOTE: dstSpec is correct since it's converted to this!
-                stream = SDL_CreateAudioStream( &dstSpec, nullptr);
-                // stream = SDL_CreateAudioStream(&srcSpec, &dstSpec);
-                if (!stream) {
-                    Log("[error]Couldn't create audio stream: %s", SDL_GetError());
-                    if (OnFatalError) OnFatalError(std::format("Couldn't create audio stream: {}", SDL_GetError()));
-                    return false;
-                }
-
-                if (!AudioManager.bindStream(stream)) {
-                    Log("Failed to bind '%s' stream to device: %s", resource->fileName.c_str(), SDL_GetError());
-                    SDL_DestroyAudioStream(stream);
-                    stream = nullptr;
-                    return false;
-                }
+                dstSpec.channels = std::min(srcSpec.channels, 2);
 
                 setSampleLenAndDuration();
 
@@ -158,8 +454,9 @@ namespace FluxAudio {
             }
             //............ OGG ..............
             case AudioType::OGG: {
-                int error;
-                vorbisDecoder = stb_vorbis_open_memory(resource->mRawData.data(), (int)resource->mRawData.size(), &error, nullptr);
+                int error = VORBIS_file_open_failure;
+                const uint8_t* data = resource->getData();
+                vorbisDecoder = data ? stb_vorbis_open_memory(data, (int)resource->getSize(), &error, nullptr) : nullptr;
                 if (!vorbisDecoder) {
                     Log("Failed to open OGG: %s ERROR:%s", resource->fileName.c_str(), get_vorbis_error_string(error));
                     setBad();
@@ -174,14 +471,6 @@ namespace FluxAudio {
 
                 dstSpec = srcSpec;
 
-
-                // stream = SDL_CreateAudioStream(&srcSpec, &dstSpec);
-                stream = SDL_CreateAudioStream(&srcSpec, nullptr);
-                if (!AudioManager.bindStream(stream)) {
-                    Log("Failed to bind '%s' stream: %s", resource->fileName.c_str(), SDL_GetError());
-                    return false;
-                }
-
                 setSampleLenAndDuration();
 
                 dLog("SAMPLE LEN = %d", (int)mSampleLen);
@@ -193,11 +482,10 @@ namespace FluxAudio {
             case AudioType::MP3:
             case AudioType::FLAC:
             {
-                ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, 0);
-
-                ma_result res = ma_decoder_init_memory(resource->mRawData.data(), resource->mRawData.size(), &config, &maDecoder);
+                // reads the stream info and the length only
+                MaDecoder probe(ResourceView(*resource, false));
 
-                if (res != MA_SUCCESS) {
+                if (!probe.isValid()) {
                     Log("[error] Audio: Failed to open MP3/FLAC: %s", resource->fileName.c_str());
                     if (OnFatalError) OnFatalError("Failed to open MP3/FLAC.");
                     setBad();
@@ -205,19 +493,12 @@ namespace FluxAudio {
                 }
 
                 srcSpec.format   = SDL_AUDIO_F32;
-                srcSpec.channels = maDecoder.outputChannels;
-                srcSpec.freq     = maDecoder.outputSampleRate;
+                srcSpec.channels = (int)probe.getChannels();
+                srcSpec.freq     = (int)probe.getSampleRate();
+                mSampleLen       = (size_t)probe.getLength();
 
                 dstSpec = srcSpec;
 
-                stream = SDL_CreateAudioStream(&srcSpec, nullptr);
-                if (!AudioManager.bindStream(stream)) {
-                    Log("[error] Audio: Failed to bind '%s' stream: %s", resource->fileName.c_str(), SDL_GetError());
-                    if (OnFatalError) OnFatalError(std::format("Failed to bind stream: {}", SDL_GetError()));
-                    ma_decoder_uninit(&maDecoder);
-                    return false;
-                }
-
                 setSampleLenAndDuration();
 
                 dLog("MP3/FLAC SAMPLE LEN = %d", (int)mSampleLen);
@@ -238,13 +519,6 @@ namespace FluxAudio {
                 srcSpec.freq =  44100 ;
                 dstSpec = srcSpec;
 
-                // stream = SDL_CreateAudioStream(&srcSpec, &dstSpec);
-                stream = SDL_CreateAudioStream(&srcSpec, nullptr);
-                if (!AudioManager.bindStream(stream)) {
-                    Log("Failed to bind '%s' stream: %s", resource->fileName.c_str(), SDL_GetError());
-                    return false;
-                }
-
                 setSampleLenAndDuration();
 
                 if ( mAutoConvertSfxToWav ) {
@@ -271,177 +545,50 @@ namespace FluxAudio {
     }
     //--------------------------------------------------------------------------
     AudioInstance::~AudioInstance( ) {
-        if ( stream ) { SDL_DestroyAudioStream(stream); stream = nullptr; }
+        // the decoder reads resource data, make sure it is gone first
+        closeStream(true);
         if ( vorbisDecoder ) { stb_vorbis_close(vorbisDecoder); vorbisDecoder = nullptr; }
-        if ( maDecoder.pBackend ) {ma_decoder_uninit(&maDecoder); maDecoder.pBackend=nullptr; }
         #ifdef AUDIO_PORT_SFX
         if ( mSFXGen ) { SAFE_DELETE(mSFXGen); mSFXGen = nullptr; }
         #endif
     }
     //--------------------------------------------------------------------------
-    bool AudioInstance::fillBuffer() {
-        if (!resource || resource->mRawData.empty()) return false;
-
-        const int CHUNK_SIZE = 4096;
-
-        switch (resource->fileType) {
-
-            case AudioType::WAV: {
-                if (mAudioBuffer.size() != CHUNK_SIZE * dstSpec.channels) {
-                    mAudioBuffer.resize(CHUNK_SIZE * dstSpec.channels);
-                }
-
-                if (mSamplePos >= resource->mRawData.size()) {
-                    if (doLoop) mSamplePos = 0;
-                    else return false;
-                }
-
-                int bytesPerSampleSource = SDL_AUDIO_BYTESIZE(srcSpec.format);
-                size_t bytesToReadFromSource = CHUNK_SIZE * srcSpec.channels * bytesPerSampleSource;
-
-                if (mSamplePos + bytesToReadFromSource > resource->mRawData.size()) {
-                    bytesToReadFromSource = resource->mRawData.size() - mSamplePos;
-                }
-
-                Uint8* tempDst = nullptr;
-                int outLen = 0;
-
-                if (SDL_ConvertAudioSamples(&srcSpec, resource->mRawData.data() + mSamplePos, (int)bytesToReadFromSource,
-                    &dstSpec, &tempDst, &outLen))
-                {
-                    mAudioBuffer.assign((float*)tempDst, (float*)(tempDst + outLen));
-                    SDL_free(tempDst);
-                } else {
-                    return false;
-                }
-
-                mSamplePos += bytesToReadFromSource;
-
-                // dLog("WAV wavOffset: %d", (int)wavOffset);
-
-                break;
-            }
-
-            // .......... OGG .............
-            case AudioType::OGG: {
-                if (mAudioBuffer.size() != CHUNK_SIZE * dstSpec.channels) {
-                    mAudioBuffer.resize(CHUNK_SIZE * dstSpec.channels);
-                }
-
-                int samplesRead = stb_vorbis_get_samples_float_interleaved(
-                    vorbisDecoder, dstSpec.channels, mAudioBuffer.data(), (int)mAudioBuffer.size());
-
-                if (samplesRead <= 0) {
-                    if (doLoop) {
-                        stb_vorbis_seek_start(vorbisDecoder);
-                        samplesRead = stb_vorbis_get_samples_float_interleaved(
-                            vorbisDecoder, dstSpec.channels, mAudioBuffer.data(), (int)mAudioBuffer.size());
-                    } else {
-                        return false; // EOF
-                    }
-                }
-
-                if (samplesRead < CHUNK_SIZE) {
-                    mAudioBuffer.resize(samplesRead * dstSpec.channels);
-                }
-
-                mSamplePos = stb_vorbis_get_sample_offset(vorbisDecoder);
-                // dLog("OGG samplesRead: %d, %d of %d, %f played", samplesRead, (int)mSamplePos, (int)mSampleLen, getProgress());
-                break;
-            }
-
-            // .......... MP3 (miniaudio) .............
-            case AudioType::MP3:
-            case AudioType::FLAC:
-            {
-                if (mAudioBuffer.size() != CHUNK_SIZE * dstSpec.channels) {
-                    mAudioBuffer.resize(CHUNK_SIZE * dstSpec.channels);
-                }
-
-                ma_uint64 framesRead = 0;
-                ma_result res = ma_decoder_read_pcm_frames(&maDecoder, mAudioBuffer.data(), CHUNK_SIZE, &framesRead);
-
-                if (framesRead == 0) {
-                    if (doLoop) {
-                        ma_decoder_seek_to_pcm_frame(&maDecoder, 0);
-                        res = ma_decoder_read_pcm_frames(&maDecoder, mAudioBuffer.data(), CHUNK_SIZE, &framesRead);
-                    } else {
-                        return false; // EOF
-                    }
-                }
-
-                if (framesRead < CHUNK_SIZE) {
-                    mAudioBuffer.resize(framesRead * dstSpec.channels);
-                }
-
-                ma_uint64 currentFrame;
-                ma_decoder_get_cursor_in_pcm_frames(&maDecoder, &currentFrame);
-                mSamplePos = (uint32_t)currentFrame;
-                // dLog("MP3 %d of %d, %f played",  (int)mSamplePos, (int)mSampleLen, getProgress());
-
-                break;
-            }
-            #ifdef AUDIO_PORT_SFX
-            case AudioType::SFX: {
-                if (!mSFXGen) return false;
-
-                if ( !mSFXGen->mState.playing_sample ) {
-                    if (doLoop)  { mSFXGen->PlaySample();  mSamplePos = 0; }
-                    else return false; //DONE
-                }
-
-                int framesToRead = CHUNK_SIZE;
-                int remainingFrames = mSampleLen - mSamplePos;
-                if ( framesToRead >  remainingFrames  )
-                    framesToRead = remainingFrames;
-
-
-                if (mAudioBuffer.size() != framesToRead * dstSpec.channels) {
-                    mAudioBuffer.resize(framesToRead * dstSpec.channels);
-                }
-
-                mSFXGen->SynthSample(framesToRead, mAudioBuffer.data());
-                mSamplePos += framesToRead;
-
-                break;
-            }
-            #endif
-
-            // ....... UNKNOWN ........
-            default:
-                return false;
-        }
-        return true;
-    }
-    //--------------------------------------------------------------------------
     // void AudioInstance::Update( const double& dt, Point3F* camPos ) {
     void AudioInstance::UpdateStream() {
         if (!isPlaying) return;
 
-        const float cacheSec = 0.250f; //was 0.1 => 100
-        const int targetQueueSize = (int)(dstSpec.freq * dstSpec.channels * sizeof(float) * cacheSec);
-        if (SDL_GetAudioStreamQueued(stream) < targetQueueSize) {
-            if ( fillBuffer() ) {
-                for (auto& sample : mAudioBuffer) {
-                    // dLog("sample: %f", sample);
-                    sample *= volume;
-                }
-                if (OnAudioProcess) OnAudioProcess(mAudioBuffer.data(),mAudioBuffer.size());
-                SDL_PutAudioStreamData(stream, mAudioBuffer.data(), mAudioBuffer.size() * sizeof(float));
-
-            } else {
-                SDL_FlushAudioStream(stream);
-                if (SDL_GetAudioStreamQueued(stream) == 0) {
-                    isPlaying = false;
-                    if (OnStreamEnds) OnStreamEnds();
-                    dLog("Sound finished playing.");
-                }
-            }
+        if (volume != mSentVolume) {
+            AudioManager.getMixer().setGain(mVoice, volume);
+            mSentVolume = volume;
+        }
+        if (doLoop != mSentLoop) {
+            AudioManager.getDecodeService().setLoop(mDecodeStream, doLoop);
+            mSentLoop = doLoop;
+        }
+        if (usePosition && (position.x != mSentPosition.x || position.y != mSentPosition.y)) {
+            AudioManager.getMixer().setPosition(mVoice, position.x, position.y);
+            mSentPosition = position;
+        }
+
+        if (!AudioManager.getMixer().isPlaying(mVoice)) {
+            isPlaying = false;
+            mVoice = 0;
+            closeStream();
+            if (OnStreamEnds) OnStreamEnds();
+            dLog("Sound finished playing.");
         }
     }
     //--------------------------------------------------------------------------
+    float AudioInstance::getProgress() {
+        size_t frames = getFrames();
+        if (!mRing || frames == 0) return 0.f;
+        size_t played = mRing->getReadCount();
+        played = doLoop ? played % frames : std::min(played, frames);
+        return (float)played / (float)frames;
+    }
+    //--------------------------------------------------------------------------
     bool AudioInstance::ConvertToWav() {
-        if (!resource || resource->mRawData.empty()) return false;
+        if (!resource || resource->getSize() == 0) return false;
         if ( isPlaying ) {
             Log("[error] ConvertToWav only allowed when not playing!");
             if (OnFatalError) OnFatalError("ConvertToWav only allowed when not playing!");
@@ -456,12 +603,21 @@ namespace FluxAudio {
                     if (OnFatalError) OnFatalError("Convert SFX To WAV: SFX Generator not Initialized!");
                     return false;
                 }
+                // a paused voice would keep the old stream
+                closeStream(true);
+                mRing.reset();
+
                 resource->fileType = FluxAudio::AudioType::WAV;
                 resource->wavSrcSpec = mSFXGen->getSpec();
+                srcSpec = resource->wavSrcSpec;
+                dstSpec = srcSpec;
+                dstSpec.format = SDL_AUDIO_F32;
                 std::vector<float> f32ExportBuffer;
                 mSFXGen->exportToBuffer(f32ExportBuffer, nullptr, false);
-                resource->mRawData.resize(f32ExportBuffer.size() * sizeof(float));
-                std::memcpy(resource->mRawData.data(), f32ExportBuffer.data(), resource->mRawData.size());
+                std::vector<uint8_t> wavData(f32ExportBuffer.size() * sizeof(float));
+                std::memcpy(wavData.data(), f32ExportBuffer.data(), wavData.size());
+                resource->setRawData(std::move(wavData));
+                AudioResourceManager.getPcmCache().remove(resource->fileName);
                 // no need to reinitialize since both are F32 but i need to update the len:
                 setSampleLenAndDuration();
 
@@ -510,13 +666,13 @@ namespace FluxAudio {
 
     void AudioInstance::setSampleLenAndDuration() {
 
-        mSamplePos = 0;
         mBytesPerFrame = (SDL_AUDIO_BITSIZE(dstSpec.format) / 8) * dstSpec.channels;
 
         switch (resource->fileType) {
             case AudioType::WAV: {
-                mSampleLen = resource->mRawData.size();
-                mWavFrames = resource->mRawData.size() / mBytesPerFrame;
+                // raw data is still in the source format
+                mSampleLen = resource->getSize();
+                mWavFrames = resource->getSize() / (SDL_AUDIO_BYTESIZE(srcSpec.format) * srcSpec.channels);
                 mSampleDuration =  (double)mWavFrames / dstSpec.freq;
 
                 break;
@@ -534,15 +690,8 @@ namespace FluxAudio {
             }
             case AudioType::MP3:
             case AudioType::FLAC: {
-
-                if (!maDecoder.pBackend) {
-                  if (OnFatalError) OnFatalError("miniaudio Decoder");
-                  return;
-                }
-                ma_uint64 totalFrames;
-                ma_decoder_get_length_in_pcm_frames(&maDecoder, &totalFrames);
-                mSampleLen = (uint32_t)totalFrames;
-                mSampleDuration = (double)mSampleLen / maDecoder.outputSampleRate;
+                // mSampleLen is set by Initialize
+                mSampleDuration = srcSpec.freq > 0 ? (double)mSampleLen / srcSpec.freq : 0.0;
 
                 break;
             }
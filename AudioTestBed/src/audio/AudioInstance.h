@@ -9,8 +9,15 @@
 //  [X] MP3
 //  [X] SFX
 //  [X] FLAC
-// [ ] DSP::Processors::Panning3D
+// [X] 2D position: attenuation and pan by the mixer, relative to its listener
 // [ ] FluxAudio::Manager handle list of instances
+//
+// Playback: every Play() opens a decoder on the DecodeService (worker thread)
+// which fills a PcmRing, the Mixer of AudioManager plays the ring. The main
+// thread only sends commands, UpdateStream() syncs volume/loop and checks the
+// end of the stream. Sounds up to ResourceManager::PCM_CACHE_MAX_SEC are
+// recorded into the PcmCache of the resource manager while the decode thread
+// plays them the first time and replayed from there.
 //-----------------------------------------------------------------------------
 // NOTE: MiniAudio rocks
 // I could have used miniaudio for WAV and OGG too but since i did WAV and OGG
@@ -101,7 +108,7 @@ namespace FluxAudio {
         bool Stop();
         bool Resume();
 
-        //------- Put Data in
+        //------- sync volume / loop / position, detect the end. Once per frame.
         // void Update( const double& dt, Point3F* camPos = nullptr );
         void UpdateStream();
 
@@ -112,12 +119,11 @@ namespace FluxAudio {
         //     return (size_t)(mSampleDuration * AudioManager.getAudioSpec().freq);
         // }
 
-        float getProgress() {
-            if (mSampleLen == 0) return 0.f;
-            return (float)mSamplePos / (float)mSampleLen;
-        }
+        float getProgress();
 
         // float* buffer, size_t numSamples
+        // called from the decode thread with the decoded data (before volume),
+        // set it before Play()
         std::function<void(const float*, size_t)> OnAudioProcess = nullptr;
         const SDL_AudioSpec getSpec() { return dstSpec; }
 
@@ -131,10 +137,23 @@ namespace FluxAudio {
 
     private:
 
-        // decoder / steam
-        SDL_AudioStream* stream = nullptr;
+        // playback
+        VoiceID mVoice = 0;
+        DecodeService::StreamID mDecodeStream = 0;
+        std::shared_ptr<PcmRing> mRing;     // for the progress
+        bool mPaused = false;
+        bool mSentLoop = false;
+        float mSentVolume = 1.f;
+        Point3F mSentPosition = {};
+
+        // cached PCM for short sounds (filled by the first play), otherwise
+        // createSourceDecoder
+        std::unique_ptr<DecodeService::Decoder> createDecoder();
+        std::unique_ptr<DecodeService::Decoder> createSourceDecoder(bool withCallback);
+        void closeStream(bool wait = false);
+
+        // decoder, only for the meta data. Playback uses its own decoders
         stb_vorbis* vorbisDecoder = nullptr;
-        ma_decoder maDecoder;
 
         #ifdef AUDIO_PORT_SFX
         SFXGeneratorStereo*  mSFXGen = nullptr;
@@ -146,7 +165,6 @@ namespace FluxAudio {
 
 
         // Buffer
-        size_t mSamplePos = 0;
         size_t mSampleLen = 0;
         double mSampleDuration = 0; // sample len in secounds
 
@@ -155,9 +173,6 @@ namespace FluxAudio {
         size_t mWavFrames = 0; //special for wav
 
         void setSampleLenAndDuration();
-
-        std::vector<float> mAudioBuffer;
-        bool fillBuffer();
     }; //AudioInstance
 
     //--------------------------------------------------------------------------
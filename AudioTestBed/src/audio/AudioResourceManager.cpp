@@ -6,6 +6,10 @@
 #include <stdexcept>
 #include <type_traits>
 
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
 
 #include "utils/errorlog.h"
 #include "utils/fluxStr.h"
@@ -24,9 +28,7 @@ namespace FluxAudio {
         mShutDown = true;
 
 
-        for (auto& [key, val] : mResourceMap) {
-            val->mRawData.clear();
-        }
+        mPcmCache.clear();
         mResourceMap.clear();
         if (mAudioDevice != 0) {
             SDL_CloseAudioDevice(mAudioDevice);
@@ -89,21 +91,37 @@ namespace FluxAudio {
             return false;
         }
 
-        // convert raw wav to directly usable
-        if ( resData->fileType == AudioType::WAV ) {
-            Uint8* wavBuf;
-            Uint32 wavLen;
-            SDL_IOStream* io = SDL_IOFromConstMem(resData->mRawData.data(), resData->mRawData.size());
-
-            if (SDL_LoadWAV_IO(io, true, &resData->wavSrcSpec, &wavBuf, &wavLen)) {
-                resData->mRawData.assign(wavBuf, wavBuf + wavLen);
-                SDL_free(wavBuf);
-            } else {
-                blacklist(fileName);
-                SDL_free(wavBuf);
-                Log("[error] Failed to load Wave %s", fileName.c_str());
-                return false;
+        switch (resData->fileType) {
+            case AudioType::SFX: {
+                // tiny, the generator wants it in memory anyway
+                std::vector<uint8_t> raw(resData->getSize());
+                raw.resize(resData->readData(0, raw.data(), raw.size()));
+                resData->setRawData(std::move(raw));
+                break;
+            }
+            case AudioType::WAV: {
+                // plain PCM is streamed from the file
+                if (MapWav(*resData)) break;
+
+                // anything else (ADPCM, 24 bit, ...) is decoded by SDL
+                Uint8* wavBuf = nullptr;
+                Uint32 wavLen;
+                const uint8_t* fileData = resData->getData();
+                SDL_IOStream* io = fileData ? SDL_IOFromConstMem(fileData, resData->getSize()) : nullptr;
+
+                if (io && SDL_LoadWAV_IO(io, true, &resData->wavSrcSpec, &wavBuf, &wavLen)) {
+                    resData->setRawData(std::vector<uint8_t>(wavBuf, wavBuf + wavLen));
+                    SDL_free(wavBuf);
+                } else {
+                    blacklist(fileName);
+                    SDL_free(wavBuf);
+                    Log("[error] Failed to load Wave %s", fileName.c_str());
+                    return false;
+                }
+                break;
             }
+            default:
+                break;
         }
 
         mResourceMap[fileName] = std::move(resData);
@@ -111,64 +129,180 @@ namespace FluxAudio {
 
     }
     //--------------------------------------------------------------------------
-    // now with preload
+    // maps the file, only the header is read here
     bool ResourceManager::LoadRawFile(ResourceData& data) {
-        std::ifstream ifs(data.fileName, std::ios::binary | std::ios::ate);
-        if (!ifs.is_open()) {
+        data.mFile = FluxMappedFile::open(data.fileName);
+        if (!data.mFile) {
             Log("[error] Load audio resource: Can't open File %s", data.fileName.c_str());
             return false;
         }
-        try {
-            std::streamsize fileSize = ifs.tellg();
-            ifs.seekg(0, std::ios::beg);
-            // preload 1024 bytes for header check
-            size_t headerSize = std::min(static_cast<size_t>(fileSize), size_t(1024));
-            std::vector<uint8_t> header(headerSize);
-            ifs.read(reinterpret_cast<char*>(header.data()), headerSize);
-
-            // Detect type from header
-            data.fileType = detectType(header);
-
-            // Handle Fallbacks (Extensions) if still UNKNOWN
-            if (data.fileType == AudioType::UNKNOWN) {
-                if (data.fileType == AudioType::UNKNOWN) {
-                    std::string ext = FluxStr::extractFileExt(data.fileName, true);
-                    if ( ext == "mp3") {
-                        data.fileType = AudioType::MP3;
-                        Log("[info] Audio type MP3 detected via extension fallback for: %s", data.fileName.c_str());
-                    }
-                    else if (ext == "sfx" && fileSize < 200) {
-                        // && data.mRawData.size() == 105 was version 102 ...
-                        // sfxGenerator have to check this - i only make sure it's a small file!
-                        data.fileType = AudioType::SFX;
-                        Log("[info] Audio type legacy SFX detected via extension fallback for: %s (size: %d)", data.fileName.c_str(), (int)data.mRawData.size());
-                    } else if (ext == "flac") {
-                        data.fileType = AudioType::FLAC;
-                    }
-                }
+        const size_t fileSize = data.mFile->size();
+        data.mDataOffset = 0;
+        data.mDataSize = fileSize;
+
+        // preload 1024 bytes for header check
+        std::vector<uint8_t> header(std::min(fileSize, size_t(1024)));
+        header.resize(data.mFile->read(0, header.data(), header.size()));
+
+        // Detect type from header
+        data.fileType = detectType(header);
+
+        // Handle Fallbacks (Extensions) if still UNKNOWN
+        if (data.fileType == AudioType::UNKNOWN) {
+            std::string ext = FluxStr::extractFileExt(data.fileName, true);
+            if ( ext == "mp3") {
+                data.fileType = AudioType::MP3;
+                Log("[info] Audio type MP3 detected via extension fallback for: %s", data.fileName.c_str());
             }
-            // Check type is set ...
-            if (data.fileType == AudioType::UNKNOWN) {
-                Log("[warning] Audio format not recognized for: %s", data.fileName.c_str());
-                return false;
+            else if (ext == "sfx" && fileSize < 200) {
+                // && size == 105 was version 102 ...
+                // sfxGenerator have to check this - i only make sure it's a small file!
+                data.fileType = AudioType::SFX;
+                Log("[info] Audio type legacy SFX detected via extension fallback for: %s (size: %d)", data.fileName.c_str(), (int)fileSize);
+            } else if (ext == "flac") {
+                data.fileType = AudioType::FLAC;
+            }
+        }
+        // Check type is set ...
+        if (data.fileType == AudioType::UNKNOWN) {
+            Log("[warning] Audio format not recognized for: %s", data.fileName.c_str());
+            data.mFile = nullptr;
+            return false;
+        }
+
+        return true;
+    }
+    //--------------------------------------------------------------------------
+    static inline uint16_t readLE16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+    static inline uint32_t readLE32(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+    //--------------------------------------------------------------------------
+    bool ResourceManager::MapWav(ResourceData& data) {
+        FluxMappedFile& file = *data.mFile;
+
+        uint8_t riff[12];
+        if (file.read(0, riff, sizeof(riff)) != sizeof(riff)
+            || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0)
+            return false;
+
+        SDL_AudioSpec spec = {};
+        bool haveFormat = false;
+        size_t offset = 12;
+        uint8_t chunk[8];
+
+        while (file.read(offset, chunk, sizeof(chunk)) == sizeof(chunk)) {
+            const uint32_t chunkSize = readLE32(chunk + 4);
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                uint8_t fmt[26] = {};
+                if (chunkSize < 16 || file.read(offset + 8, fmt, std::min<size_t>(chunkSize, sizeof(fmt))) < 16)
+                    return false;
+
+                uint16_t formatTag = readLE16(fmt);
+                const uint16_t bits = readLE16(fmt + 14);
+                // WAVE_FORMAT_EXTENSIBLE: the real tag starts the sub format GUID
+                if (formatTag == 0xFFFE) {
+                    if (chunkSize < 26) return false;
+                    formatTag = readLE16(fmt + 24);
+                }
+
+                if (formatTag == 1 && bits == 8)        spec.format = SDL_AUDIO_U8;
+                else if (formatTag == 1 && bits == 16)  spec.format = SDL_AUDIO_S16LE;
+                else if (formatTag == 1 && bits == 32)  spec.format = SDL_AUDIO_S32LE;
+                else if (formatTag == 3 && bits == 32)  spec.format = SDL_AUDIO_F32LE;
+                else return false;
+
+                spec.channels = readLE16(fmt + 2);
+                spec.freq = (int)readLE32(fmt + 4);
+                if (spec.channels == 0 || spec.freq <= 0) return false;
+                haveFormat = true;
+
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                if (!haveFormat) return false;
+
+                // truncated files are common, trust the file size
+                const size_t frameBytes = (size_t)SDL_AUDIO_BYTESIZE(spec.format) * spec.channels;
+                size_t size = std::min<size_t>(chunkSize, file.size() - (offset + 8));
+                size -= size % frameBytes;
+
+                data.wavSrcSpec = spec;
+                data.mDataOffset = offset + 8;
+                data.mDataSize = size;
+                return true;
             }
+            offset += 8 + (size_t)chunkSize + (chunkSize % 2); // Jump to next chunk
+        }
+        return false;
+    }
+    //--------------------------------------------------------------------------
+    // resident set size in bytes, 0 where we can't tell
+    static size_t getResidentBytes() {
+    #if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        size_t total = 0, resident = 0;
+        if (statm >> total >> resident)
+            return resident * (size_t)sysconf(_SC_PAGESIZE);
+    #endif
+        return 0;
+    }
+    //--------------------------------------------------------------------------
+    void ResourceManager::benchmarkLoad(const std::vector<std::string>& fileNames) {
+        if (fileNames.empty()) return;
+
+        const double freq = (double)SDL_GetPerformanceFrequency();
+        size_t totalBytes = 0;
 
-            // Read the rest only if needed
-            data.mRawData.resize(static_cast<size_t>(fileSize));
-            // Copy already read header
-            std::memcpy(data.mRawData.data(), header.data(), headerSize);
-            // Read the remainder of the file
-            if (fileSize > headerSize) {
-                ifs.read(reinterpret_cast<char*>(data.mRawData.data() + headerSize), fileSize - headerSize);
+        // read every file once untimed: both passes then run on a warm page
+        // cache, otherwise whichever pass runs first pays the disk reads.
+        // One small buffer, so the resident size is not changed by it.
+        {
+            std::vector<char> chunk(64 * 1024);
+            for (const std::string& fileName : fileNames) {
+                std::ifstream ifs(fileName, std::ios::binary);
+                while (ifs.read(chunk.data(), (std::streamsize)chunk.size()) || ifs.gcount() > 0) {}
             }
+        }
 
-            return true;
+        size_t rss = getResidentBytes();
+        uint64_t start = SDL_GetPerformanceCounter();
+        std::vector<std::shared_ptr<FluxMappedFile>> mapped;
+        for (const std::string& fileName : fileNames) {
+            auto file = FluxMappedFile::open(fileName);
+            if (!file) continue;
+            uint8_t header[1024];
+            file->read(0, header, sizeof(header));
+            totalBytes += file->size();
+            mapped.push_back(std::move(file));
+        }
+        const double mappedMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / freq;
+        size_t after = getResidentBytes();
+        const size_t mappedRss = after > rss ? after - rss : 0;
+        mapped.clear();
 
-        } catch (const std::exception& e) {
-            Log("[error] Load audio resource exception: %s", e.what());
-            return false;
+        // the loader before the mapping: whole file into a vector
+        rss = getResidentBytes();
+        start = SDL_GetPerformanceCounter();
+        std::vector<std::vector<uint8_t>> loaded;
+        for (const std::string& fileName : fileNames) {
+            std::ifstream ifs(fileName, std::ios::binary | std::ios::ate);
+            if (!ifs.is_open()) continue;
+            std::vector<uint8_t> raw((size_t)ifs.tellg());
+            ifs.seekg(0, std::ios::beg);
+            ifs.read(reinterpret_cast<char*>(raw.data()), (std::streamsize)raw.size());
+            loaded.push_back(std::move(raw));
         }
+        const double readMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / freq;
+        after = getResidentBytes();
+        const size_t readRss = after > rss ? after - rss : 0;
+        loaded.clear();
 
+        const double mb = 1.0 / (1024.0 * 1024.0);
+        Log("[info] Audio load benchmark: %d files, %.2f MB", (int)fileNames.size(), totalBytes * mb);
+        Log("[info]   read:   %8.2f ms  resident +%.2f MB", readMs, readRss * mb);
+        Log("[info]   mapped: %8.2f ms  resident +%.2f MB", mappedMs, mappedRss * mb);
+        if (rss == 0)
+            Log("[info]   resident memory is not available on this platform");
     }
 
 }; //namespace
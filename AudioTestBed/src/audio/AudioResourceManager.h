@@ -7,8 +7,12 @@
 #include <SDL3/SDL.h>
 
 #include "core/ResourceManagerBase.h"
+#include "utils/fluxMappedFile.h"
+#include "audio/fluxPcmCache.h"
 #include "AudioType.h"
 
+#include <algorithm>
+#include <cstring>
 #include <unordered_map>
 #include <vector>
 #include <memory>
@@ -19,7 +23,12 @@ namespace FluxAudio {
 
     struct ResourceData {
        std::string fileName = "";
+       // in memory data: recordings, converted SFX and WAVs SDL has to decode
        std::vector<uint8_t> mRawData =  {};
+       // file backed data, mapped or read on demand. mRawData is empty then
+       std::shared_ptr<FluxMappedFile> mFile = nullptr;
+       size_t mDataOffset = 0;  // payload inside mFile, for WAV the data chunk
+       size_t mDataSize = 0;
        AudioType fileType = AudioType::UNKNOWN;
 
        bool enableLoop      = false;  // default for instance
@@ -30,6 +39,33 @@ namespace FluxAudio {
        //     but i need to keep the Spec for convert
        SDL_AudioSpec wavSrcSpec;
 
+       // the payload. On the read on demand backend this loads the whole file,
+       // prefer readData() when the decoder can stream
+       const uint8_t* getData() {
+           if (!mFile) return mRawData.data();
+           const uint8_t* base = mFile->data();
+           return base ? base + mDataOffset : nullptr;
+       }
+       size_t getSize() const { return mFile ? mDataSize : mRawData.size(); }
+
+       // true if getData() would have to read the whole file first
+       bool isStreamed() const { return mFile && !mFile->isMapped(); }
+
+       size_t readData(size_t offset, void* dst, size_t len) {
+           if (offset >= getSize()) return 0;
+           len = std::min(len, getSize() - offset);
+           if (mFile) return mFile->read(mDataOffset + offset, dst, len);
+           std::memcpy(dst, mRawData.data() + offset, len);
+           return len;
+       }
+
+       // replaces the file with in memory data
+       void setRawData(std::vector<uint8_t>&& data) {
+           mRawData = std::move(data);
+           mFile = nullptr;
+           mDataOffset = 0;
+           mDataSize = 0;
+       }
     };
 
     // -------------------------------------------------------------------------
@@ -41,9 +77,13 @@ namespace FluxAudio {
         bool mInitialized = false;
         bool mShutDown = false;
 
+        // decoded short sounds, see AudioInstance::createDecoder
+        PcmCache mPcmCache;
+
 
         ResourceManager():
-            mShutDown(false)
+            mShutDown(false),
+            mPcmCache(PCM_CACHE_BUDGET)
         {}
         ~ResourceManager() {
             Deinitialize();
@@ -56,6 +96,10 @@ namespace FluxAudio {
         void Deinitialize();
 
     public:
+        static constexpr size_t PCM_CACHE_BUDGET = 32 * 1024 * 1024;
+        // only sounds up to this length are cached decoded
+        static constexpr double PCM_CACHE_MAX_SEC = 3.0;
+
         // Get the single instance
         static ResourceManager&  getInstance() {
             static ResourceManager instance;
@@ -85,14 +129,23 @@ namespace FluxAudio {
         ResourceData* get(std::string fileName, bool noAutoLoad = false);
 
         bool remove(std::string fileName) {
+            mPcmCache.remove(fileName);
             mResourceMap.erase(fileName);
             return true;
         }
 
+        PcmCache& getPcmCache() { return mPcmCache; }
+
+        // loads the files with the old loader (whole file into memory) and
+        // mapped, logs time and resident memory of both
+        void benchmarkLoad(const std::vector<std::string>& fileNames);
+
 
     private:
 
         bool LoadRawFile(ResourceData &data);
+        // streams PCM WAVs from the file, false if SDL has to decode it
+        bool MapWav(ResourceData &data);
 
 
     }; //class
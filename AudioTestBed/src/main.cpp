@@ -149,9 +149,28 @@ class AudioTestBed : public FluxMain
 
         if (cmd == "list") {
             for (auto& [key, val] : AudioResourceManager.getMap()) {
-                Log("%s type:%d size:%d", key.c_str(), (int)val->fileType, (int)val->mRawData.size());
+                Log("%s type:%d size:%d %s", key.c_str(), (int)val->fileType, (int)val->getSize(),
+                    val->mFile ? (val->mFile->isMapped() ? "mapped" : "on demand") : "memory");
             }
         }
+        else if (cmd == "cache") {
+            // cache [budget MB]
+            FluxAudio::PcmCache& cache = AudioResourceManager.getPcmCache();
+            if (FluxStr::getWordCount(cmdLineStr) > 1)
+                cache.setBudget((size_t)(FluxStr::strToFloat(FluxStr::getWord(cmdLineStr, 1)) * 1024.f * 1024.f));
+            FluxAudio::PcmCache::Stats stats = cache.getStats();
+            Log("PCM cache: %d entries, %.2f / %.2f MB, hits:%d misses:%d evictions:%d",
+                (int)stats.entries, stats.bytes / (1024.0 * 1024.0), stats.budget / (1024.0 * 1024.0),
+                (int)stats.hits, (int)stats.misses, (int)stats.evictions);
+        }
+        else if (cmd == "bench") {
+            // load time and resident memory of the loaded files, old loader vs. mapped
+            std::vector<std::string> fileNames;
+            for (auto& [key, val] : AudioResourceManager.getMap()) {
+                if (val->mFile) fileNames.push_back(val->mFile->getFileName());
+            }
+            AudioResourceManager.benchmarkLoad(fileNames);
+        }
 
     }
     // -------------------------------------------------------------------------
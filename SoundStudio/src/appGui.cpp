@@ -209,6 +209,85 @@ void AppGui::OnConsoleCommand(ImConsole* console, const char* cmdline){
             dLog("[info] SPAM %i", i);
         }
     }
+    else if (cmd == "/mixbench") {
+        // /mixbench [frames]
+        int frames = std::atoi(FluxStr::getWord(cmdline, 1).c_str());
+        if (frames <= 0) frames = 64;
+        if (mSoundMixModule) mSoundMixModule->benchmarkMix(frames);
+    }
+    else if (cmd == "/convbench") {
+        // /convbench [ir seconds]
+        float irSeconds = (float)std::atof(FluxStr::getWord(cmdline, 1).c_str());
+        if (irSeconds <= 0.f) irSeconds = 3.f;
+        const auto result = DSP::ConvolutionReverb::benchmark(irSeconds);
+        Log("[info] Convolution %.1f s stereo IR @ 48kHz, %d frames latency:", result.irSeconds, DSP::ConvolutionReverb::HEAD_BLOCK);
+        Log("[info]   audio thread %.2f %% (worst block %.1f us), background %.2f %%",
+            result.audioThreadLoad * 100.f, result.maxBlockUs, result.backgroundLoad * 100.f);
+    }
+    else if (cmd == "/convtest") {
+        // /convtest [instances] - more reverbs than the background worker takes
+        int count = std::atoi(FluxStr::getWord(cmdline, 1).c_str());
+        if (count <= 0) count = DSP::ConvolutionWorker::MAX_CLIENTS + 8;
+        const bool ok = DSP::ConvolutionReverb::testManyInstances(count);
+        Log("[%s] Convolution %d instances: %s", ok ? "info" : "error", count, ok ? "ok" : "FAILED");
+    }
+    else if (cmd == "/bankbench") {
+        // /bankbench [racks]
+        int racks = std::atoi(FluxStr::getWord(cmdline, 1).c_str());
+        if (racks <= 0) racks = DSP::MAX_RACKS_IN_PRESET;
+        const auto result = DSP::EffectsManager::benchmarkPresetLoad(racks);
+        Log("[info] Preset load %d racks x %d effects:", result.racks, result.effectsPerRack);
+        Log("[info]   AXE! stream %zu bytes: %.2f ms", result.streamBytes, result.streamLoadMs);
+        Log("[info]   BANK %zu bytes: open %.2f ms, select rack %.3f ms, all racks %.2f ms",
+            result.bankBytes, result.bankOpenMs, result.rackSelectMs, result.bankAllMs);
+    }
+    else if (cmd == "/silencebench") {
+        // /silencebench [seconds of silence] - blocks the gui for a while!
+        float seconds = (float)std::atof(FluxStr::getWord(cmdline, 1).c_str());
+        if (seconds <= 0.f) seconds = 60.f;
+        const auto result = DSP::EffectsManager::benchmarkSilence(512, 2.f, seconds);
+        auto logMode = [](const char* name, const DSP::EffectsManager::SilenceBenchmark::Mode& mode) {
+            Log("[info]   %-22s loud %7.1f us, silence %7.1f us (max %7.1f us)",
+                name, mode.loudUs, mode.silentUs, mode.maxSilentUs);
+        };
+        Log("[info] Silence benchmark, %d frames per block, %.0f s silence:", result.frames, result.silentSeconds);
+        logMode("no flush-to-zero", result.plain);
+        logMode("flush-to-zero", result.flush);
+        logMode("flush + tail bypass", result.bypass);
+    }
+    else if (cmd == "/idlebench") {
+        // /idlebench [seconds] - effects + analyzers, always running vs. tail bypass
+        float seconds = (float)std::atof(FluxStr::getWord(cmdline, 1).c_str());
+        if (seconds <= 0.f) seconds = 20.f;
+        const auto result = DSP::EffectsManager::benchmarkIdle(512, seconds);
+        auto logScenario = [](const char* name, const DSP::EffectsManager::IdleBenchmark::Scenario& scenario) {
+            Log("[info]   %-8s always %7.1f us, bypass %7.1f us, saved %5.1f%% (%.0f%% of effect blocks skipped)",
+                name, scenario.alwaysUs, scenario.bypassUs, scenario.savedPercent(), scenario.skippedShare * 100.0);
+        };
+        Log("[info] Idle benchmark, %d frames per block, %.0f s:", result.frames, result.seconds);
+        logScenario("idle", result.idle);
+        logScenario("sparse", result.sparse);
+    }
+    else if (cmd == "/drumbench") {
+        // /drumbench [seconds] - DrumKit with every drum on 16th notes
+        float seconds = (float)std::atof(FluxStr::getWord(cmdline, 1).c_str());
+        if (seconds <= 0.f) seconds = 10.f;
+        const auto result = DSP::DrumKit::benchmark(512, seconds);
+        Log("[info] DrumKit benchmark, %d frames, 16th notes: %.1f us/block, load %.2f%%, max %d voices",
+            result.frames, result.usPerBlock, result.load * 100.0, result.maxVoices);
+    }
+    else if (cmd == "/streamstats") {
+        // /streamstats [target ms] - worker feeding the stereo sfx stream
+        SFXGeneratorStereo* generator = mSfxStereoModule ? mSfxStereoModule->getSFXGeneratorStereo() : nullptr;
+        if (!generator) return;
+        float targetMs = (float)std::atof(FluxStr::getWord(cmdline, 1).c_str());
+        if (targetMs > 0.f) generator->setStreamLatency(targetMs / 1000.f);
+        const auto stats = generator->getStreamStats();
+        Log("[info] SFX stream: target %.1f ms, queued %.1f ms (min %.1f ms), block %u frames",
+            stats.targetMs, stats.queuedMs, stats.minQueuedMs, stats.blockFrames);
+        Log("[info]   underruns %u, wakeups %.0f/s, %llu frames rendered",
+            stats.underruns, stats.wakeupsPerSec, (unsigned long long)stats.framesRendered);
+    }
 
 }
 
@@ -15,6 +15,7 @@
 void SDLCALL PipeCallback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount) {
 
     auto* inMod = static_cast<InputModule*>(userdata);
+    SetLogThreadRealtime(true);
 
     if (additional_amount <= 0 || !inMod || !inMod->isOpen()) return;
 
@@ -30,6 +30,8 @@
 void SDLCALL FinalMixCallback(void *userdata, const SDL_AudioSpec *spec, float *buffer, int buflen) {
     if (!userdata || !spec || !buffer || buflen < 1) return;
     auto* soundMix = static_cast<SoundMixModule*>(userdata);
+    DSP::ScopedDenormalGuard denormalGuard;
+    SetLogThreadRealtime(true);
 
     if (!soundMix )
         return;
@@ -41,28 +43,8 @@ void SDLCALL FinalMixCallback(void *userdata, const SDL_AudioSpec *spec, float *
 
     if ( spec->format == SDL_AUDIO_F32 )
     {
-        soundMix->getEffectsManager()->lock();
-        if (buflen > 0 && soundMix->getEffectsManager()->getEffects().size() > 0)
-        {
-            int numSamples = buflen / sizeof(float);
-
-            soundMix->getEffectsManager()->checkFrequence(spec->freq);
-            soundMix->getEffectsManager()->process(buffer, numSamples, spec->channels);
-
-            soundMix->mDrumManager->checkFrequence(spec->freq);
-            soundMix->mDrumManager->process(buffer, numSamples, spec->channels);
-
-
-            soundMix->mDrumKit->process(buffer, numSamples, spec->channels);
-            soundMix->mSpectrumAnalyzer->process(buffer, numSamples, spec->channels);
-            soundMix->mVisualAnalyzer->process(buffer, numSamples, spec->channels);
-
-
-            // for (auto& effect : soundMix->getEffectsManager()->getEffects()) {
-            //     effect->process(buffer, numSamples, spec->channels);
-            // }
-        }
-        soundMix->getEffectsManager()->unlock();
+        int numSamples = buflen / sizeof(float);
+        soundMix->processMix(buffer, numSamples, spec->channels, spec->freq);
     }
 
     // NOTE: EXAMPLE CODE:
@@ -70,7 +52,176 @@ void SDLCALL FinalMixCallback(void *userdata, const SDL_AudioSpec *spec, float *
     //     SDL_PutAudioStreamData(recording_stream, buffer, buflen);
     // }
 }
+//------------------------------------------------------------------------------
+// effects rack on the device buffer
+void SoundMixModule::runMainBus(void* user) {
+    auto* job = static_cast<MixJob*>(user);
+    MixChain* chain = job->chain;
+    chain->rack->checkFrequence(job->freq);
+    chain->rack->process(job->buffer, job->numSamples, job->numChannels, job->input);
+}
+//------------------------------------------------------------------------------
+// drum generators only add to the buffer, so they render into their own bus
+// which is summed after the join
+void SoundMixModule::runDrumBus(void* user) {
+    auto* job = static_cast<MixJob*>(user);
+    MixChain* chain = job->chain;
+    float* bus = chain->drumBus.data();
+    std::fill(bus, bus + job->numSamples, 0.f);
+
+    chain->drums->checkFrequence(job->freq);
+    job->drumOut = chain->drums->process(bus, job->numSamples, job->numChannels, DSP::BlockInfo::silence());
+    if (job->kitOnBus) {
+        chain->kit->process(bus, job->numSamples, job->numChannels);
+        job->drumOut = DSP::BlockInfo::measure(bus, job->numSamples);
+    }
+}
+//------------------------------------------------------------------------------
+void SoundMixModule::mixChain(MixChain& chain, float* buffer, int numSamples, int numChannels, int freq, bool parallel) {
+    // only grows, the first callbacks may allocate
+    if (chain.drumBus.size() < (size_t)numSamples) chain.drumBus.resize(numSamples);
+
+    MixJob& job = chain.job;
+    job.chain = &chain;
+    job.buffer = buffer;
+    job.numSamples = numSamples;
+    job.numChannels = numChannels;
+    job.freq = freq;
+    // a recording looper needs the mixed signal, then the kit runs after the join
+    job.kitOnBus = !chain.kit->readsInput();
+    // measured once, the rack passes it from effect to effect
+    job.input = DSP::BlockInfo::measure(buffer, numSamples);
+
+    if (parallel) {
+        const float periodUs = (float)(numSamples / numChannels) * 1000000.f / (float)std::max(1, freq);
+        const DSP::WorkerPool::Task tasks[2] = {
+            { &SoundMixModule::runDrumBus, &job },
+            { &SoundMixModule::runMainBus, &job },
+        };
+        chain.pool->run(tasks, 2, periodUs * 0.5f);
+    } else {
+        runMainBus(&job);
+        runDrumBus(&job);
+    }
+
+    // idle drums leave the bus at zero, nothing to add
+    if (job.drumOut.peak > 0.f) {
+        const float* bus = chain.drumBus.data();
+        for (int i = 0; i < numSamples; i++) buffer[i] += bus[i];
+    }
+    if (!job.kitOnBus)
+        chain.kit->process(buffer, numSamples, numChannels);
+
+    // observers: copy only, they run in pumpAnalyzers()
+    chain.tap->setFormat(numChannels, freq);
+    chain.tap->write(buffer, (uint32_t)numSamples);
+}
+//------------------------------------------------------------------------------
+void SoundMixModule::processMix(float* buffer, int numSamples, int numChannels, int freq, bool parallel) {
+    if (!mInitialized || numSamples < 1 || numChannels < 1) return;
+    const uint64_t start = SDL_GetPerformanceCounter();
+
+    mixChain(mLiveChain, buffer, numSamples, numChannels, freq, parallel);
+
+    const float periodUs = (float)(numSamples / numChannels) * 1000000.f / (float)std::max(1, freq);
+    const float usedUs = (float)((double)(SDL_GetPerformanceCounter() - start) * 1000000.0
+                                 / (double)SDL_GetPerformanceFrequency());
+    mStatCallbackUs.store(usedUs, std::memory_order_relaxed);
+    if (usedUs > mStatMaxCallbackUs.load(std::memory_order_relaxed))
+        mStatMaxCallbackUs.store(usedUs, std::memory_order_relaxed);
+    const float headroom = 1.f - usedUs / periodUs;
+    if (headroom < mStatMinHeadroom.load(std::memory_order_relaxed))
+        mStatMinHeadroom.store(headroom, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+void SoundMixModule::pumpAnalyzers() {
+    const int channels = mAnalyzerTap.getChannels();
+    const int rate = mAnalyzerTap.getSampleRate();
+    if (rate != mAnalyzerRate) {
+        mAnalyzerRate = rate;
+        mSpectrumAnalyzer->setSampleRate((float)rate);
+        mVisualAnalyzer->setSampleRate((float)rate);
+    }
 
+    if (mTapScratch.empty()) mTapScratch.resize(4096);
+    uint32_t count;
+    while ((count = mAnalyzerTap.read(mTapScratch.data(), (uint32_t)mTapScratch.size(), (uint32_t)channels)) > 0) {
+        // no signal: the analyzers fall back to zero and then stop updating
+        const DSP::BlockInfo info = DSP::BlockInfo::measure(mTapScratch.data(), (int)count);
+        mSpectrumAnalyzer->processTail(mTapScratch.data(), (int)count, channels, info);
+        mVisualAnalyzer->processTail(mTapScratch.data(), (int)count, channels, info);
+    }
+}
+//------------------------------------------------------------------------------
+void SoundMixModule::benchmarkMix(int frames, int iterations) {
+    if (!mInitialized || frames < 1 || iterations < 1) return;
+
+    const int channels = 2;
+    const int freq = 48000;
+    const int numSamples = frames * channels;
+    std::vector<float> buffer(numSamples);
+
+    // private copy of the graph: the live callback keeps its rack, pool and
+    // tap for itself and the test signal never reaches the looper
+    DSP::EffectsManager lRack(mEffectsManager->isEnabled());
+    DSP::EffectsManager lDrums(mDrumManager->isEnabled());
+    mEffectsManager->lock();
+    for (const auto& fx : mEffectsManager->getEffects()) lRack.addEffect(fx->clone());
+    lRack.setTailBypass(mEffectsManager->getTailBypass());
+    mEffectsManager->unlock();
+    mDrumManager->lock();
+    for (const auto& fx : mDrumManager->getEffects()) lDrums.addEffect(fx->clone());
+    lDrums.setTailBypass(mDrumManager->getTailBypass());
+    mDrumManager->unlock();
+    std::unique_ptr<DSP::DrumKit> lKit = cast_unique<DSP::DrumKit>(mDrumKit->clone());
+
+    DSP::WorkerPool lPool(mWorkerPool.getNumWorkers());
+    DSP::SampleTap lTap(1 << 16);
+    MixChain lChain;
+    lChain.rack = &lRack;
+    lChain.drums = &lDrums;
+    lChain.kit = lKit.get();
+    lChain.pool = &lPool;
+    lChain.tap = &lTap;
+    lChain.drumBus.resize(numSamples);
+
+    auto measure = [&](bool parallel) {
+        const uint64_t start = SDL_GetPerformanceCounter();
+        for (int i = 0; i < iterations; i++) {
+            for (int s = 0; s < numSamples; s++) buffer[s] = (float)((s * 7 + i) % 64) / 64.f - 0.5f;
+            mixChain(lChain, buffer.data(), numSamples, channels, freq, parallel);
+            // the gui would drain it, keep it from filling up
+            lTap.skipAll();
+        }
+        return (double)(SDL_GetPerformanceCounter() - start) * 1000000.0
+               / (double)SDL_GetPerformanceFrequency() / (double)iterations;
+    };
+
+    // the analyzers used to run inside the callback, add them for a fair serial figure
+    auto lSpectrum = DSP::EffectFactory::Create(DSP::EffectType::SpectrumAnalyzer);
+    auto lVisual = DSP::EffectFactory::Create(DSP::EffectType::VisualAnalyzer);
+    std::vector<float> observer(numSamples);
+    const uint64_t obsStart = SDL_GetPerformanceCounter();
+    for (int i = 0; i < iterations; i++) {
+        lSpectrum->process(observer.data(), numSamples, channels);
+        lVisual->process(observer.data(), numSamples, channels);
+    }
+    const double observerUs = (double)(SDL_GetPerformanceCounter() - obsStart) * 1000000.0
+                              / (double)SDL_GetPerformanceFrequency() / (double)iterations;
+
+    const double serialUs = measure(false) + observerUs;
+    lPool.resetStats();
+    const double parallelUs = measure(true);
+    const double periodUs = (double)frames * 1000000.0 / (double)freq;
+    const DSP::WorkerPool::Stats stats = lPool.getStats();
+
+    Log("[info] Mix benchmark %d frames (%.1f us period), %d workers:", frames, periodUs, lPool.getNumWorkers());
+    Log("[info]   serial   %.2f us/block, headroom %.1f%%", serialUs, 100.0 * (1.0 - serialUs / periodUs));
+    Log("[info]   parallel %.2f us/block, headroom %.1f%%", parallelUs, 100.0 * (1.0 - parallelUs / periodUs));
+    Log("[info]   tasks on workers %u/%u, max wait %.1f us, deadline misses %u",
+        stats.tasksOnWorkers, stats.tasks, stats.maxWaitUs, stats.deadlineMisses);
+}
+//------------------------------------------------------------------------------
 void SoundMixModule::DrawDrums(bool* p_enabled) {
     if (!mInitialized ||  mDrumManager == nullptr || !*p_enabled) return;
 
@@ -87,6 +238,7 @@ void SoundMixModule::DrawDrums(bool* p_enabled) {
 void SoundMixModule::DrawRack(bool* p_enabled)
 {
     if (!mInitialized ||  mEffectsManager == nullptr) return;
+    pumpAnalyzers();
     ImGui::SetNextWindowSizeConstraints(ImVec2(600.0f, 650.f), ImVec2(FLT_MAX, FLT_MAX));
     ImGui::Begin("Post Digital Sound Effects Rack");
     mEffectsManager->renderUI(1);
@@ -95,6 +247,11 @@ void SoundMixModule::DrawRack(bool* p_enabled)
     ImGui::SetNextWindowSizeConstraints(ImVec2(600.0f, 650.f), ImVec2(FLT_MAX, FLT_MAX));
     ImGui::Begin("Post Digital Sound Effects Visualizer");
 
+    ImGui::Text("Mix %.1f us, max %.1f us, min headroom %.0f%%, %d worker(s)",
+                getCallbackUs(), getMaxCallbackUs(), 100.f * getMinHeadroom(), mWorkerPool.getNumWorkers());
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Reset##MixStats")) resetMixStats();
+
     {
         ImGui::PushID("SpectrumAnalyzer_Effect_Row");
         ImGui::BeginGroup();
@@ -213,6 +370,14 @@ bool SoundMixModule::Initialize() {
         mSpectrumAnalyzer = cast_unique<DSP::SpectrumAnalyzer>(DSP::EffectFactory::Create(DSP::EffectType::SpectrumAnalyzer));
         mVisualAnalyzer = cast_unique<DSP::VisualAnalyzer>(DSP::EffectFactory::Create(DSP::EffectType::VisualAnalyzer));
 
+        mLiveChain.rack = mEffectsManager.get();
+        mLiveChain.drums = mDrumManager.get();
+        mLiveChain.kit = mDrumKit.get();
+        mLiveChain.pool = &mWorkerPool;
+        mLiveChain.tap = &mAnalyzerTap;
+        mLiveChain.drumBus.resize(8192);
+        Log("[info] SoundMixModule: %d audio worker(s).", mWorkerPool.getNumWorkers());
+
 
 
         for (const auto& fx : mEffectsManager->getEffects()) {
@@ -6,6 +6,8 @@
 #include <DSP.h>
 #include <DSP_EffectsManager.h>
 #include <DSP_EffectFactory.h>
+#include <DSP_WorkerPool.h>
+#include <DSP_SampleTap.h>
 
 #include <imgui.h>
 #include <gui/ImFlux.h>
@@ -16,11 +18,47 @@ class SoundMixModule : public FluxBaseObject {
 private:
     std::unique_ptr<DSP::EffectsManager> mEffectsManager = nullptr;
 
-
-
+    // audio graph: the effects rack and the drum bus run in parallel, the
+    // analyzers only observe and read a copy of the output on the gui thread
+    DSP::WorkerPool mWorkerPool;
+    DSP::SampleTap mAnalyzerTap { 1 << 16 };
+    std::vector<float> mTapScratch;
+    int mAnalyzerRate = 0;
+
+    struct MixChain;
+    struct MixJob {
+        MixChain* chain = nullptr;
+        float* buffer = nullptr;
+        int numSamples = 0;
+        int numChannels = 0;
+        int freq = 0;
+        bool kitOnBus = false;
+        DSP::BlockInfo input;       // device buffer before the rack
+        DSP::BlockInfo drumOut;     // drum bus
+    };
+    // one instance of the graph: the live one belongs to the audio callback,
+    // benchmarkMix() runs on a private copy
+    struct MixChain {
+        DSP::EffectsManager* rack = nullptr;
+        DSP::EffectsManager* drums = nullptr;
+        DSP::DrumKit* kit = nullptr;
+        DSP::WorkerPool* pool = nullptr;
+        DSP::SampleTap* tap = nullptr;
+        std::vector<float> drumBus;
+        MixJob job;
+    };
+    MixChain mLiveChain;
+
+    std::atomic<float> mStatCallbackUs { 0.f };
+    std::atomic<float> mStatMaxCallbackUs { 0.f };
+    std::atomic<float> mStatMinHeadroom { 1.f };    // 1 = the whole period is left
 
     bool mInitialized = false;
 
+    static void runMainBus(void* user);
+    static void runDrumBus(void* user);
+    static void mixChain(MixChain& chain, float* buffer, int numSamples, int numChannels, int freq, bool parallel);
+
 public:
     SoundMixModule() = default;
     ~SoundMixModule() {
@@ -48,6 +86,23 @@ public:
         return mEffectsManager.get();
     }
 
+    //--------------------------------------------------------------------------
+    // audio thread: the whole post mix chain
+    void processMix(float* buffer, int numSamples, int numChannels, int freq, bool parallel = true);
+    // gui thread: feed the analyzers from the tap
+    void pumpAnalyzers();
+    // logs serial vs. parallel time per block, e.g. 64 frames at 48 kHz
+    void benchmarkMix(int frames = 64, int iterations = 20000);
+
+    float getCallbackUs() const { return mStatCallbackUs.load(std::memory_order_relaxed); }
+    float getMaxCallbackUs() const { return mStatMaxCallbackUs.load(std::memory_order_relaxed); }
+    float getMinHeadroom() const { return mStatMinHeadroom.load(std::memory_order_relaxed); }
+    void resetMixStats() {
+        mStatMaxCallbackUs.store(0.f, std::memory_order_relaxed);
+        mStatMinHeadroom.store(1.f, std::memory_order_relaxed);
+    }
+    const DSP::WorkerPool& getWorkerPool() const { return mWorkerPool; }
+
     //--------------------------------------------------------------------------
     void DrawRack(bool* p_enabled);
     void DrawDrums(bool* p_enabled);
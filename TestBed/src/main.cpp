@@ -18,8 +18,11 @@
 #include <lights/fluxLight.h>
 #include <lights/fluxLightManager.h>
 #include <OPL3Controller.h>
+#include <opl3_bank_library.h>
 #include <SFXGenerator.h>
 #include <utils/FileSearcher.h>
+#include <utils/fluxProfiler.h>
+#include <gui/fluxGuiGlue.h>
 
 #include <SDL3/SDL_main.h> //<<< Android! and Windows
 
@@ -60,6 +63,10 @@ private:
 
     FluxScheduler::TaskID mScheduleTestId = 0;
 
+    // F7: frame profiler overlay
+    std::unique_ptr<FluxGuiGlue> mGuiGlue;
+    bool mShowProfiler = false;
+
 
 public:
     bool Initialize() override
@@ -296,7 +303,12 @@ public:
              SAFE_DELETE(mSFXGenerator);
          }
 
-
+         mGuiGlue = std::make_unique<FluxGuiGlue>(false, false, nullptr);
+         if (!mGuiGlue->Initialize())
+         {
+             Log("Failed to init FluxGuiGlue, no profiler overlay");
+             mGuiGlue.reset();
+         }
 
          return true;
     }
@@ -318,6 +330,69 @@ public:
 
     }
     //--------------------------------------------------------------------------------------
+    // F2: add lCount timers, cancel every third and run them all down
+    // on a local scheduler, the global one keeps the app timers
+    void benchmarkScheduler(U32 lCount)
+    {
+        FluxScheduler lScheduler;
+        U32 lFired = 0;
+        std::vector<FluxScheduler::TaskID> lIds;
+        lIds.reserve(lCount);
+
+        Uint64 lStart = SDL_GetPerformanceCounter();
+        for (U32 i = 0; i < lCount; i++)
+            lIds.push_back(lScheduler.add((i % 600) / 60.0, nullptr, [&lFired]() { lFired++; }));
+        Uint64 lAdded = SDL_GetPerformanceCounter();
+
+        for (U32 i = 0; i < lCount; i += 3)
+            lScheduler.cancel(lIds[i]);
+        Uint64 lCancelled = SDL_GetPerformanceCounter();
+
+        for (U32 lFrame = 0; lFrame <= 600; lFrame++)
+            lScheduler.update(1.0 / 60.0);
+        Uint64 lDone = SDL_GetPerformanceCounter();
+
+        const double lMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+        Log("Scheduler benchmark %u timers: add %.2fms, cancel %.2fms, 600 updates %.2fms, fired %u",
+            lCount,
+            (lAdded - lStart) * lMs,
+            (lCancelled - lAdded) * lMs,
+            (lDone - lCancelled) * lMs,
+            lFired);
+    }
+    //--------------------------------------------------------------------------------------
+    // F3: latency of a Log call, the writer thread does the I/O. lCount is
+    // well above the 128 record ring: the normal pass shows the wait for
+    // the writer, the realtime pass (audio callback behaviour) the drops.
+    void benchmarkLog(U32 lCount)
+    {
+        SetLogRateLimit(0);
+        FlushErrorLog();
+        for (bool lRealtime : { false, true }) {
+            SetLogThreadRealtime(lRealtime);
+            U32 lDroppedBefore = GetLogDroppedCount();
+            Uint64 lMax = 0;
+            Uint64 lStart = SDL_GetPerformanceCounter();
+            for (U32 i = 0; i < lCount; i++) {
+                Uint64 lCallStart = SDL_GetPerformanceCounter();
+                Log("Log benchmark %u %.3f", i, i * 0.5f);
+                lMax = std::max(lMax, SDL_GetPerformanceCounter() - lCallStart);
+            }
+            Uint64 lDone = SDL_GetPerformanceCounter();
+            SetLogThreadRealtime(false);
+            FlushErrorLog();
+
+            const double lUs = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+            Log("Log benchmark %u calls (%s): avg %.2fus, max %.2fus, dropped %u",
+                lCount,
+                lRealtime ? "realtime" : "blocking",
+                (lDone - lStart) * lUs / lCount,
+                lMax * lUs,
+                GetLogDroppedCount() - lDroppedBefore);
+        }
+        SetLogRateLimit(10);
+    }
+    //--------------------------------------------------------------------------------------
     void Deinitialize() override
     {
         //FIXME does not work anymore ?! ...
@@ -326,6 +401,8 @@ public:
 
         SAFE_DELETE(mMonoFont);
 
+        if (mGuiGlue) mGuiGlue->Deinitialize();
+
         LightManager.clearLights();
         Parent::Deinitialize();
     }
@@ -398,6 +475,9 @@ public:
     //--------------------------------------------------------------------------------------
     void onEvent(SDL_Event event) override
     {
+        if (mGuiGlue && mShowProfiler)
+            mGuiGlue->onEvent(event);
+
         switch (event.type)
         {
             case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
@@ -409,6 +489,32 @@ public:
                     // SDL_GetJoysticks();
                     FluxSchedule.listPending();
                 }
+                if (event.key.key == SDLK_F2) {
+                    benchmarkScheduler(100000);
+                }
+                if (event.key.key == SDLK_F3) {
+                    benchmarkLog(2000);
+                }
+                if (event.key.key == SDLK_F4) {
+                    // headless, does not touch the device mixer
+                    FluxAudio::Mixer::benchmark(512, 10.f);
+                }
+                if (event.key.key == SDLK_F5) {
+                    FluxAudio::Mixer::benchmarkSpatial(2000, 10.f);
+                }
+                if (event.key.key == SDLK_F6) {
+                    // headless, 1, 2, 4 and 8 OPL3 chips
+                    OPL3Controller::benchmarkChips(5.f);
+                }
+                if (event.key.key == SDLK_F7) {
+                    // needs a debug build or -DFLUX_PROFILE=ON for the scopes
+                    mShowProfiler = !mShowProfiler;
+                }
+                if (event.key.key == SDLK_F8) {
+                    // writes 200 banks below the pref path, indexes and searches them
+                    if (!opl3::BankIndexer::benchmark(mSettings.getPrefsPath() + "banklib_bench"))
+                        Log("[error] Bank library benchmark FAILED");
+                }
                 break;
             case SDL_EVENT_MOUSE_WHEEL: {
                 // Zoom speed is usually much higher for the wheel
@@ -445,6 +551,17 @@ public:
         } //switch
     }
     //--------------------------------------------------------------------------------------
+    void onDrawTopMost() override
+    {
+        Parent::onDrawTopMost();
+        if (!mGuiGlue || !mShowProfiler)
+            return;
+
+        mGuiGlue->DrawBegin();
+        FluxProfile.drawOverlay(&mShowProfiler);
+        mGuiGlue->DrawEnd();
+    }
+    //--------------------------------------------------------------------------------------
     void Update(const double& dt) override
     {
         mLabel->setCaption("%d fps, mouse grabbed:%d ,dT:%.2fms fT:%.5f", getFPS(), (S32)SDL_GetWindowMouseGrab(getScreen()->getWindow()), dt * 1000.f, getFrameTime());
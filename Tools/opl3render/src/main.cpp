@@ -0,0 +1,351 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// opl3render: renders OPL3 songs (.fms3, .fms) without GUI and audio device
+//
+// * no SDL subsystem is initialized, the controllers are set up with
+//   initHeadless() and never get an audio stream
+// * songs are distributed over worker threads, a worker builds a fresh
+//   OPL3Controller for every song. Nothing carries over from one song to
+//   the next, so the output does not depend on --jobs.
+// * stdout gets one "<checksum>  <file>" line per song (FNV-1a 64 over the
+//   float samples), the format --check reads back. Everything else goes
+//   to stderr.
+// * --bench renders without writing and reports the realtime factor
+//
+// Usage:
+// =============
+//
+// opl3render song.fms3                        => song.wav next to the song
+// opl3render -o out --raw songs/*.fms3        => out/<name>.f32 (interleaved float)
+// opl3render --bank gm.wopl song.fms
+// opl3render --bench -j 4 songs/*.fms3
+// opl3render --no-write songs/*.fms3 > expected.txt
+// opl3render --check expected.txt             => exit code 1 on a mismatch
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "OPL3Controller.h"
+#include "opl3_bridge_fm.h"
+#include "opl3_bridge_fms3.h"
+#include "opl3_bridge_op2.h"
+#include "opl3_bridge_sbi.h"
+#include "opl3_bridge_wopl.h"
+
+#include <errorlog.h>
+
+namespace {
+
+    struct Options {
+        std::vector<std::string> songs;
+        std::vector<std::string> expected;  // --check, per song
+        std::string outDir;
+        std::string bankFile;
+        bool raw = false;
+        bool write = true;
+        bool bench = false;
+        bool effects = false;
+        bool verbose = false;
+        int jobs = 0;
+    };
+
+    struct Result {
+        bool ok = false;
+        std::string error;
+        std::string checksum;
+        uint64_t frames = 0;
+        double renderSec = 0.0;
+        double setupSec = 0.0;              // controller + song load
+    };
+
+    constexpr int SAMPLE_RATE = 44100;      // OPL3Controller export rate
+
+    //--------------------------------------------------------------------------
+    void usage() {
+        fprintf(stderr,
+            "usage: opl3render [options] <song.fms3|song.fms> ...\n"
+            "       opl3render [options] --check <checksums.txt>\n"
+            "\n"
+            "  -o, --out <dir>     write into dir (default: next to the song)\n"
+            "      --raw           raw interleaved float32 stereo (.f32) instead of WAV\n"
+            "      --no-write      render and print checksums only\n"
+            "  -b, --bank <file>   replace instruments of the song\n"
+            "                      (.wopl .op2 .sbi .fmi or fms3 bank), same index\n"
+            "      --fx            apply the song's DSP chain and normalize\n"
+            "  -j, --jobs <n>      songs rendered in parallel (default: hardware threads)\n"
+            "      --bench         no output files, report the realtime factor\n"
+            "      --check <file>  render the songs listed as \"<checksum>  <file>\"\n"
+            "                      and compare (no output files), exit code 1 on a mismatch\n"
+            "  -v, --verbose       engine log (info level)\n");
+    }
+
+    //--------------------------------------------------------------------------
+    std::string lowerExt(const std::string& path) {
+        std::string ext = std::filesystem::path(path).extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return ext;
+    }
+
+    // FNV-1a 64 over the sample bytes
+    std::string checksum(const std::vector<float>& samples) {
+        uint64_t hash = opl3::FNV1A_OFFSET;
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(samples.data());
+        for (size_t i = 0; i < samples.size() * sizeof(float); i++) {
+            hash ^= bytes[i];
+            hash *= opl3::FNV1A_PRIME;
+        }
+        char text[17];
+        snprintf(text, sizeof(text), "%016llx", (unsigned long long)hash);
+        return text;
+    }
+
+    //--------------------------------------------------------------------------
+    bool loadBank(const std::string& path, std::vector<opl3::Instrument>& bank) {
+        const std::string ext = lowerExt(path);
+        opl3::Instrument inst;
+        if (ext == ".wopl") return opl3_bridge_wopl::importBank(path, bank);
+        if (ext == ".op2")  return opl3_bridge_op2::importBank(path, bank);
+        if (ext == ".sbi" || ext == ".fmi") {
+            const bool ok = (ext == ".sbi")
+                ? opl3_bridge_sbi::loadInstrument(path, inst)
+                : opl3_bridge_fm::loadInstrument(path, inst, std::filesystem::path(path).stem().string());
+            if (ok) bank.assign(1, inst);
+            return ok;
+        }
+        return opl3_bridge_fms3::loadBank(path, bank);
+    }
+
+    //--------------------------------------------------------------------------
+    bool writeRaw(const std::string& path, const std::vector<float>& samples) {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(samples.data()), (std::streamsize)(samples.size() * sizeof(float)));
+        return (bool)ofs;
+    }
+
+    std::string outputPath(const Options& opt, const std::string& song) {
+        std::filesystem::path out = opt.outDir.empty()
+            ? std::filesystem::path(song)
+            : std::filesystem::path(opt.outDir) / std::filesystem::path(song).filename();
+        out.replace_extension(opt.raw ? ".f32" : ".wav");
+        return out.string();
+    }
+
+    //--------------------------------------------------------------------------
+    Result renderSong(const Options& opt, const std::vector<opl3::Instrument>& bank, const std::string& path) {
+        using clock = std::chrono::steady_clock;
+        Result result;
+        const auto t0 = clock::now();
+
+        OPL3Controller controller;
+        controller.initHeadless();
+
+        opl3::SongData song;
+        const std::string ext = lowerExt(path);
+        bool loaded = false;
+        if (ext == ".fms") {
+            loaded = opl3_bridge_fm::loadSongFMS(path, song);
+            if (!loaded) result.error = "can't load fms song";
+        } else {
+            loaded = opl3_bridge_fms3::loadSong(path, song, controller.getDspEffects(), true);
+            if (!loaded) {
+                result.error = opl3_bridge_fms3::errors;
+                while (!result.error.empty() && result.error.back() == '\n') result.error.pop_back();
+            }
+        }
+        if (!loaded) return result;
+
+        // the controller plays from its sound bank: the song's instruments
+        // first, --bank replaces them by index
+        auto& soundBank = controller.getSoundBank();
+        if (!song.instruments.empty()) soundBank = song.instruments;
+        for (size_t i = 0; i < bank.size(); i++) {
+            if (i < soundBank.size()) soundBank[i] = bank[i];
+            else soundBank.push_back(bank[i]);
+        }
+
+        const auto t1 = clock::now();
+        std::vector<float> samples;
+        controller.exportToBuffer(song, samples, nullptr, opt.effects);
+        const auto t2 = clock::now();
+
+        result.setupSec = std::chrono::duration<double>(t1 - t0).count();
+        result.renderSec = std::chrono::duration<double>(t2 - t1).count();
+        result.frames = samples.size() / 2;
+        result.checksum = checksum(samples);
+
+        if (opt.write && !opt.bench) {
+            const std::string out = outputPath(opt, path);
+            const bool written = opt.raw ? writeRaw(out, samples) : controller.saveWavFile(out, samples, SAMPLE_RATE);
+            if (!written) {
+                result.error = "can't write " + out;
+                return result;
+            }
+        }
+        result.ok = true;
+        return result;
+    }
+
+    //--------------------------------------------------------------------------
+    bool readCheckFile(const std::string& fileName, Options& opt) {
+        std::ifstream ifs(fileName);
+        if (!ifs) return false;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            const size_t split = line.find("  ");
+            if (line.empty() || line[0] == '#' || split == std::string::npos) continue;
+            opt.expected.push_back(line.substr(0, split));
+            opt.songs.push_back(line.substr(split + 2));
+        }
+        return true;
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            auto value = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+            const char* v = nullptr;
+
+            if (arg == "-h" || arg == "--help") return false;
+            else if (arg == "--raw") opt.raw = true;
+            else if (arg == "--no-write") opt.write = false;
+            else if (arg == "--fx") opt.effects = true;
+            else if (arg == "--bench") opt.bench = true;
+            else if (arg == "-v" || arg == "--verbose") opt.verbose = true;
+            else if (arg == "-o" || arg == "--out") {
+                if (!(v = value())) return false;
+                opt.outDir = v;
+            } else if (arg == "-b" || arg == "--bank") {
+                if (!(v = value())) return false;
+                opt.bankFile = v;
+            } else if (arg == "-j" || arg == "--jobs") {
+                if (!(v = value())) return false;
+                opt.jobs = std::atoi(v);
+            } else if (arg == "--check") {
+                if (!(v = value())) return false;
+                if (!readCheckFile(v, opt)) {
+                    fprintf(stderr, "opl3render: can't read %s\n", v);
+                    return false;
+                }
+                opt.write = false;
+            } else if (!arg.empty() && arg[0] == '-') {
+                fprintf(stderr, "opl3render: unknown option %s\n", arg.c_str());
+                return false;
+            } else {
+                if (!opt.expected.empty()) {
+                    fprintf(stderr, "opl3render: --check takes its songs from the file\n");
+                    return false;
+                }
+                opt.songs.push_back(arg);
+            }
+        }
+        return !opt.songs.empty();
+    }
+
+} // namespace
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    SetLogLevel(opt.verbose ? LogLevel_Info : LogLevel_Warn);
+
+    std::vector<opl3::Instrument> bank;
+    if (!opt.bankFile.empty() && !loadBank(opt.bankFile, bank)) {
+        fprintf(stderr, "opl3render: can't load bank %s\n", opt.bankFile.c_str());
+        return 2;
+    }
+    if (!opt.outDir.empty() && opt.write && !opt.bench) {
+        std::error_code ec;
+        std::filesystem::create_directories(opt.outDir, ec);
+    }
+
+    int jobs = opt.jobs > 0 ? opt.jobs : (int)std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min<int>(jobs, (int)opt.songs.size());
+
+    // workers take the next song, results are printed in song order
+    std::vector<Result> results(opt.songs.size());
+    std::vector<uint8_t> done(opt.songs.size(), 0);
+    std::atomic<size_t> next{0};
+    std::mutex printMutex;
+    size_t printed = 0;
+    int failures = 0;
+
+    auto print = [&](size_t index) {
+        const Result& r = results[index];
+        const std::string& song = opt.songs[index];
+        if (!r.ok) {
+            fprintf(stderr, "opl3render: %s: %s\n", song.c_str(), r.error.c_str());
+            failures++;
+            return;
+        }
+        if (!opt.expected.empty()) {
+            const bool match = (r.checksum == opt.expected[index]);
+            printf("%s: %s\n", song.c_str(), match ? "OK" : "FAILED");
+            if (!match) failures++;
+        } else {
+            printf("%s  %s\n", r.checksum.c_str(), song.c_str());
+        }
+        if (opt.bench || opt.verbose) {
+            const double seconds = (double)r.frames / SAMPLE_RATE;
+            fprintf(stderr, "  %8.2f s audio in %7.3f s (+%.3f s setup) = %7.1fx realtime  %s\n",
+                    seconds, r.renderSec, r.setupSec, r.renderSec > 0.0 ? seconds / r.renderSec : 0.0, song.c_str());
+        }
+        fflush(stdout);
+    };
+
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < opt.songs.size(); i = next.fetch_add(1)) {
+            Result r = renderSong(opt, bank, opt.songs[i]);
+            std::lock_guard<std::mutex> lock(printMutex);
+            results[i] = std::move(r);
+            done[i] = 1;
+            while (printed < done.size() && done[printed]) print(printed++);
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 1; t < jobs; t++) threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads) t.join();
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (opt.bench) {
+        uint64_t frames = 0;
+        double render = 0.0;
+        for (const Result& r : results) {
+            if (!r.ok) continue;
+            frames += r.frames;
+            render += r.renderSec;
+        }
+        const double seconds = (double)frames / SAMPLE_RATE;
+        fprintf(stderr, "bench: %zu song(s), %d job(s): %.2f s audio, %.3f s wall => %.1fx realtime"
+                        " (%.1fx per job)\n",
+                opt.songs.size(), jobs, seconds, wall, wall > 0.0 ? seconds / wall : 0.0,
+                render > 0.0 ? seconds / render : 0.0);
+    }
+
+    FlushErrorLog();
+    return failures ? 1 : 0;
+}
@@ -32,6 +32,7 @@
 #include "DSP_ToneControl.h"
 #include "DSP_AutoWah.h"
 #include "DSP_Tremolo.h"
+#include "DSP_ConvolutionReverb.h"
 
 #include "Drums/DSP_DrumKit.h"
 #include "Drums/DSP_KickDrum.h"
@@ -55,6 +56,28 @@ namespace DSP {
         return ptr;
     }
     //-----------------------------------------------------------------------------
+    // run a chain, effects ringing out silence are skipped (see Effect::processTail)
+    // input describes the incoming block, the metadata of the output is returned
+    inline BlockInfo processChain(std::vector<std::unique_ptr<DSP::Effect>>& chain,
+                                  float* buffer, int numSamples, int numChannels,
+                                  const BlockInfo& input, bool tailBypass = true) {
+        if (!tailBypass) {
+            for (auto& effect : chain) effect->process(buffer, numSamples, numChannels);
+            return BlockInfo::measure(buffer, numSamples);
+        }
+        BlockInfo info = input;
+        for (auto& effect : chain) {
+            info = effect->processTail(buffer, numSamples, numChannels, info);
+        }
+        return info;
+    }
+
+    inline BlockInfo processChain(std::vector<std::unique_ptr<DSP::Effect>>& chain,
+                                  float* buffer, int numSamples, int numChannels, bool tailBypass = true) {
+        return processChain(chain, buffer, numSamples, numChannels,
+                            BlockInfo::measure(buffer, numSamples), tailBypass);
+    }
+    //-----------------------------------------------------------------------------
     // normalize a stream
     inline void normalizeBuffer(float* buffer, size_t count, float targetPeak = 1.0f) {
         float currentPeak = 0.0f;
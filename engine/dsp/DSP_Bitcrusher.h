@@ -78,6 +78,10 @@ namespace DSP {
          float mSampleCount = 1000.0f;
          bool mTriggerHold = false;
 
+         ControlRateParam mBits;   // levels only change with the knob
+         AudioRateParam mWet;
+         float mLevels = 256.f;
+
     public:
         IMPLEMENT_EFF_CLONE(Bitcrusher)
 
@@ -88,6 +92,8 @@ namespace DSP {
             {
                 std::vector<float> mSteps{0.0f, 0.0f}; //default 2 channel
                 mEffectName = "BITCRUSHER";
+                mBits.bind(mSettings.bits);
+                mWet.bind(mSettings.wet, mSampleRate);
 
             }
         //----------------------------------------------------------------------
@@ -104,6 +110,7 @@ namespace DSP {
         virtual void setSampleRate(float sampleRate) override {
             mSampleRate = sampleRate;
             mSettings.sampleRate.setMax(sampleRate);
+            mWet.setSampleRate(sampleRate);
         }
         //----------------------------------------------------------------------
         void reset() override { mSampleCount = 999999.0f; mTriggerHold = false;}
@@ -121,11 +128,11 @@ namespace DSP {
 
         virtual void process(float* buffer, int numSamples, int numChannels) override {
 
-            const float currentWet  = mSettings.wet.get();
+            if (!isEnabled()) return;
 
-            if (!isEnabled() || currentWet  <= 0.001f) return;
+            mWet.beginBlock();
+            if (!mWet.isSmoothing() && mWet.getTarget() <= 0.001f) return;
 
-            const float currentBits = mSettings.bits.get();
             const float currentSR   = mSettings.sampleRate.get();
 
 
@@ -135,10 +142,12 @@ namespace DSP {
             }
 
             float samplesToHold = mSampleRate / std::max(1.0f, currentSR);
-            float levels = std::pow(2.0f, std::clamp(currentBits, 1.0f, 16.0f));
+            if (mBits.update()) mLevels = std::pow(2.0f, std::clamp(mBits.get(), 1.0f, 16.0f));
+            const float levels = mLevels;
 
 
             int channel = 0;
+            float currentWet = mWet.getCurrent();
             for (int i = 0; i < numSamples; i++) {
                 float dry = buffer[i];
 
@@ -166,6 +175,7 @@ namespace DSP {
                 float crushed = (quantized * 2.0f) - 1.0f;
 
                 // 4. Mix
+                if (channel == 0) currentWet = mWet.next();
                 buffer[i] = (dry * (1.0f - currentWet)) + (crushed * currentWet);
 
                 if (++channel >= numChannels) channel = 0;
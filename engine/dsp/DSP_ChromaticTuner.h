@@ -234,6 +234,9 @@ namespace DSP {
             }
         }
         //----------------------------------------------------------------------
+        // stop updating once the display has fallen back (see processTail)
+        virtual float getBypassHoldSeconds() const override { return ANALYZER_HOLD_SECONDS; }
+        //----------------------------------------------------------------------
         #ifdef FLUX_ENGINE
         virtual ImVec4 getDefaultColor() const  override { return  ImVec4(0.5f, 0.7f, 0.7f, 1.0f);}
 
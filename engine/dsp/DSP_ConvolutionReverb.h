@@ -0,0 +1,1088 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Digital Sound Processing : Convolution Reverb
+// Real rooms from an impulse response (WAV), partitioned FFT convolution.
+//-----------------------------------------------------------------------------
+// * using ISettings
+// * head: 128 sample partitions on the audio thread (= the latency of the
+//   wet signal), covers the first 2 * TAIL_BLOCK samples of the IR
+// * tail: TAIL_BLOCK partitions computed by one shared background thread,
+//   every block has a full block period of time to finish
+// * stereo in one complex FFT: left = real part, right = imaginary part
+// * IR spectra are cached per file and sample rate, clones share them
+//
+// Example usage:
+// =============
+//
+// auto* reverb = DSP::addEffectToChain<DSP::ConvolutionReverb>(chain, true);
+// reverb->loadImpulseResponse("assets/ir/church.wav");
+// ...
+// auto result = DSP::ConvolutionReverb::benchmark(3.f, 10.f);
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#ifdef FLUX_ENGINE
+#include <imgui.h>
+#include <imgui_internal.h>
+#include <gui/ImFlux.h>
+#endif
+
+
+#include "DSP_Effect.h"
+#include "DSP_FFT.h"
+#include "DSP_WorkerPool.h" // DSP_WORKER_THREADS
+
+namespace DSP {
+
+    //--------------------------------------------------------------------------
+    // Impulse response in the time domain
+    //--------------------------------------------------------------------------
+    struct ImpulseResponse {
+        int channels = 0;               // 1 or 2
+        float sampleRate = 0.f;
+        std::vector<float> data[2];
+        std::string name;
+
+        size_t length() const { return data[0].size(); }
+        float getSeconds() const { return sampleRate > 0.f ? (float)length() / sampleRate : 0.f; }
+
+        //----------------------------------------------------------------------
+        // RIFF wav, PCM 16/24/32 bit or 32 bit float, more than 2 channels are
+        // cut to the first two
+        bool loadWav(const std::string& fileName, std::string* error = nullptr) {
+            auto fail = [&](const char* msg) {
+                if (error) *error = msg;
+                return false;
+            };
+
+            std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+            if (!file) return fail("can't open file");
+            const std::streamsize size = file.tellg();
+            if (size < 44) return fail("file too small");
+            std::vector<uint8_t> bytes((size_t)size);
+            file.seekg(0);
+            if (!file.read(reinterpret_cast<char*>(bytes.data()), size)) return fail("read error");
+
+            auto u16 = [&](size_t o) { return (uint32_t)bytes[o] | ((uint32_t)bytes[o + 1] << 8); };
+            auto u32 = [&](size_t o) { return u16(o) | (u16(o + 2) << 16); };
+
+            if (std::memcmp(bytes.data(), "RIFF", 4) != 0 || std::memcmp(bytes.data() + 8, "WAVE", 4) != 0)
+                return fail("not a RIFF WAVE file");
+
+            uint32_t format = 0, numChannels = 0, rate = 0, bits = 0;
+            size_t dataOffset = 0, dataSize = 0;
+            size_t pos = 12;
+            while (pos + 8 <= bytes.size()) {
+                const uint32_t chunkSize = u32(pos + 4);
+                const size_t body = pos + 8;
+                if (std::memcmp(bytes.data() + pos, "fmt ", 4) == 0 && body + 16 <= bytes.size()) {
+                    format = u16(body);
+                    numChannels = u16(body + 2);
+                    rate = u32(body + 4);
+                    bits = u16(body + 14);
+                    // WAVE_FORMAT_EXTENSIBLE: sub format in the GUID
+                    if (format == 0xFFFE && chunkSize >= 26 && body + 26 <= bytes.size())
+                        format = u16(body + 24);
+                } else if (std::memcmp(bytes.data() + pos, "data", 4) == 0) {
+                    dataOffset = body;
+                    dataSize = std::min<size_t>(chunkSize, bytes.size() - body);
+                    break;
+                }
+                pos = body + chunkSize + (chunkSize & 1);
+            }
+
+            if (!dataOffset || numChannels == 0 || rate == 0) return fail("missing fmt or data chunk");
+            const bool isFloat = (format == 3 && bits == 32);
+            const bool isPcm = (format == 1 && (bits == 16 || bits == 24 || bits == 32));
+            if (!isFloat && !isPcm) return fail("unsupported sample format");
+
+            const uint32_t bytesPerSample = bits / 8;
+            const size_t frames = dataSize / (bytesPerSample * numChannels);
+            if (frames == 0) return fail("no samples");
+
+            channels = std::min<int>((int)numChannels, 2);
+            sampleRate = (float)rate;
+            for (int c = 0; c < 2; c++) data[c].clear();
+            for (int c = 0; c < channels; c++) data[c].resize(frames);
+
+            const uint8_t* src = bytes.data() + dataOffset;
+            for (size_t f = 0; f < frames; f++) {
+                for (int c = 0; c < channels; c++) {
+                    const uint8_t* s = src + (f * numChannels + c) * bytesPerSample;
+                    float v = 0.f;
+                    if (isFloat) {
+                        std::memcpy(&v, s, 4);
+                    } else if (bits == 16) {
+                        v = (float)(int16_t)(s[0] | (s[1] << 8)) / 32768.f;
+                    } else if (bits == 24) {
+                        int32_t i = (int32_t)((uint32_t)s[0] << 8 | (uint32_t)s[1] << 16 | (uint32_t)s[2] << 24);
+                        v = (float)(i >> 8) / 8388608.f;
+                    } else {
+                        int32_t i;
+                        std::memcpy(&i, s, 4);
+                        v = (float)i / 2147483648.f;
+                    }
+                    data[c][f] = v;
+                }
+            }
+            name = fileName;
+            return true;
+        }
+
+        //----------------------------------------------------------------------
+        // exponentially decaying noise, used when no file is loaded
+        void makeSynthetic(float seconds, float decaySeconds, float rate) {
+            channels = 2;
+            sampleRate = rate;
+            name = "built-in hall";
+            const size_t frames = (size_t)(seconds * rate);
+            uint32_t seed[2] = { 0x1234567u, 0x7654321u };
+            for (int c = 0; c < 2; c++) {
+                data[c].assign(frames, 0.f);
+                float lp = 0.f;
+                for (size_t i = 0; i < frames; i++) {
+                    seed[c] = seed[c] * 1664525u + 1013904223u;
+                    const float noise = (float)(seed[c] >> 8) / 8388608.f - 1.f;
+                    const float t = (float)i / rate;
+                    // highs die faster than lows
+                    const float damp = 0.15f + 0.8f * std::min(1.f, t / decaySeconds);
+                    lp += (noise - lp) * (1.f - damp);
+                    data[c][i] = lp * std::exp(-6.9f * t / decaySeconds);
+                }
+                // pre delay
+                const size_t pre = std::min(frames, (size_t)(0.012f * rate));
+                std::fill(data[c].begin(), data[c].begin() + pre, 0.f);
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // linear interpolation is plenty for a reverb tail
+        void resample(float newRate) {
+            if (newRate <= 0.f || sampleRate <= 0.f || newRate == sampleRate) return;
+            const double ratio = (double)sampleRate / (double)newRate;
+            const size_t oldFrames = length();
+            const size_t frames = (size_t)((double)oldFrames / ratio);
+            for (int c = 0; c < channels; c++) {
+                std::vector<float> out(frames);
+                for (size_t i = 0; i < frames; i++) {
+                    const double p = (double)i * ratio;
+                    const size_t i0 = (size_t)p;
+                    const size_t i1 = std::min(i0 + 1, oldFrames - 1);
+                    const float f = (float)(p - (double)i0);
+                    out[i] = data[c][i0] + f * (data[c][i1] - data[c][i0]);
+                }
+                data[c] = std::move(out);
+            }
+            sampleRate = newRate;
+        }
+
+        // the loudest channel gets unit energy, keeps wet levels comparable
+        void normalize() {
+            double maxEnergy = 0.0;
+            for (int c = 0; c < channels; c++) {
+                double e = 0.0;
+                for (float v : data[c]) e += (double)v * v;
+                maxEnergy = std::max(maxEnergy, e);
+            }
+            if (maxEnergy <= 0.0) return;
+            const float scale = (float)(1.0 / std::sqrt(maxEnergy));
+            for (int c = 0; c < channels; c++)
+                for (float& v : data[c]) v *= scale;
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // IR cut into equal blocks, each stored as spectrum (bins 0..block)
+    //--------------------------------------------------------------------------
+    struct PartitionSet {
+        int blockSize = 0;
+        int bins = 0;
+        int parts = 0;
+        int channels = 0;
+        std::vector<float> re[2];   // [part * bins + bin]
+        std::vector<float> im[2];
+
+        void build(const ImpulseResponse& ir, size_t offset, size_t length, int block) {
+            blockSize = block;
+            bins = block + 1;
+            channels = ir.channels;
+            parts = (int)((length + block - 1) / block);
+            const int n = 2 * block;
+            const float scale = 1.f / (float)n;     // inverse FFT scaling
+
+            FFT fft(n);
+            std::vector<float> wr(n), wi(n);
+            for (int c = 0; c < 2; c++) {
+                re[c].assign((size_t)parts * bins, 0.f);
+                im[c].assign((size_t)parts * bins, 0.f);
+            }
+
+            for (int p = 0; p < parts; p++) {
+                std::fill(wr.begin(), wr.end(), 0.f);
+                std::fill(wi.begin(), wi.end(), 0.f);
+                for (int i = 0; i < block; i++) {
+                    const size_t s = offset + (size_t)p * block + i;
+                    if (s >= offset + length || s >= ir.length()) break;
+                    wr[i] = ir.data[0][s];
+                    wi[i] = ir.channels > 1 ? ir.data[1][s] : 0.f;
+                }
+                fft.forward(wr.data(), wi.data());
+                // split the two real spectra
+                for (int k = 0; k < bins; k++) {
+                    const int nk = (n - k) & (n - 1);
+                    const size_t o = (size_t)p * bins + k;
+                    re[0][o] = 0.5f * (wr[k] + wr[nk]) * scale;
+                    im[0][o] = 0.5f * (wi[k] - wi[nk]) * scale;
+                    re[1][o] = 0.5f * (wi[k] + wi[nk]) * scale;
+                    im[1][o] = 0.5f * (wr[nk] - wr[k]) * scale;
+                }
+            }
+            if (channels == 1) {
+                re[1] = re[0];
+                im[1] = im[0];
+            }
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // IR spectra for one file and sample rate, shared and immutable
+    //--------------------------------------------------------------------------
+    struct IRSpectrum {
+        static constexpr int HEAD_BLOCK = 128;
+        static constexpr int TAIL_BLOCK = 4096;
+
+        std::string name;
+        float sampleRate = 0.f;
+        size_t length = 0;
+        PartitionSet head;
+        PartitionSet tail;  // parts == 0 for short IRs
+
+        bool hasTail() const { return tail.parts > 0; }
+        size_t getBytes() const {
+            return (head.re[0].size() + tail.re[0].size()) * 4 * sizeof(float);
+        }
+
+        // ir has to be at the target sample rate
+        static std::shared_ptr<const IRSpectrum> create(const ImpulseResponse& ir) {
+            auto spec = std::make_shared<IRSpectrum>();
+            spec->name = ir.name;
+            spec->sampleRate = ir.sampleRate;
+            spec->length = ir.length();
+            const size_t headLen = std::min(spec->length, (size_t)(2 * TAIL_BLOCK));
+            spec->head.build(ir, 0, headLen, HEAD_BLOCK);
+            if (spec->length > headLen)
+                spec->tail.build(ir, headLen, spec->length - headLen, TAIL_BLOCK);
+            return spec;
+        }
+
+        //----------------------------------------------------------------------
+        // frequency domain cache, an entry lives as long as an effect uses it
+        static std::shared_ptr<const IRSpectrum> getCached(const std::shared_ptr<const ImpulseResponse>& source, float sampleRate) {
+            static std::mutex cacheMutex;
+            static std::unordered_map<std::string, std::weak_ptr<const IRSpectrum>> cache;
+            if (!source || source->length() == 0) return nullptr;
+
+            const std::string key = source->name + "@" + std::to_string((int)sampleRate);
+            {
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                auto it = cache.find(key);
+                if (it != cache.end()) {
+                    if (auto spec = it->second.lock()) return spec;
+                }
+            }
+
+            ImpulseResponse ir = *source;
+            ir.resample(sampleRate);
+            ir.normalize();
+            auto spec = create(ir);
+
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            for (auto it = cache.begin(); it != cache.end();) {
+                if (it->second.expired()) it = cache.erase(it);
+                else ++it;
+            }
+            cache[key] = spec;
+            return spec;
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // Uniformly partitioned overlap-save convolution (stereo)
+    //--------------------------------------------------------------------------
+    class UniformConvolver {
+    private:
+        const PartitionSet* mIR = nullptr;
+        FFT mFFT;
+        int mBlock = 0;
+        int mSize = 0;
+        int mBins = 0;
+        int mPos = 0;       // newest slot of the frequency domain delay line
+
+        std::vector<float> mInRe, mInIm;            // last two input blocks
+        std::vector<float> mFdlRe[2], mFdlIm[2];    // [slot * bins + bin]
+        std::vector<float> mAccRe[2], mAccIm[2];
+        std::vector<float> mWorkRe, mWorkIm;
+
+    public:
+        void init(const PartitionSet& ir) {
+            mIR = &ir;
+            mBlock = ir.blockSize;
+            mSize = 2 * mBlock;
+            mBins = ir.bins;
+            mFFT.init(mSize);
+            mInRe.assign(mSize, 0.f);
+            mInIm.assign(mSize, 0.f);
+            for (int c = 0; c < 2; c++) {
+                mFdlRe[c].assign((size_t)ir.parts * mBins, 0.f);
+                mFdlIm[c].assign((size_t)ir.parts * mBins, 0.f);
+                mAccRe[c].assign(mBins, 0.f);
+                mAccIm[c].assign(mBins, 0.f);
+            }
+            mWorkRe.assign(mSize, 0.f);
+            mWorkIm.assign(mSize, 0.f);
+            mPos = 0;
+        }
+
+        void reset() {
+            std::fill(mInRe.begin(), mInRe.end(), 0.f);
+            std::fill(mInIm.begin(), mInIm.end(), 0.f);
+            for (int c = 0; c < 2; c++) {
+                std::fill(mFdlRe[c].begin(), mFdlRe[c].end(), 0.f);
+                std::fill(mFdlIm[c].begin(), mFdlIm[c].end(), 0.f);
+            }
+            mPos = 0;
+        }
+
+        int getBlockSize() const { return mBlock; }
+
+        //----------------------------------------------------------------------
+        // one block of mBlock samples per channel, out is overwritten
+        void process(const float* inL, const float* inR, float* outL, float* outR) {
+            const int n = mSize;
+            const int b = mBlock;
+            const int bins = mBins;
+            const int parts = mIR->parts;
+
+            // overlap-save input window
+            std::memmove(mInRe.data(), mInRe.data() + b, b * sizeof(float));
+            std::memmove(mInIm.data(), mInIm.data() + b, b * sizeof(float));
+            std::memcpy(mInRe.data() + b, inL, b * sizeof(float));
+            std::memcpy(mInIm.data() + b, inR, b * sizeof(float));
+
+            std::memcpy(mWorkRe.data(), mInRe.data(), n * sizeof(float));
+            std::memcpy(mWorkIm.data(), mInIm.data(), n * sizeof(float));
+            mFFT.forward(mWorkRe.data(), mWorkIm.data());
+
+            // split into the left and right spectrum, newest slot of the FDL
+            const size_t slot = (size_t)mPos * bins;
+            float* xlr = mFdlRe[0].data() + slot;
+            float* xli = mFdlIm[0].data() + slot;
+            float* xrr = mFdlRe[1].data() + slot;
+            float* xri = mFdlIm[1].data() + slot;
+            for (int k = 0; k < bins; k++) {
+                const int nk = (n - k) & (n - 1);
+                const float zr = mWorkRe[k], zi = mWorkIm[k];
+                const float wr = mWorkRe[nk], wi = mWorkIm[nk];
+                xlr[k] = 0.5f * (zr + wr);
+                xli[k] = 0.5f * (zi - wi);
+                xrr[k] = 0.5f * (zi + wi);
+                xri[k] = 0.5f * (wr - zr);
+            }
+
+            // multiply accumulate over all partitions
+            for (int c = 0; c < 2; c++) {
+                float* ar = mAccRe[c].data();
+                float* ai = mAccIm[c].data();
+                std::fill(ar, ar + bins, 0.f);
+                std::fill(ai, ai + bins, 0.f);
+                for (int p = 0; p < parts; p++) {
+                    int s = mPos - p;
+                    if (s < 0) s += parts;
+                    const float* xr = mFdlRe[c].data() + (size_t)s * bins;
+                    const float* xi = mFdlIm[c].data() + (size_t)s * bins;
+                    const float* hr = mIR->re[c].data() + (size_t)p * bins;
+                    const float* hi = mIR->im[c].data() + (size_t)p * bins;
+                    for (int k = 0; k < bins; k++) {
+                        ar[k] += xr[k] * hr[k] - xi[k] * hi[k];
+                        ai[k] += xr[k] * hi[k] + xi[k] * hr[k];
+                    }
+                }
+            }
+            if (++mPos >= parts) mPos = 0;
+
+            // both real spectra back into one complex spectrum
+            const float* alr = mAccRe[0].data();
+            const float* ali = mAccIm[0].data();
+            const float* arr = mAccRe[1].data();
+            const float* ari = mAccIm[1].data();
+            for (int k = 0; k < bins; k++) {
+                mWorkRe[k] = alr[k] - ari[k];
+                mWorkIm[k] = ali[k] + arr[k];
+            }
+            for (int k = bins; k < n; k++) {
+                const int m = n - k;
+                mWorkRe[k] = alr[m] + ari[m];
+                mWorkIm[k] = arr[m] - ali[m];
+            }
+            mFFT.inverse(mWorkRe.data(), mWorkIm.data());
+
+            std::memcpy(outL, mWorkRe.data() + b, b * sizeof(float));
+            std::memcpy(outR, mWorkIm.data() + b, b * sizeof(float));
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // Background threads for all convolution reverbs: one runs the tails, which
+    // have a deadline, the other rebuilds engines, which may take a while
+    //--------------------------------------------------------------------------
+    class ConvolutionWorker {
+    public:
+        enum Lane { TAILS = 0, REBUILDS = 1, LANE_COUNT };
+
+        struct Client {
+            virtual ~Client() = default;
+            virtual bool hasWork() const = 0;       // tail lane
+            virtual void runBackground() = 0;
+            virtual bool hasRebuild() const = 0;    // rebuild lane
+            virtual void runRebuild() = 0;
+        };
+
+        static constexpr int MAX_CLIENTS = 64;
+
+        static ConvolutionWorker& getInstance() {
+            static ConvolutionWorker instance;
+            return instance;
+        }
+
+        bool add(Client* client) {
+            for (auto& slot : mClients) {
+                Client* expected = nullptr;
+                if (slot.compare_exchange_strong(expected, client)) return true;
+            }
+            return false;
+        }
+
+        // returns when no lane touches the client anymore
+        void remove(Client* client) {
+            for (auto& slot : mClients) {
+                Client* expected = client;
+                slot.compare_exchange_strong(expected, nullptr);
+            }
+            for (auto& lane : mLanes)
+                while (lane.current.load() == client) std::this_thread::yield();
+        }
+
+        void wake(Lane lane = TAILS) {
+        #ifdef DSP_WORKER_THREADS
+            mLanes[lane].wake.fetch_add(1, std::memory_order_release);
+            mLanes[lane].wake.notify_one();
+        #else
+            (void)lane;
+        #endif
+        }
+
+        bool isThreaded() const {
+        #ifdef DSP_WORKER_THREADS
+            return true;
+        #else
+            return false;
+        #endif
+        }
+
+    private:
+        struct LaneState {
+            std::atomic<Client*> current { nullptr };
+            std::atomic<uint32_t> wake { 0 };
+            std::thread thread;
+        };
+
+        std::array<std::atomic<Client*>, MAX_CLIENTS> mClients {};
+        std::array<LaneState, LANE_COUNT> mLanes;
+        std::atomic<bool> mQuit { false };
+
+        ConvolutionWorker() {
+        #ifdef DSP_WORKER_THREADS
+            for (int i = 0; i < LANE_COUNT; i++)
+                mLanes[i].thread = std::thread(&ConvolutionWorker::threadMain, this, (Lane)i);
+        #endif
+        }
+        ~ConvolutionWorker() {
+            mQuit.store(true);
+            for (int i = 0; i < LANE_COUNT; i++) {
+                wake((Lane)i);
+                if (mLanes[i].thread.joinable()) mLanes[i].thread.join();
+            }
+        }
+
+        void threadMain(Lane laneId) {
+            ScopedDenormalGuard denormalGuard;
+            LaneState& lane = mLanes[laneId];
+            uint32_t seen = lane.wake.load(std::memory_order_acquire);
+            while (!mQuit.load(std::memory_order_acquire)) {
+                bool worked = false;
+                for (auto& slot : mClients) {
+                    Client* client = slot.load();
+                    if (!client) continue;
+                    // remove() clears the slot first and then waits for current
+                    lane.current.store(client);
+                    if (slot.load() == client) {
+                        if (laneId == TAILS && client->hasWork()) {
+                            client->runBackground();
+                            worked = true;
+                        } else if (laneId == REBUILDS && client->hasRebuild()) {
+                            client->runRebuild();
+                            worked = true;
+                        }
+                    }
+                    lane.current.store(nullptr);
+                }
+                if (!worked) {
+                    lane.wake.wait(seen, std::memory_order_acquire);
+                    seen = lane.wake.load(std::memory_order_acquire);
+                }
+            }
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // Settings
+    //--------------------------------------------------------------------------
+    struct ConvolutionReverbData {
+        float dry;
+        float wet;
+    };
+
+    struct ConvolutionReverbSettings : public ISettings {
+        AudioParam<float> dry          { "Dry",   1.0f ,  0.0f, 1.0f, "%.2f"};
+        AudioParam<float> wet          { "Wet",   0.30f ,  0.0f, 1.0f, "%.2f"};
+
+        ConvolutionReverbSettings() = default;
+        REGISTER_SETTINGS(ConvolutionReverbSettings, &dry, &wet)
+
+        ConvolutionReverbData getData() const {
+            return { dry.get(), wet.get() };
+        }
+
+        void setData(const ConvolutionReverbData& data) {
+            dry.set(data.dry);
+            wet.set(data.wet);
+        }
+        std::vector<std::shared_ptr<IPreset>> getPresets() const override {
+            return {
+                std::make_shared<Preset<ConvolutionReverbSettings, ConvolutionReverbData>>
+                    ("Custom", ConvolutionReverbData{ 1.0f, 0.30f }),
+                std::make_shared<Preset<ConvolutionReverbSettings, ConvolutionReverbData>>
+                    ("Subtle", ConvolutionReverbData{ 1.0f, 0.15f }),
+                std::make_shared<Preset<ConvolutionReverbSettings, ConvolutionReverbData>>
+                    ("Ambient", ConvolutionReverbData{ 0.8f, 0.55f }),
+                std::make_shared<Preset<ConvolutionReverbSettings, ConvolutionReverbData>>
+                    ("Wet Only", ConvolutionReverbData{ 0.0f, 1.0f }),
+            };
+        }
+    };
+
+    constexpr ConvolutionReverbData DEFAULT_CONVOLUTIONREVERB_DATA = { 1.0f, 0.30f };
+
+    //--------------------------------------------------------------------------
+    // Effect
+    //--------------------------------------------------------------------------
+    class ConvolutionReverb : public DSP::Effect, public ConvolutionWorker::Client {
+    public:
+        static constexpr int HEAD_BLOCK = IRSpectrum::HEAD_BLOCK;
+        static constexpr int TAIL_BLOCK = IRSpectrum::TAIL_BLOCK;
+        static constexpr float BUILTIN_SECONDS = 2.5f;
+
+        struct BenchmarkResult {
+            float irSeconds = 0.f;
+            float audioThreadLoad = 0.f;    // 1.0 = one core
+            float backgroundLoad = 0.f;
+            float maxBlockUs = 0.f;         // worst head block
+            uint32_t tailMisses = 0;
+        };
+
+    private:
+        //----------------------------------------------------------------------
+        // everything that depends on the IR, built off the audio thread and
+        // swapped in as a whole
+        struct Engine {
+            std::shared_ptr<const IRSpectrum> ir;
+            UniformConvolver head;
+            UniformConvolver tail;
+            bool hasTail = false;
+            int ratio = 1;                  // head blocks per tail block
+
+            // head fifo, the wet output lags by HEAD_BLOCK samples
+            std::vector<float> inL, inR, outL, outR;
+            int fill = 0;
+            uint64_t chunks = 0;
+
+            // tail: input / output double buffers
+            std::vector<float> tailIn[2][2];    // [slot][channel]
+            std::vector<float> tailOut[2][2];
+            int tailFill = 0;
+            uint32_t tailBlock = 0;             // next tail block to publish
+
+            explicit Engine(std::shared_ptr<const IRSpectrum> spec) : ir(std::move(spec)) {
+                head.init(ir->head);
+                inL.assign(HEAD_BLOCK, 0.f); inR.assign(HEAD_BLOCK, 0.f);
+                outL.assign(HEAD_BLOCK, 0.f); outR.assign(HEAD_BLOCK, 0.f);
+                hasTail = ir->hasTail();
+                if (hasTail) {
+                    tail.init(ir->tail);
+                    ratio = TAIL_BLOCK / HEAD_BLOCK;
+                    for (int s = 0; s < 2; s++)
+                        for (int c = 0; c < 2; c++) {
+                            tailIn[s][c].assign(TAIL_BLOCK, 0.f);
+                            tailOut[s][c].assign(TAIL_BLOCK, 0.f);
+                        }
+                }
+            }
+
+            void runTail(uint32_t block) {
+                const int s = block & 1;
+                tail.process(tailIn[s][0].data(), tailIn[s][1].data(), tailOut[s][0].data(), tailOut[s][1].data());
+            }
+        };
+
+        ConvolutionReverbSettings mSettings;
+
+        Engine* mEngine = nullptr;                  // audio thread
+        std::atomic<Engine*> mPending { nullptr };  // built, waiting for the audio thread
+        std::atomic<Engine*> mRetired { nullptr };  // swapped out, freed on the rebuild lane
+
+        // background job
+        std::atomic<uint32_t> mRequested { 0 };
+        std::atomic<uint32_t> mDone { 0 };
+        Engine* mJobEngine = nullptr;
+        uint32_t mJobBlock = 0;
+        std::atomic<float> mRebuildRate { 0.f };
+        std::atomic<uint32_t> mTailMisses { 0 };
+        bool mRegistered = false;   // false: the worker is full, the jobs run inline
+
+        // impulse response source, never touched by the audio thread
+        mutable std::mutex mSourceMutex;
+        std::shared_ptr<const ImpulseResponse> mSource;
+        std::string mIRPath;    // empty: built-in
+        bool mIRMissing = false;    // mIRPath did not load, playing the built-in
+        std::atomic<float> mIRSeconds { 0.f };  // of mSource, for the audio thread
+
+        //----------------------------------------------------------------------
+        static std::shared_ptr<const ImpulseResponse> getBuiltIn() {
+            static std::mutex builtInMutex;
+            static std::shared_ptr<const ImpulseResponse> builtIn;
+            std::lock_guard<std::mutex> lock(builtInMutex);
+            if (!builtIn) {
+                auto ir = std::make_shared<ImpulseResponse>();
+                ir->makeSynthetic(BUILTIN_SECONDS, 1.8f, 48000.f);
+                builtIn = ir;
+            }
+            return builtIn;
+        }
+
+        // UI thread or rebuild lane
+        void buildEngine(float sampleRate) {
+            std::shared_ptr<const ImpulseResponse> source;
+            {
+                std::lock_guard<std::mutex> lock(mSourceMutex);
+                source = mSource;
+            }
+            auto spec = IRSpectrum::getCached(source, sampleRate);
+            if (!spec) return;
+            Engine* old = mPending.exchange(new Engine(spec), std::memory_order_acq_rel);
+            delete old;
+            collectRetired();
+        }
+
+        void collectRetired() {
+            delete mRetired.exchange(nullptr, std::memory_order_acq_rel);
+        }
+
+        bool useWorker() const {
+            return mRegistered && ConvolutionWorker::getInstance().isThreaded();
+        }
+
+        void requestRebuild() {
+            if (useWorker()) ConvolutionWorker::getInstance().wake(ConvolutionWorker::REBUILDS);
+            else runRebuild();
+        }
+
+        void waitForBackground() {
+            while (mDone.load(std::memory_order_acquire) != mRequested.load(std::memory_order_relaxed)) {
+                if (!useWorker()) runBackground();
+                else std::this_thread::yield();
+            }
+        }
+
+        // audio thread, at a block boundary
+        void swapEngine() {
+            if (!mPending.load(std::memory_order_acquire)) return;
+            // only this thread fills mRetired: while the last one is not
+            // collected keep the current engine and try again next block
+            if (mEngine && mRetired.load(std::memory_order_acquire)) {
+                requestRebuild();
+                return;
+            }
+            Engine* next = mPending.exchange(nullptr, std::memory_order_acq_rel);
+            if (!next) return;
+            waitForBackground();
+            Engine* old = mEngine;
+            mEngine = next;
+            if (old) {
+                mRetired.store(old, std::memory_order_release);
+                requestRebuild();
+            }
+        }
+
+        void publishTail(Engine& e) {
+            // the previous block has to be finished before its buffers are reused
+            if (mDone.load(std::memory_order_acquire) != mRequested.load(std::memory_order_relaxed)) {
+                mTailMisses.fetch_add(1, std::memory_order_relaxed);
+                waitForBackground();
+            }
+            mJobEngine = &e;
+            mJobBlock = e.tailBlock++;
+            mRequested.fetch_add(1, std::memory_order_release);
+            if (useWorker()) ConvolutionWorker::getInstance().wake();
+            else runBackground();
+        }
+
+        void processChunk(Engine& e) {
+            e.head.process(e.inL.data(), e.inR.data(), e.outL.data(), e.outR.data());
+
+            if (e.hasTail) {
+                // tail output: block j is played in the chunks (j+2)*ratio ...
+                const int64_t block = (int64_t)(e.chunks / e.ratio) - 2;
+                if (block >= 0) {
+                    const int s = (int)(block & 1);
+                    const int offset = (int)(e.chunks % e.ratio) * HEAD_BLOCK;
+                    const float* tl = e.tailOut[s][0].data() + offset;
+                    const float* tr = e.tailOut[s][1].data() + offset;
+                    for (int i = 0; i < HEAD_BLOCK; i++) {
+                        e.outL[i] += tl[i];
+                        e.outR[i] += tr[i];
+                    }
+                }
+
+                // tail input
+                const int s = e.tailBlock & 1;
+                std::memcpy(e.tailIn[s][0].data() + e.tailFill, e.inL.data(), HEAD_BLOCK * sizeof(float));
+                std::memcpy(e.tailIn[s][1].data() + e.tailFill, e.inR.data(), HEAD_BLOCK * sizeof(float));
+                e.tailFill += HEAD_BLOCK;
+                if (e.tailFill >= TAIL_BLOCK) {
+                    e.tailFill = 0;
+                    publishTail(e);
+                }
+            }
+            e.chunks++;
+        }
+
+    public:
+        ConvolutionReverb(bool switchOn = false) :
+            Effect(DSP::EffectType::ConvolutionReverb, switchOn)
+            , mSettings()
+        {
+            mEffectName = "CONVOLUTION REVERB";
+            mSource = getBuiltIn();
+            mIRSeconds.store(mSource->getSeconds(), std::memory_order_relaxed);
+            buildEngine(mSampleRate);
+            mRegistered = ConvolutionWorker::getInstance().add(this);
+            #ifdef FLUX_ENGINE
+            if (!mRegistered && ConvolutionWorker::getInstance().isThreaded())
+                Log("[warn] ConvolutionReverb: more than %d instances, the tail runs on the audio thread", ConvolutionWorker::MAX_CLIENTS);
+            #endif
+        }
+
+        ~ConvolutionReverb() override {
+            if (mRegistered) ConvolutionWorker::getInstance().remove(this);
+            delete mEngine;
+            delete mPending.exchange(nullptr);
+            delete mRetired.exchange(nullptr);
+        }
+
+        std::unique_ptr<Effect> clone() const override {
+            auto newCopy = std::make_unique<ConvolutionReverb>();
+            newCopy->mSettings = this->mSettings;
+            newCopy->mEnabled = this->mEnabled;
+            {
+                std::lock_guard<std::mutex> lock(mSourceMutex);
+                newCopy->setSource(mSource, mIRPath, mIRMissing);
+            }
+            return newCopy;
+        }
+        //----------------------------------------------------------------------
+        virtual std::string getDesc() const override {
+            return "Convolution with an impulse response (WAV).\n";
+        }
+        //----------------------------------------------------------------------
+        ConvolutionReverbSettings& getSettings() { return mSettings; }
+        //----------------------------------------------------------------------
+        void setSettings(const ConvolutionReverbSettings& s) {
+            mSettings = s;
+        }
+        //----------------------------------------------------------------------
+        // the spectra are rebuilt in the background
+        virtual void setSampleRate(float sampleRate) override {
+            if (sampleRate <= 0.f) return;
+            mSampleRate = sampleRate;
+            mRebuildRate.store(sampleRate, std::memory_order_release);
+            requestRebuild();
+        }
+        //----------------------------------------------------------------------
+        // UI thread. Empty path = built-in IR
+        bool loadImpulseResponse(const std::string& path) {
+            if (path.empty()) {
+                setSource(getBuiltIn(), "");
+                return true;
+            }
+            auto ir = std::make_shared<ImpulseResponse>();
+            std::string error;
+            if (!ir->loadWav(path, &error)) {
+                #ifdef FLUX_ENGINE
+                Log("[error] ConvolutionReverb: %s: %s", path.c_str(), error.c_str());
+                #endif
+                return false;
+            }
+            setSource(ir, path);
+            return true;
+        }
+
+        // missing: path did not load and source is the built-in stand-in
+        void setSource(std::shared_ptr<const ImpulseResponse> source, const std::string& path, bool missing = false) {
+            {
+                std::lock_guard<std::mutex> lock(mSourceMutex);
+                mSource = std::move(source);
+                mIRPath = path;
+                mIRMissing = missing;
+                mIRSeconds.store(mSource ? mSource->getSeconds() : 0.f, std::memory_order_relaxed);
+            }
+            buildEngine(mSampleRate);
+        }
+
+        std::string getImpulsePath() const {
+            std::lock_guard<std::mutex> lock(mSourceMutex);
+            return mIRPath;
+        }
+        bool isImpulseMissing() const {
+            std::lock_guard<std::mutex> lock(mSourceMutex);
+            return mIRMissing;
+        }
+        std::string getImpulseName() const {
+            std::lock_guard<std::mutex> lock(mSourceMutex);
+            return mSource ? mSource->name : "";
+        }
+        float getImpulseSeconds() const { return mIRSeconds.load(std::memory_order_relaxed); }
+        uint32_t getTailMisses() const { return mTailMisses.load(std::memory_order_relaxed); }
+        int getLatencySamples() const { return HEAD_BLOCK; }
+        //----------------------------------------------------------------------
+        // tail lane (ConvolutionWorker)
+        bool hasWork() const override {
+            return mDone.load(std::memory_order_acquire) != mRequested.load(std::memory_order_acquire);
+        }
+
+        void runBackground() override {
+            const uint32_t requested = mRequested.load(std::memory_order_acquire);
+            if (requested != mDone.load(std::memory_order_relaxed)) {
+                mJobEngine->runTail(mJobBlock);
+                mDone.store(requested, std::memory_order_release);
+            }
+        }
+        //----------------------------------------------------------------------
+        // rebuild lane (ConvolutionWorker)
+        bool hasRebuild() const override {
+            return mRebuildRate.load(std::memory_order_acquire) > 0.f
+                || mRetired.load(std::memory_order_acquire) != nullptr;
+        }
+
+        void runRebuild() override {
+            collectRetired();
+            const float rate = mRebuildRate.exchange(0.f, std::memory_order_acq_rel);
+            if (rate > 0.f) buildEngine(rate);
+        }
+        //----------------------------------------------------------------------
+        void reset() override {
+            // a fresh engine has no history, swapped in by the audio thread
+            mRebuildRate.store(mSampleRate, std::memory_order_release);
+            requestRebuild();
+        }
+        //----------------------------------------------------------------------
+        void save(std::ostream& os) const override {
+            Effect::save(os);              // Save mEnabled
+            mSettings.save(os);       // Save Settings
+            DSP_STREAM_TOOLS::write_string(os, getImpulsePath());
+        }
+        //----------------------------------------------------------------------
+        bool load(std::istream& is) override {
+            if (!Effect::load(is)) return false; // Load mEnabled
+            if (!mSettings.load(is)) return false;      // Load Settings
+            std::string path;
+            DSP_STREAM_TOOLS::read_string(is, path);
+            // a missing file plays the built-in but keeps its path for the next save
+            if ((path != getImpulsePath() || isImpulseMissing()) && !loadImpulseResponse(path))
+                setSource(getBuiltIn(), path, true);
+            return is.good();
+        }
+        //----------------------------------------------------------------------
+        virtual float getTailLengthSeconds() const override {
+            if (!isEnabled()) return 0.0f;
+            return mIRSeconds.load(std::memory_order_relaxed) + (float)HEAD_BLOCK / mSampleRate;
+        }
+        //----------------------------------------------------------------------
+        // process
+        //----------------------------------------------------------------------
+        virtual void process(float* buffer, int numSamples, int numChannels) override {
+            if (!isEnabled() || numChannels < 1) return;
+
+            Engine* e = mEngine;
+            if (!e || e->fill == 0) {
+                swapEngine();
+                e = mEngine;
+            }
+            if (!e) return;
+
+            const float dry = mSettings.dry.get();
+            const float wet = mSettings.wet.get();
+            const int frames = numSamples / numChannels;
+
+            for (int f = 0; f < frames; f++) {
+                float* frame = buffer + f * numChannels;
+                const float inL = frame[0];
+                const float inR = numChannels > 1 ? frame[1] : 0.f;
+
+                const float wetL = e->outL[e->fill];
+                const float wetR = e->outR[e->fill];
+                e->inL[e->fill] = inL;
+                e->inR[e->fill] = inR;
+
+                frame[0] = inL * dry + wetL * wet;
+                if (numChannels > 1) frame[1] = inR * dry + wetR * wet;
+
+                if (++e->fill >= HEAD_BLOCK) {
+                    e->fill = 0;
+                    processChunk(*e);
+                    // a new IR (or sample rate) is only taken at a block boundary
+                    if (mPending.load(std::memory_order_relaxed)) {
+                        swapEngine();
+                        e = mEngine;
+                    }
+                }
+            }
+        }
+        //----------------------------------------------------------------------
+        // Runs a stereo IR of irSeconds over seconds of noise in 128 sample
+        // blocks. The tail is timed separately, in the effect it runs on the
+        // background thread.
+        static BenchmarkResult benchmark(float irSeconds = 3.f, float seconds = 10.f, float sampleRate = 48000.f) {
+            BenchmarkResult result;
+            result.irSeconds = irSeconds;
+
+            auto ir = std::make_shared<ImpulseResponse>();
+            ir->makeSynthetic(irSeconds, irSeconds * 0.7f, sampleRate);
+            ir->name = "benchmark " + std::to_string(irSeconds);
+            auto spec = IRSpectrum::getCached(ir, sampleRate);
+            Engine engine(spec);
+
+            const int blocks = (int)(seconds * sampleRate / HEAD_BLOCK);
+            std::vector<float> inL(HEAD_BLOCK), inR(HEAD_BLOCK), outL(HEAD_BLOCK), outR(HEAD_BLOCK);
+            std::vector<float> tailL(TAIL_BLOCK), tailR(TAIL_BLOCK);
+            uint32_t seed = 1;
+
+            double headUs = 0.0, tailUs = 0.0;
+            for (int b = 0; b < blocks; b++) {
+                for (int i = 0; i < HEAD_BLOCK; i++) {
+                    seed = seed * 1664525u + 1013904223u;
+                    inL[i] = (float)(seed >> 8) / 8388608.f - 1.f;
+                    inR[i] = -inL[i];
+                }
+                auto t0 = std::chrono::steady_clock::now();
+                engine.head.process(inL.data(), inR.data(), outL.data(), outR.data());
+                auto t1 = std::chrono::steady_clock::now();
+                const float us = std::chrono::duration<float, std::micro>(t1 - t0).count();
+                headUs += us;
+                result.maxBlockUs = std::max(result.maxBlockUs, us);
+
+                if (engine.hasTail && (b + 1) % engine.ratio == 0) {
+                    auto t2 = std::chrono::steady_clock::now();
+                    engine.tail.process(tailL.data(), tailR.data(), tailL.data(), tailR.data());
+                    tailUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t2).count();
+                }
+            }
+            const double realUs = (double)blocks * HEAD_BLOCK * 1000000.0 / sampleRate;
+            result.audioThreadLoad = (float)(headUs / realUs);
+            result.backgroundLoad = (float)(tailUs / realUs);
+            return result;
+        }
+        //----------------------------------------------------------------------
+        // More reverbs than the worker has slots: the ones left out run their
+        // jobs inline. False if one of them hangs up or has no tail output.
+        static bool testManyInstances(int count = ConvolutionWorker::MAX_CLIENTS + 8, float sampleRate = 48000.f) {
+            std::vector<std::unique_ptr<ConvolutionReverb>> reverbs;
+            for (int i = 0; i < count; i++) {
+                auto fx = std::make_unique<ConvolutionReverb>(true);
+                fx->setSampleRate(sampleRate);
+                reverbs.push_back(std::move(fx));
+            }
+
+            // an impulse, the head covers the first 2 tail blocks of the IR
+            const int ratio = TAIL_BLOCK / HEAD_BLOCK;
+            const int firstTailBlock = 2 * ratio + 2;
+            std::vector<float> buffer(HEAD_BLOCK * 2);
+            for (auto& fx : reverbs) {
+                double tailEnergy = 0.0;
+                for (int b = 0; b < 4 * ratio; b++) {
+                    std::fill(buffer.begin(), buffer.end(), 0.f);
+                    if (b == 0) buffer[0] = buffer[1] = 1.f;
+                    fx->process(buffer.data(), (int)buffer.size(), 2);
+                    if (b < firstTailBlock) continue;
+                    for (float v : buffer) tailEnergy += (double)v * v;
+                }
+                if (!(tailEnergy > 0.0)) return false;
+            }
+            return true;
+        }
+        //----------------------------------------------------------------------
+
+
+#ifdef FLUX_ENGINE
+        virtual ImVec4 getDefaultColor() const  override { return ImVec4(0.3f, 0.8f, 0.7f, 1.0f);}
+
+        virtual void renderPaddle() override {
+            DSP::ConvolutionReverbSettings currentSettings = this->getSettings();
+            currentSettings.wet.setKnobSettings(ImFlux::ksBlue); // NOTE only works here !
+            if (currentSettings.DrawPaddle(this)) {
+                this->setSettings(currentSettings);
+            }
+        }
+
+        virtual void renderUIWide() override {
+            DSP::ConvolutionReverbSettings currentSettings = this->getSettings();
+            if (currentSettings.DrawUIWide(this)) {
+                this->setSettings(currentSettings);
+            }
+        }
+        virtual void renderUI() override {
+            DSP::ConvolutionReverbSettings currentSettings = this->getSettings();
+            if (currentSettings.DrawUI(this, 140.f, true)) {
+                this->setSettings(currentSettings);
+            }
+            ImGui::TextDisabled("IR: %s (%.2f s)", getImpulseName().c_str(), getImpulseSeconds());
+            if (isImpulseMissing()) ImGui::TextDisabled("missing: %s", getImpulsePath().c_str());
+        }
+#endif
+    }; //CLASS
+}; //namespace
@@ -0,0 +1,144 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Digital Sound Processing : Denormals
+// Flush-to-zero guard for audio threads and silence detection.
+//-----------------------------------------------------------------------------
+// Feedback paths (reverb, delay, biquads, one-pole filters) decay into
+// subnormal floats once the input is silent. On x86 every operation on them
+// takes a micro code assist, the CPU load goes up when the music stops.
+//
+// * ScopedDenormalGuard sets FTZ/DAZ (x86 MXCSR) or FZ (ARM FPCR/FPSCR) for
+//   the current thread and restores the old mode in the destructor. The mode
+//   is per thread, so every thread entry that runs DSP code needs one.
+// * WebAssembly has no control register, the guard is a no-op there.
+// * BlockInfo (silent flag + peak) travels with a block through an effect
+//   chain, see Effect::processTail() and processChain().
+//
+// Example usage:
+// =============
+//
+// void SDLCALL audioCallback(void* user, ...) {
+//     DSP::ScopedDenormalGuard denormalGuard;
+//     ... process
+// }
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DSP_DENORMAL_SSE
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define DSP_DENORMAL_ARM64
+#elif defined(__arm__) && defined(__ARM_FP) && (defined(__GNUC__) || defined(__clang__))
+#define DSP_DENORMAL_ARM32
+#endif
+
+namespace DSP {
+
+    // -100 dBFS
+    constexpr float SILENCE_THRESHOLD = 1.0e-5f;
+
+    class ScopedDenormalGuard {
+    private:
+    #if defined(DSP_DENORMAL_SSE)
+        static constexpr unsigned int FLUSH_BITS = 0x8040; // FTZ | DAZ
+        unsigned int mOld = 0;
+    #elif defined(DSP_DENORMAL_ARM64)
+        static constexpr uint64_t FLUSH_BITS = 1ull << 24; // FZ
+        uint64_t mOld = 0;
+    #elif defined(DSP_DENORMAL_ARM32)
+        static constexpr uint32_t FLUSH_BITS = 1u << 24;   // FZ
+        uint32_t mOld = 0;
+    #endif
+
+    public:
+        // flush = false turns it off, e.g. for benchmarks
+        explicit ScopedDenormalGuard(bool flush = true) {
+        #if defined(DSP_DENORMAL_SSE)
+            mOld = _mm_getcsr();
+            _mm_setcsr(flush ? (mOld | FLUSH_BITS) : (mOld & ~FLUSH_BITS));
+        #elif defined(DSP_DENORMAL_ARM64)
+            asm volatile("mrs %0, fpcr" : "=r"(mOld));
+            const uint64_t mode = flush ? (mOld | FLUSH_BITS) : (mOld & ~FLUSH_BITS);
+            asm volatile("msr fpcr, %0" : : "r"(mode));
+        #elif defined(DSP_DENORMAL_ARM32)
+            asm volatile("vmrs %0, fpscr" : "=r"(mOld));
+            const uint32_t mode = flush ? (mOld | FLUSH_BITS) : (mOld & ~FLUSH_BITS);
+            asm volatile("vmsr fpscr, %0" : : "r"(mode));
+        #else
+            (void)flush;
+        #endif
+        }
+
+        ~ScopedDenormalGuard() {
+        #if defined(DSP_DENORMAL_SSE)
+            _mm_setcsr(mOld);
+        #elif defined(DSP_DENORMAL_ARM64)
+            asm volatile("msr fpcr, %0" : : "r"(mOld));
+        #elif defined(DSP_DENORMAL_ARM32)
+            asm volatile("vmsr fpscr, %0" : : "r"(mOld));
+        #endif
+        }
+
+        ScopedDenormalGuard(const ScopedDenormalGuard&) = delete;
+        void operator=(const ScopedDenormalGuard&) = delete;
+
+        // is flushing active on this thread?
+        static bool isActive() {
+        #if defined(DSP_DENORMAL_SSE)
+            return (_mm_getcsr() & FLUSH_BITS) == FLUSH_BITS;
+        #elif defined(DSP_DENORMAL_ARM64)
+            uint64_t mode;
+            asm volatile("mrs %0, fpcr" : "=r"(mode));
+            return (mode & FLUSH_BITS) != 0;
+        #elif defined(DSP_DENORMAL_ARM32)
+            uint32_t mode;
+            asm volatile("vmrs %0, fpscr" : "=r"(mode));
+            return (mode & FLUSH_BITS) != 0;
+        #else
+            return false;
+        #endif
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    inline float blockPeak(const float* buffer, int numSamples) {
+        float peak = 0.f;
+        for (int i = 0; i < numSamples; i++) {
+            const float a = std::fabs(buffer[i]);
+            peak = a > peak ? a : peak;
+        }
+        return peak;
+    }
+
+    inline bool isSilentBlock(const float* buffer, int numSamples, float threshold = SILENCE_THRESHOLD) {
+        return blockPeak(buffer, numSamples) < threshold;
+    }
+
+    //--------------------------------------------------------------------------
+    // signal metadata of one block, measured once at the source and passed
+    // along the chain instead of scanning the buffer again in every stage
+    struct BlockInfo {
+        bool silent = false;
+        float peak = 0.f;
+
+        static BlockInfo measure(const float* buffer, int numSamples) {
+            return fromPeak(blockPeak(buffer, numSamples));
+        }
+        static BlockInfo fromPeak(float peak) {
+            return { peak < SILENCE_THRESHOLD, peak };
+        }
+        static BlockInfo silence() { return { true, 0.f }; }
+
+        // two blocks summed into one, the peak is an upper bound
+        BlockInfo mix(const BlockInfo& other) const {
+            return fromPeak(peak + other.peak);
+        }
+    };
+
+} // namespace DSP
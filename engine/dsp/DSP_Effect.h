@@ -23,6 +23,7 @@
 
 #include "DSP_Math.h"
 #include "DSP_tools.h"
+#include "DSP_Denormal.h"
 
 namespace DSP {
 
@@ -105,6 +106,7 @@ namespace DSP {
     X(SnareDrum          , 25, EffectCatId::Drums)      \
     X(HiHat              , 26, EffectCatId::Drums)      \
     X(TomDrum            , 27, EffectCatId::Drums)      \
+    X(ConvolutionReverb  , 28, EffectCatId::Space)      \
 
 
 
@@ -186,6 +188,9 @@ namespace DSP {
 
         virtual AudioParamType getParamType() = 0;
 
+        // bumped on every value change, see ParamWatch
+        virtual uint32_t getVersion() const = 0;
+
         #ifdef FLUX_ENGINE
         virtual bool MiniKnobF() = 0;
         virtual bool MiniKnobInt() = 0;
@@ -223,6 +228,10 @@ namespace DSP {
     //--------------------------------------------------------------------------
     // Parameter Template-Class Thread safe
     //
+    // The GUI thread writes, the audio thread reads. Both sides only touch the
+    // atomics, so values can be read at any time. A changed value bumps the
+    // version, effects use a ParamWatch to recalculate only when needed.
+    //
     // NOTE: typecasting like that: auto p = static_cast<DSP::AudioParam<float>*>(param);
     //
 
@@ -247,9 +256,13 @@ namespace DSP {
         T get() const { return value.load(std::memory_order_relaxed); }
 
         void set(T newValue) {
-            value.store(DSP::clamp(newValue, minVal, maxVal));
+            newValue = DSP::clamp(newValue, minVal, maxVal);
+            if (value.exchange(newValue, std::memory_order_release) != newValue)
+                version.fetch_add(1, std::memory_order_release);
         }
 
+        uint32_t getVersion() const override { return version.load(std::memory_order_acquire); }
+
         void setDefaultValue() override { set(defaultValue);}
         T getDefaultValue() { return defaultValue; }
         std::string getDefaultValueAsString() const override {
@@ -313,6 +326,7 @@ namespace DSP {
     private:
         std::string name;
         std::atomic<T> value;
+        std::atomic<uint32_t> version{0};
         T defaultValue;
         T minVal, maxVal;
         std::string unit;
@@ -396,6 +410,9 @@ namespace DSP {
         float mSampleRate = SAMPLE_RATE;
         const EffectType mType;
 
+        // tail bypass, see processTail()
+        uint32_t mSilentFrames = 0;
+        bool mTailIdle = false;
 
 
     public:
@@ -480,6 +497,52 @@ namespace DSP {
         // this is required for export to wave on delayed effects
         virtual float getTailLengthSeconds() const { return 0.f; }
 
+        // minimum silence before an effect without reported tail is skipped
+        static constexpr float TAIL_BYPASS_MIN_SECONDS = 0.1f;
+        // meters and spectra have fallen back to zero after this
+        static constexpr float ANALYZER_HOLD_SECONDS = 0.5f;
+
+        // silence after which processTail() skips the effect. Analyzers
+        // override it with the time their display needs to fall back.
+        virtual float getBypassHoldSeconds() const {
+            return std::max(getTailLengthSeconds(), TAIL_BYPASS_MIN_SECONDS);
+        }
+
+        // Generators and drums produce sound without input, they always run.
+        virtual bool canBypassOnSilence() const {
+            switch (mType) {
+                #define X_BYPASS(name, id, cat) \
+                case EffectType::name: \
+                    return cat != EffectCatId::Generator && cat != EffectCatId::Drums \
+                        && cat != EffectCatId::Locked;
+                EFFECT_LIST(X_BYPASS)
+                #undef X_BYPASS
+                default: return false;
+            }
+        }
+
+        // process() for effect chains: once the input was silent for the
+        // hold time (see getBypassHoldSeconds) and the output is silent too,
+        // the effect is skipped until the input comes back. Takes the signal
+        // metadata of the input and returns the one of the output.
+        BlockInfo processTail(float* buffer, int numSamples, int numChannels, const BlockInfo& input) {
+            if (!isEnabled() || numChannels < 1) return input;
+            if (!input.silent || !canBypassOnSilence()) {
+                mSilentFrames = 0;
+                mTailIdle = false;
+                process(buffer, numSamples, numChannels);
+                return BlockInfo::measure(buffer, numSamples);
+            }
+            if (mTailIdle) return input;
+
+            process(buffer, numSamples, numChannels);
+            mSilentFrames += (uint32_t)(numSamples / numChannels);
+            const BlockInfo output = BlockInfo::measure(buffer, numSamples);
+            if (output.silent && (float)mSilentFrames >= getBypassHoldSeconds() * mSampleRate) mTailIdle = true;
+            return output;
+        }
+        bool isTailIdle() const { return mTailIdle; }
+
 
         void setCustomName( const std::string lName ) { mCustomName = lName.substr(0,64); }
         std::string getCustomName( ) const { return mCustomName; }
@@ -1022,5 +1085,95 @@ namespace DSP {
         #endif
     }; //ISettings
 
+    //--------------------------------------------------------------------------
+    // Change tracking and smoothing on the audio thread
+    //--------------------------------------------------------------------------
+    // Bind them in the effect constructor to the own mSettings (clone creates
+    // a new effect, so the pointers never cross instances). Only the audio
+    // thread calls update()/changed(), the GUI keeps writing the AudioParams.
+    //
+    // Example usage:
+    //   ControlRateParam mCutoff;  // filter coefficients, once per block
+    //   AudioRateParam   mWet;     // ramped per sample
+    //
+    //   process(...):
+    //     if (mCutoff.update()) calcCoefficients(mCutoff.get());
+    //     mWet.beginBlock();
+    //     for (...) { float wet = mWet.next(); ... }
+    //--------------------------------------------------------------------------
+
+    // dirty flag over a whole settings block, true once after any change
+    class ParamWatch {
+    private:
+        std::vector<const IParameter*> mParams;
+        uint32_t mSeen = 0;
+        std::atomic<bool> mForce{true};
+    public:
+        void bind(const ISettings& settings) {
+            mParams = settings.getAll();
+            mForce.store(true);
+        }
+        // e.g. sample rate change or reset, next changed() is true
+        void invalidate() { mForce.store(true, std::memory_order_release); }
+
+        bool changed() {
+            uint32_t sum = 0;
+            for (const IParameter* p : mParams) sum += p->getVersion();
+            const bool forced = mForce.exchange(false, std::memory_order_acq_rel);
+            if (!forced && sum == mSeen) return false;
+            mSeen = sum;
+            return true;
+        }
+    };
+
+    // value read once per block, update() reports a change
+    class ControlRateParam {
+    private:
+        const AudioParam<float>* mParam = nullptr;
+        uint32_t mSeen = 0;
+        float mValue = 0.f;
+    public:
+        void bind(const AudioParam<float>& param) {
+            mParam = &param;
+            mValue = param.get();
+            mSeen = param.getVersion() - 1; // first update() is a change
+        }
+        bool update() {
+            const uint32_t v = mParam->getVersion();
+            if (v == mSeen) return false;
+            mSeen = v;
+            mValue = mParam->get();
+            return true;
+        }
+        float get() const { return mValue; }
+    };
+
+    // value ramped to the knob position, no zipper noise
+    class AudioRateParam {
+    private:
+        const AudioParam<float>* mParam = nullptr;
+        ParamSmoother mSmoother;
+    public:
+        AudioRateParam(float timeMs = 20.f, ParamSmoother::Mode mode = ParamSmoother::Mode::Linear)
+            : mSmoother(timeMs, mode) {}
+
+        void bind(const AudioParam<float>& param, float sampleRate) {
+            mParam = &param;
+            mSmoother.setSampleRate(sampleRate);
+            mSmoother.reset(param.get());
+        }
+        void setSampleRate(float sampleRate) { mSmoother.setSampleRate(sampleRate); }
+        // jump to the current value, e.g. on reset or a preset load
+        void snap() { mSmoother.reset(mParam->get()); }
+
+        void beginBlock() { mSmoother.setTarget(mParam->get()); }
+        inline float next() { return mSmoother.next(); }
+        float advance(int numSamples) { return mSmoother.advance(numSamples); }
+
+        bool isSmoothing() const { return mSmoother.isSmoothing(); }
+        float getCurrent() const { return mSmoother.getCurrent(); }
+        float getTarget() const { return mSmoother.getTarget(); }
+    };
+
 
 }; //namespace
@@ -14,6 +14,8 @@
 #include <mutex>
 #include <memory>
 #include <filesystem>
+#include <chrono>
+#include <sstream>
 
 
 #include <fstream>
@@ -21,6 +23,7 @@
 
 #include "DSP_Effect.h"
 #include "DSP_EffectFactory.h"
+#include "DSP_PresetBank.h"
 
 #ifdef FLUX_ENGINE
 #include <imgui.h>
@@ -52,19 +55,64 @@ class EffectsRack {
 private:
     std::string mName = "";
     std::vector<std::unique_ptr<DSP::Effect>> mEffects;
+
+    // lazy rack from a preset bank, the effects are created on first use
+    std::shared_ptr<const PresetBankFile> mBank;
+    uint32_t mBankIndex = 0;
 public:
     EffectsRack() = default;
 
     //mutable getter
-    std::vector<std::unique_ptr<DSP::Effect>>& getEffects() { return mEffects; }
+    std::vector<std::unique_ptr<DSP::Effect>>& getEffects() {
+        ensureLoaded();
+        return mEffects;
+    }
 
-    const uint16_t getEffectsCount() {return (uint16_t) mEffects.size();}
+    const uint16_t getEffectsCount() {
+        if (mBank) return (uint16_t)mBank->getRackEntry(mBankIndex).effectCount;
+        return (uint16_t) mEffects.size();
+    }
+
+    //--------------------------------------------------------------------------
+    void setFromBank(std::shared_ptr<const PresetBankFile> bank, uint32_t index) {
+        mEffects.clear();
+        mName = std::string(bank->getRackName(index)).substr(0,255);
+        mBank = std::move(bank);
+        mBankIndex = index;
+    }
+    bool isLoaded() const { return !mBank; }
+
+    // creates the effects of a bank rack, throws like load(). The rack stays
+    // on the bank until the load went through.
+    void ensureLoaded() {
+        if (!mBank) return;
+        const PresetBankRackEntry entry = mBank->getRackEntry(mBankIndex);
+        MemoryIStream is(mBank->getRackData(mBankIndex), entry.size);
+        is.exceptions(std::ios::badbit | std::ios::failbit);
+        uint32_t magic = 0, version = 0;
+        DSP_STREAM_TOOLS::read_binary(is, magic);
+        DSP_STREAM_TOOLS::read_binary(is, version);
+        if (magic != DSP_RACK_MAGIC || version > DSP_RACK_VERSION) {
+            throw std::runtime_error(std::format("Invalid rack data in bank (rack {})", mBankIndex));
+        }
+        const std::string name = mName; // may be renamed already
+        try {
+            load(is);
+        } catch (...) {
+            mEffects.clear();
+            mName = name;
+            throw;
+        }
+        mName = name;
+        mBank.reset();
+    }
     const std::string getName() {return mName;}
     void setName(std::string name) {   mName = name.substr(0,255);}  //LIMIT 255 chars
     // void setName(std::string name) {mName = name;}
 
     bool add(std::unique_ptr<DSP::Effect> fx) {
         if (!fx) return false;
+        ensureLoaded();
         if ( getEffectsCount() >= MAX_EFFECTS_IN_RACKS ){
             // addError(std::format("[error] We cant have more then {} Effects in one Rack", MAX_RACKS_IN_PRESET));
             return false;
@@ -77,6 +125,8 @@ public:
     std::unique_ptr<EffectsRack> clone() const {
         auto newRack = std::make_unique<EffectsRack>();
         newRack->mName = this->mName + " *";
+        newRack->mBank = this->mBank;
+        newRack->mBankIndex = this->mBankIndex;
         for (const auto& fx : mEffects) {
             newRack->mEffects.push_back(fx->clone());
         }
@@ -84,6 +134,7 @@ public:
     }
 
     void reorderEffect(int from, int to) {
+        ensureLoaded();
         if (from == to || from < 0 || to < 0 ||
             from >= (int)mEffects.size() || to >= (int)mEffects.size()) {
             return;
@@ -99,6 +150,18 @@ public:
     }
 
     void save(std::ostream& os) const {
+        if (mBank) {
+            // not loaded yet: the bank holds the ROCK stream, skip magic and version
+            const PresetBankRackEntry entry = mBank->getRackEntry(mBankIndex);
+            DSP_STREAM_TOOLS::write_string(os, mName);
+            MemoryIStream is(mBank->getRackData(mBankIndex) + 8, entry.size - 8);
+            std::string bankName;
+            DSP_STREAM_TOOLS::read_string(is, bankName);
+            const std::streamoff skip = is.tellg();
+            os.write(reinterpret_cast<const char*>(mBank->getRackData(mBankIndex)) + 8 + skip,
+                     (std::streamsize)(entry.size - 8 - skip));
+            return;
+        }
         DSP_STREAM_TOOLS::write_string(os, mName);
         uint32_t count = static_cast<uint32_t>(mEffects.size());
 
@@ -155,6 +218,7 @@ private:
     std::recursive_mutex mEffectMutex;
 
     int mFrequence = 0;
+    bool mTailBypass = true;
 
 
 public:
@@ -282,6 +346,7 @@ public:
     //--------------------------------------------------------------------------
     bool setActiveRack(int index) {
         if (index >= 0 && index < (int)mPresets.size()) {
+            if (!prepareRack(index)) return false;
             std::lock_guard<std::recursive_mutex> lock(mEffectMutex);
             mActiveRack = mPresets[index].get();
             return true;
@@ -289,6 +354,27 @@ public:
         return false;
     }
     //--------------------------------------------------------------------------
+    // Creates the effects of a rack loaded from a bank. Not on the audio
+    // thread, setActiveRack and setSwitchRack do it before the rack is used.
+    bool prepareRack(int index) {
+        if (index < 0 || index >= (int)mPresets.size()) return false;
+        EffectsRack* rack = mPresets[index].get();
+        if (rack->isLoaded()) return true;
+        try {
+            rack->ensureLoaded();
+        } catch (const std::exception& e) {
+            addError(std::format("prepareRack: rack {} failed to load: {}", index, e.what()));
+            return false;
+        }
+        // effects are created with SAMPLE_RATE
+        if (mFrequence != SAMPLE_RATE_I) {
+            for (auto& effect : rack->getEffects()) {
+                effect->setSampleRate(static_cast<float>(mFrequence));
+            }
+        }
+        return true;
+    }
+    //--------------------------------------------------------------------------
     bool removeRack(int index) {
         if (index < 0 || index >= (int)mPresets.size()) return false;
         if (mPresets.size() <= 1) {
@@ -480,6 +566,39 @@ public:
 #endif
     }
     //--------------------------------------------------------------------------
+    // Serializes into memory first and swaps a temp file in: lazy racks may
+    // still be mapped from filePath and read while saving.
+    template <typename Writer>
+    void saveFileAtomic(const std::string& filePath, Writer&& writer) const {
+        std::ostringstream oss(std::ios::out | std::ios::binary);
+        writer(oss);
+        const std::string bytes = oss.str();
+
+        const std::string tmpFile = filePath + ".tmp";
+        {
+            std::ofstream ofs(tmpFile, std::ios::binary | std::ios::trunc);
+            ofs.write(bytes.data(), (std::streamsize)bytes.size());
+            ofs.close();
+            if (!ofs) {
+                std::error_code ec;
+                std::filesystem::remove(tmpFile, ec);
+                throw std::runtime_error(std::format("can't write {}", tmpFile));
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpFile, filePath, ec);
+        if (ec) {
+            // windows: the old file may still be open
+            std::filesystem::remove(filePath, ec);
+            std::filesystem::rename(tmpFile, filePath, ec);
+        }
+        if (ec) {
+            std::error_code ignore;
+            std::filesystem::remove(tmpFile, ignore);
+            throw std::runtime_error(ec.message());
+        }
+    }
+    //--------------------------------------------------------------------------
     void SaveRackStream( EffectsRack* rack,   std::ostream& ofs) const {
         ofs.exceptions(std::ios::badbit | std::ios::failbit);
         DSP_STREAM_TOOLS::write_binary(ofs, DSP::DSP_RACK_MAGIC);
@@ -493,9 +612,7 @@ public:
         clearErrors();
         std::lock_guard<std::recursive_mutex> lock(mEffectMutex);
         try {
-            std::ofstream ofs(filePath, std::ios::binary);
-            SaveRackStream(mActiveRack, ofs);
-            ofs.close();
+            saveFileAtomic(filePath, [&](std::ostream& os) { SaveRackStream(mActiveRack, os); });
             return true;
         } catch (const std::exception& e) {
             addError(std::format("Save failed for {}: {}", filePath, e.what()));
@@ -642,9 +759,7 @@ public:
         clearErrors();
         std::lock_guard<std::recursive_mutex> lock(mEffectMutex);
         try {
-            std::ofstream ofs(filePath, std::ios::binary);
-            SavePresetsStream(ofs);
-            ofs.close();
+            saveFileAtomic(filePath, [&](std::ostream& os) { SavePresetsStream(os); });
             return true;
         } catch (const std::exception& e) {
             addError(std::format("SavePresets: Save failed for {}: {}", filePath, e.what()));
@@ -671,8 +786,8 @@ public:
 
         int32_t presetCount = 0;
         DSP_STREAM_TOOLS::read_binary(ifs, presetCount);
-        if ( presetCount < 1 || presetCount > MAX_EFFECTS_IN_RACKS) {
-            addError(std::format("LoadPresetStream: preset count out ouf bounds: {}! max:{}", presetCount, MAX_EFFECTS_IN_RACKS));
+        if ( presetCount < 1 || presetCount > MAX_RACKS_IN_PRESET) {
+            addError(std::format("LoadPresetStream: preset count out ouf bounds: {}! max:{}", presetCount, MAX_RACKS_IN_PRESET));
             return false;
         }
         std::lock_guard<std::recursive_mutex> lock(mEffectMutex);
@@ -720,6 +835,7 @@ public:
             addError(std::format("LoadPresets: File {} not found.", filePath));
             return false;
         }
+        if (PresetBankFile::isBankFile(filePath)) return LoadBank(filePath);
         clearErrors();
         std::ifstream ifs;
         ifs.exceptions(std::ifstream::badbit | std::ifstream::failbit);
@@ -745,6 +861,311 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    // SAVE Presets as bank (BANK), see DSP_PresetBank.h
+    void SaveBankStream(std::ostream& ofs) const {
+        ofs.exceptions(std::ios::badbit | std::ios::failbit);
+        std::vector<std::string> streams(mPresets.size());
+        std::vector<std::string> names(mPresets.size());
+        std::vector<PresetBankRackSource> sources(mPresets.size());
+        for (size_t i = 0; i < mPresets.size(); i++) {
+            EffectsRack* rack = mPresets[i].get();
+            std::ostringstream rackStream(std::ios::out | std::ios::binary);
+            SaveRackStream(rack, rackStream);
+            streams[i] = rackStream.str();
+            names[i] = rack->getName();
+            sources[i].name = names[i];
+            sources[i].data = reinterpret_cast<const uint8_t*>(streams[i].data());
+            sources[i].size = streams[i].size();
+            sources[i].effectCount = rack->getEffectsCount();
+        }
+        writePresetBank(ofs, mName, mSwitchRack, sources);
+    }
+    //--------------------------------------------------------------------------
+    bool SaveBank(std::string filePath) {
+        if (getPresetsCount() < 1) return false;
+
+        clearErrors();
+        std::lock_guard<std::recursive_mutex> lock(mEffectMutex);
+        try {
+            saveFileAtomic(filePath, [&](std::ostream& os) { SaveBankStream(os); });
+            return true;
+        } catch (const std::exception& e) {
+            addError(std::format("SaveBank: Save failed for {}: {}", filePath, e.what()));
+            return false;
+        }
+    }
+    //--------------------------------------------------------------------------
+    // LOAD Presets from a bank. Only the active rack (and the switch rack)
+    // get their effects now, the others when they are selected.
+    bool LoadBank(std::shared_ptr<const PresetBankFile> bank) {
+        if (!bank) return false;
+        if (bank->getRackCount() > MAX_RACKS_IN_PRESET) {
+            addError(std::format("LoadBank: preset count out ouf bounds: {}! max:{}", bank->getRackCount(), MAX_RACKS_IN_PRESET));
+            return false;
+        }
+
+        std::vector<std::unique_ptr<EffectsRack>> racks;
+        racks.reserve(bank->getRackCount());
+        for (uint32_t i = 0; i < bank->getRackCount(); i++) {
+            auto rack = std::make_unique<EffectsRack>();
+            rack->setFromBank(bank, i);
+            racks.push_back(std::move(rack));
+        }
+        try {
+            racks.front()->ensureLoaded();
+            if (mFrequence != SAMPLE_RATE_I) {
+                for (auto& effect : racks.front()->getEffects()) {
+                    effect->setSampleRate(static_cast<float>(mFrequence));
+                }
+            }
+        } catch (const std::exception& e) {
+            addError(std::format("LoadBank: first rack failed to load: {}", e.what()));
+            return false;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(mEffectMutex);
+        mActiveRack = nullptr;
+        mPresets = std::move(racks);
+        mName = std::string(bank->getName()).substr(0,255);
+        mSwitchRack = -1;
+        mActiveRack = mPresets.front().get();
+        setSwitchRack(bank->getSwitchRack());
+        return true;
+    }
+    //--------------------------------------------------------------------------
+    bool LoadBank(std::string filePath) {
+        clearErrors();
+        std::string error;
+        auto bank = PresetBankFile::open(filePath, &error);
+        if (!bank) {
+            addError(std::format("LoadBank: {}: {}", filePath, error));
+            return false;
+        }
+        return LoadBank(bank);
+    }
+    //--------------------------------------------------------------------------
+    // Load time of the AXE! stream format against the bank. Writes two
+    // files into tempDir and removes them again.
+    struct PresetLoadBenchmark {
+        int racks = 0;
+        int effectsPerRack = 0;
+        size_t streamBytes = 0;
+        size_t bankBytes = 0;
+        double streamLoadMs = 0.0;  // LoadPresets, all effects created
+        double bankOpenMs = 0.0;    // LoadBank, first rack created
+        double rackSelectMs = 0.0;  // average first setActiveRack of a bank rack
+        double bankAllMs = 0.0;     // open + every rack selected once
+    };
+
+    static PresetLoadBenchmark benchmarkPresetLoad(int racks = MAX_RACKS_IN_PRESET, int effectsPerRack = 8,
+                                                   std::string tempDir = "") {
+        using clock = std::chrono::steady_clock;
+        auto ms = [](clock::time_point a, clock::time_point b) {
+            return std::chrono::duration<double, std::milli>(b - a).count();
+        };
+        static const EffectType rackTypes[] = {
+            EffectType::NoiseGate, EffectType::OverDrive, EffectType::AnalogGlow, EffectType::Equalizer9Band,
+            EffectType::Chorus, EffectType::Delay, EffectType::Reverb, EffectType::Limiter,
+            EffectType::Metal, EffectType::ToneControl, EffectType::Tremolo, EffectType::Warmth,
+        };
+        constexpr int typeCount = sizeof(rackTypes) / sizeof(rackTypes[0]);
+
+        PresetLoadBenchmark result;
+        racks = std::clamp(racks, 1, (int)MAX_RACKS_IN_PRESET);
+        effectsPerRack = std::clamp(effectsPerRack, 0, (int)MAX_EFFECTS_IN_RACKS);
+        result.racks = racks;
+        result.effectsPerRack = effectsPerRack;
+
+        if (tempDir.empty()) tempDir = std::filesystem::temp_directory_path().string();
+        const std::string streamPath = (std::filesystem::path(tempDir) / "dsp_bench_presets.axe").string();
+        const std::string bankPath = (std::filesystem::path(tempDir) / "dsp_bench_presets.bank").string();
+
+        {
+            EffectsManager source;
+            for (int r = 0; r < racks; r++) {
+                const int idx = (r == 0) ? 0 : source.addRack();
+                source.getRackByIndex(idx)->setName(std::format("Rack {}", r));
+                source.setActiveRack(idx);
+                for (int e = 0; e < effectsPerRack; e++) {
+                    source.addEffect(EffectFactory::Create(rackTypes[(r + e) % typeCount]));
+                }
+            }
+            source.SavePresets(streamPath);
+            source.SaveBank(bankPath);
+        }
+        std::error_code ec;
+        result.streamBytes = (size_t)std::filesystem::file_size(streamPath, ec);
+        result.bankBytes = (size_t)std::filesystem::file_size(bankPath, ec);
+
+        {
+            EffectsManager target;
+            const auto t0 = clock::now();
+            target.LoadPresets(streamPath);
+            result.streamLoadMs = ms(t0, clock::now());
+        }
+        {
+            EffectsManager target;
+            const auto t0 = clock::now();
+            target.LoadBank(bankPath);
+            const auto t1 = clock::now();
+            for (int r = 1; r < racks; r++) target.setActiveRack(r);
+            const auto t2 = clock::now();
+            result.bankOpenMs = ms(t0, t1);
+            result.bankAllMs = ms(t0, t2);
+            if (racks > 1) result.rackSelectMs = ms(t1, t2) / (double)(racks - 1);
+        }
+        std::filesystem::remove(streamPath, ec);
+        std::filesystem::remove(bankPath, ec);
+        return result;
+    }
+
+    //--------------------------------------------------------------------------
+    // CPU time per block while a rack of feedback effects decays after the
+    // input stops: without flush-to-zero, with it, and with tail bypass.
+    struct SilenceBenchmark {
+        struct Mode {
+            double loudUs = 0.0;        // average while noise is playing
+            double silentUs = 0.0;      // average over the last quarter of silence
+            double maxSilentUs = 0.0;
+        };
+        int frames = 0;
+        float silentSeconds = 0.f;
+        Mode plain;                     // no flush-to-zero, no bypass
+        Mode flush;                     // ScopedDenormalGuard
+        Mode bypass;                    // ScopedDenormalGuard + tail bypass
+    };
+
+    static SilenceBenchmark benchmarkSilence(int frames = 512, float loudSeconds = 2.f, float silentSeconds = 60.f) {
+        using clock = std::chrono::steady_clock;
+        SilenceBenchmark result;
+        result.frames = frames = std::max(frames, 16);
+        result.silentSeconds = silentSeconds;
+
+        const int channels = 2;
+        const int loudBlocks = (int)(loudSeconds * SAMPLE_RATE / frames);
+        const int silentBlocks = (int)(silentSeconds * SAMPLE_RATE / frames);
+
+        auto run = [&](bool flush, bool tailBypass) {
+            ScopedDenormalGuard guard(flush);
+            EffectsManager manager(true);
+            manager.setTailBypass(tailBypass);
+            for (EffectType type : { EffectType::Equalizer9Band, EffectType::Warmth, EffectType::Chorus,
+                                     EffectType::Delay, EffectType::Reverb }) {
+                auto fx = EffectFactory::Create(type);
+                fx->setEnabled(true);
+                manager.addEffect(std::move(fx));
+            }
+
+            std::vector<float> buffer((size_t)frames * channels);
+            uint32_t seed = 12345;
+            SilenceBenchmark::Mode mode;
+            double loudUs = 0.0, silentUs = 0.0;
+            const int lateStart = silentBlocks - silentBlocks / 4;
+            for (int b = 0; b < loudBlocks + silentBlocks; b++) {
+                const bool loud = b < loudBlocks;
+                for (float& v : buffer) {
+                    seed = seed * 1664525u + 1013904223u;
+                    v = loud ? ((float)(seed >> 8) / 8388608.f - 1.f) * 0.5f : 0.f;
+                }
+                const auto t0 = clock::now();
+                manager.process(buffer.data(), (int)buffer.size(), channels);
+                const double us = std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+                if (loud) loudUs += us;
+                else if (b - loudBlocks >= lateStart) {
+                    silentUs += us;
+                    mode.maxSilentUs = std::max(mode.maxSilentUs, us);
+                }
+            }
+            mode.loudUs = loudBlocks > 0 ? loudUs / loudBlocks : 0.0;
+            const int lateBlocks = silentBlocks - lateStart;
+            mode.silentUs = lateBlocks > 0 ? silentUs / lateBlocks : 0.0;
+            return mode;
+        };
+
+        result.plain = run(false, false);
+        result.flush = run(true, false);
+        result.bypass = run(true, true);
+        return result;
+    }
+
+    //--------------------------------------------------------------------------
+    // CPU time per block of a typical rack (effects + analyzers) when every
+    // effect always runs vs. with the tail bypass, for an idle stream (no
+    // input at all) and sparse playback (short bursts between long pauses).
+    struct IdleBenchmark {
+        struct Scenario {
+            double alwaysUs = 0.0;      // every effect runs
+            double bypassUs = 0.0;      // silence is skipped
+            double skippedShare = 0.0;  // effect blocks not processed, 0..1
+            double savedPercent() const {
+                return alwaysUs > 0.0 ? 100.0 * (1.0 - bypassUs / alwaysUs) : 0.0;
+            }
+        };
+        int frames = 0;
+        float seconds = 0.f;
+        Scenario idle;
+        Scenario sparse;                // 150 ms burst every 2 s
+    };
+
+    static IdleBenchmark benchmarkIdle(int frames = 512, float seconds = 20.f) {
+        using clock = std::chrono::steady_clock;
+        IdleBenchmark result;
+        result.frames = frames = std::max(frames, 16);
+        result.seconds = seconds;
+
+        const int channels = 2;
+        const int blocks = std::max(1, (int)(seconds * SAMPLE_RATE / frames));
+        const int period = std::max(1, (int)(2.f * SAMPLE_RATE / frames));
+        const int burst = std::max(1, (int)(0.15f * SAMPLE_RATE / frames));
+
+        auto run = [&](bool sparse, bool tailBypass) {
+            ScopedDenormalGuard guard;
+            EffectsManager manager(true);
+            manager.setTailBypass(tailBypass);
+            for (EffectType type : { EffectType::Equalizer9Band, EffectType::Warmth, EffectType::Chorus,
+                                     EffectType::Delay, EffectType::Reverb, EffectType::Limiter,
+                                     EffectType::SpectrumAnalyzer, EffectType::VisualAnalyzer }) {
+                auto fx = EffectFactory::Create(type);
+                fx->setEnabled(true);
+                manager.addEffect(std::move(fx));
+            }
+            auto& effects = manager.getActiveRack()->getEffects();
+
+            std::vector<float> buffer((size_t)frames * channels);
+            uint32_t seed = 12345;
+            double totalUs = 0.0;
+            uint64_t skipped = 0;
+            for (int b = 0; b < blocks; b++) {
+                const bool loud = sparse && (b % period) < burst;
+                if (loud) {
+                    for (float& v : buffer) {
+                        seed = seed * 1664525u + 1013904223u;
+                        v = ((float)(seed >> 8) / 8388608.f - 1.f) * 0.5f;
+                    }
+                } else {
+                    std::fill(buffer.begin(), buffer.end(), 0.f);
+                }
+                const auto t0 = clock::now();
+                manager.process(buffer.data(), (int)buffer.size(), channels);
+                totalUs += std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+                for (auto& effect : effects) if (effect->isTailIdle()) skipped++;
+            }
+            // { us per block, share of skipped effect blocks }
+            return std::pair<double, double>(totalUs / blocks,
+                                             (double)skipped / ((double)blocks * effects.size()));
+        };
+
+        for (bool sparse : { false, true }) {
+            IdleBenchmark::Scenario& scenario = sparse ? result.sparse : result.idle;
+            scenario.alwaysUs = run(sparse, false).first;
+            const auto bypass = run(sparse, true);
+            scenario.bypassUs = bypass.first;
+            scenario.skippedShare = bypass.second;
+        }
+        return result;
+    }
+
     // bool scanAndLoadPresetsFromFolder(const std::string& folderPath, bool createIfMissing = true) {
     //     namespace fs = std::filesystem;
     //     if (!fs::exists(folderPath) || !fs::is_directory(folderPath)) {
@@ -772,16 +1193,24 @@ public:
     // --------- process -------------
     void process(float* buffer, int numSamples, int numChannels) {
         if (!mEnabled || !mActiveRack) return;
+        process(buffer, numSamples, numChannels, BlockInfo::measure(buffer, numSamples));
+    }
+    // with the metadata of the input block, returns the one of the output.
+    // Callers which already know the block is silent save the scan.
+    BlockInfo process(float* buffer, int numSamples, int numChannels, const BlockInfo& input) {
+        if (!mEnabled || !mActiveRack) return input;
         std::lock_guard<std::recursive_mutex> lock(mEffectMutex);
-        for (auto& effect : this->mActiveRack->getEffects()) {
-            effect->process(buffer, numSamples, numChannels);
-        }
-
+        return processChain(this->mActiveRack->getEffects(), buffer, numSamples, numChannels, input, mTailBypass);
     }
     //--------------------------------------------------------------------------
+    // skip effects which only ring out silence, on by default
+    void setTailBypass(bool value) { mTailBypass = value; }
+    bool getTailBypass() const { return mTailBypass; }
+    //--------------------------------------------------------------------------
     // Preset switch
     void setSwitchRack(int idx) {
         if (idx >= (int)mPresets.size()) idx = -1; //reset
+        if (idx >= 0 && !prepareRack(idx)) idx = -1;
         mSwitchRack = idx;
     }
     int getSwitchRack() const { return mSwitchRack; }
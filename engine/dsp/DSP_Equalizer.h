@@ -80,6 +80,7 @@ namespace DSP {
     private:
         EQBandSettings mSettings;
         BiquadCoeffs mCoeffs;
+        ParamWatch mWatch; // coefficients are recalculated on the audio thread
         std::vector<BiquadState> mStates;
 
         // Previous samples for Left and Right (Required for IIR filtering)
@@ -113,6 +114,7 @@ namespace DSP {
             //default stereo
             mStates = { {0.f,0.f,0.f,0.f} , {0.f,0.f,0.f,0.f} };
             calculateCoefficients();
+            mWatch.bind(mSettings);
         }
         //----------------------------------------------------------------------
         // virtual std::string getName() const override { return "Equalizer Band";}
@@ -121,13 +123,16 @@ namespace DSP {
         //----------------------------------------------------------------------
         void setSettings(const EQBandSettings& s) {
             mSettings = s;
-            calculateCoefficients();
+        }
+        //----------------------------------------------------------------------
+        void setSampleRate(float sampleRate) override {
+            mSampleRate = sampleRate;
+            mWatch.invalidate();
         }
         //----------------------------------------------------------------------
         void updateSettings(float freq, float gain) {
             mSettings.frequency.set( freq ) ;
             mSettings.gainDb.set( gain );
-            calculateCoefficients();
         }
         //----------------------------------------------------------------------
         void save(std::ostream& os) const override {
@@ -149,6 +154,8 @@ namespace DSP {
                 mStates.resize(numChannels, BiquadState());
             }
 
+            if (mWatch.changed()) calculateCoefficients();
+
             int channel = 0;
             for (int i = 0; i < numSamples; i++) {
 
@@ -192,36 +192,111 @@ namespace DSP {
             float x1 = 0, x2 = 0, y1 = 0, y2 = 0;
         };
     private:
-        bool mDiry = true;
         Equalizer9BandSettings mSettings;
         static constexpr int NUM_BANDS = 9;
+        // while a gain is ramping the coefficients are recalculated every
+        // SMOOTH_FRAMES frames instead of per sample
+        static constexpr int SMOOTH_FRAMES = 32;
+        static constexpr float SMOOTH_MS = 30.f;
+        static constexpr float BAND_Q = 1.414f; // Steepness tuned for 9-band spacing
 
         // Standard ISO 9-band center frequencies
-        const float mFrequencies[NUM_BANDS] = { 63.0f, 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f, 16000.0f };
+        static constexpr float mFrequencies[NUM_BANDS] = { 63.0f, 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f, 16000.0f };
 
         BiquadCoeffs mCoeffs[NUM_BANDS];
 
+        // audio thread only
+        ParamWatch mWatch;
+        ParamSmoother mGainDb[NUM_BANDS];
+        float mSin[NUM_BANDS] = {};   // sin/cos of omega only depend on the sample rate
+        float mCos[NUM_BANDS] = {};
+        float mTrigRate = 0.f;
+        bool mFirstBlock = true;
+
         std::vector<std::vector<FilterState>> mChannelStates;
 
-        void calculateBand(int band) {
-            // float A = pow(10.0f, mSettings.gains[band] / 40.0f);
-            float A = pow(10.0f, mSettings.getGain(band) / 40.0f);
-            float omega = 2.0f * M_PI * mFrequencies[band] / mSampleRate;
-            float sn = sin(omega);
-            float cs = cos(omega);
-            float Q = 1.414f; // Steepness tuned for 9-band spacing
-            float alpha = sn / (2.0f * Q);
+        // Audio EQ Cookbook peaking filter
+        static BiquadCoeffs calcPeaking(float gainDb, float sn, float cs) {
+            BiquadCoeffs c;
+            float A = std::pow(10.0f, gainDb / 40.0f);
+            float alpha = sn / (2.0f * BAND_Q);
 
             float a0 = 1.0f + alpha / A;
-            mCoeffs[band].b0 = (1.0f + alpha * A) / a0;
-            mCoeffs[band].b1 = (-2.0f * cs) / a0;
-            mCoeffs[band].b2 = (1.0f - alpha * A) / a0;
-            mCoeffs[band].a1 = (-2.0f * cs) / a0;
-            mCoeffs[band].a2 = (1.0f - alpha / A) / a0;
+            c.b0 = (1.0f + alpha * A) / a0;
+            c.b1 = (-2.0f * cs) / a0;
+            c.b2 = (1.0f - alpha * A) / a0;
+            c.a1 = (-2.0f * cs) / a0;
+            c.a2 = (1.0f - alpha / A) / a0;
+            return c;
+        }
+
+        static BiquadCoeffs calcBand(int band, float gainDb, float sampleRate) {
+            float omega = 2.0f * M_PI * mFrequencies[band] / sampleRate;
+            return calcPeaking(gainDb, std::sin(omega), std::cos(omega));
+        }
+
+        void calculateBand(int band, float gainDb) {
+            mCoeffs[band] = calcPeaking(gainDb, mSin[band], mCos[band]);
         }
 
-        void updateAllBands() {
-            for (int i = 0; i < 9; i++) calculateBand(i);
+        // per block, only does work when a setting or the sample rate changed
+        void updateParams() {
+            bool rateChanged = false;
+            if (mTrigRate != mSampleRate) {
+                mTrigRate = mSampleRate;
+                for (int b = 0; b < NUM_BANDS; b++) {
+                    float omega = 2.0f * M_PI * mFrequencies[b] / mTrigRate;
+                    mSin[b] = std::sin(omega);
+                    mCos[b] = std::cos(omega);
+                    mGainDb[b].setTime(SMOOTH_MS, mTrigRate);
+                }
+                rateChanged = true;
+            }
+
+            if (!mWatch.changed() && !rateChanged) return;
+
+            float gains[NUM_BANDS];
+            mSettings.getGains(gains);
+            for (int b = 0; b < NUM_BANDS; b++) {
+                if (mFirstBlock) mGainDb[b].reset(gains[b]);
+                else mGainDb[b].setTarget(gains[b]);
+                if (mFirstBlock || rateChanged) calculateBand(b, mGainDb[b].getCurrent());
+            }
+            mFirstBlock = false;
+        }
+
+        void processFrames(float* buffer, int numFrames, int numChannels) {
+            int channel = 0;
+            const int numSamples = numFrames * numChannels;
+            for (int i = 0; i < numSamples; i++) {
+                float sample = buffer[i];
+
+                // Get the specific state array for this channel
+                std::vector<FilterState>& bands = mChannelStates[channel];
+
+                // Cascade the sample through all 9 filters for the current channel
+                for (int b = 0; b < NUM_BANDS; b++) {
+                    FilterState& s = bands[b];
+                    const BiquadCoeffs& c = mCoeffs[b];
+
+                    // Standard Direct Form I Biquad
+                    float out = c.b0 * sample + c.b1 * s.x1 + c.b2 * s.x2
+                    - c.a1 * s.y1 - c.a2 * s.y2;
+
+                    // Update history for this specific band and channel
+                    s.x2 = s.x1;
+                    s.x1 = sample;
+                    s.y2 = s.y1;
+                    s.y1 = out;
+
+                    sample = out; // Current output becomes input for the next band
+                }
+
+                // Store final processed sample back into the interleaved buffer
+                buffer[i] = sample;
+
+                if (++channel >= numChannels) channel = 0;
+            }
         }
 
     public:
@@ -233,35 +308,33 @@ namespace DSP {
         {
             mEffectName = "9-BAND EQUALIZER";
             mSampleRate = sampleRate;
-            mDiry = true;
+            mWatch.bind(mSettings);
+            for (int b = 0; b < NUM_BANDS; b++) mCoeffs[b] = calcBand(b, 0.f, mSampleRate);
         }
         //----------------------------------------------------------------------
         // virtual std::string getName() const override { return "9-BAND EQUALIZER";}
         //----------------------------------------------------------------------
         Equalizer9BandSettings getSettings() const { return mSettings; }
         //----------------------------------------------------------------------
+        // The filter history is kept, new gains are ramped in by the next
+        // process() call. Safe to call from the GUI thread.
         virtual void reset() override {
-            updateAllBands();
+            mWatch.invalidate();
         }
         //----------------------------------------------------------------------
         void setSettings(const Equalizer9BandSettings& s) {
             mSettings = s;
-            reset();
-
         }
         //----------------------------------------------------------------------
         void setSampleRate(float newRate) override {
             if (newRate <= 0) return;
             mSampleRate = newRate;
-            mDiry = true;
         }
         //----------------------------------------------------------------------
         // Update specific band
         void setGain(int band, float db) {
             if (band < 0 || band >= 9) return;
             mSettings.setGain(band, db);
-            // mSettings.gains[band] = db;
-            mDiry = true;
         }
         //----------------------------------------------------------------------
         float getGain(int band) const {
@@ -277,56 +350,51 @@ namespace DSP {
         bool load(std::istream& is) override {
             if (!Effect::load(is)) return false; // Load mEnabled
             if (!mSettings.load(is) ) return false;
-            mDiry = true;
             return true;
         }
         //----------------------------------------------------------------------
         // process
         //----------------------------------------------------------------------
         virtual void process(float* buffer, int numSamples, int numChannels) override {
-            if (!isEnabled()) return;
+            if (!isEnabled() || numChannels <= 0) return;
 
-            if (mDiry) { mDiry = false; reset();}
-            // 1. Ensure we have state vectors for every channel
+            // Ensure we have state vectors for every channel
             if (mChannelStates.size() != static_cast<size_t>(numChannels)) {
                 // Initialize numChannels vectors, each containing NUM_BANDS states
                 mChannelStates.resize(numChannels, std::vector<FilterState>(NUM_BANDS));
             }
 
-            int channel = 0;
-            for (int i = 0; i < numSamples; i++) {
-                float sample = buffer[i];
+            updateParams();
 
-                // Get the specific state array for this channel
-                std::vector<FilterState>& bands = mChannelStates[channel];
+            const int numFrames = numSamples / numChannels;
+            int frame = 0;
+            while (frame < numFrames) {
+                bool smoothing = false;
+                for (int b = 0; b < NUM_BANDS; b++) smoothing |= mGainDb[b].isSmoothing();
+                if (!smoothing) {
+                    processFrames(buffer + frame * numChannels, numFrames - frame, numChannels);
+                    break;
+                }
 
-                // 2. Cascade the sample through all 9 filters for the current channel
+                const int frames = std::min(SMOOTH_FRAMES, numFrames - frame);
                 for (int b = 0; b < NUM_BANDS; b++) {
-                    FilterState& s = bands[b];
-                    BiquadCoeffs& c = mCoeffs[b];
-
-                    // Standard Direct Form I Biquad
-                    float out = c.b0 * sample + c.b1 * s.x1 + c.b2 * s.x2
-                    - c.a1 * s.y1 - c.a2 * s.y2;
-
-                    // Update history for this specific band and channel
-                    s.x2 = s.x1;
-                    s.x1 = sample;
-                    s.y2 = s.y1;
-                    s.y1 = out;
-
-                    sample = out; // Current output becomes input for the next band
+                    if (mGainDb[b].isSmoothing()) calculateBand(b, mGainDb[b].advance(frames));
                 }
-
-                // 3. Store final processed sample back into the interleaved buffer
-                buffer[i] = sample;
-
-                if (++channel >= numChannels) channel = 0;
+                processFrames(buffer + frame * numChannels, frames, numChannels);
+                frame += frames;
             }
         }
 
         //----------------------------------------------------------------------
+        // Magnitude of the current settings, calculated from the settings and
+        // not the live coefficients so the GUI does not race the audio thread
         float getMagnitudeAtFrequency(float freq, float sampleRate) {
+            BiquadCoeffs coeffs[NUM_BANDS];
+            for (int b = 0; b < NUM_BANDS; b++) coeffs[b] = calcBand(b, mSettings.getGain(b), sampleRate);
+            return getMagnitudeAtFrequency(coeffs, freq, sampleRate);
+        }
+
+        static float getMagnitudeAtFrequency(const BiquadCoeffs* coeffs, float freq, float sampleRate) {
             // Nutze double für die Berechnung der Visualisierung (Präzision!)
             double phi = 2.0 * M_PI * (double)freq / (double)sampleRate;
             double cos1 = std::cos(phi);
@@ -335,7 +403,7 @@ namespace DSP {
             double totalMag = 1.0;
 
             for (int b = 0; b < NUM_BANDS; b++) {
-                const BiquadCoeffs& c = mCoeffs[b];
+                const BiquadCoeffs& c = coeffs[b];
 
                 double num = (double)c.b0*c.b0 + (double)c.b1*c.b1 + (double)c.b2*c.b2
                 + 2.0 * ((double)c.b0*c.b1 + (double)c.b1*c.b2) * cos1
@@ -459,12 +527,16 @@ namespace DSP {
             static std::vector<ImVec2> points;
             points.resize(size.x);
 
+            const float sampleRate = mSampleRate;
+            BiquadCoeffs coeffs[NUM_BANDS];
+            for (int b = 0; b < NUM_BANDS; b++) coeffs[b] = calcBand(b, mSettings.getGain(b), sampleRate);
+
             for (int x = 0; x < (int)size.x; x++) {
                 float normX = (float)x / size.x;
                 float minF = 20.0f;
                 float maxF = 20000.0f;
                 float freq = minF * std::pow(maxF / minF, normX);
-                float mag = getMagnitudeAtFrequency(freq, mSampleRate);
+                float mag = getMagnitudeAtFrequency(coeffs, freq, sampleRate);
 
                 float db = 20.0f * std::log10(mag + 1e-6f);
 
@@ -0,0 +1,113 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Digital Sound Processing : FFT
+// Radix-2 complex FFT on split real / imaginary arrays.
+//-----------------------------------------------------------------------------
+// * tables are built once in init(), forward()/inverse() do not allocate
+// * inverse() is not scaled, divide by the size (or fold 1/N into a kernel)
+// * two real signals can be transformed at once: real part = a, imag = b
+//
+// Example usage:
+// =============
+//
+// DSP::FFT fft(256);
+// std::vector<float> re(256), im(256, 0.f);
+// fft.forward(re.data(), im.data());
+// fft.inverse(re.data(), im.data()); // re = 256 * original
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace DSP {
+
+    class FFT {
+    private:
+        int mSize = 0;
+        std::vector<uint32_t> mBitRev;
+        std::vector<float> mCos;    // cos(2 pi k / N), k < N/2
+        std::vector<float> mSin;
+
+    public:
+        FFT() = default;
+        explicit FFT(int size) { init(size); }
+
+        // size has to be a power of two
+        void init(int size) {
+            if (size < 2 || (size & (size - 1)) != 0 || size == mSize) return;
+            mSize = size;
+
+            int bits = 0;
+            while ((1 << bits) < size) bits++;
+            mBitRev.resize(size);
+            for (int i = 0; i < size; i++) {
+                uint32_t r = 0;
+                for (int b = 0; b < bits; b++)
+                    if (i & (1 << b)) r |= 1u << (bits - 1 - b);
+                mBitRev[i] = r;
+            }
+
+            mCos.resize(size / 2);
+            mSin.resize(size / 2);
+            for (int k = 0; k < size / 2; k++) {
+                const double phi = 2.0 * M_PI * (double)k / (double)size;
+                mCos[k] = (float)std::cos(phi);
+                mSin[k] = (float)std::sin(phi);
+            }
+        }
+
+        int getSize() const { return mSize; }
+
+        //----------------------------------------------------------------------
+        void forward(float* re, float* im) const {
+            const int n = mSize;
+            for (int i = 0; i < n; i++) {
+                const uint32_t j = mBitRev[i];
+                if ((uint32_t)i < j) {
+                    std::swap(re[i], re[j]);
+                    std::swap(im[i], im[j]);
+                }
+            }
+
+            // first stage without twiddles
+            for (int i = 0; i < n; i += 2) {
+                const float ar = re[i], ai = im[i];
+                const float br = re[i + 1], bi = im[i + 1];
+                re[i] = ar + br;      im[i] = ai + bi;
+                re[i + 1] = ar - br;  im[i + 1] = ai - bi;
+            }
+
+            for (int len = 4; len <= n; len <<= 1) {
+                const int half = len >> 1;
+                const int step = n / len;
+                for (int i = 0; i < n; i += len) {
+                    float* r0 = re + i;
+                    float* i0 = im + i;
+                    float* r1 = re + i + half;
+                    float* i1 = im + i + half;
+                    for (int j = 0; j < half; j++) {
+                        const float wr = mCos[j * step];
+                        const float wi = -mSin[j * step];
+                        const float vr = r1[j] * wr - i1[j] * wi;
+                        const float vi = r1[j] * wi + i1[j] * wr;
+                        r1[j] = r0[j] - vr;
+                        i1[j] = i0[j] - vi;
+                        r0[j] += vr;
+                        i0[j] += vi;
+                    }
+                }
+            }
+        }
+
+        // unscaled: inverse(forward(x)) = N * x
+        void inverse(float* re, float* im) const {
+            forward(im, re);
+        }
+    };
+
+} // namespace DSP
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <numbers>
 
 namespace DSP {
@@ -60,6 +61,35 @@ namespace DSP {
             return getTable().data[idxA] * (1.0f - frac) + getTable().data[idxB] * frac;
         }
 
+        //----------------------------------------------------------------------
+        // tanh LUT for saturation in per sample loops, linear interpolation,
+        // error < 1e-5. Outside of +-TANH_RANGE tanh is 1 in float anyway.
+        static constexpr int TANH_LUT_SIZE = 2048;
+        static constexpr float TANH_RANGE = 8.0f;
+
+        struct TanhTable {
+            std::array<float, TANH_LUT_SIZE + 1> data;
+            TanhTable() : data() {
+                for (int i = 0; i <= TANH_LUT_SIZE; ++i) {
+                    data[i] = std::tanh(-TANH_RANGE + 2.0f * TANH_RANGE * (float)i / (float)TANH_LUT_SIZE);
+                }
+            }
+        };
+        static inline const TanhTable& getTanhTable() {
+            static TanhTable instance;
+            return instance;
+        }
+
+        static inline float fastTanh(float x) {
+            if (x <= -TANH_RANGE) return -1.0f;
+            if (x >= TANH_RANGE) return 1.0f;
+            const float pos = (x + TANH_RANGE) * ((float)TANH_LUT_SIZE / (2.0f * TANH_RANGE));
+            const int idx = static_cast<int>(pos);
+            const float frac = pos - (float)idx;
+            const auto& table = getTanhTable().data;
+            return table[idx] + (table[idx + 1] - table[idx]) * frac;
+        }
+
 
         //----------------------------------------------------------------------
     }; //FathMath
@@ -103,5 +133,86 @@ namespace DSP {
         return std::pow(10.0f, db * 0.05f);
     }
 
+    //--------------------------------------------------------------------------
+    // Parameter smoother: moves a value to its target over a fixed time
+    // instead of jumping, removes zipper noise and clicks on knob changes.
+    //  Linear  : reaches the target exactly after the ramp time
+    //  OnePole : exponential approach, ramp time is ~ the 99% point
+    // next() is per sample (audio rate), advance() skips a whole block and
+    // returns the value at its end (control rate, e.g. filter coefficients).
+    //--------------------------------------------------------------------------
+    class ParamSmoother {
+    public:
+        enum class Mode : uint8_t { Linear, OnePole };
+
+        ParamSmoother(float timeMs = 20.f, Mode mode = Mode::Linear) : mMode(mode), mTimeMs(timeMs) {}
+
+        void setTime(float timeMs, float sampleRate) {
+            mTimeMs = timeMs;
+            mSampleRate = sampleRate;
+            mRampSamples = std::max(1, static_cast<int>(timeMs * 0.001f * sampleRate));
+            // 1 - e^(-t/tau) with 4.6 tau = 99%
+            mCoeff = 1.0f - std::exp(-4.6f / static_cast<float>(mRampSamples));
+        }
+        void setSampleRate(float sampleRate) { setTime(mTimeMs, sampleRate); }
+
+        // jump without ramp
+        void reset(float value) {
+            mCurrent = mTarget = value;
+            mStep = 0.f;
+            mRemaining = 0;
+        }
+
+        void setTarget(float target) {
+            if (mRampSamples == 0) setSampleRate(mSampleRate);
+            if (target == mTarget) return;
+            mTarget = target;
+            mRemaining = mRampSamples;
+            mStep = (mTarget - mCurrent) / static_cast<float>(mRampSamples);
+        }
+
+        bool isSmoothing() const { return mRemaining > 0; }
+        float getTarget() const { return mTarget; }
+        float getCurrent() const { return mCurrent; }
+
+        inline float next() {
+            if (mRemaining <= 0) return mCurrent;
+            if (--mRemaining == 0) {
+                mCurrent = mTarget;
+            } else if (mMode == Mode::Linear) {
+                mCurrent += mStep;
+            } else {
+                mCurrent += (mTarget - mCurrent) * mCoeff;
+            }
+            return mCurrent;
+        }
+
+        float advance(int numSamples) {
+            if (mRemaining <= 0) return mCurrent;
+            if (numSamples >= mRemaining) {
+                mRemaining = 0;
+                mCurrent = mTarget;
+            } else if (mMode == Mode::Linear) {
+                mRemaining -= numSamples;
+                mCurrent += mStep * static_cast<float>(numSamples);
+            } else {
+                mRemaining -= numSamples;
+                mCurrent += (mTarget - mCurrent) * (1.0f - std::pow(1.0f - mCoeff, static_cast<float>(numSamples)));
+            }
+            return mCurrent;
+        }
+
+    private:
+        Mode mMode;
+        float mTimeMs;
+        float mSampleRate = 48000.f;
+        int mRampSamples = 0;
+        float mCoeff = 1.f;
+        float mCurrent = 0.f;
+        float mTarget = 0.f;
+        float mStep = 0.f;
+        int mRemaining = 0;
+    };
+
 
 } //namespace
@@ -0,0 +1,363 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Digital Sound Processing : Preset Bank
+// Flat binary preset file with an offset table, loaded by mmap.
+//-----------------------------------------------------------------------------
+// Layout (little endian, all offsets from the start of the file):
+//
+//   PresetBankHeader       fixed size, magic "BANK"
+//   PresetBankRackEntry[]  one per rack: offset / size of the rack data,
+//                          name, effect count
+//   names                  bank name and rack names, not terminated
+//   rack data              each rack is a complete "ROCK" stream, the same
+//                          bytes SaveRack writes, 4 byte aligned
+//
+// Opening a bank only reads the header and the table. The EffectsManager
+// creates the effects of a rack when the rack is selected. Since a rack is
+// stored as ROCK stream it can be copied out of a bank as .rack file and
+// re-saved without touching its effects.
+//
+// Example usage:
+// =============
+//
+// std::string error;
+// auto bank = DSP::PresetBankFile::open("presets.bank", &error);
+// if (bank) {
+//     for (uint32_t i = 0; i < bank->getRackCount(); i++)
+//         printf("%s\n", std::string(bank->getRackName(i)).c_str());
+//     DSP::MemoryIStream is(bank->getRackData(0), bank->getRackEntry(0).size);
+// }
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if !defined(__EMSCRIPTEN__) && !defined(__ANDROID__)
+#define DSP_BANK_MMAP
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+#include "DSP_tools.h"
+
+namespace DSP {
+
+    constexpr uint32_t DSP_BANK_MAGIC   = DSP_STREAM_TOOLS::MakeMagic("BANK");
+    constexpr uint32_t DSP_BANK_VERSION = 1;
+
+    struct PresetBankHeader {
+        uint32_t magic = DSP_BANK_MAGIC;
+        uint32_t version = DSP_BANK_VERSION;
+        uint32_t headerSize = sizeof(PresetBankHeader);
+        uint32_t entrySize = 0;         // sizeof(PresetBankRackEntry)
+        uint32_t rackCount = 0;
+        int32_t  switchRack = -1;
+        uint32_t tableOffset = 0;
+        uint32_t nameOffset = 0;        // bank name
+        uint32_t nameLength = 0;
+        uint32_t fileSize = 0;
+        uint32_t reserved[2] = { 0, 0 };
+    };
+
+    struct PresetBankRackEntry {
+        uint32_t offset = 0;            // ROCK stream
+        uint32_t size = 0;
+        uint32_t nameOffset = 0;
+        uint32_t nameLength = 0;
+        uint32_t effectCount = 0;
+        uint32_t reserved = 0;
+    };
+
+    static_assert(sizeof(PresetBankHeader) == 48, "PresetBankHeader layout changed");
+    static_assert(sizeof(PresetBankRackEntry) == 24, "PresetBankRackEntry layout changed");
+
+    //--------------------------------------------------------------------------
+    // std::istream reading from memory without a copy, supports tellg/seekg
+    //--------------------------------------------------------------------------
+    class MemoryStreamBuf : public std::streambuf {
+    public:
+        MemoryStreamBuf(const uint8_t* data, size_t size) {
+            char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+            setg(begin, begin, begin + size);
+        }
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+            if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+            off_type pos = off;
+            if (dir == std::ios_base::cur) pos += gptr() - eback();
+            else if (dir == std::ios_base::end) pos += egptr() - eback();
+            if (pos < 0 || pos > egptr() - eback()) return pos_type(off_type(-1));
+            setg(eback(), eback() + pos, egptr());
+            return pos_type(pos);
+        }
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
+    class MemoryIStream : public std::istream {
+    private:
+        MemoryStreamBuf mBuf;
+    public:
+        MemoryIStream(const uint8_t* data, size_t size) : std::istream(nullptr), mBuf(data, size) {
+            rdbuf(&mBuf);
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // A bank file, mapped read only. Emscripten and Android read it into memory.
+    //--------------------------------------------------------------------------
+    class PresetBankFile {
+    private:
+        const uint8_t* mData = nullptr;
+        size_t mSize = 0;
+        std::vector<uint8_t> mOwned;
+        PresetBankHeader mHeader;
+    #ifdef DSP_BANK_MMAP
+        bool mMapped = false;
+    #ifdef _WIN32
+        HANDLE mFile = INVALID_HANDLE_VALUE;
+        HANDLE mMapping = nullptr;
+    #endif
+    #endif
+
+        PresetBankFile() = default;
+
+        bool map(const std::string& fileName) {
+        #ifdef DSP_BANK_MMAP
+        #ifdef _WIN32
+            mFile = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (mFile == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0) return false;
+            mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mMapping) return false;
+            mData = static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+            if (!mData) return false;
+            mSize = (size_t)size.QuadPart;
+        #else
+            const int fd = ::open(fileName.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size == 0) {
+                ::close(fd);
+                return false;
+            }
+            void* ptr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (ptr == MAP_FAILED) return false;
+            mData = static_cast<const uint8_t*>(ptr);
+            mSize = (size_t)st.st_size;
+        #endif
+            mMapped = true;
+            return true;
+        #else
+            (void)fileName;
+            return false;
+        #endif
+        }
+
+        bool readAll(const std::string& fileName) {
+            std::ifstream ifs(fileName, std::ios::binary | std::ios::ate);
+            if (!ifs) return false;
+            const std::streamsize size = ifs.tellg();
+            if (size <= 0) return false;
+            mOwned.resize((size_t)size);
+            ifs.seekg(0);
+            if (!ifs.read(reinterpret_cast<char*>(mOwned.data()), size)) return false;
+            mData = mOwned.data();
+            mSize = mOwned.size();
+            return true;
+        }
+
+        bool inside(uint64_t offset, uint64_t size) const {
+            return offset <= mSize && size <= mSize - offset;
+        }
+
+        bool validate(std::string* error) {
+            auto fail = [&](const char* msg) {
+                if (error) *error = msg;
+                return false;
+            };
+            if (mSize < sizeof(PresetBankHeader)) return fail("file too small");
+            std::memcpy(&mHeader, mData, sizeof(PresetBankHeader));
+            if (mHeader.magic != DSP_BANK_MAGIC) return fail("invalid file format (magic mismatch)");
+            if (mHeader.version > DSP_BANK_VERSION) return fail("unsupported bank version");
+            if (mHeader.headerSize < sizeof(PresetBankHeader) || mHeader.entrySize < sizeof(PresetBankRackEntry))
+                return fail("invalid header");
+            if (mHeader.fileSize != mSize) return fail("file size mismatch (truncated?)");
+            if (mHeader.rackCount < 1) return fail("bank has no racks");
+            if (!inside(mHeader.tableOffset, (uint64_t)mHeader.rackCount * mHeader.entrySize))
+                return fail("rack table out of bounds");
+            if (!inside(mHeader.nameOffset, mHeader.nameLength)) return fail("bank name out of bounds");
+            for (uint32_t i = 0; i < mHeader.rackCount; i++) {
+                const PresetBankRackEntry e = getRackEntry(i);
+                if (!inside(e.offset, e.size) || e.size < 8) return fail("rack data out of bounds");
+                if (!inside(e.nameOffset, e.nameLength)) return fail("rack name out of bounds");
+            }
+            return true;
+        }
+
+    public:
+        ~PresetBankFile() {
+        #ifdef DSP_BANK_MMAP
+            if (mMapped) {
+            #ifdef _WIN32
+                UnmapViewOfFile(mData);
+            #else
+                munmap(const_cast<uint8_t*>(mData), mSize);
+            #endif
+            }
+        #ifdef _WIN32
+            if (mMapping) CloseHandle(mMapping);
+            if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+        #endif
+        #endif
+        }
+
+        PresetBankFile(const PresetBankFile&) = delete;
+        void operator=(const PresetBankFile&) = delete;
+
+        //----------------------------------------------------------------------
+        static std::shared_ptr<const PresetBankFile> open(const std::string& fileName, std::string* error = nullptr) {
+            std::shared_ptr<PresetBankFile> bank(new PresetBankFile());
+            if (!bank->map(fileName) && !bank->readAll(fileName)) {
+                if (error) *error = "can't open file";
+                return nullptr;
+            }
+            if (!bank->validate(error)) return nullptr;
+            return bank;
+        }
+
+        static std::shared_ptr<const PresetBankFile> fromMemory(std::vector<uint8_t> bytes, std::string* error = nullptr) {
+            std::shared_ptr<PresetBankFile> bank(new PresetBankFile());
+            bank->mOwned = std::move(bytes);
+            bank->mData = bank->mOwned.data();
+            bank->mSize = bank->mOwned.size();
+            if (!bank->validate(error)) return nullptr;
+            return bank;
+        }
+
+        // peek at the first bytes of a file
+        static bool isBankFile(const std::string& fileName) {
+            std::ifstream ifs(fileName, std::ios::binary);
+            uint32_t magic = 0;
+            ifs.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+            return ifs && magic == DSP_BANK_MAGIC;
+        }
+
+        //----------------------------------------------------------------------
+        bool isMapped() const {
+        #ifdef DSP_BANK_MMAP
+            return mMapped;
+        #else
+            return false;
+        #endif
+        }
+        size_t getSize() const { return mSize; }
+        const PresetBankHeader& getHeader() const { return mHeader; }
+        uint32_t getRackCount() const { return mHeader.rackCount; }
+        int32_t getSwitchRack() const { return mHeader.switchRack; }
+
+        std::string_view getName() const {
+            return std::string_view(reinterpret_cast<const char*>(mData + mHeader.nameOffset), mHeader.nameLength);
+        }
+
+        PresetBankRackEntry getRackEntry(uint32_t index) const {
+            PresetBankRackEntry e;
+            std::memcpy(&e, mData + mHeader.tableOffset + (size_t)index * mHeader.entrySize, sizeof(e));
+            return e;
+        }
+
+        std::string_view getRackName(uint32_t index) const {
+            const PresetBankRackEntry e = getRackEntry(index);
+            return std::string_view(reinterpret_cast<const char*>(mData + e.nameOffset), e.nameLength);
+        }
+
+        const uint8_t* getRackData(uint32_t index) const {
+            return mData + getRackEntry(index).offset;
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // Writes a bank. The data of each rack is a complete ROCK stream.
+    //--------------------------------------------------------------------------
+    struct PresetBankRackSource {
+        std::string_view name;
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        uint32_t effectCount = 0;
+    };
+
+    inline void writePresetBank(std::ostream& os, const std::string& bankName, int32_t switchRack,
+                                const std::vector<PresetBankRackSource>& racks) {
+        auto align4 = [](uint64_t v) { return (v + 3) & ~uint64_t(3); };
+
+        PresetBankHeader header;
+        header.entrySize = sizeof(PresetBankRackEntry);
+        header.rackCount = (uint32_t)racks.size();
+        header.switchRack = switchRack;
+        header.tableOffset = sizeof(PresetBankHeader);
+
+        uint64_t pos = header.tableOffset + (uint64_t)racks.size() * sizeof(PresetBankRackEntry);
+        header.nameOffset = (uint32_t)pos;
+        header.nameLength = (uint32_t)bankName.size();
+        pos += bankName.size();
+
+        std::vector<PresetBankRackEntry> table(racks.size());
+        for (size_t i = 0; i < racks.size(); i++) {
+            table[i].nameOffset = (uint32_t)pos;
+            table[i].nameLength = (uint32_t)racks[i].name.size();
+            table[i].effectCount = racks[i].effectCount;
+            pos += racks[i].name.size();
+        }
+        for (size_t i = 0; i < racks.size(); i++) {
+            pos = align4(pos);
+            table[i].offset = (uint32_t)pos;
+            table[i].size = (uint32_t)racks[i].size;
+            pos += racks[i].size;
+        }
+        if (pos > UINT32_MAX) throw std::runtime_error("Preset bank exceeds 4 GB");
+        header.fileSize = (uint32_t)pos;
+
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(table.data()), (std::streamsize)(table.size() * sizeof(PresetBankRackEntry)));
+        os.write(bankName.data(), (std::streamsize)bankName.size());
+        uint64_t written = header.nameOffset + bankName.size();
+        for (const auto& rack : racks) {
+            os.write(rack.name.data(), (std::streamsize)rack.name.size());
+            written += rack.name.size();
+        }
+        const char pad[4] = { 0, 0, 0, 0 };
+        for (size_t i = 0; i < racks.size(); i++) {
+            os.write(pad, (std::streamsize)(table[i].offset - written));
+            os.write(reinterpret_cast<const char*>(racks[i].data), (std::streamsize)racks[i].size);
+            written = (uint64_t)table[i].offset + racks[i].size;
+        }
+    }
+
+}; //namespace
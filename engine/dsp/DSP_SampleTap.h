@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Digital Sound Processing : SampleTap
+// Lock free single producer / single consumer copy of an audio stream.
+//-----------------------------------------------------------------------------
+// Observers (analyzers, meters) do not change the signal, so the audio
+// callback only copies the block into the tap and the observers run on the
+// reading thread (e.g. the GUI). When the reader falls behind, the newest
+// samples are dropped instead of blocking the audio thread.
+//
+// Example usage:
+// =============
+//
+// DSP::SampleTap tap(48000 * 2);
+// // audio thread
+// tap.write(buffer, numSamples);
+// // gui thread
+// float tmp[1024];
+// uint32_t n;
+// while ((n = tap.read(tmp, 1024)) > 0) analyzer->process(tmp, n, 2);
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace DSP {
+
+    class SampleTap {
+    private:
+        std::vector<float> mData;
+        uint32_t mMask = 0;
+        alignas(64) std::atomic<uint32_t> mWritePos{0};
+        alignas(64) std::atomic<uint32_t> mReadPos{0};
+        std::atomic<uint32_t> mDropped{0};
+        std::atomic<int> mChannels{2};
+        std::atomic<int> mSampleRate{48000};
+
+    public:
+        // capacity in samples (not frames), rounded up to a power of two
+        explicit SampleTap(uint32_t capacity = 65536) {
+            uint32_t size = 1;
+            while (size < capacity) size <<= 1;
+            mData.resize(size, 0.f);
+            mMask = size - 1;
+        }
+
+        uint32_t getCapacity() const { return mMask + 1; }
+        uint32_t getDropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+        // format of the stream, set by the writer
+        void setFormat(int channels, int sampleRate) {
+            mChannels.store(channels, std::memory_order_relaxed);
+            mSampleRate.store(sampleRate, std::memory_order_relaxed);
+        }
+        int getChannels() const { return mChannels.load(std::memory_order_relaxed); }
+        int getSampleRate() const { return mSampleRate.load(std::memory_order_relaxed); }
+
+        uint32_t available() const {
+            return mWritePos.load(std::memory_order_acquire) - mReadPos.load(std::memory_order_relaxed);
+        }
+
+        //----------------------------------------------------------------------
+        // producer, whole block or nothing so frames stay aligned
+        bool write(const float* src, uint32_t count) {
+            const uint32_t w = mWritePos.load(std::memory_order_relaxed);
+            const uint32_t r = mReadPos.load(std::memory_order_acquire);
+            if (count > getCapacity() - (w - r)) {
+                mDropped.fetch_add(count, std::memory_order_relaxed);
+                return false;
+            }
+            const uint32_t start = w & mMask;
+            const uint32_t first = std::min(count, getCapacity() - start);
+            std::memcpy(mData.data() + start, src, first * sizeof(float));
+            if (count > first)
+                std::memcpy(mData.data(), src + first, (count - first) * sizeof(float));
+            mWritePos.store(w + count, std::memory_order_release);
+            return true;
+        }
+
+        //----------------------------------------------------------------------
+        // consumer, returns the samples copied (a multiple of multipleOf)
+        uint32_t read(float* dst, uint32_t maxCount, uint32_t multipleOf = 1) {
+            const uint32_t r = mReadPos.load(std::memory_order_relaxed);
+            const uint32_t w = mWritePos.load(std::memory_order_acquire);
+            uint32_t count = std::min(maxCount, w - r);
+            if (multipleOf > 1) count -= count % multipleOf;
+            if (count == 0) return 0;
+
+            const uint32_t start = r & mMask;
+            const uint32_t first = std::min(count, getCapacity() - start);
+            std::memcpy(dst, mData.data() + start, first * sizeof(float));
+            if (count > first)
+                std::memcpy(dst + first, mData.data(), (count - first) * sizeof(float));
+            mReadPos.store(r + count, std::memory_order_release);
+            return count;
+        }
+
+        // consumer, forget everything written so far
+        void skipAll() {
+            mReadPos.store(mWritePos.load(std::memory_order_acquire), std::memory_order_release);
+        }
+    };
+
+} // namespace DSP
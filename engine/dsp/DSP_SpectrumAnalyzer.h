@@ -244,6 +244,8 @@ namespace DSP {
         //----------------------------------------------------------------------
         // virtual std::string getName() const override { return "SPECTRUM ANALYSER";}
         //----------------------------------------------------------------------
+        // stop updating once the display has fallen back (see processTail)
+        virtual float getBypassHoldSeconds() const override { return ANALYZER_HOLD_SECONDS; }
         //----------------------------------------------------------------------
         #ifdef FLUX_ENGINE
         virtual ImVec4 getDefaultColor() const  override { return ImVec4(0.73f, 0.8f, 0.73f, 1.0f);}
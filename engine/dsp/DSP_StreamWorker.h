@@ -0,0 +1,273 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Digital Sound Processing : StreamWorker
+// Keeps an SDL audio stream filled to a target latency from a worker thread.
+//-----------------------------------------------------------------------------
+// * the worker sleeps on a condition variable, the stream's get callback
+//   (SDL audio thread, every device pull) wakes it. A timeout of the target
+//   latency covers a paused or unbound stream.
+// * on each wakeup the queue is topped up to the target, in blocks of the
+//   device pull size (power of two, at most half the target, max maxBlock)
+// * the render function runs on the worker only, the SDL audio thread never
+//   waits for it or for a lock taken by it
+// * an underrun is a device pull the queue could not serve after the first
+//   fill; a few are expected when the target is below the device buffer
+// * without threads (Emscripten w/o pthreads) the get callback renders the
+//   missing frames itself
+//
+// Example usage:
+// =============
+//
+// DSP::StreamWorker worker;
+// worker.setTargetLatency(0.020f);
+// worker.start(stream, 2, 44100, [](void* user, float* buffer, int frames, int queuedFrames) {
+//     static_cast<Synth*>(user)->render(buffer, frames);
+// }, &synth, 512);
+// ...
+// worker.stop();
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "DSP_Denormal.h"
+#include <utils/errorlog.h>
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define DSP_STREAM_THREADS
+#endif
+
+namespace DSP {
+
+    class StreamWorker {
+    public:
+        // fills frames interleaved float frames, queuedFrames still wait in
+        // the stream (the render function can derive the playback clock)
+        using RenderFn = void (*)(void* user, float* buffer, int frames, int queuedFrames);
+
+        struct Stats {
+            float queuedMs = 0.f;           // in the stream at the last wakeup
+            float minQueuedMs = 0.f;        // least seen at a wakeup
+            float targetMs = 0.f;
+            uint32_t blockFrames = 0;
+            uint32_t underruns = 0;
+            float wakeupsPerSec = 0.f;      // over the last second
+            uint64_t framesRendered = 0;
+        };
+
+        static constexpr float MIN_LATENCY = 0.005f;
+        static constexpr float MAX_LATENCY = 0.250f;
+        static constexpr int MIN_BLOCK = 64;
+
+    private:
+        SDL_AudioStream* mStream = nullptr;
+        RenderFn mRender = nullptr;
+        void* mUser = nullptr;
+        int mChannels = 2;
+        int mSampleRate = 44100;
+        int mMaxBlock = 512;
+        std::vector<float> mBuffer;
+
+        std::atomic<float> mTargetLatency{0.020f};
+        std::atomic<int> mDeviceFrames{0};      // last device pull
+        std::atomic<bool> mPrimed{false};       // queue reached the target once
+
+        std::thread mThread;
+        std::atomic<bool> mRunning{false};
+        std::mutex mWakeMutex;
+        std::condition_variable mWakeCond;
+        bool mWake = false;
+
+        std::atomic<float> mStatQueuedMs{0.f};
+        std::atomic<float> mStatMinQueuedMs{-1.f};
+        std::atomic<uint32_t> mStatUnderruns{0};
+        std::atomic<float> mStatWakeupsPerSec{0.f};
+        std::atomic<uint64_t> mStatFrames{0};
+
+        int frameBytes() const { return mChannels * static_cast<int>(sizeof(float)); }
+
+        int targetFrames() const {
+            return static_cast<int>(mTargetLatency.load(std::memory_order_relaxed) * mSampleRate);
+        }
+
+        // device pull rounded up to a power of two, at most half the target
+        int blockFrames() const {
+            const int device = mDeviceFrames.load(std::memory_order_relaxed);
+            int block = MIN_BLOCK;
+            while (block < device && block < mMaxBlock) block <<= 1;
+            while (block > MIN_BLOCK && block > targetFrames() / 2) block >>= 1;
+            return std::min(block, mMaxBlock);
+        }
+
+        void renderBlock(int frames, int queuedFrames) {
+            mRender(mUser, mBuffer.data(), frames, queuedFrames);
+            SDL_PutAudioStreamData(mStream, mBuffer.data(), frames * frameBytes());
+            mStatFrames.fetch_add(static_cast<uint64_t>(frames), std::memory_order_relaxed);
+        }
+
+        // tops the stream up to the target, returns the frames queued before
+        int fill() {
+            const int queued = SDL_GetAudioStreamQueued(mStream) / frameBytes();
+            const float queuedMs = queued * 1000.f / mSampleRate;
+            mStatQueuedMs.store(queuedMs, std::memory_order_relaxed);
+            const float minMs = mStatMinQueuedMs.load(std::memory_order_relaxed);
+            if (mPrimed.load(std::memory_order_relaxed) && (minMs < 0.f || queuedMs < minMs))
+                mStatMinQueuedMs.store(queuedMs, std::memory_order_relaxed);
+
+            const int target = targetFrames();
+            const int block = blockFrames();
+            int pending = queued;
+            while (pending < target) {
+                renderBlock(block, pending);
+                pending += block;
+            }
+            mPrimed.store(true, std::memory_order_relaxed);
+            return queued;
+        }
+
+        void workerMain() {
+            ScopedDenormalGuard denormalGuard;
+            SetLogThreadRealtime(true);
+            uint32_t wakeups = 0;
+            auto second = std::chrono::steady_clock::now();
+
+            while (mRunning.load(std::memory_order_acquire)) {
+                fill();
+
+                const auto timeout = std::chrono::duration<float>(mTargetLatency.load(std::memory_order_relaxed));
+                {
+                    std::unique_lock<std::mutex> lock(mWakeMutex);
+                    mWakeCond.wait_for(lock, timeout, [this] {
+                        return mWake || !mRunning.load(std::memory_order_relaxed);
+                    });
+                    mWake = false;
+                }
+
+                wakeups++;
+                const auto now = std::chrono::steady_clock::now();
+                const float elapsed = std::chrono::duration<float>(now - second).count();
+                if (elapsed >= 1.f) {
+                    mStatWakeupsPerSec.store(wakeups / elapsed, std::memory_order_relaxed);
+                    wakeups = 0;
+                    second = now;
+                }
+            }
+        }
+
+        // SDL audio thread, stream lock held
+        static void SDLCALL getCallback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount) {
+            auto* worker = static_cast<StreamWorker*>(userdata);
+            (void)stream;
+            SetLogThreadRealtime(true);
+            worker->mDeviceFrames.store(total_amount / worker->frameBytes(), std::memory_order_relaxed);
+            if (additional_amount > 0 && worker->mPrimed.load(std::memory_order_relaxed))
+                worker->mStatUnderruns.fetch_add(1, std::memory_order_relaxed);
+
+        #ifdef DSP_STREAM_THREADS
+            {
+                std::lock_guard<std::mutex> lock(worker->mWakeMutex);
+                worker->mWake = true;
+            }
+            worker->mWakeCond.notify_one();
+        #else
+            ScopedDenormalGuard denormalGuard;
+            int missing = additional_amount / worker->frameBytes();
+            int queued = (total_amount - additional_amount) / worker->frameBytes();
+            while (missing > 0) {
+                const int frames = std::min(missing, worker->mMaxBlock);
+                worker->renderBlock(frames, queued);
+                queued += frames;
+                missing -= frames;
+            }
+        #endif
+        }
+
+    public:
+        StreamWorker() = default;
+        ~StreamWorker() { stop(); }
+
+        StreamWorker(const StreamWorker&) = delete;
+        void operator=(const StreamWorker&) = delete;
+
+        //----------------------------------------------------------------------
+        // maxBlock: most frames the render function gets in one call
+        bool start(SDL_AudioStream* stream, int channels, int sampleRate,
+                   RenderFn render, void* user, int maxBlock = 512) {
+            if (!stream || !render || isRunning()) return false;
+            mStream = stream;
+            mChannels = channels;
+            mSampleRate = sampleRate;
+            mRender = render;
+            mUser = user;
+            mMaxBlock = std::max(maxBlock, MIN_BLOCK);
+            mBuffer.assign(static_cast<size_t>(mMaxBlock * channels), 0.f);
+            mPrimed.store(false, std::memory_order_relaxed);
+            mWake = false;
+
+            mRunning.store(true, std::memory_order_release);
+        #ifdef DSP_STREAM_THREADS
+            mThread = std::thread(&StreamWorker::workerMain, this);
+        #endif
+            SDL_SetAudioStreamGetCallback(mStream, &StreamWorker::getCallback, this);
+            return true;
+        }
+
+        //----------------------------------------------------------------------
+        // no render call is running or follows when this returns
+        void stop() {
+            if (!mRunning.load(std::memory_order_acquire)) return;
+            // SDL takes the stream lock here, a running callback finishes first
+            SDL_SetAudioStreamGetCallback(mStream, NULL, NULL);
+            {
+                std::lock_guard<std::mutex> lock(mWakeMutex);
+                mRunning.store(false, std::memory_order_release);
+            }
+            mWakeCond.notify_one();
+            if (mThread.joinable()) mThread.join();
+        }
+
+        bool isRunning() const { return mRunning.load(std::memory_order_acquire); }
+
+        //----------------------------------------------------------------------
+        // seconds of audio kept in the stream, any thread
+        void setTargetLatency(float seconds) {
+            mTargetLatency.store(std::clamp(seconds, MIN_LATENCY, MAX_LATENCY), std::memory_order_relaxed);
+        }
+        float getTargetLatency() const { return mTargetLatency.load(std::memory_order_relaxed); }
+
+        // frames per render call right now
+        int getBlockFrames() const { return blockFrames(); }
+
+        //----------------------------------------------------------------------
+        Stats getStats() const {
+            Stats s;
+            s.queuedMs = mStatQueuedMs.load(std::memory_order_relaxed);
+            s.minQueuedMs = std::max(mStatMinQueuedMs.load(std::memory_order_relaxed), 0.f);
+            s.targetMs = getTargetLatency() * 1000.f;
+            s.blockFrames = static_cast<uint32_t>(blockFrames());
+            s.underruns = mStatUnderruns.load(std::memory_order_relaxed);
+            s.wakeupsPerSec = mStatWakeupsPerSec.load(std::memory_order_relaxed);
+            s.framesRendered = mStatFrames.load(std::memory_order_relaxed);
+            return s;
+        }
+
+        void resetStats() {
+            mStatMinQueuedMs.store(-1.f);
+            mStatUnderruns.store(0);
+            mStatWakeupsPerSec.store(0.f);
+            mStatFrames.store(0);
+        }
+    };
+
+} // namespace DSP
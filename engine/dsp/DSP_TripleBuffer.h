@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Digital Sound Processing : TripleBuffer
+// Wait free hand over of the latest frame from one writer to one reader.
+//-----------------------------------------------------------------------------
+// The writer fills back() and publish()es it, the reader calls update() and
+// reads front(). Neither side ever waits: a third slot sits in the middle
+// and the two sides only swap their slot with it (one atomic exchange).
+// Frames the reader did not pick up in time are replaced by newer ones,
+// which is what a display wants (scope, meters, spectra).
+//
+// * the slots are never (re)allocated here, size them before use
+// * only one writer thread and one reader thread
+//
+// Example usage:
+// =============
+//
+// DSP::TripleBuffer<std::vector<float>> scope;
+// scope.forEachSlot([](auto& v) { v.resize(2048); });
+// // audio thread
+// std::copy(buffer, buffer + 2048, scope.back().begin());
+// scope.publish();
+// // gui thread
+// scope.update();
+// draw(scope.front());
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace DSP {
+
+    template<typename T>
+    class TripleBuffer {
+    private:
+        static constexpr uint8_t INDEX_MASK = 0x3;
+        static constexpr uint8_t NEW_BIT = 0x4;
+
+        T mSlots[3];
+        // index of the slot in the middle + NEW_BIT if the writer put it there
+        alignas(64) std::atomic<uint8_t> mMiddle{1};
+        alignas(64) uint8_t mBack = 0;     // writer only
+        alignas(64) uint8_t mFront = 2;    // reader only
+
+    public:
+        TripleBuffer() = default;
+        TripleBuffer(const TripleBuffer&) = delete;
+        void operator=(const TripleBuffer&) = delete;
+
+        // setup, no reader or writer may be active
+        template<typename F>
+        void forEachSlot(F func) { for (T& slot : mSlots) func(slot); }
+
+        //----------------------------------------------------------------------
+        // writer
+        T& back() { return mSlots[mBack]; }
+
+        void publish() {
+            const uint8_t old = mMiddle.exchange(mBack | NEW_BIT, std::memory_order_acq_rel);
+            mBack = old & INDEX_MASK;
+        }
+
+        // false while the reader has not taken the last frame, a writer can
+        // skip filling a frame nobody would see
+        bool wasTaken() const {
+            return (mMiddle.load(std::memory_order_relaxed) & NEW_BIT) == 0;
+        }
+
+        //----------------------------------------------------------------------
+        // reader: returns true if front() changed
+        bool update() {
+            if ((mMiddle.load(std::memory_order_relaxed) & NEW_BIT) == 0) return false;
+            const uint8_t old = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+            mFront = old & INDEX_MASK;
+            return true;
+        }
+
+        const T& front() const { return mSlots[mFront]; }
+    };
+
+} // namespace DSP
@@ -5,16 +5,19 @@
 // Digital Sound Processing : VisualAnalyzer
 //-----------------------------------------------------------------------------
 // - no need for ISettings
+// - the audio thread never waits for the gui: meters are atomics, the scope
+//   is handed over by a TripleBuffer and only copied when the gui took the
+//   last frame. The gui draws a min/max overview per pixel column.
 //-----------------------------------------------------------------------------
 
 #pragma once
 
 #include <vector>
+#include <array>
 #include <cstdint>
 #include <algorithm>
 #include <cstring>
 #include <atomic>
-#include <mutex>
 
 #ifdef FLUX_ENGINE
 #include <imgui.h>
@@ -24,26 +27,39 @@
 
 
 #include "DSP_Effect.h"
+#include "DSP_TripleBuffer.h"
 
 namespace DSP {
     class VisualAnalyzer : public Effect {
-    private:
-        std::vector<float> mMirrorBuffer;
-        std::mutex mDataMutex;
-
-        // left right values for a VU-Meter
-        // float mLeftLevel = 0.0f;
-        // float mRightLevel = 0.0f;
-
-        // float mRmsL = 0.0f;
-        // float mRmsR = 0.0f;
+    public:
+        static constexpr int MAX_CHANNELS = 8;
+        static constexpr int SCOPE_FRAMES = 1024;
+
+        // the last SCOPE_FRAMES frames, interleaved
+        struct ScopeFrame {
+            std::vector<float> samples;
+            int channels = 0;
+            int frames = 0;
+        };
 
+    private:
+        // audio thread: the scope history and the meter ballistics
+        std::vector<float> mScopeHistory;
+        int mScopePos = 0;
+        int mScopeChannels = 0;
+        std::array<float, MAX_CHANNELS> mLevelState{};
 
-        std::vector<float> mChannelLevels;
-        std::vector<float> mChannelRms;
-        std::vector<float> mSums;
+        // audio -> gui, no locks: the gui never blocks the audio thread
+        TripleBuffer<ScopeFrame> mScope;
+        std::array<std::atomic<float>, MAX_CHANNELS> mChannelLevels{};
+        std::array<std::atomic<float>, MAX_CHANNELS> mChannelRms{};
+        std::array<std::atomic<float>, MAX_CHANNELS> mChannelPeaks{};
+        std::atomic<int> mNumChannels{0};
+        std::atomic<bool> mEnableOszi{false};
 
-        bool mEnableOszi = false;
+        // gui thread
+        std::vector<float> mOverviewMin;
+        std::vector<float> mOverviewMax;
 
 
     public:
@@ -56,102 +72,145 @@ namespace DSP {
         VisualAnalyzer( bool switchOn = true) : Effect(DSP::EffectType::VisualAnalyzer, switchOn) {
             mEffectName = "VISUAL ANALYSER";
 
-            mMirrorBuffer.resize(2048, 0.0f); // Size for the oscilloscope display
+            // Size for the oscilloscope display, allocated once
+            mScopeHistory.resize(SCOPE_FRAMES * MAX_CHANNELS, 0.0f);
+            mScope.forEachSlot([](ScopeFrame& frame) { frame.samples.resize(SCOPE_FRAMES * MAX_CHANNELS, 0.0f); });
         }
 
 
 
         //----------------------------------------------------------------------
         virtual void process(float* buffer, int numSamples, int numChannels) override {
-            if (!mEnabled) return;
-
-            // 1. Initialize channel levels if count changed
-            if (mChannelLevels.size() != static_cast<size_t>(numChannels)) {
-                mChannelLevels.resize(numChannels, 0.0f);
-                 mChannelRms.resize(numChannels, 0.0f);
-                 mSums.resize(numChannels, 0.0f);
-            }
-
-
-            // automaticly enabled if we draw it else save cpu cycles
-            if (mEnableOszi) {
-                std::lock_guard<std::mutex> lock(mDataMutex);
-
-                // Mirror Buffer (Oscilloscope View)
-                // For visual clarity, we often mirror the "Mono Sum" or "Main Left"
-                // to avoid a messy overlapping waveform. Here we mirror the interleaved data.
-                int toCopy = std::min(numSamples, (int)mMirrorBuffer.size());
-                if (toCopy > 0) {
-                    std::move(mMirrorBuffer.begin() + toCopy, mMirrorBuffer.end(), mMirrorBuffer.begin());
-                    std::copy(buffer + (numSamples - toCopy), buffer + numSamples, mMirrorBuffer.end() - toCopy);
-                }
+            if (!mEnabled || numChannels < 1) return;
+
+            const int channels = std::min(numChannels, MAX_CHANNELS);
+            const int numFrames = numSamples / numChannels;
+            if (channels != mScopeChannels) {
+                mScopeChannels = channels;
+                mScopePos = 0;
+                std::fill(mScopeHistory.begin(), mScopeHistory.end(), 0.0f);
+                mLevelState.fill(0.0f);
+                mNumChannels.store(channels, std::memory_order_relaxed);
             }
 
-            std::fill(mSums.begin(), mSums.end(), 0.0f);
-
-            // 3. RMS Level Calculation per Channel
-            int numFrames = numSamples / numChannels;
-            float numFramesF = static_cast<float>(numFrames);
+            // 1. RMS and peak per channel
             if (numFrames > 0) {
-                int channel = 0;
-                for (int i = 0; i < numSamples; i++) {
-                    //
-                    float sample = buffer[i];
-
-                    // Safety check
-                    if (!std::isfinite(sample)) sample = 0.0f;
-
-                    mSums[channel] += (sample * sample);
-
-                    if (++channel >= numChannels) channel = 0;
+                float sums[MAX_CHANNELS] = {};
+                float peaks[MAX_CHANNELS] = {};
+                for (int i = 0; i < numFrames; i++) {
+                    const float* frame = buffer + i * numChannels;
+                    for (int c = 0; c < channels; c++) {
+                        float sample = frame[c];
+                        // Safety check
+                        if (!std::isfinite(sample)) sample = 0.0f;
+                        sums[c] += sample * sample;
+                        peaks[c] = std::max(peaks[c], std::fabs(sample));
+                    }
                 }
 
-                for (int c = 0; c < numChannels; ++c) {
-                    // Calculate RMS
-                    float rms = std::sqrt(std::max(0.0f, mSums[c] / numFramesF));
-
+                const float numFramesF = static_cast<float>(numFrames);
+                for (int c = 0; c < channels; ++c) {
                     // Visual Gain and Denormal Protection
-                    float rawLevel = rms * 2.0f;
+                    float rawLevel = std::sqrt(sums[c] / numFramesF) * 2.0f;
                     if (rawLevel < 1e-6f || !std::isfinite(rawLevel)) rawLevel = 0.0f;
 
-                    mChannelRms[c] = rawLevel;
-                    //denormal protection
-                    if ( mChannelRms[c] < 1e-6f)  mChannelRms[c]= 0.0f;
-                    if (!std::isfinite( mChannelRms[c]))  mChannelRms[c] = 0.0f;
+                    // 2. Smoothing (Ballistics) per channel
+                    mLevelState[c] = (mLevelState[c] * 0.8f) + (rawLevel * 0.2f);
+                    if (mLevelState[c] < 1e-6f) mLevelState[c] = 0.0f;
+
+                    mChannelRms[c].store(rawLevel, std::memory_order_relaxed);
+                    mChannelLevels[c].store(mLevelState[c], std::memory_order_relaxed);
+                    mChannelPeaks[c].store(peaks[c], std::memory_order_relaxed);
+                }
+            }
 
-                    // 4. Smoothing (Ballistics) per channel
-                    mChannelLevels[c] = (mChannelLevels[c] * 0.8f) + (rawLevel * 0.2f);
+            // 3. Oscilloscope: automaticly enabled if we draw it else save cpu cycles
+            if (mEnableOszi.load(std::memory_order_relaxed)) {
+                const int first = std::max(0, numFrames - SCOPE_FRAMES);
+                for (int i = first; i < numFrames; i++) {
+                    std::memcpy(&mScopeHistory[mScopePos * channels], buffer + i * numChannels, channels * sizeof(float));
+                    if (++mScopePos >= SCOPE_FRAMES) mScopePos = 0;
+                }
 
+                // a new frame only when the gui took the last one
+                if (mScope.wasTaken()) {
+                    ScopeFrame& frame = mScope.back();
+                    const int older = (SCOPE_FRAMES - mScopePos) * channels;
+                    std::memcpy(frame.samples.data(), &mScopeHistory[mScopePos * channels], older * sizeof(float));
+                    std::memcpy(frame.samples.data() + older, mScopeHistory.data(), mScopePos * channels * sizeof(float));
+                    frame.channels = channels;
+                    frame.frames = SCOPE_FRAMES;
+                    mScope.publish();
                 }
             }
         }
 
 
         //----------------------------------------------------------------------
-        // GUI calls this to get the data
+        // GUI calls this to get the data, wait free. The reference stays
+        // valid until the next call.
+        const ScopeFrame& getScopeFrame() {
+            mEnableOszi.store(true, std::memory_order_relaxed); // somebody whats the data let's enable it ;)
+            mScope.update();
+            return mScope.front();
+        }
+        // copy of the scope, interleaved
         void getLatestSamples(std::vector<float>& outBuffer) {
-            mEnableOszi = true; // somebody whats the data let's enable it ;)
-            std::lock_guard<std::mutex> lock(mDataMutex);
-            outBuffer = mMirrorBuffer;
+            const ScopeFrame& frame = getScopeFrame();
+            outBuffer.assign(frame.samples.begin(), frame.samples.begin() + frame.frames * frame.channels);
         }
         //----------------------------------------------------------------------
-        float getLevel(int channel) {
-            if (channel >= 0 && channel < (int)mChannelLevels.size()) {
-                return mChannelLevels[channel];
+        // min / max of one channel per column (e.g. per pixel): drawing the
+        // overview costs the same at any sample rate or scope length
+        static void buildOverview(const ScopeFrame& frame, int channel, int columns,
+                                  std::vector<float>& outMin, std::vector<float>& outMax) {
+            outMin.assign(std::max(columns, 0), 0.0f);
+            outMax.assign(std::max(columns, 0), 0.0f);
+            if (columns <= 0 || frame.frames <= 0 || channel < 0 || channel >= frame.channels) return;
+
+            const float* samples = frame.samples.data();
+            for (int col = 0; col < columns; col++) {
+                const int from = (int)((int64_t)col * frame.frames / columns);
+                const int to = std::max(from + 1, (int)((int64_t)(col + 1) * frame.frames / columns));
+                float lo = samples[from * frame.channels + channel];
+                float hi = lo;
+                for (int i = from + 1; i < to; i++) {
+                    const float s = samples[i * frame.channels + channel];
+                    lo = std::min(lo, s);
+                    hi = std::max(hi, s);
+                }
+                outMin[col] = lo;
+                outMax[col] = hi;
+            }
+        }
+        //----------------------------------------------------------------------
+        int getChannels() const { return mNumChannels.load(std::memory_order_relaxed); }
+        //----------------------------------------------------------------------
+        float getLevel(int channel) const {
+            if (channel >= 0 && channel < getChannels()) {
+                return mChannelLevels[channel].load(std::memory_order_relaxed);
             }
             return 0.0f;
         }
         //----------------------------------------------------------------------
-        float getDecible(int channel) {
-            if (channel >= 0 && channel < (int)mChannelLevels.size()) {
-                return 20.0f * std::log10(mChannelLevels[channel] + 1e-9f);
+        float getDecible(int channel) const {
+            if (channel >= 0 && channel < getChannels()) {
+                return 20.0f * std::log10(getLevel(channel) + 1e-9f);
             }
             return -90.0f; // Silence floor
         }
         //----------------------------------------------------------------------
-        float getRMS(int channel) {
-            if (channel >= 0 && channel < (int)mChannelRms.size()) {
-                return mChannelRms[channel];
+        float getRMS(int channel) const {
+            if (channel >= 0 && channel < getChannels()) {
+                return mChannelRms[channel].load(std::memory_order_relaxed);
+            }
+            return 0.0f;
+        }
+        //----------------------------------------------------------------------
+        // sample peak of the last block
+        float getPeak(int channel) const {
+            if (channel >= 0 && channel < getChannels()) {
+                return mChannelPeaks[channel].load(std::memory_order_relaxed);
             }
             return 0.0f;
         }
@@ -159,6 +218,8 @@ namespace DSP {
 
 
         // virtual std::string getName() const override { return "VISUAL ANALYSER";}
+        // stop updating once the display has fallen back (see processTail)
+        virtual float getBypassHoldSeconds() const override { return ANALYZER_HOLD_SECONDS; }
 #ifdef FLUX_ENGINE
         virtual ImVec4 getDefaultColor() const  override { return ImVec4(0.93f, 0.8f, 0.93f, 1.0f);}
         // i dont want to render UI here !
@@ -290,47 +351,29 @@ namespace DSP {
         if (size.x <= 0.0f) size.x = ImGui::GetContentRegionAvail().x;
         if (size.y <= 0.0f) size.y = ImGui::GetContentRegionAvail().y;
 
-        static std::vector<float> samples;
-        analyzer->getLatestSamples(samples);
-        if (samples.empty() || numChannels <= 0) {
+        const ScopeFrame& frame = analyzer->getScopeFrame();
+        if (frame.frames < 2 || frame.channels <= 0 || numChannels <= 0) {
             ImGui::Dummy(size);
             return;
         }
 
         ImDrawList* dl = ImGui::GetWindowDrawList();
         ImVec2 pos = ImGui::GetCursorScreenPos();
-        float mid_y = pos.y + size.y * 0.5f;
 
         // --- Background & Grid ---
         dl->AddRectFilled(pos, pos + size, IM_COL32(5, 12, 5, 255));
         // ... (Grid drawing logic same as before) ...
 
-        // --- 2. Calculate Frames ---
-        int num_frames = (int)samples.size() / numChannels;
-        if (num_frames < 2) { ImGui::Dummy(size); return; }
-
-        // Use a 2D-like point buffer approach to avoid reallocating many vectors
-        static std::vector<ImVec2> points;
-        points.resize(num_frames);
-
-        float x_step = size.x / (float)(num_frames - 1);
-        float yScale = size.y * 0.45f;
+        // --- 2. one min/max pair per pixel column ---
+        const int columns = std::max(2, (int)size.x);
 
         // --- 3. Draw each channel separately ---
-        for (int c = 0; c < numChannels; ++c) {
-            // Calculate points for this specific channel
-            for (int i = 0; i < num_frames; ++i) {
-                float x = pos.x + i * x_step;
-                // Access the sample for frame 'i' and channel 'c'
-                float s = samples[i * numChannels + c];
-                points[i] = ImVec2(x, mid_y - (s * yScale));
-            }
-
+        const int channels = std::min(numChannels, frame.channels);
+        for (int c = 0; c < channels; ++c) {
+            buildOverview(frame, c, columns, mOverviewMin, mOverviewMax);
             // Get color for this channel (wrap around if more channels than colors)
             ImU32 col = channelColors[c % maxColorCount];
-
-            // Render current channel path
-            dl->AddPolyline(points.data(), num_frames, col, 0, 1.2f);
+            ImFlux::MinMaxWaveform(dl, pos, size, mOverviewMin.data(), mOverviewMax.data(), columns, col);
         }
 
         // Border & Dummy
@@ -0,0 +1,214 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Digital Sound Processing : WorkerPool
+// Runs independent branches of one audio callback (e.g. a drum bus and the
+// effects rack) on a few worker threads.
+//-----------------------------------------------------------------------------
+// * the calling audio thread takes part, tasks nobody picked up are run by
+//   the caller itself, a sleeping worker never stalls the callback
+// * dispatch is lock free: one atomic claim word (batch << 32 | next task)
+// * workers spin a short while after a batch and then sleep on an atomic
+// * the deadline is a budget for waiting on the workers, misses are counted
+// * without threads (Emscripten w/o pthreads) run() is a plain loop
+//
+// Example usage:
+// =============
+//
+// DSP::WorkerPool pool;   // hardware threads - 1, max 3 workers
+// DSP::WorkerPool::Task tasks[2] = {
+//     { [](void* u) { static_cast<Bus*>(u)->process(); }, &drumBus },
+//     { [](void* u) { static_cast<Bus*>(u)->process(); }, &mainBus },
+// };
+// pool.run(tasks, 2, 500.f); // inside the audio callback
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "DSP_Denormal.h"
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define DSP_WORKER_THREADS
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace DSP {
+
+    class WorkerPool {
+    public:
+        using TaskFn = void (*)(void* user);
+        struct Task {
+            TaskFn fn = nullptr;
+            void* user = nullptr;
+        };
+
+        struct Stats {
+            uint32_t batches = 0;
+            uint32_t tasks = 0;
+            uint32_t tasksOnWorkers = 0;    // not run by the caller
+            uint32_t deadlineMisses = 0;
+            float maxWaitUs = 0.f;          // caller waiting for workers
+        };
+
+        static constexpr int MAX_WORKERS = 3;
+        static constexpr int SPIN_COUNT = 4000; // ~ 50..100 us before a worker sleeps
+
+    private:
+        std::vector<std::thread> mWorkers;
+        std::atomic<bool> mQuit{false};
+        std::atomic<uint32_t> mWake{0};
+
+        std::atomic<uint64_t> mClaim{0};    // batch << 32 | next task index
+        std::atomic<const Task*> mTasks{nullptr};
+        std::atomic<uint32_t> mCount{0};
+        std::atomic<uint32_t> mDone{0};
+        uint32_t mBatch = 0;
+
+        std::atomic<uint32_t> mStatBatches{0};
+        std::atomic<uint32_t> mStatTasks{0};
+        std::atomic<uint32_t> mStatOnWorkers{0};
+        std::atomic<uint32_t> mStatMisses{0};
+        std::atomic<float> mStatMaxWaitUs{0.f};
+
+        static inline void cpuRelax() {
+        #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+            _mm_pause();
+        #endif
+        }
+
+        // claims and runs tasks of the current batch until none is left
+        uint32_t drain() {
+            uint32_t ran = 0;
+            uint64_t claim = mClaim.load(std::memory_order_acquire);
+            for (;;) {
+                const uint32_t index = static_cast<uint32_t>(claim);
+                // a claim of an already finished batch fails the CAS below,
+                // the task list can only be replaced once all tasks are claimed
+                if (index >= mCount.load(std::memory_order_acquire)) break;
+                if (!mClaim.compare_exchange_weak(claim, claim + 1,
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    continue;
+                }
+                const Task& task = mTasks.load(std::memory_order_acquire)[index];
+                task.fn(task.user);
+                mDone.fetch_add(1, std::memory_order_acq_rel);
+                ran++;
+                claim = mClaim.load(std::memory_order_acquire);
+            }
+            return ran;
+        }
+
+        void workerMain() {
+            ScopedDenormalGuard denormalGuard;
+            uint32_t seen = mWake.load(std::memory_order_acquire);
+            while (!mQuit.load(std::memory_order_acquire)) {
+                int spin = 0;
+                uint32_t wake;
+                while ((wake = mWake.load(std::memory_order_acquire)) == seen && spin < SPIN_COUNT) {
+                    cpuRelax();
+                    spin++;
+                }
+                if (wake == seen) {
+                    mWake.wait(seen, std::memory_order_acquire);
+                    continue;
+                }
+                seen = wake;
+                const uint32_t ran = drain();
+                if (ran) mStatOnWorkers.fetch_add(ran, std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        // numWorkers < 0: hardware threads - 1, capped at MAX_WORKERS
+        explicit WorkerPool(int numWorkers = -1) {
+        #ifdef DSP_WORKER_THREADS
+            if (numWorkers < 0) {
+                int hw = static_cast<int>(std::thread::hardware_concurrency());
+                numWorkers = std::clamp(hw - 1, 0, MAX_WORKERS);
+            }
+            for (int i = 0; i < numWorkers; i++)
+                mWorkers.emplace_back(&WorkerPool::workerMain, this);
+        #else
+            (void)numWorkers;
+        #endif
+        }
+
+        ~WorkerPool() {
+            mQuit.store(true, std::memory_order_release);
+            mWake.fetch_add(1, std::memory_order_release);
+            mWake.notify_all();
+            for (auto& t : mWorkers) t.join();
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        void operator=(const WorkerPool&) = delete;
+
+        int getNumWorkers() const { return static_cast<int>(mWorkers.size()); }
+
+        //----------------------------------------------------------------------
+        // Runs all tasks and returns when every one has finished. Only one
+        // thread may call run() at a time (the audio callback).
+        void run(const Task* tasks, uint32_t count, float deadlineUs = 0.f) {
+            if (count == 0) return;
+            mStatBatches.fetch_add(1, std::memory_order_relaxed);
+            mStatTasks.fetch_add(count, std::memory_order_relaxed);
+
+            if (mWorkers.empty() || count == 1) {
+                for (uint32_t i = 0; i < count; i++) tasks[i].fn(tasks[i].user);
+                return;
+            }
+
+            mTasks.store(tasks, std::memory_order_relaxed);
+            mCount.store(count, std::memory_order_relaxed);
+            mDone.store(0, std::memory_order_relaxed);
+            mBatch++;
+            mClaim.store(static_cast<uint64_t>(mBatch) << 32, std::memory_order_release);
+            mWake.fetch_add(1, std::memory_order_release);
+            mWake.notify_all();
+
+            drain();
+
+            if (mDone.load(std::memory_order_acquire) >= count) return;
+
+            const auto start = std::chrono::steady_clock::now();
+            while (mDone.load(std::memory_order_acquire) < count) cpuRelax();
+            const float waitUs = std::chrono::duration<float, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+
+            if (waitUs > mStatMaxWaitUs.load(std::memory_order_relaxed))
+                mStatMaxWaitUs.store(waitUs, std::memory_order_relaxed);
+            if (deadlineUs > 0.f && waitUs > deadlineUs)
+                mStatMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        //----------------------------------------------------------------------
+        Stats getStats() const {
+            Stats s;
+            s.batches = mStatBatches.load(std::memory_order_relaxed);
+            s.tasks = mStatTasks.load(std::memory_order_relaxed);
+            s.tasksOnWorkers = mStatOnWorkers.load(std::memory_order_relaxed);
+            s.deadlineMisses = mStatMisses.load(std::memory_order_relaxed);
+            s.maxWaitUs = mStatMaxWaitUs.load(std::memory_order_relaxed);
+            return s;
+        }
+
+        void resetStats() {
+            mStatBatches.store(0);
+            mStatTasks.store(0);
+            mStatOnWorkers.store(0);
+            mStatMisses.store(0);
+            mStatMaxWaitUs.store(0.f);
+        }
+    };
+
+} // namespace DSP
@@ -67,6 +67,7 @@ class Cymbals: public Effect {
 private:
     CymbalsSettings mSettings;
     DrumSynth::CymbalsSynth mCymbalsSynth;
+    std::vector<float> mMono;   // render scratch, only grows
 
 
 
@@ -120,19 +121,15 @@ public:
         const float samplerate = mSampleRate;
 
 
-        for (int i = 0; i < numSamples; i += numChannels) {
-            // generate once
-            float monoOut = 0;
-            monoOut = mCymbalsSynth.processSample(pitch, decay, drive, velocity,  samplerate);
+        // nothing is ringing, nothing to add
+        if (!mCymbalsSynth.isActive() || numChannels < 1) return;
 
-            // put into channels
-            for (int ch = 0; ch < numChannels; ch++) {
-                int idx = i + ch;
-                if (idx < numSamples) {
-                    buffer[idx] += monoOut;
-                }
-            }
-        }
+        // generate once, then put into channels
+        const int numFrames = DrumSynth::framesOf(numSamples, numChannels);
+        if (mMono.size() < (size_t)numFrames) mMono.resize(numFrames);
+        std::fill(mMono.begin(), mMono.begin() + numFrames, 0.f);
+        mCymbalsSynth.render(mMono.data(), numFrames, pitch, decay, drive, velocity, samplerate);
+        DrumSynth::addMonoToChannels(mMono.data(), buffer, numSamples, numChannels);
     }
 
 public:
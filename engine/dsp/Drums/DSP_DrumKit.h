@@ -13,6 +13,7 @@
 #include <atomic>
 #include <algorithm>
 #include <filesystem>
+#include <chrono>
 
 #include "../DSP_Effect.h"
 #include "DrumSynth.h"
@@ -205,6 +206,15 @@ namespace DSP {
             return true;
         }
 
+        //----------------------------------------------------------------------
+        // true while the looper records (or is about to) the incoming signal.
+        // Otherwise the kit only adds to the buffer and can render into a
+        // separate bus.
+        bool readsInput() const {
+            if (mDeferredRecoding) return true;
+            Processors::LooperMode mode = mLooper.getMode();
+            return mode != Processors::LooperMode::Off && mode != Processors::LooperMode::Playing;
+        }
         //----------------------------------------------------------------------
         void stopLooper() {
 
@@ -326,13 +336,20 @@ namespace DSP {
             //<<<<<
 
 
-            for (int i = 0; i < numSamples; i += numChannels) {
-                float out = 0.f;
+            // the voices render whole segments between two steps
+            const int numFrames = DrumSynth::framesOf(numSamples, numChannels);
+            if (mMono.size() < (size_t)numFrames) mMono.resize(numFrames);
+            std::fill(mMono.begin(), mMono.begin() + numFrames, 0.f);
+
+            int segmentStart = 0;
+            for (int frame = 0; frame < numFrames; frame++) {
                 // Phase-Accumulator
                 mPhase += 1.0;
 
                 int step = static_cast<int>(mPhase / samplesPerStep) % 16;
                 if (step != mCurrentStep) {
+                    renderVoices(mMono.data() + segmentStart, frame - segmentStart, sampleRate);
+                    segmentStart = frame;
 
                     //NOTE: looper => we call the init looper state check
                     if (onLooperStep(numChannels)) {
@@ -358,25 +375,65 @@ namespace DSP {
                     if (tomPat & stepper) { mTomTom.trigger(); }
                     if (cymPat & stepper) { mCymbals.trigger(); }
                 }
-
-                //using  default values here ...
-                out +=  mKick.processSample(50.f, 0.3f, 0.5f, 1.f, 1.f, sampleRate);
-                out +=  mSnare.processSample(180.f, 0.2f, 0.7f, 1.5f, 0.8f, sampleRate);
-                out +=  mHiHatClosed.processSample(14000.f, 0.2f, 5.f, 0.8f, sampleRate);
-                out +=  mHiHatOpen.processSample(8000.f, 0.5f, 3.f, 0.5f, sampleRate);
-                out +=  mTomTom.processSample(120.f,0.4f,0.50f,1.0f, sampleRate);
-                out +=  mCymbals.processSample(450.f, 1.0f, 1.5f, 0.5f, sampleRate);
-                out *= vol;
-                for (int ch = 0; ch < numChannels; ch++) {
-                    if ((i + ch) < numSamples) {
-                        buffer[i + ch] += out;
-                    }
-                }
             } //for ....
+            renderVoices(mMono.data() + segmentStart, numFrames - segmentStart, sampleRate);
+            DrumSynth::addMonoToChannels(mMono.data(), buffer, numSamples, numChannels, vol);
+
             // Normalized beatPhase
             maBeatPhase = fmodf(mPhase, samplesPerBeat) / samplesPerBeat;
         }
         //----------------------------------------------------------------------
+        // adds all ringing voices, silent ones are skipped inside the synths
+        void renderVoices(float* mono, int numFrames, float sampleRate) {
+            if (numFrames <= 0) return;
+            //using  default values here ...
+            mKick.render(mono, numFrames, 50.f, 0.3f, 0.5f, 1.f, 1.f, sampleRate);
+            mSnare.render(mono, numFrames, 180.f, 0.2f, 0.7f, 1.5f, 0.8f, sampleRate);
+            mHiHatClosed.render(mono, numFrames, 14000.f, 0.2f, 5.f, 0.8f, sampleRate);
+            mHiHatOpen.render(mono, numFrames, 8000.f, 0.5f, 3.f, 0.5f, sampleRate);
+            mTomTom.render(mono, numFrames, 120.f,0.4f,0.50f,1.0f, sampleRate);
+            mCymbals.render(mono, numFrames, 450.f, 1.0f, 1.5f, 0.5f, sampleRate);
+        }
+        //----------------------------------------------------------------------
+        // CPU time per block with every drum playing 16th notes
+        struct Benchmark {
+            int frames = 0;
+            double usPerBlock = 0.0;
+            double load = 0.0;          // share of the block period, 0..1
+            int maxVoices = 0;          // ringing voices of all drums
+        };
+
+        static Benchmark benchmark(int frames = 512, float seconds = 10.f, uint16_t bpm = 125) {
+            using clock = std::chrono::steady_clock;
+            Benchmark result;
+            result.frames = frames = std::max(frames, 16);
+
+            DrumKit kit(true);
+            DrumKitData data = kit.getSettings().getData();
+            data.bpm = bpm;
+            data.kickPat = data.snarePat = data.hiHatClosedPat = 0xFFFF;
+            data.hiHatOpenPat = data.tomPat = data.cymbalsPat = 0xFFFF;
+            kit.getSettings().setData(data);
+
+            const int channels = 2;
+            const int blocks = std::max(1, (int)(seconds * kit.mSampleRate / frames));
+            std::vector<float> buffer((size_t)frames * channels);
+            double totalUs = 0.0;
+            for (int b = 0; b < blocks; b++) {
+                std::fill(buffer.begin(), buffer.end(), 0.f);
+                const auto t0 = clock::now();
+                kit.process(buffer.data(), (int)buffer.size(), channels);
+                totalUs += std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+                const int voices = kit.mKick.activeVoices() + kit.mSnare.activeVoices()
+                    + kit.mHiHatClosed.activeVoices() + kit.mHiHatOpen.activeVoices()
+                    + kit.mTomTom.activeVoices() + kit.mCymbals.activeVoices();
+                result.maxVoices = std::max(result.maxVoices, voices);
+            }
+            result.usPerBlock = totalUs / blocks;
+            result.load = result.usPerBlock / ((double)frames * 1000000.0 / kit.mSampleRate);
+            return result;
+        }
+        //----------------------------------------------------------------------
         // void Trigger() {
         //         mTriggered = true;
         // }
@@ -393,6 +450,7 @@ namespace DSP {
         DrumSynth::HiHatSynth mHiHatOpen;
         DrumSynth::TomSynth mTomTom;
         DrumSynth::CymbalsSynth mCymbals;
+        std::vector<float> mMono;   // render scratch, only grows
 
         double mPhase = 0.0;    // position
         int mCurrentStep = -1;  // triggered step
@@ -70,6 +70,7 @@ class HiHat: public Effect {
 private:
     HiHatSettings mSettings;
     DrumSynth::HiHatSynth mHiHatSynth;
+    std::vector<float> mMono;   // render scratch, only grows
 
 
 
@@ -122,19 +123,15 @@ public:
         const float samplerate = mSampleRate;
 
 
-        for (int i = 0; i < numSamples; i += numChannels) {
-            // generate once
-            float monoOut = 0;
-            monoOut = mHiHatSynth.processSample(pitch, decay, drive, velocity,  samplerate);
+        // nothing is ringing, nothing to add
+        if (!mHiHatSynth.isActive() || numChannels < 1) return;
 
-            // put into channels
-            for (int ch = 0; ch < numChannels; ch++) {
-                int idx = i + ch;
-                if (idx < numSamples) {
-                    buffer[idx] += monoOut;
-                }
-            }
-        }
+        // generate once, then put into channels
+        const int numFrames = DrumSynth::framesOf(numSamples, numChannels);
+        if (mMono.size() < (size_t)numFrames) mMono.resize(numFrames);
+        std::fill(mMono.begin(), mMono.begin() + numFrames, 0.f);
+        mHiHatSynth.render(mMono.data(), numFrames, pitch, decay, drive, velocity, samplerate);
+        DrumSynth::addMonoToChannels(mMono.data(), buffer, numSamples, numChannels);
     }
 
 public:
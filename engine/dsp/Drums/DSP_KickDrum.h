@@ -113,24 +113,21 @@ public:
         const float samplerate = mSampleRate;
 
 
-        for (int i = 0; i < numSamples; i += numChannels) {
-            // generate once
-            float monoOut = 0;
-            monoOut = mKickSynth.processSample(pitch, decay, click, drive, velocity,  samplerate);
-
-            // put into channels
-            for (int ch = 0; ch < numChannels; ch++) {
-                int idx = i + ch;
-                if (idx < numSamples) {
-                    buffer[idx] += monoOut;
-                }
-            }
-        }
+        // nothing is ringing, nothing to add
+        if (!mKickSynth.isActive() || numChannels < 1) return;
+
+        // generate once, then put into channels
+        const int numFrames = DrumSynth::framesOf(numSamples, numChannels);
+        if (mMono.size() < (size_t)numFrames) mMono.resize(numFrames);
+        std::fill(mMono.begin(), mMono.begin() + numFrames, 0.f);
+        mKickSynth.render(mMono.data(), numFrames, pitch, decay, click, drive, velocity, samplerate);
+        DrumSynth::addMonoToChannels(mMono.data(), buffer, numSamples, numChannels);
     }
 
 private:
     KickSettings mSettings;
     DrumSynth::KickSynth mKickSynth;
+    std::vector<float> mMono;   // render scratch, only grows
 
     #ifdef FLUX_ENGINE
     bool mShowKnobs = true;
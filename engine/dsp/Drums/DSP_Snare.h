@@ -70,6 +70,7 @@ class SnareDrum: public Effect {
 private:
     SnareSettings mSettings;
     DrumSynth::SnareSynth mSnareDrumSynth;
+    std::vector<float> mMono;   // render scratch, only grows
 
 
 
@@ -123,19 +124,15 @@ public:
         const float samplerate = mSampleRate;
 
 
-        for (int i = 0; i < numSamples; i += numChannels) {
-            // generate once
-            float monoOut = 0;
-            monoOut = mSnareDrumSynth.processSample(pitch, decay,noise, drive, velocity,  samplerate);
+        // nothing is ringing, nothing to add
+        if (!mSnareDrumSynth.isActive() || numChannels < 1) return;
 
-            // put into channels
-            for (int ch = 0; ch < numChannels; ch++) {
-                int idx = i + ch;
-                if (idx < numSamples) {
-                    buffer[idx] += monoOut;
-                }
-            }
-        }
+        // generate once, then put into channels
+        const int numFrames = DrumSynth::framesOf(numSamples, numChannels);
+        if (mMono.size() < (size_t)numFrames) mMono.resize(numFrames);
+        std::fill(mMono.begin(), mMono.begin() + numFrames, 0.f);
+        mSnareDrumSynth.render(mMono.data(), numFrames, pitch, decay, noise, drive, velocity, samplerate);
+        DrumSynth::addMonoToChannels(mMono.data(), buffer, numSamples, numChannels);
     }
 
 public:
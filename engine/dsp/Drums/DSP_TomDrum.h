@@ -67,6 +67,7 @@ class TomDrum: public Effect {
 private:
     TomDrumSettings mSettings;
     DrumSynth::TomSynth mTomDrumSynth;
+    std::vector<float> mMono;   // render scratch, only grows
 
 
 
@@ -119,19 +120,15 @@ public:
         const float samplerate = mSampleRate;
 
 
-        for (int i = 0; i < numSamples; i += numChannels) {
-            // generate once
-            float monoOut = 0;
-            monoOut = mTomDrumSynth.processSample(pitch, decay, drive, velocity,  samplerate);
+        // nothing is ringing, nothing to add
+        if (!mTomDrumSynth.isActive() || numChannels < 1) return;
 
-            // put into channels
-            for (int ch = 0; ch < numChannels; ch++) {
-                int idx = i + ch;
-                if (idx < numSamples) {
-                    buffer[idx] += monoOut;
-                }
-            }
-        }
+        // generate once, then put into channels
+        const int numFrames = DrumSynth::framesOf(numSamples, numChannels);
+        if (mMono.size() < (size_t)numFrames) mMono.resize(numFrames);
+        std::fill(mMono.begin(), mMono.begin() + numFrames, 0.f);
+        mTomDrumSynth.render(mMono.data(), numFrames, pitch, decay, drive, velocity, samplerate);
+        DrumSynth::addMonoToChannels(mMono.data(), buffer, numSamples, numChannels);
     }
 
 public:
@@ -8,6 +8,25 @@
 //  - HiHatSynth
 //  - TomSynth
 //  - CymbalsSynth
+//  - HighBellSynth
+//-----------------------------------------------------------------------------
+// * every synth has a small voice pool, a new hit starts a new voice while
+//   the last one rings out. When all voices are busy the quietest is taken.
+// * envelope factors exp(-k / (decay * sampleRate)) are cached and only
+//   recomputed when decay or sample rate change (DecayCoeff)
+// * noise is a xorshift per voice (NoiseSource), no global std::rand()
+// * render() adds a whole mono block and skips finished voices,
+//   processSample() is render() for one sample
+// * saturation uses the FastMath tanh table instead of std::tanh
+//
+// Example usage:
+// =============
+//
+// DrumSynth::KickSynth kick;
+// kick.trigger();
+// std::vector<float> mono(frames, 0.f);
+// kick.render(mono.data(), frames, 50.f, 0.3f, 0.5f, 1.f, 1.f, 44100.f);
+// DrumSynth::addMonoToChannels(mono.data(), buffer, numSamples, numChannels);
 //-----------------------------------------------------------------------------
 #pragma once
 
@@ -17,15 +36,106 @@
 #include <algorithm>
 #include <atomic>
 #include <fstream>
-#include <cstdlib>
+#include <cstdint>
 
-#include "../DSP_Math.h" // fast_tanh
+#include "../DSP_Math.h" // FastMath
 
 
 
 namespace DSP {
 namespace DrumSynth {
 
+    constexpr int MAX_VOICES = 4;
+
+    //-----------------------------------------------------------------------------
+    // Xorshift32 white noise, the state must never be zero
+    struct NoiseSource {
+        uint32_t state = 0xACE12345;
+
+        void seed(uint32_t value) { state = value ? value : 0xACE12345; }
+
+        inline uint32_t nextBits() {
+            state ^= (state << 13);
+            state ^= (state >> 17);
+            state ^= (state << 5);
+            return state;
+        }
+        // -1 .. 1
+        inline float next() {
+            return static_cast<int32_t>(nextBits()) * (1.0f / 2147483647.0f);
+        }
+    };
+
+    //-----------------------------------------------------------------------------
+    // per sample factor of an exponential decay: exp(-rate / (decay * sampleRate))
+    class DecayCoeff {
+    public:
+        explicit DecayCoeff(float rate) : mRate(rate) {}
+
+        inline float get(float decay, float sampleRate) {
+            if (decay != mDecay || sampleRate != mSampleRate) {
+                mDecay = decay;
+                mSampleRate = sampleRate;
+                mValue = std::exp(-mRate / (decay * sampleRate));
+            }
+            return mValue;
+        }
+
+    private:
+        float mRate;
+        float mDecay = -1.f;
+        float mSampleRate = -1.f;
+        float mValue = 1.f;
+    };
+
+    //-----------------------------------------------------------------------------
+    // Voice needs: float env; bool active;
+    template<typename Voice>
+    struct VoicePool {
+        Voice voices[MAX_VOICES];
+
+        Voice& allocate() {
+            Voice* quietest = &voices[0];
+            for (Voice& v : voices) {
+                if (!v.active) return v;
+                if (v.env < quietest->env) quietest = &v;
+            }
+            return *quietest;
+        }
+
+        bool isActive() const {
+            for (const Voice& v : voices) if (v.active) return true;
+            return false;
+        }
+
+        int activeCount() const {
+            int count = 0;
+            for (const Voice& v : voices) if (v.active) count++;
+            return count;
+        }
+
+        Voice* begin() { return voices; }
+        Voice* end() { return voices + MAX_VOICES; }
+    };
+
+    //-----------------------------------------------------------------------------
+    // spread a mono block to interleaved channels (adds)
+    inline void addMonoToChannels(const float* mono, float* buffer, int numSamples, int numChannels, float gain = 1.f) {
+        if (numChannels == 1) {
+            for (int i = 0; i < numSamples; i++) buffer[i] += mono[i] * gain;
+            return;
+        }
+        for (int i = 0, frame = 0; i < numSamples; i += numChannels, frame++) {
+            const float v = mono[frame] * gain;
+            for (int ch = 0; ch < numChannels && i + ch < numSamples; ch++) buffer[i + ch] += v;
+        }
+    }
+    //-----------------------------------------------------------------------------
+    // frames in an interleaved buffer, a trailing partial frame counts
+    inline int framesOf(int numSamples, int numChannels) {
+        return numChannels > 0 ? (numSamples + numChannels - 1) / numChannels : 0;
+    }
+
     //-----------------------------------------------------------------------------
     // KickSynt
     // default values :
@@ -45,56 +155,74 @@ namespace DrumSynth {
     class KickSynth {
     public:
         void trigger() {
-            mPhase = 0.0f;
-            mEnvelope = 1.0f; // full volume
-            mPitchEnv = 1.0f; // highest pitch
-            mActive = true;
+            Voice& v = mVoices.allocate();
+            v.phase = 0.0f;
+            v.env = 1.0f; // full volume
+            v.pitchEnv = 1.0f; // highest pitch
+            v.active = true;
         }
 
         void stop() {
             // no chance :P
         }
 
-        float processSample(float pitch, float decay, float click, float drive, float velocity, float sampleRate) {
-            if (!mActive || velocity < 0.01f ) return 0.0f;
-
-            // 1. Envelop
-            float safeDecay = std::max(0.01f, decay);
-            mPitchEnv *= std::exp(-15.0f / (safeDecay * sampleRate));
-            mEnvelope *= std::exp(-1.0f / (safeDecay * sampleRate));
-
-            // 2. Oszillator
-            float dynamicClick = click * (0.5f + 0.5f * velocity);
-            float currentFreq = pitch + (mPitchEnv * dynamicClick * 500.0f);
-
-            float phaseIncrement = currentFreq / sampleRate;
-            mPhase += phaseIncrement;
-            if (mPhase >= 1.0f) mPhase -= 1.0f;
-            float signal = DSP::FastMath::fastSin(mPhase);
+        bool isActive() const { return mVoices.isActive(); }
+        int activeVoices() const { return mVoices.activeCount(); }
 
+        float processSample(float pitch, float decay, float click, float drive, float velocity, float sampleRate) {
+            float out = 0.f;
+            render(&out, 1, pitch, decay, click, drive, velocity, sampleRate);
+            return out;
+        }
 
-            float saturatedSignal = std::tanh(signal * drive);
+        // adds numFrames mono samples to out
+        void render(float* out, int numFrames, float pitch, float decay, float click, float drive, float velocity, float sampleRate) {
+            if (velocity < 0.01f || !isActive()) return;
 
-            // 4. Kill-Switch
-            if (mEnvelope < 0.0001f) {
-                mEnvelope = 0.0f; mPitchEnv = 0.0f; mActive = false; mPhase = 0.0f;
+            // 1. Envelop
+            const float safeDecay = std::max(0.01f, decay);
+            const float pitchFactor = mPitchDecay.get(safeDecay, sampleRate);
+            const float envFactor = mEnvDecay.get(safeDecay, sampleRate);
+
+            const float dynamicClick = click * (0.5f + 0.5f * velocity);
+            const float invSampleRate = 1.0f / sampleRate;
+            // normalize
+            const float outputGain = 1.0f / (1.0f + (drive * 0.2f)) * velocity;
+
+            for (Voice& v : mVoices) {
+                if (!v.active) continue;
+                for (int i = 0; i < numFrames; i++) {
+                    v.pitchEnv *= pitchFactor;
+                    v.env *= envFactor;
+
+                    // 2. Oszillator
+                    const float currentFreq = pitch + (v.pitchEnv * dynamicClick * 500.0f);
+                    v.phase += currentFreq * invSampleRate;
+                    if (v.phase >= 1.0f) v.phase -= 1.0f;
+                    const float signal = DSP::FastMath::fastSin(v.phase);
+
+                    // 4. Kill-Switch
+                    if (v.env < 0.0001f) {
+                        v.env = 0.0f; v.pitchEnv = 0.0f; v.active = false; v.phase = 0.0f;
+                        break;
+                    }
+
+                    // 6. Apply Envelope
+                    out[i] += DSP::FastMath::fastTanh(signal * drive) * v.env * outputGain;
+                }
             }
-
-            // 5. normalize
-            float outputGain = 1.0f / (1.0f + (drive * 0.2f));
-
-            // 6. Apply Envelope
-            float finalSignal = saturatedSignal * mEnvelope;
-
-            return finalSignal * outputGain * velocity;
-
         }
 
     protected:
-        float mPhase = 0.0f;
-        float mEnvelope = 0.0f;
-        float mPitchEnv = 0.0f;
-        bool mActive = false;
+        struct Voice {
+            float phase = 0.0f;
+            float env = 0.0f;
+            float pitchEnv = 0.0f;
+            bool active = false;
+        };
+        VoicePool<Voice> mVoices;
+        DecayCoeff mPitchDecay { 15.0f };
+        DecayCoeff mEnvDecay { 1.0f };
     };
 
     //-----------------------------------------------------------------------------
@@ -125,61 +253,90 @@ namespace DrumSynth {
     //-----------------------------------------------------------------------------
     class SnareSynth {
     public:
+        SnareSynth() {
+            uint32_t seed = 0x5EED1234;
+            for (Voice& v : mVoices) v.noise.seed(seed += 0x9E3779B9);
+        }
+
         void trigger() {
-            mEnvelope = 1.0f;
-            mActive = true;
-            mPhase = 0.0f;
-            mPitchEnv = 0.0f;
+            Voice& v = mVoices.allocate();
+            v.env = 1.0f;
+            v.active = true;
+            v.phase = 0.0f;
+            v.pitchEnv = 0.0f;
         }
 
         // hold
         void stop() {
-            mPitchEnv = 0.f;
-            mEnvelope = 0.0f;
-            mPhase = 0.0f;
-            mActive = false;
+            for (Voice& v : mVoices) {
+                v.pitchEnv = 0.f;
+                v.env = 0.0f;
+                v.phase = 0.0f;
+                v.active = false;
+            }
         }
 
+        bool isActive() const { return mVoices.isActive(); }
+        int activeVoices() const { return mVoices.activeCount(); }
 
         float processSample(float pitch, float decay, float noiseAmount, float drive, float velocity, float sampleRate) {
-            if (!mActive || velocity < 0.01f ) return 0.0f;
+            float out = 0.f;
+            render(&out, 1, pitch, decay, noiseAmount, drive, velocity, sampleRate);
+            return out;
+        }
+
+        void render(float* out, int numFrames, float pitch, float decay, float noiseAmount, float drive, float velocity, float sampleRate) {
+            if (velocity < 0.01f || !isActive()) return;
 
             // 1. Envelopes (Snare needs a faster pitch drop than a kick)
-            float safeDecay = std::max(0.01f, decay);
-            mPitchEnv *= std::exp(-40.0f / (safeDecay * sampleRate)); // Fast snap
-            mEnvelope *= std::exp(-2.5f / (safeDecay * sampleRate));  // Snare decay
-
-            // 2. Oscillator (Body)
-            float currentFreq = pitch + (mPitchEnv * 400.0f);
-            mPhase += currentFreq / sampleRate;
-            if (mPhase >= 1.0f) mPhase -= 1.0f;
-            float body = DSP::FastMath::fastSin(mPhase);
-
-            // 3. Noise (The "Sizzle")
-            // Simple white noise: ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-            float sizzle = ((float)std::rand() / (float)RAND_MAX * 2.0f - 1.0f);
-
-            // High-pass filter for the noise (optional but recommended for "crispy" feel)
-            // float filteredNoise = sizzle - mPrevNoise; mPrevNoise = sizzle; // Simple HP
-
-            // 4. Mix & Saturate
-            float mixed = (body * 0.5f) + (sizzle * noiseAmount);
-            float saturated = std::tanh(mixed * drive * (0.5f + 0.5f * velocity));
-
-            // 5. Kill-Switch (a bit higher for snares to avoid "static" sizzle tail)
-            if (mEnvelope < 0.001f) {
-                mActive = false; mEnvelope = 0.0f; mPhase = 0.0f;
+            const float safeDecay = std::max(0.01f, decay);
+            const float pitchFactor = mPitchDecay.get(safeDecay, sampleRate); // Fast snap
+            const float envFactor = mEnvDecay.get(safeDecay, sampleRate);     // Snare decay
+
+            const float invSampleRate = 1.0f / sampleRate;
+            const float gain = drive * (0.5f + 0.5f * velocity);
+
+            for (Voice& v : mVoices) {
+                if (!v.active) continue;
+                for (int i = 0; i < numFrames; i++) {
+                    v.pitchEnv *= pitchFactor;
+                    v.env *= envFactor;
+
+                    // 2. Oscillator (Body)
+                    const float currentFreq = pitch + (v.pitchEnv * 400.0f);
+                    v.phase += currentFreq * invSampleRate;
+                    if (v.phase >= 1.0f) v.phase -= 1.0f;
+                    const float body = DSP::FastMath::fastSin(v.phase);
+
+                    // 3. Noise (The "Sizzle")
+                    const float sizzle = v.noise.next();
+
+                    // 5. Kill-Switch (a bit higher for snares to avoid "static" sizzle tail)
+                    if (v.env < 0.001f) {
+                        v.active = false; v.env = 0.0f; v.phase = 0.0f;
+                        break;
+                    }
+
+                    // 4. Mix & Saturate
+                    const float mixed = (body * 0.5f) + (sizzle * noiseAmount);
+
+                    // 6. Apply Envelope & Velocity
+                    out[i] += DSP::FastMath::fastTanh(mixed * gain) * v.env * velocity;
+                }
             }
-
-            // 6. Apply Envelope & Velocity
-            return saturated * mEnvelope * velocity;
         }
 
     private:
-        float mPitchEnv = 0.f;
-        float mEnvelope = 0.0f;
-        float mPhase = 0.0f;
-        bool mActive = false;
+        struct Voice {
+            float pitchEnv = 0.f;
+            float env = 0.0f;
+            float phase = 0.0f;
+            NoiseSource noise;
+            bool active = false;
+        };
+        VoicePool<Voice> mVoices;
+        DecayCoeff mPitchDecay { 40.0f };
+        DecayCoeff mEnvDecay { 2.5f };
     };
 
 
@@ -199,63 +356,84 @@ namespace DrumSynth {
     //-----------------------------------------------------------------------------
     class HiHatSynth {
     public:
-        HiHatSynth() : mNoiseState(0xACE12345) {} // IMPORTANT: Seed must be non-zero
+        HiHatSynth(uint32_t seed = 0xACE12345) {
+            for (Voice& v : mVoices) {
+                v.noise.seed(seed);
+                seed += 0x9E3779B9;
+            }
+        }
 
         void trigger() {
-            mEnvelope = 1.0f;
-            mActive = true;
+            Voice& v = mVoices.allocate();
+            v.env = 1.0f;
+            v.active = true;
         }
 
         // used for open hihat when a closed it triggered :D
         void stop() {
-            mEnvelope = 0.0f;
-            mActive = false;
+            for (Voice& v : mVoices) {
+                v.env = 0.0f;
+                v.active = false;
+            }
         }
 
+        bool isActive() const { return mVoices.isActive(); }
+        int activeVoices() const { return mVoices.activeCount(); }
 
         float processSample(float pitch, float decay, float drive, float velocity, float sampleRate) {
-            if (!mActive || velocity < 0.01f) return 0.0f;
+            float out = 0.f;
+            render(&out, 1, pitch, decay, drive, velocity, sampleRate);
+            return out;
+        }
+
+        void render(float* out, int numFrames, float pitch, float decay, float drive, float velocity, float sampleRate) {
+            if (velocity < 0.01f || !isActive()) return;
 
             // 1. Envelope
-            float safeDecay = std::max(0.005f, decay);
-            mEnvelope *= std::exp(-10.0f / (safeDecay * sampleRate));
-
-            // 2. Xorshift (Only works if mNoiseState != 0)
-            mNoiseState ^= (mNoiseState << 13);
-            mNoiseState ^= (mNoiseState >> 17);
-            mNoiseState ^= (mNoiseState << 5);
-
-            // Use unsigned cast for proper 32-bit mapping
-            float noise = (static_cast<float>(mNoiseState) * (1.0f / 2147483647.0f)) - 1.0f;
-
-            // 3. High-pass (Alpha check)
-            // For 12kHz @ 44.1kHz sampleRate, alpha is ~0.27
-            // open hihat :
-            float dynamicPitch = pitch * (1.0f + mEnvelope * 0.05f); // Pitch sinkt leicht mit dem Decay
-            float alpha = std::clamp(dynamicPitch / sampleRate, 0.01f, 0.99f);
-
-            // float alpha = std::clamp(pitch / sampleRate, 0.01f, 0.99f);
-            mFilterState += alpha * (noise - mFilterState);
-            float hihatSignal = noise - mFilterState;
-
-            // 4. Saturation
-            float saturated = std::tanh(hihatSignal * drive * (0.5f + 0.5f * velocity));
-
-            // 5. Kill-Switch
-            if (mEnvelope < 0.001f) {
-                mActive = false;
-                mEnvelope = 0.0f;
-                mFilterState = 0.0f;
+            const float safeDecay = std::max(0.005f, decay);
+            const float envFactor = mEnvDecay.get(safeDecay, sampleRate);
+
+            const float pitchRatio = pitch / sampleRate;
+            const float gain = drive * (0.5f + 0.5f * velocity);
+
+            for (Voice& v : mVoices) {
+                if (!v.active) continue;
+                for (int i = 0; i < numFrames; i++) {
+                    v.env *= envFactor;
+
+                    // 2. Xorshift, unsigned mapping
+                    const float noise = (static_cast<float>(v.noise.nextBits()) * (1.0f / 2147483647.0f)) - 1.0f;
+
+                    // 3. High-pass (Alpha check)
+                    // For 12kHz @ 44.1kHz sampleRate, alpha is ~0.27
+                    // open hihat : Pitch sinkt leicht mit dem Decay
+                    const float alpha = std::clamp(pitchRatio * (1.0f + v.env * 0.05f), 0.01f, 0.99f);
+                    v.filterState += alpha * (noise - v.filterState);
+                    const float hihatSignal = noise - v.filterState;
+
+                    // 5. Kill-Switch
+                    if (v.env < 0.001f) {
+                        v.active = false;
+                        v.env = 0.0f;
+                        v.filterState = 0.0f;
+                        break;
+                    }
+
+                    // 4. Saturation
+                    out[i] += DSP::FastMath::fastTanh(hihatSignal * gain) * v.env * velocity;
+                }
             }
-
-            return saturated * mEnvelope * velocity;
         }
 
     private:
-        float mEnvelope = 0.0f;
-        uint32_t mNoiseState = 0xACE12345; // Use uint32_t and non-zero seed
-        float mFilterState = 0.0f;
-        bool mActive = false;
+        struct Voice {
+            float env = 0.0f;
+            float filterState = 0.0f;
+            NoiseSource noise;
+            bool active = false;
+        };
+        VoicePool<Voice> mVoices;
+        DecayCoeff mEnvDecay { 10.0f };
     };
 
 
@@ -269,51 +447,75 @@ namespace DrumSynth {
     class TomSynth {
     public:
         void trigger() {
-            mPhase = 0.0f;
-            mEnvelope = 1.0f;
-            mPitchEnv = 1.0f;
-            mActive = true;
+            Voice& v = mVoices.allocate();
+            v.phase = 0.0f;
+            v.env = 1.0f;
+            v.pitchEnv = 1.0f;
+            v.active = true;
         }
         // hold - no chance !
         void stop() {
         }
 
+        bool isActive() const { return mVoices.isActive(); }
+        int activeVoices() const { return mVoices.activeCount(); }
 
         float processSample(float pitch, float decay, float drive, float velocity, float sampleRate) {
-            if (!mActive || velocity < 0.01f) return 0.0f;
+            float out = 0.f;
+            render(&out, 1, pitch, decay, drive, velocity, sampleRate);
+            return out;
+        }
+
+        void render(float* out, int numFrames, float pitch, float decay, float drive, float velocity, float sampleRate) {
+            if (velocity < 0.01f || !isActive()) return;
 
             // 1. Envelopes
-            float safeDecay = std::max(0.01f, decay);
+            const float safeDecay = std::max(0.01f, decay);
             // Pitch drops slower than a kick for that "boing"
-            mPitchEnv *= std::exp(-7.0f / (safeDecay * sampleRate));
-            mEnvelope *= std::exp(-1.5f / (safeDecay * sampleRate));
-
-            // 2. Oscillator with Pitch Sweep
-            // Toms have a very characteristic pitch drop
-            float currentFreq = pitch + (mPitchEnv * pitch * 1.5f);
-            mPhase += currentFreq / sampleRate;
-            if (mPhase >= 1.0f) mPhase -= 1.0f;
+            const float pitchFactor = mPitchDecay.get(safeDecay, sampleRate);
+            const float envFactor = mEnvDecay.get(safeDecay, sampleRate);
 
-            float body = DSP::FastMath::fastSin(mPhase);
-
-            // 3. Saturation & Velocity
+            const float invSampleRate = 1.0f / sampleRate;
             // Drive makes it sound like a real drum head being hit hard
-            float saturated = std::tanh(body * drive * (0.7f + 0.3f * velocity));
-
-            // 4. Kill-Switch
-            if (mEnvelope < 0.001f) {
-                mActive = false; mEnvelope = 0.0f; mPhase = 0.0f;
+            const float gain = drive * (0.7f + 0.3f * velocity);
+
+            for (Voice& v : mVoices) {
+                if (!v.active) continue;
+                for (int i = 0; i < numFrames; i++) {
+                    v.pitchEnv *= pitchFactor;
+                    v.env *= envFactor;
+
+                    // 2. Oscillator with Pitch Sweep
+                    // Toms have a very characteristic pitch drop
+                    const float currentFreq = pitch + (v.pitchEnv * pitch * 1.5f);
+                    v.phase += currentFreq * invSampleRate;
+                    if (v.phase >= 1.0f) v.phase -= 1.0f;
+
+                    const float body = DSP::FastMath::fastSin(v.phase);
+
+                    // 4. Kill-Switch
+                    if (v.env < 0.001f) {
+                        v.active = false; v.env = 0.0f; v.phase = 0.0f;
+                        break;
+                    }
+
+                    // 3. Saturation & Velocity
+                    out[i] += DSP::FastMath::fastTanh(body * gain) * v.env * velocity;
+                }
             }
-
-            return saturated * mEnvelope * velocity;
         }
 
 
     private:
-        float mPhase = 0.0f;
-        float mEnvelope = 0.0f;
-        float mPitchEnv = 0.0f;
-        bool mActive = false;
+        struct Voice {
+            float phase = 0.0f;
+            float env = 0.0f;
+            float pitchEnv = 0.0f;
+            bool active = false;
+        };
+        VoicePool<Voice> mVoices;
+        DecayCoeff mPitchDecay { 7.0f };
+        DecayCoeff mEnvDecay { 1.5f };
     };
 
     //-----------------------------------------------------------------------------
@@ -325,84 +527,111 @@ namespace DrumSynth {
     class CymbalsSynth {
     public:
 
-        CymbalsSynth(): mNoiseState(0xACE12345) {};
+        CymbalsSynth() {
+            uint32_t seed = 0xACE12345;
+            for (Voice& v : mVoices) {
+                v.noise.seed(seed);
+                seed += 0x9E3779B9;
+            }
+        }
 
         void trigger() {
-            mEnvelope = 1.0f;
-            mActive = true;
+            Voice& v = mVoices.allocate();
+            v.env = 1.0f;
+            v.active = true;
         }
 
         // hold
         void stop() {
-            mEnvelope = 0.0f;
-            for ( int i = 0; i < 6; ++i) mPhases[i] = 0.0f;
-            mActive = false;
+            for (Voice& v : mVoices) {
+                v.env = 0.0f;
+                for ( int i = 0; i < 6; ++i) v.phases[i] = 0.0f;
+                v.active = false;
+            }
         }
 
+        bool isActive() const { return mVoices.isActive(); }
+        int activeVoices() const { return mVoices.activeCount(); }
 
         float processSample(float pitch, float decay, float drive, float velocity, float sampleRate) {
-            if (!mActive || velocity < 0.01f) return 0.0f;
+            float out = 0.f;
+            render(&out, 1, pitch, decay, drive, velocity, sampleRate);
+            return out;
+        }
+
+        void render(float* out, int numFrames, float pitch, float decay, float drive, float velocity, float sampleRate) {
+            if (velocity < 0.01f || !isActive()) return;
 
             // 1. Envelope (Exponentiell ist gut)
-            mEnvelope *= std::exp(-1.0f / (decay * sampleRate));
+            const float envFactor = mEnvDecay.get(decay, sampleRate);
 
             // 2. METALLIC CORE (The "808-on-Steroids" Approach)
             // Diese Ratios sind bewusst krumm (Primzahlen-nah), um Schwebungen zu vermeiden
             const float ratios[] = { 1.0f, 1.483f, 1.931f, 2.541f, 3.321f, 4.111f };
-            float osc[6];
-
-            for(int i = 0; i < 6; ++i) {
-                mPhases[i] += (pitch * ratios[i]) / sampleRate;
-                if (mPhases[i] >= 1.0f) mPhases[i] -= 1.0f;
-                // Rechteck-Oszillator
-                osc[i] = (mPhases[i] > 0.5f) ? 1.0f : -1.0f;
-            }
-
-            // --- RINGMODULATION & XOR-LOGIK ---
-            // Wir multiplizieren die Oszillatoren paarweise.
-            // Das erzeugt massive Inharmonik (Summen- und Differenztöne).
-            float metalA = osc[0] * osc[1];
-            float metalB = osc[2] * osc[3];
-            float metalC = osc[4] * osc[5];
-
-            // Alles zusammenmischen und durch schnelles "Schneiden" (XOR-artig) verschmutzen
-            float metallic = (metalA + metalB + metalC) * 0.5f;
-            if (metalA > 0.0f) metallic *= -1.0f; // Harte Phasen-Invertierung für mehr Sizzle
-
-            // 3. NOISE GENERATION (Xorshift)
-            mNoiseState ^= (mNoiseState << 13);
-            mNoiseState ^= (mNoiseState >> 17);
-            mNoiseState ^= (mNoiseState << 5);
-            float whiteNoise = (static_cast<int32_t>(mNoiseState) * (1.0f / 2147483647.0f));
-
-            // 4. MIX & FILTER (High-Pass ist Pflicht!)
-            // Becken-Körper (Metallic) + Becken-Rauschen (White Noise)
-            float mixedSource = (metallic * 0.4f) + (whiteNoise * 0.6f);
+            float increments[6];
+            for (int k = 0; k < 6; ++k) increments[k] = (pitch * ratios[k]) / sampleRate;
 
             // Aggressiver High-Pass: Cymbals brauchen Platz untenrum
             // Wir setzen den Cutoff deutlich höher an (z.B. 6-8 kHz)
-            float hpCutoff = std::clamp(pitch * 8.0f, 6000.0f, 18000.0f);
-            float alpha = hpCutoff / (hpCutoff + sampleRate / (2.0f * 3.14159f));
-
-            mFilterState = alpha * (mFilterState + mixedSource - mLastInput);
-            float cymbalSignal = mFilterState;
-            mLastInput = mixedSource;
-
-            // 5. SATURATION (Verklebt die Oszillatoren zu einem Teppich)
-            float saturated = std::tanh(cymbalSignal * drive * (1.0f + velocity));
-
-            if (mEnvelope < 0.0001f) { mActive = false; mEnvelope = 0.0f; }
-
-            return saturated * mEnvelope * velocity * 0.5f;
+            const float hpCutoff = std::clamp(pitch * 8.0f, 6000.0f, 18000.0f);
+            const float alpha = hpCutoff / (hpCutoff + sampleRate / (2.0f * 3.14159f));
+            const float gain = drive * (1.0f + velocity);
+
+            for (Voice& v : mVoices) {
+                if (!v.active) continue;
+                for (int i = 0; i < numFrames; i++) {
+                    v.env *= envFactor;
+
+                    float osc[6];
+                    for (int k = 0; k < 6; ++k) {
+                        v.phases[k] += increments[k];
+                        if (v.phases[k] >= 1.0f) v.phases[k] -= 1.0f;
+                        // Rechteck-Oszillator
+                        osc[k] = (v.phases[k] > 0.5f) ? 1.0f : -1.0f;
+                    }
+
+                    // --- RINGMODULATION & XOR-LOGIK ---
+                    // Wir multiplizieren die Oszillatoren paarweise.
+                    // Das erzeugt massive Inharmonik (Summen- und Differenztöne).
+                    const float metalA = osc[0] * osc[1];
+                    const float metalB = osc[2] * osc[3];
+                    const float metalC = osc[4] * osc[5];
+
+                    // Alles zusammenmischen und durch schnelles "Schneiden" (XOR-artig) verschmutzen
+                    float metallic = (metalA + metalB + metalC) * 0.5f;
+                    if (metalA > 0.0f) metallic *= -1.0f; // Harte Phasen-Invertierung für mehr Sizzle
+
+                    // 3. NOISE GENERATION (Xorshift)
+                    const float whiteNoise = v.noise.next();
+
+                    // 4. MIX & FILTER (High-Pass ist Pflicht!)
+                    // Becken-Körper (Metallic) + Becken-Rauschen (White Noise)
+                    const float mixedSource = (metallic * 0.4f) + (whiteNoise * 0.6f);
+                    v.filterState = alpha * (v.filterState + mixedSource - v.lastInput);
+                    v.lastInput = mixedSource;
+
+                    if (v.env < 0.0001f) {
+                        v.active = false; v.env = 0.0f;
+                        break;
+                    }
+
+                    // 5. SATURATION (Verklebt die Oszillatoren zu einem Teppich)
+                    out[i] += DSP::FastMath::fastTanh(v.filterState * gain) * v.env * velocity * 0.5f;
+                }
+            }
         }
 
     private:
-        float mEnvelope = 0.0f;
-        float mFilterState = 0.f;
-        bool mActive = false;
-        float mPhases[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
-        uint32_t mNoiseState = 0xACE12345;
-        float mLastInput = 0.f;
+        struct Voice {
+            float env = 0.0f;
+            float filterState = 0.f;
+            float phases[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+            float lastInput = 0.f;
+            NoiseSource noise;
+            bool active = false;
+        };
+        VoicePool<Voice> mVoices;
+        DecayCoeff mEnvDecay { 1.0f };
     };
     //-----------------------------------------------------------------------------
     //-----------------------------------------------------------------------------
@@ -414,63 +643,83 @@ namespace DrumSynth {
     class HighBellSynth {
     public:
         void trigger() {
-            mEnvelope = 1.0f;
-            mActive = true;
+            Voice& v = mVoices.allocate();
+            v.env = 1.0f;
+            v.active = true;
         }
 
         // hold
         void stop() {
-            mEnvelope = 0.0f;
-            for ( int i = 0; i < 6; ++i) mPhases[i] = 0.0f;
-            mActive = false;
+            for (Voice& v : mVoices) {
+                v.env = 0.0f;
+                for ( int i = 0; i < 6; ++i) v.phases[i] = 0.0f;
+                v.active = false;
+            }
         }
 
+        bool isActive() const { return mVoices.isActive(); }
+        int activeVoices() const { return mVoices.activeCount(); }
 
         float processSample(float pitch, float decay, float drive, float velocity, float sampleRate) {
-            if (!mActive || velocity < 0.01f) return 0.0f;
+            float out = 0.f;
+            render(&out, 1, pitch, decay, drive, velocity, sampleRate);
+            return out;
+        }
+
+        void render(float* out, int numFrames, float pitch, float decay, float drive, float velocity, float sampleRate) {
+            if (velocity < 0.01f || !isActive()) return;
 
             // 1. Long Decay for Cymbals
-            float safeDecay = std::max(0.1f, decay);
-            mEnvelope *= std::exp(-0.8f / (safeDecay * sampleRate));
+            const float safeDecay = std::max(0.1f, decay);
+            const float envFactor = mEnvDecay.get(safeDecay, sampleRate);
 
             // 2. Metallic Noise (6 FM Oscillators)
             // Classic TR-808 style: 6 square waves with weird ratios
-            float frequencies[] = { 1.1f, 1.45f, 1.91f, 2.3f, 2.73f, 3.14f };
-            float metallicNoise = 0.0f;
-
-            for(int i = 0; i < 6; ++i) {
-                mPhases[i] += (pitch * frequencies[i]) / sampleRate;
-                if (mPhases[i] >= 1.0f) mPhases[i] -= 1.0f;
-                metallicNoise += (mPhases[i] > 0.5f) ? 1.0f : -1.0f; // Square waves
-            }
+            const float frequencies[] = { 1.1f, 1.45f, 1.91f, 2.3f, 2.73f, 3.14f };
+            float increments[6];
+            for (int k = 0; k < 6; ++k) increments[k] = (pitch * frequencies[k]) / sampleRate;
 
             // 3. High-Pass Filter (Crucial for Cymbals)
-            float alpha = std::clamp((pitch * 0.5f) / sampleRate, 0.01f, 0.95f);
-            mFilterState += alpha * (metallicNoise - mFilterState);
-            float cymbalSignal = metallicNoise - mFilterState;
-
-            // 4. Drive & Velocity
+            const float alpha = std::clamp((pitch * 0.5f) / sampleRate, 0.01f, 0.95f);
             // Drive "smears" the frequencies into a wash
-            float saturated = std::tanh(cymbalSignal * drive * (0.4f + 0.6f * velocity));
-
-            // 5. Kill-Switch
-            if (mEnvelope < 0.0005f) {
-                mActive = false; mEnvelope = 0.0f;
+            const float gain = drive * (0.4f + 0.6f * velocity);
+
+            for (Voice& v : mVoices) {
+                if (!v.active) continue;
+                for (int i = 0; i < numFrames; i++) {
+                    v.env *= envFactor;
+
+                    float metallicNoise = 0.0f;
+                    for (int k = 0; k < 6; ++k) {
+                        v.phases[k] += increments[k];
+                        if (v.phases[k] >= 1.0f) v.phases[k] -= 1.0f;
+                        metallicNoise += (v.phases[k] > 0.5f) ? 1.0f : -1.0f; // Square waves
+                    }
+
+                    v.filterState += alpha * (metallicNoise - v.filterState);
+                    const float cymbalSignal = metallicNoise - v.filterState;
+
+                    // 5. Kill-Switch
+                    if (v.env < 0.0005f) {
+                        v.active = false; v.env = 0.0f;
+                        break;
+                    }
+
+                    // 4. Drive & Velocity
+                    out[i] += DSP::FastMath::fastTanh(cymbalSignal * gain) * v.env * velocity * 0.3f; // Reduced base gain
+                }
             }
-
-            return saturated * mEnvelope * velocity * 0.3f; // Reduced base gain
         }
 
     private:
-        float mEnvelope = 0.0f;
-        float mFilterState = 0.f;
-        bool mActive = false;
-        float mPhases[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
-
-        // float mLastOut = 0.0f;
-        // float mLastIn = 0.0f;
-
+        struct Voice {
+            float env = 0.0f;
+            float filterState = 0.f;
+            float phases[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+            bool active = false;
+        };
+        VoicePool<Voice> mVoices;
+        DecayCoeff mEnvDecay { 0.8f };
     };
 
 };}; //namespaces
-
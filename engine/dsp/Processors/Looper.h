@@ -269,7 +269,7 @@ namespace Processors {
         bool bufferFilled() { return mBufferLength > 0 && !mLoopBuffers.empty();}
         int  getBPM() const { return mBeatsPerMinute;};
         //----------------------------------------------------------------------
-        LooperMode  getMode() { return mMode;}
+        LooperMode  getMode() const { return mMode;}
         bool setMode(LooperMode mode) {
             // why ? if (mBufferLength == 0) return false;
             mMode = mode;
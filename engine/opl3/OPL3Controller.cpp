@@ -7,17 +7,63 @@
 #include "opl3_base.h"
 #include "OPL3Instruments.h"
 #include <mutex>
+#include <chrono>
 
 #ifdef FLUX_ENGINE
 #include <audio/fluxAudio.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OPL3_MIX_SSE
+#endif
+
+//------------------------------------------------------------------------------
+// ymfm output of a few chips to float stereo, the 4 outputs fold to 0+2 = Left
+// and 1+3 = Right. Returns false if every sample is 0 (silence check).
+using ChipOutput = ymfm::ymf262::output_data;
+static_assert(sizeof(ChipOutput) == 4 * sizeof(int32_t), "ymf262 output is expected as 4 packed int32");
+
+static inline bool mixChipBlocks(float* dst, const ChipOutput* const* blocks, int numBlocks, int frames, float scale)
+{
+    int i = 0;
+    int32_t any = 0;
+#ifdef OPL3_MIX_SSE
+    // two frames per step: a0 a1 a2 a3 | b0 b1 b2 b3 => a0+a2 a1+a3 b0+b2 b1+b3
+    const __m128 s = _mm_set1_ps(scale);
+    __m128i anyBits = _mm_setzero_si128();
+    for (; i + 2 <= frames; i += 2) {
+        __m128i acc = _mm_setzero_si128();
+        for (int b = 0; b < numBlocks; b++) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks[b][i].data));
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks[b][i + 1].data));
+            acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_unpacklo_epi64(a, c), _mm_unpackhi_epi64(a, c)));
+        }
+        anyBits = _mm_or_si128(anyBits, acc);
+        _mm_storeu_ps(dst + i * 2, _mm_mul_ps(_mm_cvtepi32_ps(acc), s));
+    }
+    any = (_mm_movemask_epi8(_mm_cmpeq_epi32(anyBits, _mm_setzero_si128())) != 0xFFFF);
+#endif
+    for (; i < frames; i++) {
+        int32_t left = 0, right = 0;
+        for (int b = 0; b < numBlocks; b++) {
+            left  += blocks[b][i].data[0] + blocks[b][i].data[2];
+            right += blocks[b][i].data[1] + blocks[b][i].data[3];
+        }
+        any |= left | right;
+        dst[i * 2]     = (float)left * scale;
+        dst[i * 2 + 1] = (float)right * scale;
+    }
+    return any != 0;
+}
+
 //------------------------------------------------------------------------------
 OPL3Controller::OPL3Controller(){
 
-    mChip = new ymfm::ymf262(mInterface);//OPL3
-    uint32_t master_clock = 14318180;
-    mOutputSampleRate = mChip->sample_rate(master_clock);
+    mChips.push_back(std::make_unique<ChipState>());
+    mChips[0]->block.resize(NATIVE_BLOCK);
+    mChipTasks.push_back({ &ChipState::renderTask, mChips[0].get() });
+    mOutputSampleRate = mChips[0]->chip.sample_rate(MASTER_CLOCK);
 
     Log("OPL SampleRate is: %d" , mOutputSampleRate );
 
@@ -26,11 +72,13 @@ OPL3Controller::OPL3Controller(){
     m_lastSampleR = 0.f;
 
     mF32Buffer.resize(MAX_FRAMES * 2);
+    mNativeMix.resize(NATIVE_BLOCK * 2);
 
     reset();
 }
 //------------------------------------------------------------------------------
 OPL3Controller::~OPL3Controller(){
+    stopKeyframes();
     stopSong();
     detachAudio();
     if (mStream) {
@@ -39,57 +87,33 @@ OPL3Controller::~OPL3Controller(){
         SDL_DestroyAudioStream(mStream);
         mStream = nullptr;
     }
+}
+//------------------------------------------------------------------------------
+// runs on mStreamWorker, queuedFrames still wait in mStream
+void OPL3Controller::renderStream(void* user, float* buffer, int frames, int queuedFrames) {
+    auto* controller = static_cast<OPL3Controller*>(user);
+    const bool active = controller->isAnyVoiceActive();
 
-    if (mChip) {
-        delete mChip;
-        mChip = nullptr;
+    // Fill Buffer
+    {
+        RenderScope scope(*controller);
+        controller->mStreamQueuedFrames = queuedFrames;
+        controller->fillBuffer(buffer, frames);
+    }
+    // DSP Effects
+    if (active)
+    {
+        DSP::processChain(controller->mDspEffects, buffer, frames * 2, 2);
     }
 }
 //------------------------------------------------------------------------------
-// mhh switched to push but voiceactive check is gone ... and higher load
-void OPL3Controller::DecoderWorker() {
-
-    const float cacheSec = 0.100f;
-    const int targetQueueSize = (int)(cSampleRate * 2 * sizeof(float) * cacheSec);
-    OPL3Controller* controller = this;
-    int totalFrames = MAX_FRAMES;
-    int totalSamples = totalFrames * 2;
-    float* f32Buffer = controller->mF32Buffer.data();
-    bool active = false;
-
-    while (mDecoderThreadRunning.load()) {
-        active = controller->isAnyVoiceActive();
-        if (SDL_GetAudioStreamQueued(mStream) < targetQueueSize) {
-
-            // Fill Buffer
-            {
-                std::lock_guard<std::recursive_mutex> lock(controller->mDataMutex);
-                controller->fillBuffer(f32Buffer, totalFrames);
-            }
-            // DSP Effects
-            if (active)
-            {
-                for (auto& effect : controller->mDspEffects) {
-                    effect->process(f32Buffer, totalSamples, 2);
-                }
-            }
-            SDL_PutAudioStreamData(mStream, f32Buffer, MAX_FRAMES * 8);
-        } else {
-           std::this_thread::sleep_for(std::chrono::milliseconds( 25 ));
-        }
-
-        if (!active) {
-            std::this_thread::sleep_for(std::chrono::milliseconds( 100 ));
-            // dLog("Long sleep");
-        }
-
-
-    } //while ...
-
-
+void OPL3Controller::startStreamWorker() {
+    if (!mStream || mStreamWorker.isRunning()) return;
+    mQueueWrites.store( true );
+    mStreamWorker.start(mStream, 2, cSampleRate, &OPL3Controller::renderStream, this, MAX_FRAMES);
 }
 //------------------------------------------------------------------------------
-// 2026-05-13 replaced by DecoderWorker!
+// 2026-05-13 replaced by DecoderWorker, now mStreamWorker!
 // void SDLCALL OPL3Controller::audio_callback(void* userdata, SDL_AudioStream *stream, int additional_amount, int total_amount) {
 //     auto* controller = static_cast<OPL3Controller*>(userdata);
 //     if (!controller || additional_amount <= 0) return;
@@ -150,9 +174,8 @@ bool OPL3Controller::initController()
         return false;
     }
 
-    // start DecoderWorker
-    mDecoderThreadRunning.store( true );
-    mDecoderThread = std::thread([this]() { DecoderWorker(); });
+    mStreamWorker.setTargetLatency(STREAM_LATENCY_SEC);
+    startStreamWorker();
 
     // SDL_SetAudioStreamGetCallback(mStream, OPL3Controller::audio_callback, this);
 
@@ -176,6 +199,31 @@ bool OPL3Controller::initController()
 
     SDL_ResumeAudioStreamDevice(mStream);
 
+    initRenderChain();
+
+    Log("OPL3 Controller initialized..");
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool OPL3Controller::initHeadless()
+{
+    if ( mStream || !mDspEffects.empty() ) {
+        Log("[error] OPL3Controller::initHeadless controller is already initialized!");
+        return false;
+    }
+
+    initRenderChain();
+
+    Log("OPL3 Controller initialized (headless)..");
+
+    return true;
+}
+//------------------------------------------------------------------------------
+// output rate and DSP chain, shared by initController and initHeadless
+void OPL3Controller::initRenderChain()
+{
     m_step = (double)mOutputSampleRate / (double)cSampleRate;
 
     // Digital post processing
@@ -196,16 +244,14 @@ bool OPL3Controller::initController()
     mLimiter = DSP::addEffectToChain<DSP::Limiter>(mDspEffects, false);
     // --- End of Initialization ---
     // ------------------------
-
-    Log("OPL3 Controller initialized..");
-
-    return true;
 }
-
 //------------------------------------------------------------------------------
 bool OPL3Controller::shutDownController()
 {
+    // stop the render thread before the stream it writes to goes away
+    detachAudio();
     if (mStream) {
+        SDL_SetAudioStreamGetCallback(mStream, NULL, NULL);
         SDL_DestroyAudioStream(mStream);
         mStream = nullptr;
     }
@@ -214,24 +260,14 @@ bool OPL3Controller::shutDownController()
     return true;
 }
 //------------------------------------------------------------------------------
-bool OPL3Controller::checkAnyVoiceActive(float* buffer, int total_frames) {
+bool OPL3Controller::checkAnyVoiceActive(bool bufferHasSound, int total_frames) {
     // 1. If sequencer is playing, we are ALWAYS active.
     if (mTrackerState.playing) return true;
 
     // 2. Wake-up override (from playNoteByFNumHW)
     if (isAnyVoiceActive()) {
 
-        // 3. Scan the buffer we JUST filled to see if there is any sound
-        bool bufferHasSound = false;
-        const float EPSILON = 0.00001f; // Ignore digital floor noise
-
-        for (int i = 0; i < total_frames * 2; ++i) {
-            if (std::abs(buffer[i]) > EPSILON) {
-                bufferHasSound = true;
-                break;
-            }
-        }
-
+        // 3. generate() saw a sample != 0 in the buffer we JUST filled
         if (bufferHasSound) {
             mSilenceCounter = 0;
             return true;
@@ -249,26 +285,71 @@ bool OPL3Controller::checkAnyVoiceActive(float* buffer, int total_frames) {
     return false;
 }
 //------------------------------------------------------------------------------
-void OPL3Controller::generate(float* buffer, int frames) {
+bool OPL3Controller::renderChips(float* out, int nativeFrames) {
     const float inv32768 = 1.0f / 32768.0f;
-    for (int i = 0; i < frames; ++i) {
-        mChip->generate(&mOutput);
+    const int numChips = (int)mChips.size();
+    const ChipOutput* blocks[MAX_CHIPS];
+
+    for (int c = 0; c < numChips; c++)
+        blocks[c] = mChips[c]->block.data();
+
+    int done = 0;
+    while (done < nativeFrames) {
+        // apply the queued writes that are due, render up to the next one
+        int frames = nativeFrames - done;
+        while (const opl3::RegisterWrite* write = mWriteQueue.peek()) {
+            if (write->frame > mNativeFrame) {
+                frames = (int)std::min<uint64_t>(frames, write->frame - mNativeFrame);
+                break;
+            }
+            applyWrite(*write);
+            mWriteQueue.pop();
+        }
 
-        // Convert to float while mixing
-        float L = (mOutput.data[0] + mOutput.data[2]) * inv32768;
-        float R = (mOutput.data[1] + mOutput.data[3]) * inv32768;
+        for (auto& chip : mChips) {
+            chip->offset = done;
+            chip->frames = frames;
+        }
+
+        // every chip renders its own block, then one pass mixes them
+        if (numChips > 1 && mChipWorkers && mChipThreads) {
+            mChipWorkers->run(mChipTasks.data(), (uint32_t)numChips);
+        } else {
+            for (auto& chip : mChips) chip->render();
+        }
 
-        // Direct write to float buffer
-        *buffer++ = L;
-        *buffer++ = R;
+        done += frames;
+        mNativeFrame += frames;
     }
+
+    return mixChipBlocks(out, blocks, numChips, nativeFrames, inv32768);
+}
+//------------------------------------------------------------------------------
+// returns false if all frames are silent
+bool OPL3Controller::generate(float* buffer, int frames) {
+    bool sound = false;
+    while (frames > 0) {
+        const int block = std::min(frames, NATIVE_BLOCK);
+        sound |= renderChips(buffer, block);
+        buffer += block * 2;
+        frames -= block;
+    }
+    return sound;
 }
 //------------------------------------------------------------------------------
 void OPL3Controller::fillBuffer(float* buffer, int total_frames)
 {
-    const float inv32768 = 1.0f / 32768.0f;
     int buffer_offset = 0;
 
+    // producers stamp their writes relative to the frame heard now: the
+    // rendered frames minus what still waits in the stream
+    const double nativePerFrame = mTrackerState.playing ? getStep() : 1.0;
+    const uint64_t queuedNative = (uint64_t)(mStreamQueuedFrames * nativePerFrame);
+    mClockFrame.store(mNativeFrame > queuedNative ? mNativeFrame - queuedNative : 0, std::memory_order_relaxed);
+    mClockRate.store(cSampleRate * nativePerFrame, std::memory_order_relaxed);
+    mClockNanos.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count(), std::memory_order_release);
+
     // if (!isAnyVoiceActive() && !mTrackerState.playing) {
     //     std::memset(buffer, 0, total_frames * sizeof(float) * 2);
     //     return;
@@ -276,8 +357,8 @@ void OPL3Controller::fillBuffer(float* buffer, int total_frames)
 
     // If not playing a song, but manual notes are active
     if (!mTrackerState.playing) {
-        this->generate(buffer, total_frames);
-        this->checkAnyVoiceActive(buffer, total_frames);
+        const bool sound = this->generate(buffer, total_frames);
+        this->checkAnyVoiceActive(sound, total_frames);
         return;
     }
 
@@ -289,28 +370,43 @@ void OPL3Controller::fillBuffer(float* buffer, int total_frames)
         double samples_until_tick = mTrackerState.samples_per_tick - mTrackerState.sample_accumulator;
         int chunk = std::min(frames_left, (int)std::max(1.0, samples_until_tick));
 
-        // 2. Generate and Resample this chunk
-        for (int i = 0; i < chunk; i++) {
-            m_opl3_accumulator += step;
-
-            // Generate new OPL3 data only when needed
-            while (m_opl3_accumulator >= 1.0) {
-                mChip->generate(&mOutput);
-                // Mix and convert to float IMMEDIATELY
-                // OPL3 uses 4-channel output usually mapped: 0+2 = Left, 1+3 = Right
-                m_lastSampleL = (mOutput.data[0] + mOutput.data[2]) * inv32768;
-                m_lastSampleR = (mOutput.data[1] + mOutput.data[3]) * inv32768;
-                m_opl3_accumulator -= 1.0;
+        // 2. Generate and Resample this chunk, in blocks of RENDER_BLOCK frames
+        for (int done = 0; done < chunk; ) {
+            const int frames = std::min(chunk - done, RENDER_BLOCK);
+
+            // Count the OPL3 samples this block needs (sample and hold)
+            int native = 0;
+            for (int i = 0; i < frames; i++) {
+                m_opl3_accumulator += step;
+                while (m_opl3_accumulator >= 1.0) {
+                    native++;
+                    m_opl3_accumulator -= 1.0;
+                }
+                mHoldIndex[i] = (int16_t)(native - 1); // -1: keep the last sample
             }
+
+            renderChips(mNativeMix.data(), native);
+
             // Write the stored float values to the buffer
-            buffer[(buffer_offset + i) * 2]     = m_lastSampleL;
-            buffer[(buffer_offset + i) * 2 + 1] = m_lastSampleR;
+            float* out = buffer + (buffer_offset + done) * 2;
+            for (int i = 0; i < frames; i++) {
+                if (mHoldIndex[i] >= 0) {
+                    m_lastSampleL = mNativeMix[mHoldIndex[i] * 2];
+                    m_lastSampleR = mNativeMix[mHoldIndex[i] * 2 + 1];
+                }
+                *out++ = m_lastSampleL;
+                *out++ = m_lastSampleR;
+            }
+            done += frames;
         }
 
         // 3. Update Sequencer state
         mTrackerState.sample_accumulator += chunk;
         if (mTrackerState.sample_accumulator >= mTrackerState.samples_per_tick) {
-            this->tickSequencer();
+            // the note functions may run on the gui now, never held while rendering
+            NoteLock lock(*this);
+            if (mTimelineActive) this->stepTimeline();
+            else this->tickSequencer();
             mTrackerState.sample_accumulator -= mTrackerState.samples_per_tick;
         }
 
@@ -412,17 +508,7 @@ void OPL3Controller::tickSequencer() {
                     mTrackerState.orderIdx = 0; //restart on loop
                 } else {
                     // Stop!
-                    // dont i have a function for that ?!
-                    mTrackerState.playing = false;
-                    mTrackerState.orderIdx = 0;
-                    this->silenceAll(true);
-                    for (int i = 0; i < MAX_HW_CHANNELS; ++i) {
-                        mTrackerState.last_steps[i] = {};
-                    }
-                    mTrackerState.ui_dirty = true;
-
-                    // i reset playRange also !!
-                    mTrackerState.playRange.init();
+                    this->endSong();
                 } // stopped
             } // end reached
 
@@ -444,6 +530,566 @@ void OPL3Controller::tickSequencer() {
         } // last row reached
     } //tick checker
 }
+//------------------------------------------------------------------------------
+// the song reached its end, stepTimeline runs it at the END tick
+void OPL3Controller::endSong() {
+    mTrackerState.playing = false;
+    mTrackerState.orderIdx = 0;
+    // a compile leaves the silence to playback. Only the song chip, the
+    // live voices on the other chips play on
+    if (!mCapture) this->silenceChips(true, 1);
+    for (int i = 0; i < MAX_HW_CHANNELS; ++i) {
+        mTrackerState.last_steps[i] = {};
+    }
+    mTrackerState.ui_dirty = true;
+
+    // i reset playRange also !!
+    mTrackerState.playRange.init();
+}
+//------------------------------------------------------------------------------
+// replaces tickSequencer while a compiled song plays
+void OPL3Controller::stepTimeline() {
+    if (!mTrackerState.playing) return;
+    const opl3::SongTimeline& timeline = *mTimeline;
+
+    // somebody moved the position: go on from there
+    const bool inSync = (mTimelineTick == 0)
+        ? (mTrackerState.orderIdx == 0 && mTrackerState.rowIdx == 0 && mTrackerState.current_tick == 0)
+        : (timeline.ticks[mTimelineTick - 1].orderIdx == mTrackerState.orderIdx
+           && timeline.ticks[mTimelineTick - 1].rowIdx == mTrackerState.rowIdx
+           && timeline.ticks[mTimelineTick - 1].tick == mTrackerState.current_tick);
+    if (!inSync)
+        mTimelineTick = mapTimelineTick(mCompiled, timeline, mTimelineTick >= timeline.passTicks);
+
+    if (mTimelineTick >= timeline.ticks.size()) {
+        mTimelineActive = false;
+        this->tickSequencer();
+        return;
+    }
+
+    const size_t index = mTimelineTick++;
+    for (const opl3::TimelineEvent* event = timeline.eventsBegin(index); event != timeline.eventsEnd(index); ++event) {
+        if (event->kind == opl3::TimelineEvent::STEP) {
+            mTrackerState.last_steps[event->reg] = timeline.steps[event->value];
+            continue;
+        }
+        if (event->chip >= mChips.size()) continue;
+        if (event->kind == opl3::TimelineEvent::CLOCK) {
+            mChips[event->chip]->chip.generate(&mOutput);
+        } else {
+            mChips[event->chip]->shadowRegs[event->reg].store((uint8_t)event->value, std::memory_order_relaxed);
+            applyWrite({ 0, event->reg, (uint8_t)event->value, event->chip });
+        }
+    }
+
+    const opl3::TimelineTick& tick = timeline.ticks[index];
+    mTrackerState.orderIdx = tick.orderIdx;
+    mTrackerState.rowIdx = tick.rowIdx;
+    mTrackerState.current_tick = tick.tick;
+    if (tick.flags & opl3::TimelineTick::DIRTY) mTrackerState.ui_dirty = true;
+
+    if (tick.flags & opl3::TimelineTick::END) {
+        mTimelineActive = false;
+        this->endSong();
+    } else if (tick.flags & opl3::TimelineTick::LOOP) {
+        // a loop which never settles goes on with the live sequencer
+        if (timeline.loopTick != opl3::SongTimeline::NO_LOOP) mTimelineTick = timeline.loopTick;
+        else mTimelineActive = false;
+    }
+}
+//------------------------------------------------------------------------------
+// next tick for the tracker position, a position outside of it ends the walk
+size_t OPL3Controller::mapTimelineTick(const SongCompile& compiled, const opl3::SongTimeline& timeline, bool secondPass) const {
+    const size_t orderCount = compiled.orderList.size();
+    size_t segment = mTrackerState.orderIdx;
+    if (secondPass && compiled.segments.size() > orderCount + segment) segment += orderCount;
+    if (segment >= compiled.segments.size()) return timeline.ticks.size();
+
+    const size_t first = compiled.segments[segment].firstTick;
+    const size_t end = (segment + 1 < compiled.segments.size()) ? compiled.segments[segment + 1].firstTick : timeline.ticks.size();
+    const size_t index = first + (size_t)mTrackerState.rowIdx * compiled.ticksPerRow + mTrackerState.current_tick;
+    return (index < end) ? index : timeline.ticks.size();
+}
+//------------------------------------------------------------------------------
+// FNV-1a over the played fields of a pattern
+static uint64_t hashPattern(const opl3::Pattern& pattern) {
+    uint64_t hash = opl3::FNV1A_OFFSET;
+    auto add = [&hash](uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= opl3::FNV1A_PRIME;
+        }
+    };
+    add(pattern.getRowCount());
+    add(pattern.getColCount());
+    for (const SongStep& step : pattern) {
+        add(step.note | (step.volume << 8) | (step.panning << 16) | ((uint32_t)step.effectType << 24));
+        add(step.instrument | ((uint32_t)step.effectVal << 16));
+    }
+    return hash;
+}
+//------------------------------------------------------------------------------
+double OPL3Controller::calcSamplesPerTick(const SongData& songData) const {
+    double hostRate = (double) cSampleRate;
+
+    // orig: double ticks_per_sec = songData.bpm * 0.4;
+
+    //TEST sync BPM / 6 magic number from ticksPerRow
+    //FIXEM speed effect this must be a function to calulate
+    double ticks_per_sec = songData.bpm * 0.4 * songData.ticksPerRow * 0.166666666f;
+
+    // At 125 BPM: 44100 / 50 = 882 samples per tick
+    return (ticks_per_sec > 0) ? hostRate / ticks_per_sec : hostRate;
+}
+//------------------------------------------------------------------------------
+OPL3Controller::CompileState OPL3Controller::saveCompileState(uint64_t frame, double accumulator) {
+    CompileState state;
+    for (int i = 0; i < 512; i++)
+        state.shadowRegs[i] = mChips[0]->shadowRegs[i].load(std::memory_order_relaxed);
+    std::copy(std::begin(mTrackerState.last_steps), std::end(mTrackerState.last_steps), state.lastSteps);
+    state.frame = frame;
+    state.accumulator = accumulator;
+    return state;
+}
+
+void OPL3Controller::loadCompileState(const CompileState& state) {
+    for (int i = 0; i < 512; i++)
+        mChips[0]->shadowRegs[i].store(state.shadowRegs[i], std::memory_order_relaxed);
+    std::copy(std::begin(state.lastSteps), std::end(state.lastSteps), mTrackerState.last_steps);
+}
+
+bool OPL3Controller::sameCompileState(const CompileState& a, const CompileState& b) {
+    if (std::memcmp(a.shadowRegs, b.shadowRegs, sizeof(a.shadowRegs)) != 0) return false;
+    return std::equal(std::begin(a.lastSteps), std::end(a.lastSteps), std::begin(b.lastSteps));
+}
+//------------------------------------------------------------------------------
+// Runs the sequencer on mSongCompiler and records its writes per tick.
+// Orders before the first changed one and, once the state matches again,
+// the ones after the last changed one are taken from the last timeline.
+// timeline stays empty if nothing changed.
+bool OPL3Controller::buildTimeline(const SongData& songData, bool loop, const CompileState& start,
+                                   std::unique_ptr<opl3::SongTimeline>& timeline, SongCompile& compiled)
+{
+    const size_t orderCount = songData.orderList.size();
+    if (orderCount == 0) return false;
+
+    if (!mSongCompiler) mSongCompiler = std::make_unique<OPL3Controller>();
+    OPL3Controller& compiler = *mSongCompiler;
+
+    std::vector<uint64_t> hashes(songData.patterns.size());
+    for (size_t i = 0; i < songData.patterns.size(); i++)
+        hashes[i] = hashPattern(songData.patterns[i]);
+
+    // orders played differently since the last compile, all if the setup changed
+    const SongCompile& old = mCompiled;
+    size_t firstDirty = 0;
+    size_t lastDirtySegment = SIZE_MAX;
+    const bool sameSetup = mTimeline && old.song == &songData && old.loop == loop
+        && old.bpm == songData.bpm && old.ticksPerRow == songData.ticksPerRow
+        && old.orderList.size() == orderCount && old.segments.size() >= orderCount
+        && compiler.mSoundBank == mSoundBank && sameCompileState(old.start, start);
+    if (sameSetup) {
+        size_t lastDirty = 0;
+        firstDirty = orderCount;
+        for (size_t o = 0; o < orderCount; o++) {
+            const uint8_t pat = songData.orderList[o];
+            if (pat != old.orderList[o] || pat >= old.patternHashes.size() || old.patternHashes[pat] != hashes[pat]) {
+                firstDirty = std::min(firstDirty, o);
+                lastDirty = o;
+            }
+        }
+        if (firstDirty == orderCount) return true;
+        // the old second pass plays the changed orders again
+        lastDirtySegment = (old.segments.size() > orderCount ? orderCount : 0) + lastDirty;
+    } else if (!(compiler.mSoundBank == mSoundBank)) {
+        compiler.mSoundBank = mSoundBank;
+    }
+
+    compiled.song = &songData;
+    compiled.loop = loop;
+    compiled.bpm = songData.bpm;
+    compiled.ticksPerRow = songData.ticksPerRow;
+    compiled.orderList = songData.orderList;
+    compiled.patternHashes = std::move(hashes);
+    compiled.start = start;
+
+    timeline = std::make_unique<opl3::SongTimeline>();
+    opl3::SongTimeline& tl = *timeline;
+    tl.samplesPerTick = calcSamplesPerTick(songData);
+
+    CompileState state = start;
+    if (firstDirty > 0) {
+        const opl3::SongTimeline& prev = *mTimeline;
+        const CompileSegment& from = old.segments[firstDirty];
+        tl.ticks.reserve(prev.ticks.size());
+        tl.events.reserve(prev.events.size());
+        tl.ticks.assign(prev.ticks.begin(), prev.ticks.begin() + from.firstTick);
+        tl.events.assign(prev.events.begin(), prev.events.begin() + from.firstEvent);
+        tl.steps.assign(prev.steps.begin(), prev.steps.begin() + from.firstStep);
+        tl.orderTicks.assign(prev.orderTicks.begin(), prev.orderTicks.begin() + firstDirty);
+        compiled.segments.assign(old.segments.begin(), old.segments.begin() + firstDirty);
+        compiled.keptTicks = from.firstTick;
+        state = from.state;
+    }
+
+    // the compiler plays from there, write() records into the timeline
+    compiler.loadCompileState(state);
+    TrackerState& ts = compiler.mTrackerState;
+    ts.playRange.init();
+    ts.current_song = &songData;
+    ts.loop = loop;
+    ts.ticks_per_row = songData.ticksPerRow;
+    ts.samples_per_tick = tl.samplesPerTick;
+    ts.orderIdx = (uint16_t)firstDirty;
+    ts.rowIdx = 0;
+    ts.current_tick = 0;
+    ts.ui_dirty = false;
+    ts.playing = true;
+    compiler.mCapture = &tl;
+
+    const double samplesPerTick = tl.samplesPerTick;
+    uint64_t frame = state.frame;
+    double accumulator = state.accumulator;
+    size_t pass = 0;
+    bool ok = true;
+
+    while (ts.playing) {
+        if (ts.rowIdx == 0 && ts.current_tick == 0) {
+            const size_t segment = pass * orderCount + ts.orderIdx;
+            const CompileState now = compiler.saveCompileState(frame, accumulator);
+
+            // unchanged from here on: the rest of the last timeline, moved
+            if (segment > lastDirtySegment && segment < old.segments.size()
+                && sameCompileState(old.segments[segment].state, now)) {
+                const opl3::SongTimeline& prev = *mTimeline;
+                const CompileSegment& from = old.segments[segment];
+                const int64_t tickShift = (int64_t)tl.ticks.size() - from.firstTick;
+                const int64_t eventShift = (int64_t)tl.events.size() - from.firstEvent;
+                const int64_t stepShift = (int64_t)tl.steps.size() - from.firstStep;
+                const int64_t frameShift = (int64_t)frame - (int64_t)from.state.frame;
+
+                for (size_t i = from.firstTick; i < prev.ticks.size(); i++) {
+                    opl3::TimelineTick tick = prev.ticks[i];
+                    tick.firstEvent = (uint32_t)(tick.firstEvent + eventShift);
+                    tick.frame = (uint64_t)(tick.frame + frameShift);
+                    tl.ticks.push_back(tick);
+                }
+                for (size_t i = from.firstEvent; i < prev.events.size(); i++) {
+                    opl3::TimelineEvent event = prev.events[i];
+                    if (event.kind == opl3::TimelineEvent::STEP) event.value = (uint32_t)(event.value + stepShift);
+                    tl.events.push_back(event);
+                }
+                tl.steps.insert(tl.steps.end(), prev.steps.begin() + from.firstStep, prev.steps.end());
+                for (size_t s = segment; s < old.segments.size(); s++) {
+                    CompileSegment seg = old.segments[s];
+                    seg.firstTick = (uint32_t)(seg.firstTick + tickShift);
+                    seg.firstEvent = (uint32_t)(seg.firstEvent + eventShift);
+                    seg.firstStep = (uint32_t)(seg.firstStep + stepShift);
+                    seg.state.frame = (uint64_t)(seg.state.frame + frameShift);
+                    if (s < orderCount) tl.orderTicks.push_back(seg.firstTick);
+                    compiled.segments.push_back(seg);
+                }
+                if (segment < orderCount) tl.passTicks = (uint32_t)(prev.passTicks + tickShift);
+                compiled.loopSegment = old.loopSegment;
+                break;
+            }
+
+            compiled.segments.push_back({ (uint32_t)tl.ticks.size(), (uint32_t)tl.events.size(), (uint32_t)tl.steps.size(), now });
+            if (pass == 0) tl.orderTicks.push_back((uint32_t)tl.ticks.size());
+        }
+
+        // frame of the tick, rounded like fillBuffer does
+        for (;;) {
+            const int chunk = (int)std::max(1.0, samplesPerTick - accumulator);
+            frame += chunk;
+            accumulator += chunk;
+            if (accumulator >= samplesPerTick) {
+                accumulator -= samplesPerTick;
+                break;
+            }
+        }
+
+        opl3::TimelineTick tick;
+        tick.frame = frame;
+        tick.firstEvent = (uint32_t)tl.events.size();
+
+        const uint16_t orderBefore = ts.orderIdx;
+        const uint16_t rowBefore = ts.rowIdx;
+        const uint8_t tickBefore = ts.current_tick;
+        SongStep lastSteps[MAX_HW_CHANNELS];
+        std::copy(std::begin(ts.last_steps), std::end(ts.last_steps), lastSteps);
+
+        compiler.tickSequencer();
+
+        tick.orderIdx = ts.orderIdx;
+        tick.rowIdx = ts.rowIdx;
+        tick.tick = ts.current_tick;
+        if (ts.ui_dirty) {
+            tick.flags |= opl3::TimelineTick::DIRTY;
+            ts.ui_dirty = false;
+        }
+        if (!ts.playing) {
+            tick.flags |= opl3::TimelineTick::END;
+        } else {
+            for (uint8_t ch = 0; ch < MAX_HW_CHANNELS; ch++) {
+                if (ts.last_steps[ch] == lastSteps[ch]) continue;
+                tl.events.push_back({ opl3::TimelineEvent::STEP, 0, ch, (uint32_t)tl.steps.size() });
+                tl.steps.push_back(ts.last_steps[ch]);
+            }
+        }
+        tl.ticks.push_back(tick);
+
+        if (!ts.playing) break;
+
+        // a pass which ends in the state it started from repeats
+        if (orderBefore == orderCount - 1 && ts.orderIdx == 0 && ts.rowIdx == 0 && ts.current_tick == 0) {
+            const size_t passStart = pass * orderCount;
+            if (sameCompileState(compiler.saveCompileState(frame, accumulator), compiled.segments[passStart].state)) {
+                compiled.loopSegment = passStart;
+                tl.ticks.back().flags |= opl3::TimelineTick::LOOP;
+                break;
+            }
+            if (pass == 1) { // does not settle, the live sequencer takes over
+                tl.ticks.back().flags |= opl3::TimelineTick::LOOP;
+                break;
+            }
+            pass++;
+            tl.passTicks = (uint32_t)tl.ticks.size();
+            continue;
+        }
+
+        if (ts.orderIdx == orderBefore && ts.rowIdx == rowBefore && ts.current_tick == tickBefore) {
+            Log("[error] compileSong: sequencer stuck at order %d row %d (empty pattern?)", orderBefore, rowBefore);
+            ok = false;
+            break;
+        }
+    }
+
+    compiler.mCapture = nullptr;
+    ts.playing = false;
+    ts.current_song = nullptr;
+
+    if (!ok) {
+        timeline.reset();
+        return false;
+    }
+    if (tl.passTicks == 0) tl.passTicks = (uint32_t)tl.ticks.size();
+    tl.loopTick = (compiled.loopSegment < compiled.segments.size())
+        ? compiled.segments[compiled.loopSegment].firstTick : opl3::SongTimeline::NO_LOOP;
+    return true;
+}
+//------------------------------------------------------------------------------
+// caller holds a RenderScope, the old timeline is handed back in timeline
+void OPL3Controller::installTimeline(std::unique_ptr<opl3::SongTimeline>& timeline, SongCompile& compiled) {
+    // keyframes of the unchanged ticks stay, the worker goes on after them
+    stopKeyframes();
+    if (compiled.song != mCompiled.song) mKeyframesWanted = false;
+    mKeyframes.truncate(compiled.keptTicks);
+
+    // a playing song goes on at its position
+    if (mTimelineActive && mTimeline)
+        mTimelineTick = mapTimelineTick(compiled, *timeline, mTimelineTick >= mTimeline->passTicks);
+
+    std::swap(mTimeline, timeline);
+    mCompiled = std::move(compiled);
+    if (mTimelineTick >= mTimeline->ticks.size()) mTimelineActive = false;
+
+    if (mKeyframesWanted) startKeyframes();
+}
+//------------------------------------------------------------------------------
+bool OPL3Controller::compileSong(const opl3::SongData& songData) {
+    if (!songValid(songData)) return false;
+
+    // the playing song compiles from the state it started in
+    CompileState start;
+    bool loop;
+    {
+        RenderScope scope(*this);
+        const bool playing = mTimelineActive && mCompiled.song == &songData;
+        start = playing ? mCompiled.start : saveCompileState(0, 0.0);
+        loop = playing ? mCompiled.loop : mTrackerState.loop;
+    }
+
+    std::unique_ptr<opl3::SongTimeline> timeline;
+    SongCompile compiled;
+    if (!buildTimeline(songData, loop, start, timeline, compiled)) return false;
+    if (!timeline) return true;
+
+    RenderScope scope(*this);
+    installTimeline(timeline, compiled);
+    return true;
+}
+//------------------------------------------------------------------------------
+// caller holds a RenderScope, the worker must not run while the index changes
+void OPL3Controller::startKeyframes() {
+    if (mKeyframeRunning.load(std::memory_order_acquire) || !mTimeline) return;
+    if (mKeyframeThread.joinable()) mKeyframeThread.join();
+
+    const opl3::SongTimeline& timeline = *mTimeline;
+    size_t rows = 0;
+    for (size_t i = 0; i < timeline.passTicks; i++) {
+        if (i == 0 || timeline.ticks[i - 1].tick == 0) rows++;
+    }
+    mKeyframeRows.store(rows, std::memory_order_relaxed);
+    if (mKeyframes.ready() >= rows) return;
+
+    mKeyframes.frames.reserve(rows);
+    mKeyframeCancel.store(false, std::memory_order_relaxed);
+    mKeyframeRunning.store(true, std::memory_order_release);
+    mKeyframeThread = std::thread(&OPL3Controller::keyframeWorker, this);
+}
+
+void OPL3Controller::stopKeyframes() {
+    mKeyframeCancel.store(true, std::memory_order_relaxed);
+    if (mKeyframeThread.joinable()) mKeyframeThread.join();
+    mKeyframeRunning.store(false, std::memory_order_release);
+}
+//------------------------------------------------------------------------------
+// plays the first pass of mTimeline on a chip of its own, one keyframe per row
+void OPL3Controller::keyframeWorker() {
+    const opl3::SongTimeline& timeline = *mTimeline;
+    auto state = std::make_unique<ChipState>();
+    uint32_t stepIndex[MAX_HW_CHANNELS];
+    size_t tick = 0;
+
+    const size_t ready = mKeyframes.ready();
+    if (ready > 0) {
+        const opl3::SongKeyframe& last = mKeyframes.frames[ready - 1];
+        loadKeyframe(*state, last, stepIndex);
+        playTimelineTo(*state, stepIndex, last.tick, last.tick + 1, false);
+        tick = last.tick + 1;
+    } else {
+        loadSongStart(*state, stepIndex);
+    }
+
+    for (; tick < timeline.passTicks; tick++) {
+        if (mKeyframeCancel.load(std::memory_order_relaxed)) break;
+
+        if (tick == 0 || timeline.ticks[tick - 1].tick == 0) {
+            opl3::SongKeyframe keyframe;
+            keyframe.tick = (uint32_t)tick;
+            std::copy(std::begin(stepIndex), std::end(stepIndex), keyframe.stepIndex);
+            for (int i = 0; i < 512; i++)
+                keyframe.shadowRegs[i] = state->shadowRegs[i].load(std::memory_order_relaxed);
+            ymfm::ymfm_saved_state image(keyframe.chip, true);
+            state->chip.save_restore(image);
+            mKeyframes.publish(std::move(keyframe));
+        }
+        playTimelineTo(*state, stepIndex, tick, tick + 1, false);
+    }
+    mKeyframeRunning.store(false, std::memory_order_release);
+}
+//------------------------------------------------------------------------------
+// the chip as mCompiled started from, its envelopes are not known
+void OPL3Controller::loadSongStart(ChipState& state, uint32_t* stepIndex) const {
+    const CompileState& start = mCompiled.start;
+    state.chip.reset();
+
+    // OPL3 mode and the 4-OP pairs first, they decide how the rest is read
+    auto load = [&state, &start](uint16_t reg) {
+        state.shadowRegs[reg].store(start.shadowRegs[reg], std::memory_order_relaxed);
+        state.apply(reg, start.shadowRegs[reg]);
+    };
+    load(0x105);
+    load(0x104);
+    for (uint16_t reg = 0; reg < 512; reg++) {
+        if (reg != 0x105 && reg != 0x104) load(reg);
+    }
+    std::fill(stepIndex, stepIndex + MAX_HW_CHANNELS, opl3::SongKeyframe::NO_STEP);
+}
+
+void OPL3Controller::loadKeyframe(ChipState& state, const opl3::SongKeyframe& keyframe, uint32_t* stepIndex) const {
+    std::vector<uint8_t> data = keyframe.chip;
+    ymfm::ymfm_saved_state image(data, false);
+    state.chip.save_restore(image);
+    for (int i = 0; i < 512; i++)
+        state.shadowRegs[i].store(keyframe.shadowRegs[i], std::memory_order_relaxed);
+    std::copy(std::begin(keyframe.stepIndex), std::end(keyframe.stepIndex), stepIndex);
+}
+//------------------------------------------------------------------------------
+// runs the ticks fromTick .. toTick - 1 of mTimeline on state, the chip ends
+// at the frame of toTick. warmupOnly renders the last SEEK_WARMUP_FRAMES only.
+void OPL3Controller::playTimelineTo(ChipState& state, uint32_t* stepIndex, size_t fromTick, size_t toTick, bool warmupOnly) {
+    const opl3::SongTimeline& timeline = *mTimeline;
+    toTick = std::min(toTick, timeline.ticks.size());
+    const uint64_t endFrame = (toTick < timeline.ticks.size()) ? timeline.ticks[toTick].frame : timeline.ticks.back().frame;
+    const uint64_t warmupFrame = (warmupOnly && endFrame > SEEK_WARMUP_FRAMES) ? endFrame - SEEK_WARMUP_FRAMES : 0;
+    const double step = this->getStep();
+
+    for (size_t i = fromTick; i < toTick; i++) {
+        const bool render = timeline.ticks[i].frame >= warmupFrame;
+        for (const opl3::TimelineEvent* event = timeline.eventsBegin(i); event != timeline.eventsEnd(i); ++event) {
+            if (event->kind == opl3::TimelineEvent::STEP) {
+                stepIndex[event->reg] = event->value;
+            } else if (event->chip != 0) {
+                continue;
+            } else if (event->kind == opl3::TimelineEvent::CLOCK) {
+                if (render) state.chip.generate(&state.output);
+            } else {
+                state.shadowRegs[event->reg].store((uint8_t)event->value, std::memory_order_relaxed);
+                state.apply(event->reg, (uint8_t)event->value);
+            }
+        }
+
+        if (!render || i + 1 >= timeline.ticks.size()) continue;
+        const uint64_t native = (uint64_t)(timeline.ticks[i + 1].frame * step) - (uint64_t)(timeline.ticks[i].frame * step);
+        for (uint64_t n = 0; n < native; n++) state.chip.generate(&state.output);
+    }
+}
+//------------------------------------------------------------------------------
+// caller holds a RenderScope: chip 0 and the ui state as they are at tick
+void OPL3Controller::seekTimeline(size_t tick) {
+    NoteLock lock(*this);
+    uint32_t stepIndex[MAX_HW_CHANNELS];
+    ChipState& state = *mChips[0];
+    size_t from = 0;
+
+    if (const opl3::SongKeyframe* keyframe = mKeyframes.find((uint32_t)tick)) {
+        loadKeyframe(state, *keyframe, stepIndex);
+        from = keyframe->tick;
+    } else {
+        loadSongStart(state, stepIndex);
+    }
+    playTimelineTo(state, stepIndex, from, tick, true);
+
+    for (int ch = 0; ch < MAX_HW_CHANNELS; ch++) {
+        mTrackerState.last_steps[ch] = (stepIndex[ch] == opl3::SongKeyframe::NO_STEP)
+            ? mCompiled.start.lastSteps[ch] : mTimeline->steps[stepIndex[ch]];
+    }
+}
+//------------------------------------------------------------------------------
+bool OPL3Controller::seekSong(uint16_t orderIdx, uint16_t rowIdx) {
+    const SongData* song = mTrackerState.current_song;
+    if (!song || !mCompiledPlayback || mTrackerState.playRange.active) return false;
+    if (mCompiled.song != song && !compileSong(*song)) return false;
+
+    RenderScope scope(*this);
+    if (!mTimeline || orderIdx >= mCompiled.orderList.size()) return false;
+    const opl3::SongTimeline& timeline = *mTimeline;
+    const size_t tick = timeline.findTick(orderIdx, rowIdx, mCompiled.ticksPerRow);
+
+    seekTimeline(tick);
+    mKeyframesWanted = true;
+    startKeyframes();
+
+    // the tracker stands before the tick, it runs with the next frame
+    mTrackerState.orderIdx = tick ? timeline.ticks[tick - 1].orderIdx : 0;
+    mTrackerState.rowIdx = tick ? timeline.ticks[tick - 1].rowIdx : 0;
+    mTrackerState.current_tick = tick ? timeline.ticks[tick - 1].tick : 0;
+    mTrackerState.sample_accumulator = std::max(0.0, mTrackerState.samples_per_tick - 1.0);
+    mTrackerState.ui_dirty = true;
+    mTimelineTick = tick;
+    mTimelineActive = true;
+
+    mIsSilent = false;
+    mSilenceCounter = 0;
+    return true;
+}
+
+float OPL3Controller::getSeekIndexProgress() const {
+    const size_t rows = mKeyframeRows.load(std::memory_order_relaxed);
+    return rows ? std::min(1.f, (float)mKeyframes.ready() / (float)rows) : 0.f;
+}
 
 //------------------------------------------------------------------------------
 uint16_t OPL3Controller::get_modulator_offset(uint8_t channel) {
@@ -489,30 +1135,43 @@ void OPL3Controller::setPlaying(bool value, bool hardStop) {
 }
 //------------------------------------------------------------------------------
 void OPL3Controller::silenceAll(bool hardStop) {
-    std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+    NoteLock lock(*this);
 
-    // Loop through all 18 channels (0-17)
-    // Note: If you defined MAX_CHANNEL as 16, you are missing the last channel.
-    // Standard OPL3 uses 0 to 17.
-    for (int i = 0; i < MAX_HW_CHANNELS; ++i) {
-        stopNoteHW(i); // Sends Key-Off to 0xB0 + channel_offset
-
-        if (hardStop) {
-            // Get 16-bit offsets to support the 0x100 bank switch
-            uint16_t mod_offset = get_modulator_offset(i);
-            uint16_t car_offset = get_carrier_offset(i);
-
-            // Set Total Level to maximum attenuation (63 = silent)
-            // Bit 6-7 are KSL, we set them to 0 here for a clean silence.
-            write(0x40 + mod_offset, 63);
-            write(0x40 + car_offset, 63);
-
-            // Optional: Force Release Rate to fastest to kill any long release phases
-            // This writes to the $80-$95 range
-            write(0x80 + mod_offset, 0x0F); // Max Release
-            write(0x80 + car_offset, 0x0F); // Max Release
+    silenceChips(hardStop);
+}
+//------------------------------------------------------------------------------
+// hardware only, the tracker calls it from the render thread
+void OPL3Controller::silenceChips(bool hardStop, int chipCount) {
+    NoteLock lock(*this);
+    chipCount = std::min(chipCount, (int)mChips.size());
+    for (uint8_t chip = 0; chip < chipCount; chip++) {
+        ScopedChip scope(*this, chip);
+
+        // Loop through all 18 channels (0-17)
+        // Note: If you defined MAX_CHANNEL as 16, you are missing the last channel.
+        // Standard OPL3 uses 0 to 17.
+        for (int i = 0; i < MAX_HW_CHANNELS; ++i) {
+            stopNoteHW(i); // Sends Key-Off to 0xB0 + channel_offset
+
+            if (hardStop) {
+                // Get 16-bit offsets to support the 0x100 bank switch
+                uint16_t mod_offset = get_modulator_offset(i);
+                uint16_t car_offset = get_carrier_offset(i);
+
+                // Set Total Level to maximum attenuation (63 = silent)
+                // Bit 6-7 are KSL, we set them to 0 here for a clean silence.
+                write(0x40 + mod_offset, 63);
+                write(0x40 + car_offset, 63);
+
+                // Optional: Force Release Rate to fastest to kill any long release phases
+                // This writes to the $80-$95 range
+                write(0x80 + mod_offset, 0x0F); // Max Release
+                write(0x80 + car_offset, 0x0F); // Max Release
+            }
         }
+        for (LiveVoice& voice : mLiveVoices[chip]) voice = {};
     }
+    std::erase_if(mChordVoices, [chipCount](int voice) { return voice / VOICES_PER_CHIP < chipCount; });
     for (int i = 0; i < SOFTWARE_CHANNEL_COUNT; i++)
         mChannelToNote[i] = -1;
 }
@@ -527,24 +1186,47 @@ void OPL3Controller::togglePause() {
 //------------------------------------------------------------------------------
 void OPL3Controller::reset() {
     std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+    RenderScope scope(*this);
+    flushWrites();
 
     // 1. Hardware & Shadow Reset
-    mChip->reset();
+    for (uint8_t chip = 0; chip < mChips.size(); chip++) {
+        ScopedChip scope(*this, chip);
+        initChip();
+    }
 
     m_pos = 0.0;
 
-    // Crucial: Reset your shadow registers to 0 to match ymfm's fresh state
-    memset(mShadowRegs, 0, sizeof(mShadowRegs));
-
     // 2. Reset Sequencer Position
     // We replace 'song_needle' with the new hierarchical indices
     mTrackerState.orderIdx = 0;
     mTrackerState.rowIdx = 0;
     mTrackerState.sample_accumulator = 0.0;
+    mTimelineActive = false; // the chips start over, the sequencer goes on live
 
     memset(mTrackerState.last_steps, 0, sizeof(mTrackerState.last_steps));
     mTrackerState.ui_dirty = false;
 
+    // 6. Silence Hardware
+    // This sets TL=63 for all 18 channels
+    this->silenceAll(true);
+
+    this->initDefaultBank();
+
+
+
+    Log("OPL3 Controller Reset: %d x 18 Channels enabled, Shadows cleared, Sequencer at Start.", (int)mChips.size());
+}
+//------------------------------------------------------------------------------
+// resets the chip selected by ScopedChip
+void OPL3Controller::initChip() {
+    ChipState& state = *mChips[writeChip()];
+    state.chip.reset();
+
+    // Crucial: Reset your shadow registers to 0 to match ymfm's fresh state
+    for (auto& reg : state.shadowRegs) reg.store(0, std::memory_order_relaxed);
+    for (SongStep& step : state.lastSteps) step = {};
+
     // // 2. Enable OPL3 extensions (Bank 1 access)
     // // write(0x105, 0x01); // OPL3 Mode enabled ?!
     // write(0x005, 0x01); // OPL3 Mode enabled ?!
@@ -592,22 +1274,11 @@ void OPL3Controller::reset() {
         // Set Default Output to L+R for all 18 channels
         write(0xC0 + i, 0x30);  write(0x1C0 + i, 0x30);
     }
-
-
-
-    // 6. Silence Hardware
-    // This sets TL=63 for all 18 channels
-    this->silenceAll(true);
-
-    this->initDefaultBank();
-
-
-
-    Log("OPL3 Controller Reset: 18 Channels enabled, Shadows cleared, Sequencer at Start.");
 }
 //------------------------------------------------------------------------------
 void OPL3Controller::setChannelVolume(uint8_t channel, uint8_t oplVolume) {
     if (channel >= MAX_HW_CHANNELS) return;
+    NoteLock lock(*this);
     uint8_t vol = oplVolume & 0x3F;
     uint16_t bank = (channel < 9) ? 0x000 : 0x100;
 
@@ -800,6 +1471,7 @@ bool OPL3Controller::playNote(uint8_t softwareChannel, SongStep songStep) {
     if (softwareChannel >= SOFTWARE_CHANNEL_COUNT)
         return false;
 
+    NoteLock lock(*this);
     if (songStep.note < LAST_NOTE) mChannelToNote[softwareChannel] = songStep.note;
     return this->playNoteHW(getHardWareChannel(softwareChannel), songStep);
 }
@@ -807,11 +1479,11 @@ bool OPL3Controller::playNote(uint8_t softwareChannel, SongStep songStep) {
 bool OPL3Controller::playNoteHW(uint8_t channel, SongStep step) {
     if (channel >= MAX_HW_CHANNELS) return false;
 
-    std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+    NoteLock lock(*this);
 
-    SongStep prevStep = mTrackerState.last_steps[channel];
-    mTrackerState.last_steps[channel] = step;
-    mTrackerState.ui_dirty = true;
+    SongStep prevStep = lastStep(channel);
+    lastStep(channel) = step;
+    if (writeChip() == 0) mTrackerState.ui_dirty = true;
 
     // Helper for hardware volume conversion (0-63 -> 63-0)
     auto getOplVol = [](uint8_t v) {
@@ -909,6 +1581,7 @@ bool OPL3Controller::stopNote(uint8_t softwareChannel) {
     if (softwareChannel >= SOFTWARE_CHANNEL_COUNT)
         return false;
 
+    NoteLock lock(*this);
     mChannelToNote[softwareChannel] = -1;
 
     return this->stopNoteHW(getHardWareChannel(softwareChannel));
@@ -917,7 +1590,7 @@ bool OPL3Controller::stopNote(uint8_t softwareChannel) {
 //------------------------------------------------------------------------------
 bool OPL3Controller::stopNoteHW(uint8_t channel) {
     if (channel >= MAX_HW_CHANNELS) return false;
-    std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+    NoteLock lock(*this);
 
 
 
@@ -950,8 +1623,14 @@ bool OPL3Controller::stopNoteHW(uint8_t channel) {
         keyOff(channel + 3);
     }
 
-    // crtitical:
-    mChip->generate(&mOutput);
+    // crtitical: the key-off must be seen for one sample before a new key-on
+    if (mCapture) {
+        mCapture->events.push_back({ opl3::TimelineEvent::CLOCK, writeChip(), 0, 0 });
+    } else if (mQueueWrites.load(std::memory_order_acquire) && !isRenderThread()) {
+        mLastStamp.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        mChips[writeChip()]->chip.generate(&mOutput);
+    }
 
     return true;
 }
@@ -960,21 +1639,75 @@ bool OPL3Controller::stopNoteHW(uint8_t channel) {
 //------------------------------------------------------------------------------
 void OPL3Controller::write(uint16_t reg, uint8_t val, bool doLog)
 {
-    if (reg > 512 ) {
+    if (reg >= 512 ) {
         Log("[error] OPL3Controller::write reg it out of bounds! %d", reg);
         return;
     }
-    mShadowRegs[reg] = val;
+    const uint8_t chip = writeChip();
+    mChips[chip]->shadowRegs[reg].store(val, std::memory_order_relaxed);
+
+    // compiling: recorded only, the chip is never rendered
+    if (mCapture) {
+        mCapture->events.push_back({ opl3::TimelineEvent::WRITE, chip, reg, val });
+        return;
+    }
 
+    opl3::RegisterWrite regWrite;
+    regWrite.reg = reg;
+    regWrite.value = val;
+    regWrite.chip = chip;
 
-    uint32_t portBase = (reg & 0x100) ? 2 : 0;
-    uint8_t index = reg & 0xFF;
-    mChip->write(portBase + 0, index);
-    mChip->write(portBase + 1, val);
+    // the render thread owns the chips, everybody else queues while it runs
+    if (!mQueueWrites.load(std::memory_order_acquire) || isRenderThread()) {
+        applyWrite(regWrite);
+    } else {
+        regWrite.frame = stampWrite();
+        int retry = 0;
+        while (!mWriteQueue.push(regWrite)) {
+            if (++retry > 1000) {
+                Log("[error] OPL3Controller::write queue full, write dropped!");
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    if (doLog) {
+        Log("OPL_WRITE Chip:%d Bank:%d Reg:%02X Data:%02X", chip, reg >> 8,  reg & 0xFF, val);
+    }
+}
+//------------------------------------------------------------------------------
+void OPL3Controller::applyWrite(const opl3::RegisterWrite& regWrite) {
+    if (regWrite.chip >= mChips.size()) return;
+    mChips[regWrite.chip]->apply(regWrite.reg, regWrite.value);
     // mChip->write_address(reg);
     // mChip->write_data(val);
-    if (doLog) {
-        Log("OPL_WRITE Bank:%d portBase:%d Reg:%02X Data:%02X", reg >> 8, portBase,  reg & 0xFF, val);
+}
+//------------------------------------------------------------------------------
+// frame heard now plus a constant latency longer than the stream cache, so a
+// write lands at the time it was made (shifted by the latency) instead of
+// at the start of whatever block is rendered next
+uint64_t OPL3Controller::stampWrite() {
+    const int64_t nowNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const int64_t clockNanos = mClockNanos.load(std::memory_order_acquire);
+    const double latency = mStreamWorker.getTargetLatency()
+                         + 2.0 * mStreamWorker.getBlockFrames() / cSampleRate;
+    const double elapsed = std::clamp((nowNanos - clockNanos) * 1.0e-9, 0.0, 1.0);
+    uint64_t frame = mClockFrame.load(std::memory_order_relaxed)
+                   + (uint64_t)((elapsed + latency) * mClockRate.load(std::memory_order_relaxed));
+
+    // never before an earlier write
+    uint64_t last = mLastStamp.load(std::memory_order_relaxed);
+    while (frame > last && !mLastStamp.compare_exchange_weak(last, frame, std::memory_order_relaxed)) {}
+    return std::max(frame, last);
+}
+//------------------------------------------------------------------------------
+// applies all queued writes now, caller holds a RenderScope
+void OPL3Controller::flushWrites() {
+    while (const opl3::RegisterWrite* regWrite = mWriteQueue.peek()) {
+        applyWrite(*regWrite);
+        mWriteQueue.pop();
     }
 }
 
@@ -999,7 +1732,7 @@ uint8_t OPL3Controller::readShadow(uint16_t reg) {
     if (reg >= 512) {
         return 0;
     }
-    return mShadowRegs[reg];
+    return mChips[writeChip()]->shadowRegs[reg].load(std::memory_order_relaxed);
 
 }
 //------------------------------------------------------------------------------
@@ -1030,7 +1763,7 @@ bool OPL3Controller::isChannelAdditive(uint8_t channel) {
 
 void OPL3Controller::setChannelPanning(uint8_t channel, uint8_t pan) {
     if (channel >= MAX_HW_CHANNELS) return;
-
+    NoteLock lock(*this);
 
     uint16_t bankOffset = (channel <= 8) ? 0x000 : 0x100;
     uint16_t c0Addr = bankOffset + 0xC0 + (channel % 9);
@@ -1127,7 +1860,7 @@ void OPL3Controller::setFrequencyLinear(uint8_t channel, float linearFreq) {
 void OPL3Controller::setFrequency(uint8_t channel, uint16_t fnum, uint8_t octave) {
     if (channel >= MAX_HW_CHANNELS) return;
 
-    std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+    NoteLock lock(*this);
 
     // Determine dual-bank addressing
     uint16_t bankOffset = (channel <= 8) ? 0x000 : 0x100;
@@ -1151,14 +1884,14 @@ void OPL3Controller::setFrequency(uint8_t channel, uint16_t fnum, uint8_t octave
 void OPL3Controller::setChannelOn(uint8_t channel) {
     if (channel >= MAX_HW_CHANNELS) return;
 
-    std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+    NoteLock lock(*this);
 
     uint16_t bankOffset = (channel <= 8) ? 0x000 : 0x100;
     uint8_t relChan = channel % 9;
     uint16_t reg = bankOffset + 0xB0 + relChan;
 
     // 1. Read current state from your shadow register
-    uint8_t currentB0 = mShadowRegs[reg];
+    uint8_t currentB0 = readShadow(reg);
 
     // 2. Force the Key-On bit (bit 5) to 1
     uint8_t newB0 = currentB0 | 0x20;
@@ -1168,6 +1901,7 @@ void OPL3Controller::setChannelOn(uint8_t channel) {
 }
 //------------------------------------------------------------------------------
 void OPL3Controller::processStepEffects(uint8_t channel, const SongStep& step) {
+    NoteLock lock(*this);
     uint8_t type = step.effectType;
     uint8_t val  = step.effectVal;
 
@@ -1224,6 +1958,7 @@ void OPL3Controller::processStepEffects(uint8_t channel, const SongStep& step) {
 }
 //------------------------------------------------------------------------------
 void OPL3Controller::modifyChannelPitch(uint8_t channel, int8_t amount) {
+    NoteLock lock(*this);
     uint16_t bank = (channel < 9) ? 0x000 : 0x100;
     uint8_t relChan = channel % 9;
 
@@ -1255,6 +1990,7 @@ void OPL3Controller::consoleSongOutput(bool useNumbers, bool showHWChannels)
 {
     if (!mTrackerState.playing)
         return;
+    NoteLock lock(*this);
 
     char buffer[1024]; // Increased size: 18 channels * ~15 chars each + padding
     char *ptr = buffer;
@@ -1345,94 +2081,123 @@ bool OPL3Controller::playSong(opl3::SongData& songData, bool loop )  {
 
 
 
-    std::lock_guard<std::recursive_mutex> lock(mDataMutex);
-
-    // Assign Song Data
-    mTrackerState.current_song = &songData;
-
-    // Reset Sequencer Positions
-    mTrackerState.orderIdx = 0;
-    mTrackerState.rowIdx = 0;
-    mTrackerState.current_tick = 0;
-    mTrackerState.sample_accumulator = 0.f;
-    mTrackerState.loop = loop;
-    mTrackerState.ticks_per_row = songData.ticksPerRow;
-
-    if ( mTrackerState.playRange.active )
+    // checks and the start state under the lock, the compile runs without it
+    bool range;
+    bool update = false;
+    uint16_t startRow = 0;
+    CompileState start;
     {
-        // check pattern
-        if ( mTrackerState.playRange.patternIdx >= songData.patterns.size())
-        {
-            Log("[error] playRange Pattern index out of bounds! %d", mTrackerState.playRange.patternIdx);
-            return false;
-        }
-        Pattern* tmpPat = &songData.patterns[mTrackerState.playRange.patternIdx];
+        RenderScope scope(*this);
 
-        //check startRow
-        if (
-            mTrackerState.playRange.startPoint[0] > tmpPat->getRowCount() ||
-            mTrackerState.playRange.startPoint[1] > tmpPat->getColCount()
-        )
-        {
-            Log("[error] playRange StartPoint out of bounds! row:%d, col:%d"
-                , mTrackerState.playRange.startPoint[0], mTrackerState.playRange.startPoint[1]);
-            mTrackerState.playRange.active = false;
-            return false;
-        }
-        //check stopRow
-        if (
-            (mTrackerState.playRange.stopPoint[0] >= 0 && mTrackerState.playRange.stopPoint[1] >= 0 )
-            &&
-            (
-            mTrackerState.playRange.stopPoint[0] > tmpPat->getRowCount() ||
-            mTrackerState.playRange.stopPoint[1] > tmpPat->getColCount() ||
-            mTrackerState.playRange.stopPoint[0] < mTrackerState.playRange.startPoint[0] ||
-            mTrackerState.playRange.stopPoint[1] < mTrackerState.playRange.startPoint[1]
-            )
-        )
+        if ( mTrackerState.playRange.active )
         {
-            Log("[error] playRange StopPoint out of bounds! row:%d, col:%d",
-                mTrackerState.playRange.stopPoint[0], mTrackerState.playRange.stopPoint[1]);
-            mTrackerState.playRange.active = false;
-            return false;
+            // check pattern
+            if ( mTrackerState.playRange.patternIdx >= songData.patterns.size())
+            {
+                Log("[error] playRange Pattern index out of bounds! %d", mTrackerState.playRange.patternIdx);
+                return false;
+            }
+            Pattern* tmpPat = &songData.patterns[mTrackerState.playRange.patternIdx];
 
-        }
+            //check startRow
+            if (
+                mTrackerState.playRange.startPoint[0] > tmpPat->getRowCount() ||
+                mTrackerState.playRange.startPoint[1] > tmpPat->getColCount()
+            )
+            {
+                Log("[error] playRange StartPoint out of bounds! row:%d, col:%d"
+                    , mTrackerState.playRange.startPoint[0], mTrackerState.playRange.startPoint[1]);
+                mTrackerState.playRange.active = false;
+                return false;
+            }
+            //check stopRow
+            if (
+                (mTrackerState.playRange.stopPoint[0] >= 0 && mTrackerState.playRange.stopPoint[1] >= 0 )
+                &&
+                (
+                mTrackerState.playRange.stopPoint[0] > tmpPat->getRowCount() ||
+                mTrackerState.playRange.stopPoint[1] > tmpPat->getColCount() ||
+                mTrackerState.playRange.stopPoint[0] < mTrackerState.playRange.startPoint[0] ||
+                mTrackerState.playRange.stopPoint[1] < mTrackerState.playRange.startPoint[1]
+                )
+            )
+            {
+                Log("[error] playRange StopPoint out of bounds! row:%d, col:%d",
+                    mTrackerState.playRange.stopPoint[0], mTrackerState.playRange.stopPoint[1]);
+                mTrackerState.playRange.active = false;
+                return false;
 
-        dLog("[info] OPL3Controller PlayRange: %d, %d - %d, %d",
-             mTrackerState.playRange.startPoint[0], mTrackerState.playRange.startPoint[1],
-             mTrackerState.playRange.stopPoint[0], mTrackerState.playRange.stopPoint[1]
-        );
+            }
 
+            dLog("[info] OPL3Controller PlayRange: %d, %d - %d, %d",
+                 mTrackerState.playRange.startPoint[0], mTrackerState.playRange.startPoint[1],
+                 mTrackerState.playRange.stopPoint[0], mTrackerState.playRange.stopPoint[1]
+            );
 
-        //should be ok we set at least the start Row
-        mTrackerState.rowIdx = mTrackerState.playRange.startPoint[0];
+            //should be ok we set at least the start Row
+            startRow = mTrackerState.playRange.startPoint[0];
 
-    } //playRange
-    else {
-        // we do not have a playRange so we must have a orderList!
-        if (songData.orderList.empty()) {
-            Log("[error] Playlist (orderlist) is empty! play song not cancled");
-            return false;
+        } //playRange
+        else {
+            // we do not have a playRange so we must have a orderList!
+            if (songData.orderList.empty()) {
+                Log("[error] Playlist (orderlist) is empty! play song not cancled");
+                return false;
+            }
         }
+
+        // the old song stops here, so the chips keep the start state until the install
+        mTrackerState.playing = false;
+        mTimelineActive = false;
+        range = mTrackerState.playRange.active;
+        // a range only takes the chip state from it, edits update the timeline of the song
+        update = range && mCompiled.song == &songData;
+        start = update ? mCompiled.start : saveCompileState(0, 0.0);
     }
 
+    // compiled playback, a play range runs the sequencer live
+    std::unique_ptr<opl3::SongTimeline> timeline;
+    SongCompile compiled;
+    const bool built = mCompiledPlayback
+        && buildTimeline(songData, update ? mCompiled.loop : (loop && !range), start, timeline, compiled);
 
+    RenderScope scope(*this);
 
-    // Calculate timing
-    double hostRate = (double) cSampleRate;
+    // Assign Song Data
+    mTrackerState.current_song = &songData;
 
-    // orig: double ticks_per_sec = songData.bpm * 0.4;
+    // Reset Sequencer Positions
+    mTrackerState.orderIdx = 0;
+    mTrackerState.rowIdx = startRow;
+    mTrackerState.current_tick = 0;
+    mTrackerState.sample_accumulator = 0.f;
+    mTrackerState.loop = loop;
+    mTrackerState.ticks_per_row = songData.ticksPerRow;
 
-    //TEST sync BPM / 6 magic number from ticksPerRow
-    //FIXEM speed effect this must be a function to calulate
-    double ticks_per_sec = songData.bpm * 0.4 * songData.ticksPerRow * 0.166666666f;
+    // Calculate timing
+    mTrackerState.samples_per_tick = calcSamplesPerTick(songData);
+
+    mTimelineActive = false;
+    mTimelineTick = 0;
+    if (built) {
+        if (timeline) installTimeline(timeline, compiled);
+        if (!range) {
+            mTimelineActive = true;
+            // wakes the silence check like the first note would
+            mIsSilent = false;
+            mSilenceCounter = 0;
+        }
+    }
 
-    // Calculate samples per tick
-    if (ticks_per_sec > 0) {
-        // At 125 BPM: 44100 / 50 = 882 samples per tick
-        mTrackerState.samples_per_tick = hostRate / ticks_per_sec;
-    } else {
-        mTrackerState.samples_per_tick = hostRate;
+    // a range starts with the chip state the song has at its first use
+    if (range && mCompiledPlayback && mTimeline && mCompiled.song == &songData) {
+        const auto& orders = songData.orderList;
+        const auto it = std::find(orders.begin(), orders.end(), mTrackerState.playRange.patternIdx);
+        if (it != orders.end()) {
+            seekTimeline(mTimeline->findTick((uint16_t)(it - orders.begin()), mTrackerState.rowIdx, mCompiled.ticksPerRow));
+            mKeyframesWanted = true;
+            startKeyframes();
+        }
     }
 
 
@@ -1537,15 +2302,21 @@ void OPL3Controller::writeChannelRegHW(uint16_t baseReg, uint8_t channel, uint8_
 }
 //------------------------------------------------------------------------------
 void OPL3Controller::toggleDeepEffects(bool deepTremolo, bool deepVibrato) {
-    uint8_t currentBD = readShadow(0xBD);
+    std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+
+    // global register, same setting on every chip
+    for (uint8_t chip = 0; chip < mChips.size(); chip++) {
+        ScopedChip scope(*this, chip);
+        uint8_t currentBD = readShadow(0xBD);
 
-    if (deepTremolo) currentBD |= 0x80;  // Set Bit 7
-    else             currentBD &= ~0x80; // Clear Bit 7
+        if (deepTremolo) currentBD |= 0x80;  // Set Bit 7
+        else             currentBD &= ~0x80; // Clear Bit 7
 
-    if (deepVibrato) currentBD |= 0x40;  // Set Bit 6
-    else             currentBD &= ~0x40; // Clear Bit 6
+        if (deepVibrato) currentBD |= 0x40;  // Set Bit 6
+        else             currentBD &= ~0x40; // Clear Bit 6
 
-    write(0xBD, currentBD);
+        write(0xBD, currentBD);
+    }
 }
 //------------------------------------------------------------------------------
 bool OPL3Controller::songValid(const opl3::SongData& songData) {
@@ -1577,6 +2348,144 @@ bool OPL3Controller::songValid(const opl3::SongData& songData) {
     return true;
 }
 //------------------------------------------------------------------------------
+bool OPL3Controller::setChipCount(int count) {
+    if (count < 1 || count > MAX_CHIPS) {
+        Log("[error] OPL3Controller::setChipCount %d is out of range (1..%d)", count, MAX_CHIPS);
+        return false;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+    RenderScope scope(*this);
+    flushWrites();
+
+    // voices move to other chips, stop the old ones
+    stopVoices();
+    for (auto& chipVoices : mLiveVoices)
+        for (LiveVoice& voice : chipVoices) voice = {};
+    mChordVoices.clear();
+
+    if ((int)mChips.size() > count) mChips.resize(count);
+    while ((int)mChips.size() < count) {
+        mChips.push_back(std::make_unique<ChipState>());
+        mChips.back()->block.resize(NATIVE_BLOCK);
+        ScopedChip scope(*this, (uint8_t)(mChips.size() - 1));
+        initChip();
+    }
+
+    mChipTasks.clear();
+    for (auto& chip : mChips)
+        mChipTasks.push_back({ &ChipState::renderTask, chip.get() });
+
+    if (count > 1 && !mChipWorkers)
+        mChipWorkers = std::make_unique<DSP::WorkerPool>();
+
+    Log("[info] OPL3Controller: %d chip(s), %d workers", count, mChipWorkers ? mChipWorkers->getNumWorkers() : 0);
+    return true;
+}
+//------------------------------------------------------------------------------
+int OPL3Controller::playVoice(uint8_t note, uint16_t instrument, uint8_t volume) {
+    NoteLock lock(*this);
+
+    // rank: 0 free, 1 released, 2 playing; the oldest of a rank goes first
+    int bestChip = -1, bestVoice = -1, bestRank = 3;
+    uint32_t bestAge = 0;
+    for (int chip = firstLiveChip(); chip < (int)mChips.size(); chip++) {
+        for (int v = 0; v < VOICES_PER_CHIP; v++) {
+            const LiveVoice& voice = mLiveVoices[chip][v];
+            const int rank = (voice.note < 0) ? 0 : (voice.keyOn ? 2 : 1);
+            if (rank < bestRank || (rank == bestRank && voice.age < bestAge)) {
+                bestChip = chip;
+                bestVoice = v;
+                bestRank = rank;
+                bestAge = voice.age;
+            }
+        }
+        if (bestRank == 0) break;
+    }
+    if (bestChip < 0) return -1;
+
+    ScopedChip scope(*this, (uint8_t)bestChip);
+    SongStep step{note, instrument, volume};
+    if (!playNoteHW(getHardWareChannel((uint8_t)bestVoice), step)) return -1;
+
+    LiveVoice& voice = mLiveVoices[bestChip][bestVoice];
+    voice.note = note;
+    voice.keyOn = true;
+    voice.age = ++mVoiceAge;
+    return bestChip * VOICES_PER_CHIP + bestVoice;
+}
+//------------------------------------------------------------------------------
+bool OPL3Controller::stopVoice(int voiceId) {
+    const int chip = voiceId / VOICES_PER_CHIP;
+    const int v = voiceId % VOICES_PER_CHIP;
+    if (voiceId < 0 || chip >= (int)mChips.size()) return false;
+
+    NoteLock lock(*this);
+    LiveVoice& voice = mLiveVoices[chip][v];
+    if (!voice.keyOn) return false;
+
+    ScopedChip scope(*this, (uint8_t)chip);
+    voice.keyOn = false; // still in its release phase
+    return stopNoteHW(getHardWareChannel((uint8_t)v));
+}
+//------------------------------------------------------------------------------
+void OPL3Controller::stopVoices() {
+    NoteLock lock(*this);
+    for (int chip = 0; chip < (int)mChips.size(); chip++)
+        for (int v = 0; v < VOICES_PER_CHIP; v++)
+            if (mLiveVoices[chip][v].keyOn) stopVoice(chip * VOICES_PER_CHIP + v);
+}
+//------------------------------------------------------------------------------
+int OPL3Controller::getActiveVoiceCount() const {
+    int count = 0;
+    for (const auto& chipVoices : mLiveVoices)
+        for (const LiveVoice& voice : chipVoices)
+            if (voice.keyOn) count++;
+    return count;
+}
+//------------------------------------------------------------------------------
+// headless: no audio stream, the chips are rendered like the decoder does
+void OPL3Controller::benchmarkChips(float seconds) {
+    OPL3Controller controller;
+    const int frames = MAX_FRAMES;
+    const int blocks = std::max(1, (int)(seconds * controller.cSampleRate / frames));
+    const double periodUs = frames * 1.0e6 / controller.cSampleRate;
+    std::vector<float> buffer(frames * 2);
+
+    double singleUs = 0.0;
+    for (int count : { 1, 2, 4, 8 }) {
+        controller.setChipCount(count);
+
+        // every software channel of every chip holds a note
+        for (uint8_t chip = 0; chip < count; chip++) {
+            ScopedChip scope(controller, chip);
+            for (uint8_t ch = 0; ch < SOFTWARE_CHANNEL_COUNT; ch++) {
+                SongStep step{(uint8_t)(48 + ch * 2), 0, 63};
+                controller.playNoteHW(getHardWareChannel(ch), step);
+            }
+        }
+
+        double us[2] = {};
+        for (int threads = 0; threads < 2; threads++) {
+            controller.mChipThreads = (threads == 1);
+            const auto start = std::chrono::steady_clock::now();
+            for (int b = 0; b < blocks; b++) {
+                RenderScope scope(controller);
+                controller.fillBuffer(buffer.data(), frames);
+            }
+            us[threads] = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count() / blocks;
+        }
+        if (count == 1) singleUs = us[0];
+
+        Log("[info] OPL3 chips %d (%3d voices): serial %7.1f us, parallel %7.1f us/block => %5.1f%% load, %.2fx of 1 chip",
+            count, count * SOFTWARE_CHANNEL_COUNT, us[0], us[1], us[1] / periodUs * 100.0, us[1] / singleUs);
+
+        controller.silenceAll(true);
+    }
+    controller.mChipThreads = true;
+}
+//------------------------------------------------------------------------------
 void OPL3Controller::exportToBuffer(SongData &sd, std::vector<float>& exportBuffer, float* progressOut, bool applyEffects) {
 
     dLog("[info] OPL3Controller::exportToBuffer (Optimized Float Pipeline)...");
@@ -1594,6 +2503,7 @@ void OPL3Controller::exportToBuffer(SongData &sd, std::vector<float>& exportBuff
 
     int framesProcessed = 0;
 
+    RenderScope scope(*this);
     mTrackerState.sample_accumulator = 0;
     m_pos = 0;
 
@@ -1750,22 +2660,24 @@ bool OPL3Controller::saveWavFile(const std::string& filename, const std::vector<
 }
 //------------------------------------------------------------------------------
 void OPL3Controller::detachAudio(){
-    SDL_PauseAudioStreamDevice(mStream);
+    if (mStream) SDL_PauseAudioStreamDevice(mStream);
     // SDL_SetAudioStreamGetCallback(mStream, NULL, NULL);
 
-    // stop DecoderWorker
-    mDecoderThreadRunning.store( false );
-    if (mDecoderThread.joinable()) {
-        mDecoderThread.join();
-    }
+    // stop the render thread, no fillBuffer runs after this
+    mStreamWorker.stop();
+
+    // from now on writes go straight to the chips
+    mQueueWrites.store( false );
+    RenderScope scope(*this);
+    flushWrites();
 
 }
 
 void OPL3Controller::attachAudio(){
-    // start DecoderWorker
-    mDecoderThreadRunning.store( true );
+    // start the render thread again, detachAudio stopped it
+    startStreamWorker();
 
     // SDL_SetAudioStreamGetCallback(mStream, OPL3Controller::audio_callback, this);
-    SDL_ResumeAudioStreamDevice(mStream);
+    if (mStream) SDL_ResumeAudioStreamDevice(mStream);
 }
 //------------------------------------------------------------------------------
@@ -10,9 +10,14 @@
 #include "ymfmGlue.h"
 
 #include "opl3_base.h"
+#include "opl3_register_queue.h"
+#include "opl3_song_timeline.h"
+#include "opl3_song_keyframes.h"
 #include "ymfmGlue.h"
 
 #include <DSP.h>
+#include <DSP_WorkerPool.h>
+#include <DSP_StreamWorker.h>
 
 #include <fstream>
 #include <vector>
@@ -90,13 +95,76 @@ public:
     };
 
 
+    // ---------- Multi chip ----------------
+    static constexpr int MAX_CHIPS = 8;
+    // the live voices use the software channels of a chip, so 4-OP
+    // instruments work on every voice
+    static constexpr int VOICES_PER_CHIP = SOFTWARE_CHANNEL_COUNT;
+
 private:
     // ---------- OPL/YMFM ----------------
     using OplChip = ymfm::ymf262; //OPL3
-    OplChip* mChip; //OPL
-    YMFMInterface mInterface;
+    static constexpr uint32_t MASTER_CLOCK = 14318180;
+
+    // one ymf262 with its own register shadow and render block. Chip 0 is
+    // the tracker chip, the others are used by the live voices.
+    struct ChipState {
+        YMFMInterface intf; // per chip, ymfm binds its engine to it
+        OplChip chip{intf};
+        std::atomic<uint8_t> shadowRegs[512] = {}; // register for read, lock free
+        SongStep lastSteps[MAX_HW_CHANNELS] = {}; // chip 0 uses mTrackerState.last_steps
+        OplChip::output_data output;
+
+        // native rate, the 4 ymfm outputs per frame, folded to stereo by
+        // the mix (0+2 = Left, 1+3 = Right)
+        std::vector<OplChip::output_data> block;
+        int offset = 0;             // frame in block of the next batch
+        int frames = 0;             // to render in the next batch
+
+        void apply(uint16_t reg, uint8_t value) {
+            const uint32_t portBase = (reg & 0x100) ? 2 : 0;
+            chip.write(portBase + 0, reg & 0xFF);
+            chip.write(portBase + 1, value);
+        }
+
+        void render() {
+            if (frames > 0) chip.generate(block.data() + offset, (uint32_t)frames);
+        }
+        static void renderTask(void* user) { static_cast<ChipState*>(user)->render(); }
+    };
+    std::vector<std::unique_ptr<ChipState>> mChips;
+    uint8_t mWriteChip = 0;  // target of write() / readShadow(), callers of mDataMutex
+    uint8_t mRenderChip = 0; // same for the render thread
     OplChip::output_data mOutput;
 
+    uint8_t& writeChip() { return isRenderThread() ? mRenderChip : mWriteChip; }
+
+    // routes write() and readShadow() to one chip, mDataMutex or a
+    // RenderScope must be held
+    struct ScopedChip {
+        uint8_t& target;
+        uint8_t old;
+        ScopedChip(OPL3Controller& c, uint8_t chip) : target(c.writeChip()), old(target) { target = chip; }
+        ~ScopedChip() { target = old; }
+    };
+
+    // chips render in parallel if there is more than one
+    std::unique_ptr<DSP::WorkerPool> mChipWorkers;
+    std::vector<DSP::WorkerPool::Task> mChipTasks;
+    bool mChipThreads = true;
+
+    // ---------- live voices ----------------
+    struct LiveVoice {
+        int16_t note = -1;  // -1 never used or silenced
+        bool keyOn = false;
+        uint32_t age = 0;
+    };
+    LiveVoice mLiveVoices[MAX_CHIPS][VOICES_PER_CHIP];
+    uint32_t mVoiceAge = 0;
+    std::vector<int> mChordVoices;
+
+    int firstLiveChip() const { return mChips.size() > 1 ? 1 : 0; }
+
 
     const int cSampleRate = 44100;
 
@@ -121,19 +189,154 @@ private:
     // int32_t mRender_prev_l = 0, mRender_prev_r = 0;             // Changed to int32 for OPL3 summing
 
     // ---------- ThreadSafety ---------------
+    // mDataMutex serializes the callers of the note functions (gui, input).
+    // The render loop never takes it: it owns the chips and holds
+    // mRenderMutex while rendering. Writes from other threads go through
+    // mWriteQueue and land at their sample frame, the shadow registers are
+    // updated at once and stay readable without a lock.
+    // mNoteMutex guards the note state the tracker shares with the note
+    // functions, the render loop only holds it for a sequencer tick.
     std::recursive_mutex mDataMutex;
+    std::mutex mRenderMutex;
+    std::recursive_mutex mNoteMutex;
+    std::atomic<std::thread::id> mRenderThread{};
+    std::atomic<bool> mQueueWrites{false};  // true while mStreamWorker runs
+
+    bool isRenderThread() const {
+        return mRenderThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+    // exclusive access to the chips: the render loop and changes of the chip
+    // setup (chip count, reset, song start). Reentrant on the same thread.
+    struct RenderScope {
+        OPL3Controller& controller;
+        bool owner;
+        explicit RenderScope(OPL3Controller& c) : controller(c), owner(!c.isRenderThread()) {
+            if (!owner) return;
+            c.mRenderMutex.lock();
+            c.mRenderThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        }
+        ~RenderScope() {
+            if (!owner) return;
+            controller.mRenderThread.store(std::thread::id(), std::memory_order_relaxed);
+            controller.mRenderMutex.unlock();
+        }
+    };
+
+    // note state of chip 0: mTrackerState.last_steps, ui_dirty, mChannelToNote
+    // and the read-modify-writes of the shadow registers. Locks mDataMutex,
+    // except on the render thread, and then mNoteMutex.
+    struct NoteLock {
+        std::recursive_mutex* mutex;
+        std::recursive_mutex& note;
+        explicit NoteLock(OPL3Controller& c) : mutex(c.isRenderThread() ? nullptr : &c.mDataMutex), note(c.mNoteMutex) {
+            if (mutex) mutex->lock();
+            note.lock();
+        }
+        ~NoteLock() {
+            note.unlock();
+            if (mutex) mutex->unlock();
+        }
+    };
+
+    // ---------- register write queue ---------------
+    opl3::RegisterQueue mWriteQueue;
+    uint64_t mNativeFrame = 0;                  // render thread: OPL3 frames rendered
+    int mStreamQueuedFrames = 0;                // render thread: frames waiting in mStream
+    std::atomic<uint64_t> mClockFrame{0};       // OPL3 frame heard at ...
+    std::atomic<int64_t> mClockNanos{0};        // ... this steady_clock time
+    std::atomic<double> mClockRate{44100.0};    // OPL3 frames per second
+    std::atomic<uint64_t> mLastStamp{0};        // keeps the stamps in order
+
+    uint64_t stampWrite();
+    void applyWrite(const opl3::RegisterWrite& write);
+    void flushWrites();
+
+    // ---------- compiled song ---------------
+    // what the sequencer depends on at the start of an order
+    struct CompileState {
+        uint8_t shadowRegs[512] = {};         // chip 0
+        SongStep lastSteps[MAX_HW_CHANNELS] = {};
+        uint64_t frame = 0;                   // output frame and tick
+        double accumulator = 0.0;             // accumulator there
+    };
+    // a compiled order (pass * orders + order), where it starts in the timeline
+    struct CompileSegment {
+        uint32_t firstTick = 0;
+        uint32_t firstEvent = 0;
+        uint32_t firstStep = 0;
+        CompileState state;
+    };
+    // inputs of the last compile, an edit recompiles from the first changed order
+    struct SongCompile {
+        const SongData* song = nullptr;
+        bool loop = false;
+        float bpm = 0.f;
+        uint8_t ticksPerRow = 0;
+        std::vector<uint8_t> orderList;
+        std::vector<uint64_t> patternHashes;
+        std::vector<CompileSegment> segments;
+        size_t loopSegment = SIZE_MAX;        // segment the loop restarts at
+        uint32_t keptTicks = 0;               // ticks taken unchanged from the last timeline
+        CompileState start;
+    };
 
+    std::unique_ptr<OPL3Controller> mSongCompiler;   // runs the sequencer ahead, never rendered
+    opl3::SongTimeline* mCapture = nullptr;          // mSongCompiler: write() records here
+    std::unique_ptr<opl3::SongTimeline> mTimeline;   // swapped under RenderScope
+    SongCompile mCompiled;
+    bool mCompiledPlayback = false;                  // off: the live sequencer, edits are heard at once
+    bool mTimelineActive = false;                    // render thread: walk mTimeline
+    size_t mTimelineTick = 0;                        // render thread: next tick
+
+    double calcSamplesPerTick(const SongData& songData) const;
+    CompileState saveCompileState(uint64_t frame, double accumulator);
+    void loadCompileState(const CompileState& state);
+    static bool sameCompileState(const CompileState& a, const CompileState& b);
+    bool buildTimeline(const SongData& songData, bool loop, const CompileState& start,
+                       std::unique_ptr<opl3::SongTimeline>& timeline, SongCompile& compiled);
+    void installTimeline(std::unique_ptr<opl3::SongTimeline>& timeline, SongCompile& compiled);
+    size_t mapTimelineTick(const SongCompile& compiled, const opl3::SongTimeline& timeline, bool secondPass) const;
+    void stepTimeline();
+    void endSong();
+
+    // ---------- seek keyframes ---------------
+    // output frames before a seek target which are rendered, older ticks
+    // only get their register writes (keeps a seek below a few ms)
+    static constexpr int SEEK_WARMUP_FRAMES = 8192;
+
+    opl3::SongKeyframes mKeyframes;                  // of mTimeline, first pass
+    std::thread mKeyframeThread;
+    std::atomic<bool> mKeyframeCancel{false};
+    std::atomic<bool> mKeyframeRunning{false};
+    std::atomic<size_t> mKeyframeRows{0};            // keyframes of a complete index
+    bool mKeyframesWanted = false;                   // a seek asked for them, kept for the song
+
+    void startKeyframes();
+    void stopKeyframes();
+    void keyframeWorker();
+    void loadSongStart(ChipState& state, uint32_t* stepIndex) const;
+    void loadKeyframe(ChipState& state, const opl3::SongKeyframe& keyframe, uint32_t* stepIndex) const;
+    void playTimelineTo(ChipState& state, uint32_t* stepIndex, size_t fromTick, size_t toTick, bool warmupOnly);
+    void seekTimeline(size_t tick);
 
 
 
 
-    uint8_t mShadowRegs[512] = {0}; // register for read
 
     // ------- audio_callback and buffers ----------
 
     static constexpr int MAX_FRAMES = 512;
+    static constexpr float STREAM_LATENCY_SEC = 0.030f; // default target of mStreamWorker
     std::vector<float> mF32Buffer;
 
+    // output frames rendered per chip batch, the OPL3 rate is below
+    // 2x the output rate so NATIVE_BLOCK always holds them
+    static constexpr int RENDER_BLOCK = 256;
+    static constexpr int NATIVE_BLOCK = RENDER_BLOCK * 2;
+    std::vector<float> mNativeMix;           // native rate, L R L R
+    int16_t mHoldIndex[RENDER_BLOCK] = {};   // last native sample per output frame
+
     const int SILENCE_THRESHOLD = cSampleRate * 20; //raised * 20 because of reverb ...
     std::atomic<bool> mIsSilent{true};
     std::atomic<int> mSilenceCounter{0};
@@ -142,9 +345,17 @@ private:
     float m_lastSampleL = 0.0f;
     float m_lastSampleR = 0.0f;
 
-    void generate(float* buffer, int frames);
+    bool generate(float* buffer, int frames);
+    bool renderChips(float* out, int nativeFrames);
+    void initChip();
+    // the first chipCount chips, their live voices are freed
+    void silenceChips(bool hardStop, int chipCount = MAX_CHIPS);
+    SongStep& lastStep(uint8_t channel) {
+        const uint8_t chip = writeChip();
+        return (chip == 0) ? mTrackerState.last_steps[channel] : mChips[chip]->lastSteps[channel];
+    }
     void fillBuffer(float* buffer, int total_frames);
-    bool checkAnyVoiceActive(float* buffer, int total_frames);
+    bool checkAnyVoiceActive(bool bufferHasSound, int total_frames);
 
     //------------
     virtual void tickSequencer();
@@ -167,15 +378,19 @@ private:
 
     // ------ import -------------
     // ------ export -------------
-    bool saveWavFile(const std::string& filename, const std::vector<float>& data, int sampleRate);
     // bool saveWavFile(const std::string& filename, const std::vector<int16_t>& data, int sampleRate);
 
+    void initRenderChain();
+
 
 public:
     // ----------   Init ---------------
     OPL3Controller();
     ~OPL3Controller();
     bool initController();
+    // export / render only (no GUI, no audio device): the same DSP chain and
+    // output rate as initController, but no audio stream
+    bool initHeadless();
     bool shutDownController();
 
     // ----------  ----------------
@@ -212,13 +427,18 @@ public:
 
 
     // ---------- SDL3 ----------------
-    std::thread mDecoderThread;
-    std::atomic<bool> mDecoderThreadRunning{true};
-    void DecoderWorker();
+    // keeps mStream filled, woken by the stream's get callback
+    DSP::StreamWorker mStreamWorker;
+    static void renderStream(void* user, float* buffer, int frames, int queuedFrames);
+    void startStreamWorker();
 
 
     // static void SDLCALL audio_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount);
     SDL_AudioStream* getAudioStream() { return mStream; }
+    // seconds rendered ahead of the device, 0.010 .. 0.040 suits most devices
+    void setStreamLatency(float seconds) { mStreamWorker.setTargetLatency(seconds); }
+    float getStreamLatency() const { return mStreamWorker.getTargetLatency(); }
+    DSP::StreamWorker::Stats getStreamStats() const { return mStreamWorker.getStats(); }
     float getVolume() {
         if (mStream) {
             float gain = SDL_GetAudioStreamGain(mStream);
@@ -272,6 +492,22 @@ public:
 
     bool playSong(SongData& songData, bool loop = false);
     bool songValid(const opl3::SongData& songData);
+
+    // with setCompiledPlayback(true) songs play from a precompiled timeline
+    // (not for play ranges). The owner must then call compileSong after
+    // editing the playing song, it recompiles from the first changed order
+    // and playback goes on at the same position.
+    bool compileSong(const SongData& songData);
+    void setCompiledPlayback(bool value) { mCompiledPlayback = value; }
+    bool getCompiledPlayback() const { return mCompiledPlayback; }
+    const opl3::SongTimeline* getTimeline() const { return mTimeline.get(); }
+
+    // jumps the playing (or paused) song to a row, the chip state there is
+    // restored from the seek index. The first seek of a song starts building
+    // it in the background, call it repeatedly for scrubbing.
+    bool seekSong(uint16_t orderIdx, uint16_t rowIdx);
+    // share of the song the seek index covers, 0..1
+    float getSeekIndexProgress() const;
     void stopSong(bool hardStop = false) { mTrackerState.playing = false; silenceAll(hardStop);}
     void continueSong() { mTrackerState.playing = true;}
     bool isPlaying() { return mTrackerState.playing;}
@@ -283,7 +519,7 @@ public:
 
     // ---------  ------------
 
-    OplChip* getChip() { return mChip; }
+    OplChip* getChip() { return &mChips[0]->chip; }
     OplChip::output_data& getOutPut() { return mOutput; }
 
     double getPos() const { return m_pos; }
@@ -321,6 +557,22 @@ public:
     // DSP::SoundCardEmulation* getSoundCardEmulation() { return mSoundCardEmulation; }
 
 
+    // ------- multi chip / live voices ----------
+    // count 1: live voices share chip 0 with the tracker (old behavior)
+    // count > 1: live voices get chips 1..count-1 for themselves
+    bool setChipCount(int count);
+    int getChipCount() const { return (int)mChips.size(); }
+
+    // returns a voice id (chip * VOICES_PER_CHIP + voice) or -1, steals the
+    // oldest released voice first and the oldest playing one last
+    int playVoice(uint8_t note, uint16_t instrument, uint8_t volume = MAX_VOLUME);
+    bool stopVoice(int voice);
+    void stopVoices();
+    int getActiveVoiceCount() const;
+
+    // renders 1, 2, 4 and 8 fully used chips, serial and in parallel
+    static void benchmarkChips(float seconds = 5.f);
+
     // ----- chords --------------
     // getMain()->getController()->playChord(mCurrentInstrument, 60, OPL3Controller::CHORD_MAJOR)
 
@@ -329,16 +581,32 @@ public:
 
 
     void stopPlayedNotes() {
+        std::lock_guard<std::recursive_mutex> lock(mDataMutex);
         for (uint8_t i = 0; i < SOFTWARE_CHANNEL_COUNT; i++)
         {
             if (mChannelToNote[i] >= 0)
                 stopNote(i);
         }
+        for (int voice : mChordVoices)
+            stopVoice(voice);
+        mChordVoices.clear();
 
     }
 
     void playChord(uint8_t softwareChannel, uint16_t instrument,  uint8_t rootNote, const std::vector<int>& offsets) {
 
+        // own chips: no need to take channels from the tracker
+        if (mChips.size() > 1) {
+            std::lock_guard<std::recursive_mutex> lock(mDataMutex);
+            for (int offset : offsets) {
+                const int midiNote = rootNote + offset;
+                if (midiNote < 0 || midiNote > 127) continue;
+                const int voice = playVoice((uint8_t)midiNote, instrument, 63);
+                if (voice >= 0) mChordVoices.push_back(voice);
+            }
+            return;
+        }
+
         // we use the last channels
 
         for (size_t i = 0; i < offsets.size(); i++) {
@@ -370,6 +638,8 @@ public:
 
     bool exportToWav(SongData &sd, const std::string& filename, float* progressOut = nullptr, bool applyEffects = false);
 
+    bool saveWavFile(const std::string& filename, const std::vector<float>& data, int sampleRate);
+
 
 protected:
     TrackerState mTrackerState;
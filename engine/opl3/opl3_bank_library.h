@@ -0,0 +1,841 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Instrument library: every bank below a few directories in one index file
+//
+// BankIndexer walks the directories and parses the banks on a few threads.
+// The result is one flat file that is mapped when it is opened, search and
+// preview read the mapped tables and nothing is parsed again until a bank
+// file changes.
+//
+// Layout (little endian, all offsets from the start of the file):
+//
+//   BankIndexHeader        fixed size, magic "OBIX"
+//   BankIndexFile[]        one per scanned file: mtime / size, path, format,
+//                          lower case file name for the search
+//   BankIndexInstrument[]  one per instrument: parameter hash, name, file,
+//                          packed parameters (BANK_PARAM_SIZE bytes)
+//   strings                paths and names, not terminated
+//
+// * files are sorted by path, the instruments of a file are consecutive
+// * an update reuses the entries of every file with unchanged mtime and
+//   size, only new and modified files are parsed
+// * a file with an unknown extension is checked for the fms3 bank
+//   identifier, anything else is kept with no instruments so it is not
+//   opened again on the next update
+// * the hash covers the sound only (not the name), the same sound in two
+//   banks has the same hash
+// * a search term matches the instrument name or the file name, all terms
+//   have to match
+//
+// Example usage:
+// =============
+//
+// std::string error;
+// opl3::BankIndexer::Stats stats;
+// auto library = opl3::BankIndexer::update({ "assets/banks" }, "cache/banks.idx", &stats, &error);
+// if (library) {
+//     for (uint32_t i : library->search("dmx piano", 100)) {
+//         opl3::Instrument inst;
+//         library->loadInstrument(i, inst);
+//     }
+// }
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "opl3_base.h"
+#include "opl3_bridge_fm.h"
+#include "opl3_bridge_fms3.h"
+#include "opl3_bridge_op2.h"
+#include "opl3_bridge_sbi.h"
+#include "opl3_bridge_wopl.h"
+
+#include <DSP.h>
+#include <fluxMappedFile.h>
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define OPL3_BANK_THREADS
+#endif
+
+namespace opl3 {
+
+    constexpr uint32_t BANK_INDEX_MAGIC   = DSP::DSP_STREAM_TOOLS::MakeMagic("OBIX");
+    constexpr uint32_t BANK_INDEX_VERSION = 1;
+    constexpr uint32_t BANK_PARAM_SIZE    = 64;   // packInstrument, 10 + 2 * 27 bytes
+
+    enum BankFormat : uint8_t {
+        BANK_NONE = 0,      // not a bank, kept so it is not opened again
+        BANK_WOPL,
+        BANK_OP2,
+        BANK_SBI,
+        BANK_FMI,
+        BANK_FMS3
+    };
+
+    struct BankIndexHeader {
+        uint32_t magic = BANK_INDEX_MAGIC;
+        uint32_t version = BANK_INDEX_VERSION;
+        uint32_t headerSize = sizeof(BankIndexHeader);
+        uint32_t fileEntrySize = 0;         // sizeof(BankIndexFile)
+        uint32_t instrumentEntrySize = 0;   // sizeof(BankIndexInstrument)
+        uint32_t fileCount = 0;
+        uint32_t instrumentCount = 0;
+        uint32_t fileTableOffset = 0;
+        uint32_t instrumentTableOffset = 0;
+        uint32_t stringOffset = 0;
+        uint32_t fileSize = 0;
+        uint32_t reserved = 0;
+    };
+
+    struct BankIndexFile {
+        int64_t mtime = 0;                  // file_clock ticks
+        uint64_t size = 0;
+        uint32_t pathOffset = 0;
+        uint32_t pathLength = 0;
+        uint32_t searchOffset = 0;          // lower case file name
+        uint32_t searchLength = 0;
+        uint32_t firstInstrument = 0;
+        uint32_t instrumentCount = 0;
+        uint8_t format = BANK_NONE;
+        uint8_t failed = 0;                 // known extension, parser said no
+        uint8_t reserved[6] = {};
+    };
+
+    struct BankIndexInstrument {
+        uint64_t hash = 0;
+        uint32_t fileIndex = 0;
+        uint32_t indexInFile = 0;
+        uint32_t nameOffset = 0;
+        uint32_t nameLength = 0;
+        uint32_t searchOffset = 0;          // lower case name
+        uint32_t searchLength = 0;
+        uint8_t params[BANK_PARAM_SIZE] = {};
+    };
+
+    static_assert(sizeof(BankIndexHeader) == 48, "BankIndexHeader layout changed");
+    static_assert(sizeof(BankIndexFile) == 48, "BankIndexFile layout changed");
+    static_assert(sizeof(BankIndexInstrument) == 96, "BankIndexInstrument layout changed");
+
+    //--------------------------------------------------------------------------
+    // Instrument without its name <> BANK_PARAM_SIZE bytes
+    //--------------------------------------------------------------------------
+    inline void packInstrument(const Instrument& inst, uint8_t* out) {
+        std::memset(out, 0, BANK_PARAM_SIZE);
+        out[0] = (inst.isFourOp ? 0x01 : 0) | (inst.isDoubleVoice ? 0x02 : 0);
+        out[1] = static_cast<uint8_t>(inst.fineTune);
+        out[2] = inst.fixedNote;
+        out[3] = static_cast<uint8_t>(inst.noteOffset);
+        out[4] = static_cast<uint8_t>(inst.noteOffset2);
+        out[5] = inst.velocityOffset;
+        out[6] = inst.delayOn & 0xFF;
+        out[7] = inst.delayOn >> 8;
+        out[8] = inst.delayOff & 0xFF;
+        out[9] = inst.delayOff >> 8;
+        uint8_t* p = out + 10;
+        for (const auto& pair : inst.pairs) {
+            *p++ = pair.feedback;
+            *p++ = pair.connection;
+            *p++ = pair.panning;
+            for (const auto& op : pair.ops) {
+                *p++ = op.ksl;    *p++ = op.tl;      *p++ = op.multi;
+                *p++ = op.attack; *p++ = op.decay;   *p++ = op.sustain; *p++ = op.release;
+                *p++ = op.wave;   *p++ = op.ksr;     *p++ = op.egTyp;   *p++ = op.vib; *p++ = op.am;
+            }
+        }
+    }
+
+    inline void unpackInstrument(const uint8_t* in, Instrument& inst) {
+        inst.isFourOp = (in[0] & 0x01) != 0;
+        inst.isDoubleVoice = (in[0] & 0x02) != 0;
+        inst.fineTune = static_cast<int8_t>(in[1]);
+        inst.fixedNote = in[2];
+        inst.noteOffset = static_cast<int8_t>(in[3]);
+        inst.noteOffset2 = static_cast<int8_t>(in[4]);
+        inst.velocityOffset = in[5];
+        inst.delayOn = static_cast<uint16_t>(in[6] | (in[7] << 8));
+        inst.delayOff = static_cast<uint16_t>(in[8] | (in[9] << 8));
+        const uint8_t* p = in + 10;
+        for (auto& pair : inst.pairs) {
+            pair.feedback = *p++;
+            pair.connection = *p++;
+            pair.panning = *p++;
+            for (auto& op : pair.ops) {
+                op.ksl = *p++;    op.tl = *p++;      op.multi = *p++;
+                op.attack = *p++; op.decay = *p++;   op.sustain = *p++; op.release = *p++;
+                op.wave = *p++;   op.ksr = *p++;     op.egTyp = *p++;   op.vib = *p++; op.am = *p++;
+            }
+        }
+    }
+
+    // FNV-1a over the packed parameters
+    inline uint64_t hashInstrumentParams(const uint8_t* params) {
+        uint64_t hash = FNV1A_OFFSET;
+        for (uint32_t i = 0; i < BANK_PARAM_SIZE; i++) {
+            hash ^= params[i];
+            hash *= FNV1A_PRIME;
+        }
+        return hash;
+    }
+
+    inline std::string toLowerAscii(std::string_view text) {
+        std::string result(text);
+        for (char& c : result)
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        return result;
+    }
+
+    //--------------------------------------------------------------------------
+    // An index file, mapped read only (FluxMappedFile reads it into memory
+    // where there is no mmap)
+    //--------------------------------------------------------------------------
+    class BankIndex {
+    public:
+        enum SearchFilter : uint32_t {
+            FILTER_NONE     = 0,
+            FILTER_TWO_OP   = 0x01,
+            FILTER_FOUR_OP  = 0x02,
+            FILTER_UNIQUE   = 0x04     // first of every sound (hash) only
+        };
+
+    private:
+        std::shared_ptr<FluxMappedFile> mFile;
+        std::vector<uint8_t> mOwned;
+        const uint8_t* mData = nullptr;
+        size_t mSize = 0;
+        BankIndexHeader mHeader;
+
+        BankIndex() = default;
+
+        bool inside(uint64_t offset, uint64_t size) const {
+            return offset <= mSize && size <= mSize - offset;
+        }
+
+        bool validate(std::string* error) {
+            auto fail = [&](const char* msg) {
+                if (error) *error = msg;
+                return false;
+            };
+            if (!mData || mSize < sizeof(BankIndexHeader)) return fail("file too small");
+            std::memcpy(&mHeader, mData, sizeof(BankIndexHeader));
+            if (mHeader.magic != BANK_INDEX_MAGIC) return fail("invalid file format (magic mismatch)");
+            if (mHeader.version != BANK_INDEX_VERSION) return fail("unsupported index version");
+            if (mHeader.headerSize != sizeof(BankIndexHeader)
+                || mHeader.fileEntrySize != sizeof(BankIndexFile)
+                || mHeader.instrumentEntrySize != sizeof(BankIndexInstrument))
+                return fail("invalid header");
+            if (mHeader.fileSize != mSize) return fail("file size mismatch (truncated?)");
+            if (!inside(mHeader.fileTableOffset, (uint64_t)mHeader.fileCount * sizeof(BankIndexFile))
+                || !inside(mHeader.instrumentTableOffset, (uint64_t)mHeader.instrumentCount * sizeof(BankIndexInstrument))
+                || mHeader.fileTableOffset % 8 != 0 || mHeader.instrumentTableOffset % 8 != 0)
+                return fail("table out of bounds");
+            for (uint32_t i = 0; i < mHeader.fileCount; i++) {
+                const BankIndexFile& f = getFile(i);
+                if (!inside(f.pathOffset, f.pathLength) || !inside(f.searchOffset, f.searchLength))
+                    return fail("path out of bounds");
+                if ((uint64_t)f.firstInstrument + f.instrumentCount > mHeader.instrumentCount)
+                    return fail("instrument range out of bounds");
+            }
+            for (uint32_t i = 0; i < mHeader.instrumentCount; i++) {
+                const BankIndexInstrument& e = getInstrument(i);
+                if (!inside(e.nameOffset, e.nameLength) || !inside(e.searchOffset, e.searchLength))
+                    return fail("name out of bounds");
+                if (e.fileIndex >= mHeader.fileCount) return fail("file index out of bounds");
+            }
+            return true;
+        }
+
+        std::string_view string(uint32_t offset, uint32_t length) const {
+            return std::string_view(reinterpret_cast<const char*>(mData + offset), length);
+        }
+
+    public:
+        BankIndex(const BankIndex&) = delete;
+        void operator=(const BankIndex&) = delete;
+
+        //----------------------------------------------------------------------
+        static std::shared_ptr<const BankIndex> open(const std::string& fileName, std::string* error = nullptr) {
+            std::shared_ptr<BankIndex> index(new BankIndex());
+            index->mFile = FluxMappedFile::open(fileName);
+            if (!index->mFile || !index->mFile->data()) {
+                if (error) *error = "can't open file";
+                return nullptr;
+            }
+            index->mData = index->mFile->data();
+            index->mSize = index->mFile->size();
+            if (!index->validate(error)) return nullptr;
+            return index;
+        }
+
+        static std::shared_ptr<const BankIndex> fromMemory(std::vector<uint8_t> bytes, std::string* error = nullptr) {
+            std::shared_ptr<BankIndex> index(new BankIndex());
+            index->mOwned = std::move(bytes);
+            index->mData = index->mOwned.data();
+            index->mSize = index->mOwned.size();
+            if (!index->validate(error)) return nullptr;
+            return index;
+        }
+
+        //----------------------------------------------------------------------
+        bool isMapped() const { return mFile && mFile->isMapped(); }
+        size_t getSize() const { return mSize; }
+        const BankIndexHeader& getHeader() const { return mHeader; }
+
+        uint32_t getFileCount() const { return mHeader.fileCount; }
+        const BankIndexFile& getFile(uint32_t index) const {
+            return reinterpret_cast<const BankIndexFile*>(mData + mHeader.fileTableOffset)[index];
+        }
+        std::string_view getFilePath(uint32_t index) const {
+            const BankIndexFile& f = getFile(index);
+            return string(f.pathOffset, f.pathLength);
+        }
+
+        uint32_t getInstrumentCount() const { return mHeader.instrumentCount; }
+        const BankIndexInstrument& getInstrument(uint32_t index) const {
+            return reinterpret_cast<const BankIndexInstrument*>(mData + mHeader.instrumentTableOffset)[index];
+        }
+        std::string_view getName(uint32_t index) const {
+            const BankIndexInstrument& e = getInstrument(index);
+            return string(e.nameOffset, e.nameLength);
+        }
+        bool isFourOp(uint32_t index) const { return (getInstrument(index).params[0] & 0x01) != 0; }
+
+        // file by path, -1 if it is not in the index
+        int32_t findFile(std::string_view path) const {
+            uint32_t lo = 0, hi = mHeader.fileCount;
+            while (lo < hi) {
+                const uint32_t mid = (lo + hi) / 2;
+                if (getFilePath(mid) < path) lo = mid + 1;
+                else hi = mid;
+            }
+            return (lo < mHeader.fileCount && getFilePath(lo) == path) ? (int32_t)lo : -1;
+        }
+
+        //----------------------------------------------------------------------
+        void loadInstrument(uint32_t index, Instrument& inst) const {
+            const BankIndexInstrument& e = getInstrument(index);
+            unpackInstrument(e.params, inst);
+            inst.name = std::string(string(e.nameOffset, e.nameLength));
+        }
+
+        std::vector<Instrument> loadInstruments(const std::vector<uint32_t>& indices) const {
+            std::vector<Instrument> result(indices.size());
+            for (size_t i = 0; i < indices.size(); i++) loadInstrument(indices[i], result[i]);
+            return result;
+        }
+
+        // batch export of a selection, .wopl or else a fms3 bank
+        bool exportBank(const std::vector<uint32_t>& indices, const std::string& fileName) const {
+            const std::vector<Instrument> bank = loadInstruments(indices);
+            const std::string ext = toLowerAscii(std::filesystem::path(fileName).extension().string());
+            if (ext == ".wopl") return opl3_bridge_wopl::exportBank(fileName, bank);
+            return opl3_bridge_fms3::saveBank(fileName, bank);
+        }
+
+        //----------------------------------------------------------------------
+        // instruments matching all words of query, in index order (by path).
+        // The words are matched against the file names once, then only the
+        // instrument names are scanned.
+        std::vector<uint32_t> search(std::string_view query, size_t maxResults = SIZE_MAX,
+                                     uint32_t filter = FILTER_NONE) const {
+            std::vector<std::string> terms;
+            const std::string lower = toLowerAscii(query);
+            size_t pos = 0;
+            while (pos < lower.size() && terms.size() < 32) {
+                const size_t start = lower.find_first_not_of(" \t", pos);
+                if (start == std::string::npos) break;
+                size_t end = lower.find_first_of(" \t", start);
+                if (end == std::string::npos) end = lower.size();
+                terms.push_back(lower.substr(start, end - start));
+                pos = end;
+            }
+            const uint32_t allTerms = terms.size() >= 32 ? 0xFFFFFFFFu : ((1u << terms.size()) - 1u);
+
+            std::vector<uint32_t> result;
+            std::unordered_set<uint64_t> seen;
+            for (uint32_t f = 0; f < mHeader.fileCount && result.size() < maxResults; f++) {
+                const BankIndexFile& file = getFile(f);
+                if (file.instrumentCount == 0) continue;
+
+                uint32_t fileMask = 0;
+                const std::string_view fileText = string(file.searchOffset, file.searchLength);
+                for (size_t t = 0; t < terms.size(); t++)
+                    if (fileText.find(terms[t]) != std::string_view::npos) fileMask |= 1u << t;
+
+                const uint32_t end = file.firstInstrument + file.instrumentCount;
+                for (uint32_t i = file.firstInstrument; i < end && result.size() < maxResults; i++) {
+                    const BankIndexInstrument& e = getInstrument(i);
+                    const bool fourOp = (e.params[0] & 0x01) != 0;
+                    if ((filter & FILTER_TWO_OP) && fourOp) continue;
+                    if ((filter & FILTER_FOUR_OP) && !fourOp) continue;
+
+                    uint32_t mask = fileMask;
+                    if (mask != allTerms) {
+                        const std::string_view name = string(e.searchOffset, e.searchLength);
+                        for (size_t t = 0; t < terms.size(); t++)
+                            if (!(mask & (1u << t)) && name.find(terms[t]) != std::string_view::npos)
+                                mask |= 1u << t;
+                        if (mask != allTerms) continue;
+                    }
+                    if ((filter & FILTER_UNIQUE) && !seen.insert(e.hash).second) continue;
+                    result.push_back(i);
+                }
+            }
+            return result;
+        }
+
+        // every instrument with the same sound as index (itself included)
+        std::vector<uint32_t> findSameSound(uint32_t index) const {
+            const uint64_t hash = getInstrument(index).hash;
+            std::vector<uint32_t> result;
+            for (uint32_t i = 0; i < mHeader.instrumentCount; i++)
+                if (getInstrument(i).hash == hash) result.push_back(i);
+            return result;
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // Builds and updates index files
+    //--------------------------------------------------------------------------
+    class BankIndexer {
+    public:
+        struct Stats {
+            uint32_t files = 0;             // in the index
+            uint32_t parsed = 0;            // new or changed
+            uint32_t reused = 0;
+            uint32_t failed = 0;
+            uint32_t instruments = 0;
+            float scanMs = 0.f;             // directory walk
+            float parseMs = 0.f;
+            float writeMs = 0.f;
+            std::vector<std::string> failedFiles;
+        };
+
+    private:
+        struct Entry {
+            std::string path;
+            int64_t mtime = 0;
+            uint64_t size = 0;
+            BankFormat format = BANK_NONE;
+            bool failed = false;
+            std::vector<Instrument> parsed;
+            // reused from the old index
+            const BankIndex* old = nullptr;
+            uint32_t oldFile = 0;
+        };
+
+        static BankFormat formatOf(const std::filesystem::path& path) {
+            const std::string ext = toLowerAscii(path.extension().string());
+            if (ext == ".wopl") return BANK_WOPL;
+            if (ext == ".op2")  return BANK_OP2;
+            if (ext == ".sbi")  return BANK_SBI;
+            if (ext == ".fmi")  return BANK_FMI;
+            return BANK_NONE;
+        }
+
+        static bool isFms3Bank(const std::string& path) {
+            std::ifstream ifs(path, std::ios::binary);
+            char id[opl3_bridge_fms3::ID_SIZE_BANK];
+            ifs.read(id, sizeof(id));
+            return ifs && std::memcmp(id, opl3_bridge_fms3::FILE_IDENTIFIER_BANK, sizeof(id)) == 0;
+        }
+
+        static int64_t mtimeOf(const std::filesystem::directory_entry& entry, std::error_code& ec) {
+            return static_cast<int64_t>(entry.last_write_time(ec).time_since_epoch().count());
+        }
+
+        // runs fn(i) for i in [0, count) on up to threads threads, the caller
+        // takes part
+        template <typename Fn>
+        static void parallelFor(size_t count, int threads, Fn&& fn) {
+            std::atomic<size_t> next{0};
+            auto work = [&]() {
+                for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+            };
+        #ifdef OPL3_BANK_THREADS
+            std::vector<std::thread> pool;
+            const size_t extra = std::min<size_t>(threads > 1 ? (size_t)threads - 1 : 0, count > 0 ? count - 1 : 0);
+            for (size_t t = 0; t < extra; t++) pool.emplace_back(work);
+            work();
+            for (auto& t : pool) t.join();
+        #else
+            (void)threads;
+            work();
+        #endif
+        }
+
+        // directory walk, the subdirectories of each root are walked in parallel
+        static std::vector<Entry> scan(const std::vector<std::string>& roots, int threads) {
+            namespace fs = std::filesystem;
+            std::vector<Entry> files;
+            std::vector<fs::path> dirs;
+            std::error_code ec;
+
+            auto addFile = [](std::vector<Entry>& out, const fs::directory_entry& de) {
+                std::error_code fec;
+                if (!de.is_regular_file(fec)) return;
+                Entry e;
+                e.path = de.path().string();
+                e.size = static_cast<uint64_t>(de.file_size(fec));
+                if (fec) return;
+                e.mtime = mtimeOf(de, fec);
+                if (fec) return;
+                e.format = formatOf(de.path());
+                out.push_back(std::move(e));
+            };
+
+            for (const auto& root : roots) {
+                const fs::directory_entry rootEntry(root, ec);
+                if (ec) continue;
+                if (rootEntry.is_regular_file(ec)) {
+                    addFile(files, rootEntry);
+                    continue;
+                }
+                for (fs::directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+                     !ec && it != end; it.increment(ec)) {
+                    std::error_code dec;
+                    if (it->is_directory(dec)) dirs.push_back(it->path());
+                    else addFile(files, *it);
+                }
+            }
+
+            std::vector<std::vector<Entry>> found(dirs.size());
+            parallelFor(dirs.size(), threads, [&](size_t d) {
+                std::error_code dec;
+                for (fs::recursive_directory_iterator it(dirs[d], fs::directory_options::skip_permission_denied, dec), end;
+                     !dec && it != end; it.increment(dec))
+                    addFile(found[d], *it);
+            });
+            for (auto& list : found)
+                for (auto& e : list) files.push_back(std::move(e));
+
+            std::sort(files.begin(), files.end(), [](const Entry& a, const Entry& b) { return a.path < b.path; });
+            files.erase(std::unique(files.begin(), files.end(),
+                                    [](const Entry& a, const Entry& b) { return a.path == b.path; }), files.end());
+            return files;
+        }
+
+        static void parseEntry(Entry& e) {
+            const std::string stem = std::filesystem::path(e.path).stem().string();
+            Instrument inst;
+            switch (e.format) {
+                case BANK_WOPL:
+                    e.failed = !opl3_bridge_wopl::importBank(e.path, e.parsed);
+                    break;
+                case BANK_OP2:
+                    e.failed = !opl3_bridge_op2::importBank(e.path, e.parsed);
+                    break;
+                case BANK_SBI:
+                    e.failed = !opl3_bridge_sbi::loadInstrument(e.path, inst);
+                    if (!e.failed) e.parsed.push_back(inst);
+                    break;
+                case BANK_FMI:
+                    e.failed = !opl3_bridge_fm::loadInstrument(e.path, inst, stem);
+                    if (!e.failed) e.parsed.push_back(inst);
+                    break;
+                default:
+                    if (e.size > opl3_bridge_fms3::ID_SIZE_BANK && isFms3Bank(e.path)) {
+                        e.format = BANK_FMS3;
+                        e.failed = !opl3_bridge_fms3::loadBank(e.path, e.parsed);
+                    }
+                    break;
+            }
+            if (e.failed) e.parsed.clear();
+        }
+
+        static std::vector<uint8_t> build(const std::vector<Entry>& files) {
+            auto align8 = [](uint64_t v) { return (v + 7) & ~uint64_t(7); };
+
+            std::vector<BankIndexFile> fileTable(files.size());
+            std::vector<BankIndexInstrument> instTable;
+            std::string strings;
+            auto addString = [&](std::string_view s, uint32_t& offset, uint32_t& length) {
+                offset = (uint32_t)strings.size();      // relative until the layout is known
+                length = (uint32_t)s.size();
+                strings.append(s);
+            };
+
+            for (size_t f = 0; f < files.size(); f++) {
+                const Entry& e = files[f];
+                BankIndexFile& fe = fileTable[f];
+                fe.mtime = e.mtime;
+                fe.size = e.size;
+                fe.format = e.format;
+                fe.failed = e.failed ? 1 : 0;
+                fe.firstInstrument = (uint32_t)instTable.size();
+                addString(e.path, fe.pathOffset, fe.pathLength);
+                addString(toLowerAscii(std::filesystem::path(e.path).filename().string()), fe.searchOffset, fe.searchLength);
+
+                if (e.old) {
+                    const BankIndexFile& of = e.old->getFile(e.oldFile);
+                    for (uint32_t i = 0; i < of.instrumentCount; i++) {
+                        const uint32_t oi = of.firstInstrument + i;
+                        BankIndexInstrument ie = e.old->getInstrument(oi);
+                        ie.fileIndex = (uint32_t)f;
+                        const std::string_view name = e.old->getName(oi);
+                        addString(name, ie.nameOffset, ie.nameLength);
+                        addString(toLowerAscii(name), ie.searchOffset, ie.searchLength);
+                        instTable.push_back(ie);
+                    }
+                } else {
+                    for (size_t i = 0; i < e.parsed.size(); i++) {
+                        BankIndexInstrument ie;
+                        ie.fileIndex = (uint32_t)f;
+                        ie.indexInFile = (uint32_t)i;
+                        packInstrument(e.parsed[i], ie.params);
+                        ie.hash = hashInstrumentParams(ie.params);
+                        const std::string_view name = std::string_view(e.parsed[i].name).substr(0, MAX_STRING_LENGTH);
+                        addString(name, ie.nameOffset, ie.nameLength);
+                        addString(toLowerAscii(name), ie.searchOffset, ie.searchLength);
+                        instTable.push_back(ie);
+                    }
+                }
+                fe.instrumentCount = (uint32_t)instTable.size() - fe.firstInstrument;
+            }
+
+            BankIndexHeader header;
+            header.fileEntrySize = sizeof(BankIndexFile);
+            header.instrumentEntrySize = sizeof(BankIndexInstrument);
+            header.fileCount = (uint32_t)fileTable.size();
+            header.instrumentCount = (uint32_t)instTable.size();
+            header.fileTableOffset = sizeof(BankIndexHeader);
+            header.instrumentTableOffset = (uint32_t)align8(header.fileTableOffset + fileTable.size() * sizeof(BankIndexFile));
+            const uint64_t stringOffset = header.instrumentTableOffset + (uint64_t)instTable.size() * sizeof(BankIndexInstrument);
+            const uint64_t fileSize = stringOffset + strings.size();
+            if (fileSize > UINT32_MAX) return {};
+            header.stringOffset = (uint32_t)stringOffset;
+            header.fileSize = (uint32_t)fileSize;
+
+            for (auto& fe : fileTable) {
+                fe.pathOffset += header.stringOffset;
+                fe.searchOffset += header.stringOffset;
+            }
+            for (auto& ie : instTable) {
+                ie.nameOffset += header.stringOffset;
+                ie.searchOffset += header.stringOffset;
+            }
+
+            std::vector<uint8_t> bytes(header.fileSize, 0);
+            std::memcpy(bytes.data(), &header, sizeof(header));
+            if (!fileTable.empty())
+                std::memcpy(bytes.data() + header.fileTableOffset, fileTable.data(), fileTable.size() * sizeof(BankIndexFile));
+            if (!instTable.empty())
+                std::memcpy(bytes.data() + header.instrumentTableOffset, instTable.data(), instTable.size() * sizeof(BankIndexInstrument));
+            if (!strings.empty())
+                std::memcpy(bytes.data() + header.stringOffset, strings.data(), strings.size());
+            return bytes;
+        }
+
+    public:
+        //----------------------------------------------------------------------
+        // Scans roots (directories or single files) and writes indexFile.
+        // Files already in indexFile with the same mtime and size are not
+        // parsed again. An empty indexFile keeps the index in memory only.
+        // threads 0 = hardware threads
+        static std::shared_ptr<const BankIndex> update(const std::vector<std::string>& roots,
+                                                       const std::string& indexFile,
+                                                       Stats* stats = nullptr,
+                                                       std::string* error = nullptr,
+                                                       int threads = 0) {
+            using clock = std::chrono::steady_clock;
+            auto ms = [](clock::time_point from) {
+                return std::chrono::duration<float, std::milli>(clock::now() - from).count();
+            };
+            if (threads <= 0) threads = std::max(1, (int)std::thread::hardware_concurrency());
+            Stats s;
+
+            auto t0 = clock::now();
+            std::vector<Entry> files = scan(roots, threads);
+            s.scanMs = ms(t0);
+
+            // unchanged files keep their entries
+            std::shared_ptr<const BankIndex> old;
+            if (!indexFile.empty() && std::filesystem::exists(indexFile))
+                old = BankIndex::open(indexFile);
+            std::vector<size_t> toParse;
+            for (size_t i = 0; i < files.size(); i++) {
+                Entry& e = files[i];
+                const int32_t of = old ? old->findFile(e.path) : -1;
+                if (of >= 0 && old->getFile((uint32_t)of).mtime == e.mtime && old->getFile((uint32_t)of).size == e.size) {
+                    const BankIndexFile& f = old->getFile((uint32_t)of);
+                    e.old = old.get();
+                    e.oldFile = (uint32_t)of;
+                    e.format = (BankFormat)f.format;
+                    e.failed = f.failed != 0;
+                    s.reused++;
+                } else {
+                    toParse.push_back(i);
+                }
+            }
+
+            t0 = clock::now();
+            parallelFor(toParse.size(), threads, [&](size_t i) { parseEntry(files[toParse[i]]); });
+            s.parseMs = ms(t0);
+            s.parsed = (uint32_t)toParse.size();
+
+            t0 = clock::now();
+            std::vector<uint8_t> bytes = build(files);
+            if (bytes.empty()) {
+                if (error) *error = "index exceeds 4 GB";
+                return nullptr;
+            }
+            for (const auto& e : files) {
+                if (e.failed) {
+                    s.failed++;
+                    s.failedFiles.push_back(e.path);
+                }
+            }
+            old.reset();
+
+            std::shared_ptr<const BankIndex> index;
+            if (!indexFile.empty()) {
+                // write a temp file and swap it in, a reader never sees half an index
+                const std::string tmpFile = indexFile + ".tmp";
+                std::error_code ec;
+                const std::filesystem::path parent = std::filesystem::path(indexFile).parent_path();
+                if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+                {
+                    std::ofstream ofs(tmpFile, std::ios::binary | std::ios::trunc);
+                    ofs.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+                    if (!ofs) ec = std::make_error_code(std::errc::io_error);
+                }
+                if (!ec) {
+                    std::filesystem::rename(tmpFile, indexFile, ec);
+                    if (ec) {
+                        // windows: the old index may still be open
+                        std::filesystem::remove(indexFile, ec);
+                        std::filesystem::rename(tmpFile, indexFile, ec);
+                    }
+                }
+                if (ec) {
+                    std::filesystem::remove(tmpFile, ec);
+                    Log("[warn] BankIndexer: can't write %s, index kept in memory", indexFile.c_str());
+                } else {
+                    index = BankIndex::open(indexFile, error);
+                }
+            }
+            if (!index) index = BankIndex::fromMemory(std::move(bytes), error);
+            s.writeMs = ms(t0);
+
+            if (index) {
+                s.files = index->getFileCount();
+                s.instruments = index->getInstrumentCount();
+            }
+            if (stats) *stats = std::move(s);
+            return index;
+        }
+
+        //----------------------------------------------------------------------
+        // Writes banks (half wopl, half fms3) of 128 instruments each below
+        // workDir, indexes them, updates the index unchanged and with one
+        // touched file, then searches. The sounds repeat across the banks.
+        // Logs the timings, returns false if a result is wrong. workDir is
+        // removed afterwards.
+        static bool benchmark(const std::string& workDir, int banks = 200, int threads = 0) {
+            namespace fs = std::filesystem;
+            using clock = std::chrono::steady_clock;
+            constexpr int BANK_SIZE = 128;
+            constexpr int SOUNDS = 1000;
+            static const char* names[] = { "Piano", "Bass", "Strings", "Brass", "Lead", "Pad", "Drum", "Organ" };
+
+            std::error_code ec;
+            fs::remove_all(workDir, ec);
+            const std::string bankDir = (fs::path(workDir) / "banks").string();
+            const std::string indexFile = (fs::path(workDir) / "banks.idx").string();
+
+            auto makeInstrument = [](int sound, int slot) {
+                Instrument inst;
+                inst.name = std::string(names[slot % 8]) + " " + std::to_string(slot);
+                inst.fineTune = (int8_t)(sound % 50);
+                inst.pairs[0].feedback = (uint8_t)(sound % 8);
+                inst.pairs[0].ops[0].tl = (uint8_t)(sound % 64);
+                inst.pairs[0].ops[1].attack = (uint8_t)((sound / 64) % 16);
+                return inst;
+            };
+            std::string touchFile;
+            for (int b = 0; b < banks; b++) {
+                const fs::path dir = fs::path(bankDir) / ("d" + std::to_string(b % 8));
+                fs::create_directories(dir, ec);
+                std::vector<Instrument> bank;
+                for (int k = 0; k < BANK_SIZE; k++)
+                    bank.push_back(makeInstrument((b * BANK_SIZE + k) % SOUNDS, k));
+                const std::string file = (dir / ("bank" + std::to_string(b) + ((b & 1) ? ".wopl" : ".fmb"))).string();
+                const bool saved = (b & 1) ? opl3_bridge_wopl::exportBank(file, bank) : opl3_bridge_fms3::saveBank(file, bank);
+                if (!saved) {
+                    Log("[error] BankIndexer::benchmark: can't write %s", file.c_str());
+                    fs::remove_all(workDir, ec);
+                    return false;
+                }
+                if (b == banks / 2) touchFile = file;
+            }
+
+            bool ok = true;
+            auto check = [&ok](bool value, const char* what) {
+                if (!value) Log("[error] BankIndexer::benchmark: %s", what);
+                ok = ok && value;
+            };
+            const uint32_t expected = (uint32_t)(banks * BANK_SIZE);
+
+            Stats full, same, touched;
+            std::string error;
+            auto index = update({ bankDir }, indexFile, &full, &error, threads);
+            check(index && full.parsed == (uint32_t)banks && full.failed == 0 && full.instruments == expected, "full index");
+            index = update({ bankDir }, indexFile, &same, &error, threads);
+            check(index && same.parsed == 0 && same.reused == (uint32_t)banks && same.instruments == expected, "unchanged update");
+            fs::last_write_time(touchFile, fs::file_time_type::clock::now() + std::chrono::seconds(2), ec);
+            index = update({ bankDir }, indexFile, &touched, &error, threads);
+            check(index && touched.parsed == 1 && touched.instruments == expected, "update of one file");
+
+            float searchMs = 0.f;
+            size_t hits = 0, unique = 0, sameSound = 0;
+            if (index) {
+                const auto t0 = clock::now();
+                hits = index->search("brass").size();
+                searchMs = std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+                unique = index->search("", SIZE_MAX, BankIndex::FILTER_UNIQUE).size();
+                sameSound = index->findSameSound(0).size();
+
+                // every 8th slot, the second term matches the file name
+                check(hits == (size_t)banks * BANK_SIZE / 8, "search");
+                check(index->search("organ wopl").size() == (size_t)(banks / 2) * BANK_SIZE / 8, "search by file name");
+                check(unique == (size_t)std::min(SOUNDS, banks * BANK_SIZE), "unique sounds");
+                check(sameSound == (size_t)(banks * BANK_SIZE + SOUNDS - 1) / SOUNDS, "same sound");
+
+                Instrument stored, loaded;
+                std::vector<Instrument> bank;
+                const int32_t f = index->findFile(touchFile);
+                check(f >= 0 && ((banks / 2) & 1 ? opl3_bridge_wopl::importBank(touchFile, bank) : opl3_bridge_fms3::loadBank(touchFile, bank)), "reload bank");
+                if (f >= 0 && bank.size() > 5) {
+                    index->loadInstrument(index->getFile((uint32_t)f).firstInstrument + 5, loaded);
+                    check(loaded == bank[5], "instrument round trip");
+                }
+            }
+
+            Log("[info] Bank library %d banks, %u instruments, %s:", banks, expected, index && index->isMapped() ? "mapped" : "in memory");
+            Log("[info]   full     scan %.1f ms, parse %.1f ms, write %.1f ms", full.scanMs, full.parseMs, full.writeMs);
+            Log("[info]   same     scan %.1f ms, parse %.1f ms, write %.1f ms", same.scanMs, same.parseMs, same.writeMs);
+            Log("[info]   touched  scan %.1f ms, parse %.1f ms (%u file), write %.1f ms", touched.scanMs, touched.parseMs, touched.parsed, touched.writeMs);
+            Log("[info]   search %.3f ms (%zu hits), %zu unique sounds, %zu with the sound of #0",
+                searchMs, hits, unique, sameSound);
+
+            index.reset();
+            fs::remove_all(workDir, ec);
+            return ok;
+        }
+    };
+
+} // namespace opl3
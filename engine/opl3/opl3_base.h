@@ -34,6 +34,10 @@ namespace opl3 {
     // pattern 4096 * 18 channel => 73728 steps
     constexpr uint32_t MAX_VECTOR_ELEMENTS = 100000; // should be enough
 
+    // FNV-1a 64, pattern and instrument hashes
+    constexpr uint64_t FNV1A_OFFSET = 14695981039346656037ull;
+    constexpr uint64_t FNV1A_PRIME  = 1099511628211ull;
+
 
 
     static constexpr std::array<const char*, 12> NOTE_NAMES = {
@@ -31,9 +31,9 @@ namespace opl3_bridge_fms3 {
 
     constexpr uint8_t DUMMYBYTE = 0; // a dummy for reserve bytes
 
-    std::string errors = "";
+    inline thread_local std::string errors = "";
 
-    void addError(std::string error)
+    inline void addError(std::string error)
     {
         errors += error + "\n";
     }
@@ -60,7 +60,7 @@ namespace opl3_bridge_fms3 {
 
 
     // Helper to write std::string
-    void write_string(std::ofstream& ofs, const std::string& str) {
+    inline void write_string(std::ofstream& ofs, const std::string& str) {
         // 1. Determine the safe length to write
         uint32_t length = static_cast<uint32_t>(str.length());
 
@@ -78,7 +78,7 @@ namespace opl3_bridge_fms3 {
     }
 
     // Helper to read std::string
-    void read_string(std::ifstream& ifs, std::string& str) {
+    inline void read_string(std::ifstream& ifs, std::string& str) {
         uint32_t length;
         read_binary(ifs, length);
 
@@ -150,7 +150,7 @@ namespace opl3_bridge_fms3 {
 
     //--------------------------------------------------------------------------
     // Implementations for nested structs
-    void write_opl_instrument(std::ofstream& ofs, const opl3::Instrument& inst) {
+    inline void write_opl_instrument(std::ofstream& ofs, const opl3::Instrument& inst) {
         write_string(ofs, inst.name);
         write_binary(ofs, inst.isFourOp);
         write_binary(ofs, inst.isDoubleVoice);
@@ -191,7 +191,7 @@ namespace opl3_bridge_fms3 {
     }
 
     //--------------------------------------------------------------------------
-    void read_opl_instrument(std::ifstream& ifs, opl3::Instrument& inst) {
+    inline void read_opl_instrument(std::ifstream& ifs, opl3::Instrument& inst) {
         read_string(ifs, inst.name);
         read_binary(ifs, inst.isFourOp);
         read_binary(ifs, inst.isDoubleVoice);
@@ -229,7 +229,7 @@ namespace opl3_bridge_fms3 {
     }
 
     //--------------------------------------------------------------------------
-    void write_pattern(std::ofstream& ofs, const opl3::Pattern& pat) {
+    inline void write_pattern(std::ofstream& ofs, const opl3::Pattern& pat) {
         write_string(ofs, pat.mName);
         write_binary(ofs, pat.mColor);
         // NOT! write_binary(ofs, pat.getRowCount());
@@ -244,7 +244,7 @@ namespace opl3_bridge_fms3 {
     }
 
     //--------------------------------------------------------------------------
-    void read_pattern(std::ifstream& ifs, opl3::Pattern& pat) {
+    inline void read_pattern(std::ifstream& ifs, opl3::Pattern& pat) {
         read_string(ifs, pat.mName);
         read_binary(ifs, pat.mColor);
         read_vector(ifs, pat.getStepsMutable());
@@ -258,7 +258,7 @@ namespace opl3_bridge_fms3 {
     //                   Song load / save
     //--------------------------------------------------------------------------
     // --------------- saveSong
-    bool saveSong(const std::string& filePath, const opl3::SongData& song,
+    inline bool saveSong(const std::string& filePath, const opl3::SongData& song,
             const std::vector<std::unique_ptr<DSP::Effect>>& dspEffects,
             bool withDspSettings = false
     ) {
@@ -362,7 +362,7 @@ namespace opl3_bridge_fms3 {
 
     //--------------------------------------------------------------------------
     // ------------- loadSong
-    bool loadSong(const std::string& filePath, opl3::SongData& song,
+    inline bool loadSong(const std::string& filePath, opl3::SongData& song,
                 std::vector<std::unique_ptr<DSP::Effect>>& dspEffects,
                 bool withDspSettings = true
         ) {
@@ -542,7 +542,7 @@ namespace opl3_bridge_fms3 {
     //              wopl is good but does not have panning!!
     //--------------------------------------------------------------------------
     // --------------- saveBank
-    bool saveBank(const std::string& filePath, const std::vector<opl3::Instrument>& bank) {
+    inline bool saveBank(const std::string& filePath, const std::vector<opl3::Instrument>& bank) {
         errors = "";
 
         if (bank.size() == 0) {
@@ -602,7 +602,7 @@ namespace opl3_bridge_fms3 {
 
     //--------------------------------------------------------------------------
     // ------------- loadBank
-    bool loadBank(const std::string& filePath, std::vector<opl3::Instrument>& bank) {
+    inline bool loadBank(const std::string& filePath, std::vector<opl3::Instrument>& bank) {
         errors = "";
         std::ifstream ifs; //(filePath, std::ios::binary);
         ifs.exceptions(std::ifstream::badbit | std::ifstream::failbit);
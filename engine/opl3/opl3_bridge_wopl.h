@@ -30,8 +30,8 @@
 
 namespace opl3_bridge_wopl {
 
-    std::string error = "";
-    std::string debug = "";
+    inline thread_local std::string error = "";
+    inline thread_local std::string debug = "";
 
     // Helper to fill OplInstrument::OpPair::OpParams from Wopl instrument data (62 bytes)
     // op_idx: 0=Mod1, 1=Car1, 2=Mod2, 3=Car2
@@ -322,7 +322,8 @@ namespace opl3_bridge_wopl {
         }
 
 
-        printf("%s", debug.c_str());;
+        // the trace stays in debug for the caller, stdout belongs to the app
+        // (opl3render prints checksums there)
 
         f.close();
         return true;
@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Lock free multi producer / single consumer FIFO of OPL3 register writes
+//
+// Producers (gui, input, ...) push writes stamped with the OPL3 sample frame
+// they should land on, the render loop pops them at exactly that frame.
+// Bounded ring with a sequence number per cell (Vyukov), push fails when full.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace opl3 {
+
+    struct RegisterWrite {
+        uint64_t frame = 0;  // OPL3 sample frame (native rate)
+        uint16_t reg = 0;    // 0x000 - 0x1FF
+        uint8_t value = 0;
+        uint8_t chip = 0;
+    };
+
+    class RegisterQueue {
+    public:
+        static constexpr uint32_t CAPACITY = 4096; // power of two
+
+    private:
+        static constexpr uint32_t MASK = CAPACITY - 1;
+
+        struct Cell {
+            std::atomic<uint32_t> sequence{0};
+            RegisterWrite data;
+        };
+        Cell mCells[CAPACITY];
+
+        alignas(64) std::atomic<uint32_t> mHead{0}; // producers
+        alignas(64) uint32_t mTail = 0;             // consumer only
+
+    public:
+        RegisterQueue() {
+            for (uint32_t i = 0; i < CAPACITY; i++)
+                mCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        RegisterQueue(const RegisterQueue&) = delete;
+        void operator=(const RegisterQueue&) = delete;
+
+        //----------------------------------------------------------------------
+        // producer side, any thread
+        bool push(const RegisterWrite& write) {
+            uint32_t pos = mHead.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = mCells[pos & MASK];
+                const uint32_t seq = cell.sequence.load(std::memory_order_acquire);
+                const int32_t diff = (int32_t)(seq - pos);
+                if (diff == 0) {
+                    if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.data = write;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // full
+                } else {
+                    pos = mHead.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // consumer side, one thread at a time
+        const RegisterWrite* peek() const {
+            const Cell& cell = mCells[mTail & MASK];
+            const uint32_t seq = cell.sequence.load(std::memory_order_acquire);
+            if ((int32_t)(seq - (mTail + 1)) < 0) return nullptr;
+            return &cell.data;
+        }
+
+        void pop() {
+            Cell& cell = mCells[mTail & MASK];
+            cell.sequence.store(mTail + CAPACITY, std::memory_order_release);
+            mTail++;
+        }
+
+        bool empty() const { return peek() == nullptr; }
+    };
+
+} // namespace opl3
@@ -0,0 +1,79 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Seek index of a compiled song: the tracker chip at the start of every row
+//
+// A worker thread plays the SongTimeline on a chip of its own and stores a
+// ymfm save_restore image per row. Seeking restores the last image before
+// the target and plays the few ticks up to it.
+//
+// * keyframes are sorted by tick, the vector is reserved for the whole song
+//   before the worker starts, so a reader sees complete entries up to
+//   ready() and nothing moves while the worker appends
+// * stepIndex holds the ui state (last_steps) as indices into
+//   SongTimeline::steps, NO_STEP is the state the song started with
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "opl3_base.h"
+
+namespace opl3 {
+
+    struct SongKeyframe {
+        static constexpr uint32_t NO_STEP = UINT32_MAX;
+
+        uint32_t tick = 0;                          // state before this tick runs
+        uint32_t stepIndex[MAX_HW_CHANNELS] = {};
+        uint8_t shadowRegs[512] = {};
+        std::vector<uint8_t> chip;                  // ymfm save_restore image
+    };
+
+    class SongKeyframes {
+    public:
+        std::vector<SongKeyframe> frames;
+
+        size_t ready() const { return mReady.load(std::memory_order_acquire); }
+
+        //----------------------------------------------------------------------
+        // worker side, frames has room for it
+        void publish(SongKeyframe&& keyframe) {
+            frames.push_back(std::move(keyframe));
+            mReady.store(frames.size(), std::memory_order_release);
+        }
+
+        //----------------------------------------------------------------------
+        // the worker is stopped for these
+        void truncate(uint32_t tick) {
+            auto it = std::lower_bound(frames.begin(), frames.end(), tick,
+                [](const SongKeyframe& k, uint32_t t) { return k.tick < t; });
+            frames.erase(it, frames.end());
+            mReady.store(frames.size(), std::memory_order_release);
+        }
+        void clear() { truncate(0); }
+
+        //----------------------------------------------------------------------
+        // last ready keyframe at or before tick, nullptr if there is none
+        const SongKeyframe* find(uint32_t tick) const {
+            const auto end = frames.begin() + ready();
+            auto it = std::upper_bound(frames.begin(), end, tick,
+                [](uint32_t t, const SongKeyframe& k) { return t < k.tick; });
+            return (it == frames.begin()) ? nullptr : &*(it - 1);
+        }
+
+        size_t getMemoryBytes() const {
+            size_t bytes = frames.capacity() * sizeof(SongKeyframe);
+            for (size_t i = 0; i < ready(); i++) bytes += frames[i].chip.capacity();
+            return bytes;
+        }
+
+    private:
+        std::atomic<size_t> mReady{0};
+    };
+
+} // namespace opl3
@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Compiled song: a flat stream of register writes per sequencer tick
+//
+// OPL3Controller::compileSong runs the sequencer once ahead of playback and
+// records what it writes, effects (slides, porta) come out as plain writes
+// on every tick they touch. Playback walks a cursor over the ticks, export
+// does the same without any pattern lookups.
+//
+// * ticks[i] owns events[ticks[i].firstEvent .. ticks[i + 1].firstEvent)
+// * orderTicks[o] is the first tick of order o, sorted, so a position or a
+//   frame is found with a binary search
+// * with loop a pass that ends in the state it started from repeats from
+//   loopTick. The first pass starts from whatever the chip held before, so
+//   mostly a second pass is compiled and that one repeats.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "opl3_base.h"
+
+namespace opl3 {
+
+    struct TimelineEvent {
+        enum Kind : uint8_t {
+            WRITE = 0,  // reg = register, value = data
+            CLOCK,      // one chip sample, a key-off is seen before the next key-on
+            STEP        // reg = hardware channel, value = index into steps (ui state)
+        };
+        uint8_t kind = WRITE;
+        uint8_t chip = 0;
+        uint16_t reg = 0;
+        uint32_t value = 0;
+    };
+
+    struct TimelineTick {
+        enum Flags : uint8_t {
+            END  = 0x01,    // the song stops after this tick
+            LOOP = 0x02,    // continue at SongTimeline::loopTick
+            DIRTY = 0x04    // tracker ui state changed
+        };
+        uint64_t frame = 0;         // output frame the tick runs at
+        uint32_t firstEvent = 0;
+        uint16_t orderIdx = 0;      // tracker position after the tick
+        uint16_t rowIdx = 0;
+        uint8_t tick = 0;
+        uint8_t flags = 0;
+    };
+
+    class SongTimeline {
+    public:
+        static constexpr uint32_t NO_LOOP = UINT32_MAX;
+
+        std::vector<TimelineTick> ticks;
+        std::vector<TimelineEvent> events;
+        std::vector<SongStep> steps;
+        std::vector<uint32_t> orderTicks;   // first pass only
+        uint32_t passTicks = 0;             // ticks of the first pass
+        uint32_t loopTick = NO_LOOP;
+        double samplesPerTick = 0.0;
+
+        //----------------------------------------------------------------------
+        // events of tick index
+        const TimelineEvent* eventsBegin(size_t index) const { return events.data() + ticks[index].firstEvent; }
+        const TimelineEvent* eventsEnd(size_t index) const {
+            return events.data() + (index + 1 < ticks.size() ? ticks[index + 1].firstEvent : events.size());
+        }
+
+        //----------------------------------------------------------------------
+        // last tick at or before frame (first pass)
+        size_t findTick(uint64_t frame) const {
+            auto it = std::upper_bound(ticks.begin(), ticks.begin() + passTicks, frame,
+                [](uint64_t f, const TimelineTick& t) { return f < t.frame; });
+            return (it == ticks.begin()) ? 0 : (size_t)(it - ticks.begin() - 1);
+        }
+
+        // first tick of order / row, ticksPerRow as compiled
+        size_t findTick(uint16_t orderIdx, uint16_t rowIdx, uint8_t ticksPerRow) const {
+            if (orderTicks.empty()) return 0;
+            orderIdx = std::min<uint16_t>(orderIdx, (uint16_t)(orderTicks.size() - 1));
+            const size_t end = (orderIdx + 1u < orderTicks.size()) ? orderTicks[orderIdx + 1] : passTicks;
+            return std::min(orderTicks[orderIdx] + (size_t)rowIdx * ticksPerRow, end > 0 ? end - 1 : 0);
+        }
+
+        size_t getMemoryBytes() const {
+            return ticks.capacity() * sizeof(TimelineTick)
+                 + events.capacity() * sizeof(TimelineEvent)
+                 + steps.capacity() * sizeof(SongStep)
+                 + orderTicks.capacity() * sizeof(uint32_t);
+        }
+
+        void clear() {
+            ticks.clear();
+            events.clear();
+            steps.clear();
+            orderTicks.clear();
+            passTicks = 0;
+            loopTick = NO_LOOP;
+        }
+    };
+
+} // namespace opl3
@@ -10,6 +10,7 @@
 #ifdef FLUX_ENGINE
 #include <audio/fluxAudio.h>
 #endif
+#include <DSP_Denormal.h>
 
 
 #ifndef M_PI
@@ -787,6 +788,8 @@ void SDLCALL SFXGenerator::audio_callback(void* userdata, SDL_AudioStream* strea
 {
     if (!userdata)
         return;
+    DSP::ScopedDenormalGuard denormalGuard;
+    SetLogThreadRealtime(true);
 
     auto* gen = static_cast<SFXGenerator*>(userdata);
 
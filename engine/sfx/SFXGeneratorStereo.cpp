@@ -260,8 +260,8 @@ SFXGeneratorStereo::~SFXGeneratorStereo()
 {
     if (mStream)
     {
+        mStreamWorker.stop();
         SDL_FlushAudioStream(mStream);
-        SDL_SetAudioStreamGetCallback(mStream, NULL, NULL);
         SDL_DestroyAudioStream(mStream);
         mStream = nullptr;
     }
@@ -603,7 +603,11 @@ void SFXGeneratorStereo::SynthSample(int length, float* stereoBuffer) {
 
 
     for (int i = 0; i < length; i++) {
-        if (!mState.playing_sample) break;
+        if (!mState.playing_sample) {
+            // the buffer is reused, no stale frames after the end
+            std::memset(stereoBuffer + i * 2, 0, (length - i) * sizeof(float) * 2);
+            break;
+        }
 
         // Part 1: Update the simulation
         updateSystemState();
@@ -936,40 +940,20 @@ void SFXGeneratorStereo::AddPanning(bool doLock) {
 //------------------------------------------------------------------------------
 // --- SDL
 //------------------------------------------------------------------------------
-void SDLCALL SFXGeneratorStereo::audio_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount)
+void SFXGeneratorStereo::renderStream(void* user, float* buffer, int frames, int queuedFrames)
 {
-    if (!userdata) return;
-    auto* gen = static_cast<SFXGeneratorStereo*>(userdata);
-
-    if (!gen)
-        return;
-
-    int frames_needed = additional_amount / (sizeof(float) * 2);
-
-    if (frames_needed > 0)
-    {
-        int totalFrames = frames_needed * 2;
-        std::lock_guard<std::recursive_mutex> lock(gen->mParamsMutex);
-        // if (gen->mState.playing_sample)
-        {
-
-            if (gen->mAudioBuffer.size() < totalFrames) {
-                gen->mAudioBuffer.resize(totalFrames);
-                std::fill(gen->mAudioBuffer.begin(), gen->mAudioBuffer.end(), 0.f);
-            }
+    auto* gen = static_cast<SFXGeneratorStereo*>(user);
+    (void)queuedFrames;
 
-            gen->SynthSample(frames_needed, gen->mAudioBuffer.data());
+    std::lock_guard<std::recursive_mutex> lock(gen->mParamsMutex);
 
-            #ifdef SFX_USE_DSP
-            for (auto& effect : gen->mDspEffects) {
-                effect->process(gen->mAudioBuffer.data(), totalFrames, 2);
-            }
-            #endif
+    gen->SynthSample(frames, buffer);
 
-            // SDL_PutAudioStreamData(stream, stereoBuffer.data(), additional_amount);
-            SDL_PutAudioStreamData(stream, gen->mAudioBuffer.data(), totalFrames * sizeof(float));
-        }
-    }
+    #ifdef SFX_USE_DSP
+    int totalFrames = frames * 2;
+    // between sounds the effects ring out and are then skipped
+    DSP::processChain(gen->mDspEffects, buffer, totalFrames, 2);
+    #endif
 }
 
 //------------------------------------------------------------------------------
@@ -1178,11 +1162,11 @@ bool SFXGeneratorStereo::saveWavFile(const std::string& filename, const std::vec
 void SFXGeneratorStereo::detachAudio(){
     dLog("SFXGeneratorStereo::detachAudio");
     SDL_PauseAudioStreamDevice(mStream);
-    SDL_SetAudioStreamGetCallback(mStream, NULL, NULL);
+    mStreamWorker.stop();
 }
 void SFXGeneratorStereo::attachAudio() {
     dLog("SFXGeneratorStereo::attachAudio");
-    SDL_SetAudioStreamGetCallback(mStream, SFXGeneratorStereo::audio_callback, this);
+    mStreamWorker.start(mStream, 2, mSpec.freq, &SFXGeneratorStereo::renderStream, this, STREAM_BLOCK);
     SDL_ResumeAudioStreamDevice(mStream);
 }
 
@@ -1205,7 +1189,7 @@ bool SFXGeneratorStereo::initSDLAudio()
         return false;
     }
 
-    SDL_SetAudioStreamGetCallback(mStream, SFXGeneratorStereo::audio_callback, this);
+    mStreamWorker.start(mStream, 2, mSpec.freq, &SFXGeneratorStereo::renderStream, this, STREAM_BLOCK);
 
 
 
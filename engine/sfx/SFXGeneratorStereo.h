@@ -19,6 +19,8 @@
 #include <cstring>
 #include <mutex>
 
+#include <DSP_StreamWorker.h>
+
 #ifdef SFX_USE_DSP
 #include <DSP.h>
 #endif
@@ -44,8 +46,6 @@ class SFXGeneratorStereo
 
     SDL_AudioSpec mSpec;
 
-    std::vector<float>mAudioBuffer;
-
 public:
     // Parameters that define the sound
     struct SFXParams
@@ -226,7 +226,8 @@ public:
     //------------------------------------------------------------------------------
     // --- SDL
     //------------------------------------------------------------------------------
-    static void SDLCALL audio_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount);
+    // runs on mStreamWorker, which keeps mStream filled
+    static void renderStream(void* user, float* buffer, int frames, int queuedFrames);
     bool initSDLAudio();
 
     void stop() {
@@ -235,6 +236,10 @@ public:
     }
 
     SDL_AudioStream* getAudioStream() { return mStream; }
+    // seconds rendered ahead of the device
+    void setStreamLatency(float seconds) { mStreamWorker.setTargetLatency(seconds); }
+    float getStreamLatency() const { return mStreamWorker.getTargetLatency(); }
+    DSP::StreamWorker::Stats getStreamStats() const { return mStreamWorker.getStats(); }
     float getVolume() {
         if (mStream) {
             float gain = SDL_GetAudioStreamGain(mStream);
@@ -259,6 +264,8 @@ private:
     float frnd(float range);
     std::mt19937 m_rand_engine;
     SDL_AudioStream* mStream = nullptr;
+    DSP::StreamWorker mStreamWorker;
+    static constexpr int STREAM_BLOCK = 512;
     void ResetParamsNoLock();
 
 public:
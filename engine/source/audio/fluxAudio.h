@@ -3,11 +3,18 @@
 // SPDX-License-Identifier: MIT
 //-----------------------------------------------------------------------------
 // Singleton
+//
+// Owns the output device, the software mixer (getMixer()) which plays all
+// FluxAudioStream's through one device stream and the background decoder of
+// streamed files (getDecodeService()). Generators with their own
+// callback (SFX, OPL3, ...) still bind a stream with bindStream.
 //-----------------------------------------------------------------------------
 #pragma once
 
 #include "SDL3/SDL.h"
 #include "utils/errorlog.h"
+#include "audio/fluxAudioMixer.h"
+#include "audio/fluxDecodeService.h"
 
 namespace FluxAudio {
 
@@ -31,6 +38,8 @@ namespace FluxAudio {
     private:
         Manager() : mAudioDevice(0) {}
         ~Manager() {
+            mMixer.shutdown();
+            mDecodeService.shutdown();
             if (mAudioDevice) SDL_CloseAudioDevice(mAudioDevice);
         }
 
@@ -42,6 +51,9 @@ namespace FluxAudio {
 
         SDL_AudioSpec mOutputSpec;
 
+        Mixer mMixer;
+        DecodeService mDecodeService;
+
     public:
         // Get the single instance
         static Manager&  getInstance() {
@@ -65,12 +77,28 @@ namespace FluxAudio {
             }
             Log("Init Audiomanager ID:%d.", mAudioDevice);
 
+            if (mAudioDevice) {
+                uint32_t rate = mOutputSpec.freq > 0 ? (uint32_t)mOutputSpec.freq : 48000;
+                if (!mMixer.init(rate) || !mMixer.attach(mAudioDevice))
+                    Log("[error] Audiomanager: mixer not available!");
+                mDecodeService.init();
+            }
+
             return mAudioDevice != 0;
         }
 
         SDL_AudioDeviceID getDeviceID() const { return mAudioDevice; }
         const SDL_AudioSpec getAudioSpec() { return mOutputSpec; }
 
+        Mixer& getMixer() { return mMixer; }
+        DecodeService& getDecodeService() { return mDecodeService; }
+
+        // once per frame from the main thread
+        void update() {
+            mDecodeService.update();
+            mMixer.update();
+        }
+
         bool bindStream(SDL_AudioStream* stream, bool isNewStream = false)
         {
             if (!mAudioDevice || !stream)
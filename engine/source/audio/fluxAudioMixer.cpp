@@ -0,0 +1,1251 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+#include "audio/fluxAudioMixer.h"
+#include "utils/errorlog.h"
+
+#include <DSP_EffectsManager.h>
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLUX_MIXER_SSE
+#endif
+
+namespace FluxAudio {
+
+//-------------------------------------------------------------------------------
+// dst[i] += src[i] * (gain + delta * i)
+static inline void mixRamp(float* dst, const float* src, float gain, float delta, uint32_t frames)
+{
+    uint32_t i = 0;
+#ifdef FLUX_MIXER_SSE
+    __m128 g = _mm_setr_ps(gain, gain + delta, gain + 2.f * delta, gain + 3.f * delta);
+    const __m128 d = _mm_set1_ps(4.f * delta);
+    for (; i + 4 <= frames; i += 4) {
+        __m128 acc = _mm_loadu_ps(dst + i);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+        _mm_storeu_ps(dst + i, acc);
+        g = _mm_add_ps(g, d);
+    }
+#endif
+    for (; i < frames; i++)
+        dst[i] += src[i] * (gain + delta * (float)i);
+}
+//-------------------------------------------------------------------------------
+// mono sources use an equal power pan, stereo sources a balance
+static inline void panGains(const VoiceParams& params, uint32_t channels, float& left, float& right)
+{
+    const float pan = std::clamp(params.pan, -1.f, 1.f);
+    if (channels == 1) {
+        const float theta = (pan + 1.f) * 0.78539816f; // pi / 4
+        left = params.gain * std::cos(theta);
+        right = params.gain * std::sin(theta);
+    } else {
+        left = params.gain * std::min(1.f, 1.f - pan);
+        right = params.gain * std::min(1.f, 1.f + pan);
+    }
+}
+//-------------------------------------------------------------------------------
+static inline uint32_t nextPow2(uint32_t value)
+{
+    uint32_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+//-------------------------------------------------------------------------------
+bool Mixer::init(uint32_t sampleRate, uint32_t maxVoices)
+{
+    shutdown();
+
+    if (sampleRate == 0 || maxVoices == 0 || maxVoices > 0xFFFF) {
+        Log("[error] Mixer::init: invalid sample rate %u or voice count %u", sampleRate, maxVoices);
+        return false;
+    }
+
+    mSampleRate = sampleRate;
+    mMaxVoices = maxVoices;
+
+    mVoices.assign(maxVoices, Voice());
+    mActive.clear();
+    mActive.reserve(maxVoices);
+
+    mSlots.assign(maxVoices, Slot());
+    mFreeSlots.clear();
+    mFreeSlots.reserve(maxVoices);
+    for (uint32_t i = maxVoices; i-- > 0;)
+        mFreeSlots.push_back(i);
+    mGraveyard.clear();
+    mStartCounter = 0;
+
+    mCommands.assign(COMMAND_CAPACITY, Command());
+    mCmdWrite.store(0);
+    mCmdRead.store(0);
+    mCmdSeq = 0;
+    mCmdProcessed.store(0);
+
+    // a slot has at most a few releases in flight (stolen + natural end)
+    mReleased.assign(nextPow2(maxVoices * 4), Released{ 0, 0 });
+    mRelWrite.store(0);
+    mRelRead.store(0);
+    mReleasePending.clear();
+    mReleasePending.reserve(maxVoices);
+
+    for (uint32_t b = 0; b < MAX_BUSES; b++) {
+        mBusEffects[b] = nullptr;
+        mBusAllocated[b] = (b == 0);
+        mBusUsed[b] = (b == 0);
+        mBusL[b].assign(BLOCK_FRAMES, 0.f);
+        mBusR[b].assign(BLOCK_FRAMES, 0.f);
+    }
+    mTmpL.assign(BLOCK_FRAMES, 0.f);
+    mTmpR.assign(BLOCK_FRAMES, 0.f);
+    mStreamTmp.assign(((size_t)(BLOCK_FRAMES * MAX_STEP) + 2) * 2, 0.f);
+    mInterleaved.assign(BLOCK_FRAMES * 2, 0.f);
+    mDeviceBuffer.assign(BLOCK_FRAMES * 2, 0.f);
+    mMasterGain = 1.f;
+
+    const size_t spatialSize = ((size_t)maxVoices + 3) & ~(size_t)3;
+    for (std::vector<float>* array : { &mSpatial.x, &mSpatial.y, &mSpatial.gain, &mSpatial.stereo,
+                                       &mSpatial.left, &mSpatial.right })
+        array->assign(spatialSize, 0.f);
+    mSpatial.slot.assign(spatialSize, 0);
+    mSpatial.count = 0;
+    mListener = Listener();
+    mSentListener = Listener();
+
+    mStatActive.store(0);
+    mStatPeak.store(0);
+    mStatStolen.store(0);
+    mStatRejected.store(0);
+    mStatUnderruns.store(0);
+    mStatVirtual.store(0);
+    mStatLoad.store(0.f);
+
+    dLog("Mixer: %u voices at %u Hz.", maxVoices, sampleRate);
+    return true;
+}
+//-------------------------------------------------------------------------------
+void Mixer::shutdown()
+{
+    detach();
+
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    // the audio thread is gone, everything can be dropped
+    mActive.clear();
+    mVoices.clear();
+    mSlots.clear();
+    mFreeSlots.clear();
+    mGraveyard.clear();
+    mCommands.clear();
+    mReleased.clear();
+    mReleasePending.clear();
+    mSpatial.count = 0;
+    mMaxVoices = 0;
+}
+//-------------------------------------------------------------------------------
+bool Mixer::attach(SDL_AudioDeviceID device)
+{
+    detach();
+    if (!device || mMaxVoices == 0)
+        return false;
+
+    SDL_AudioSpec spec;
+    spec.format = SDL_AUDIO_F32;
+    spec.channels = 2;
+    spec.freq = (int)mSampleRate;
+
+    mDeviceStream = SDL_CreateAudioStream(&spec, &spec);
+    if (!mDeviceStream) {
+        Log("[error] Mixer: failed to create the device stream: %s", SDL_GetError());
+        return false;
+    }
+
+    if (!SDL_SetAudioStreamGetCallback(mDeviceStream, deviceCallback, this)
+        || !SDL_BindAudioStream(device, mDeviceStream)) {
+        Log("[error] Mixer: failed to bind the device stream: %s", SDL_GetError());
+        SDL_DestroyAudioStream(mDeviceStream);
+        mDeviceStream = nullptr;
+        return false;
+    }
+    return true;
+}
+//-------------------------------------------------------------------------------
+void Mixer::detach()
+{
+    if (!mDeviceStream)
+        return;
+    // the callback runs under the stream lock, after this it is not called anymore
+    SDL_DestroyAudioStream(mDeviceStream);
+    mDeviceStream = nullptr;
+}
+//-------------------------------------------------------------------------------
+void SDLCALL Mixer::deviceCallback(void* userdata, SDL_AudioStream* stream, int additional, int /*total*/)
+{
+    Mixer* mixer = static_cast<Mixer*>(userdata);
+    DSP::ScopedDenormalGuard denormalGuard;
+    SetLogThreadRealtime(true);
+    uint32_t frames = additional > 0 ? (uint32_t)additional / (2 * sizeof(float)) : 0;
+
+    while (frames > 0) {
+        uint32_t count = std::min(frames, BLOCK_FRAMES);
+        mixer->mix(mixer->mDeviceBuffer.data(), count);
+        SDL_PutAudioStreamData(stream, mixer->mDeviceBuffer.data(), (int)(count * 2 * sizeof(float)));
+        frames -= count;
+    }
+}
+//-------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------
+// main thread
+//-------------------------------------------------------------------------------
+bool Mixer::pushCommand(const Command& cmd)
+{
+    if (mCommands.empty())
+        return false;
+
+    const uint32_t w = mCmdWrite.load(std::memory_order_relaxed);
+    if (w - mCmdRead.load(std::memory_order_acquire) >= COMMAND_CAPACITY) {
+        Log("[warn] Mixer: command queue is full, is the audio device running?");
+        return false;
+    }
+    mCommands[w & (COMMAND_CAPACITY - 1)] = cmd;
+    mCmdWrite.store(w + 1, std::memory_order_release);
+    mCmdSeq++;
+    return true;
+}
+//-------------------------------------------------------------------------------
+void Mixer::collectReleased()
+{
+    if (mReleased.empty())
+        return;
+
+    const uint32_t mask = (uint32_t)mReleased.size() - 1;
+    uint32_t r = mRelRead.load(std::memory_order_relaxed);
+    const uint32_t w = mRelWrite.load(std::memory_order_acquire);
+    for (; r != w; r++) {
+        const Released& rel = mReleased[r & mask];
+        Slot& slot = mSlots[rel.slot];
+        if (slot.id != rel.id)
+            continue; // slot was stolen in the meantime
+        slot.id = 0;
+        slot.stopping = false;
+        slot.buffer.reset();
+        slot.ring.reset();
+        mFreeSlots.push_back(rel.slot);
+    }
+    mRelRead.store(r, std::memory_order_release);
+}
+//-------------------------------------------------------------------------------
+void Mixer::buryGraves()
+{
+    if (mGraveyard.empty())
+        return;
+    const uint64_t processed = mCmdProcessed.load(std::memory_order_acquire);
+    std::erase_if(mGraveyard, [processed](const Grave& grave) { return grave.seq <= processed; });
+}
+//-------------------------------------------------------------------------------
+uint32_t Mixer::acquireSlot(uint8_t priority, bool& stolen)
+{
+    stolen = false;
+    collectReleased();
+
+    if (!mFreeSlots.empty()) {
+        uint32_t slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        return slot;
+    }
+
+    // steal: stopping voices first, then lowest priority, then oldest
+    uint32_t victim = mMaxVoices;
+    for (uint32_t i = 0; i < mMaxVoices; i++) {
+        const Slot& slot = mSlots[i];
+        if (victim == mMaxVoices) {
+            victim = i;
+            continue;
+        }
+        const Slot& best = mSlots[victim];
+        if (slot.stopping != best.stopping) {
+            if (slot.stopping) victim = i;
+            continue;
+        }
+        if (slot.priority < best.priority
+            || (slot.priority == best.priority && slot.started < best.started))
+            victim = i;
+    }
+
+    if (victim == mMaxVoices
+        || (!mSlots[victim].stopping && mSlots[victim].priority > priority)) {
+        mStatRejected.fetch_add(1, std::memory_order_relaxed);
+        return mMaxVoices;
+    }
+
+    stolen = true;
+    mStatStolen.fetch_add(1, std::memory_order_relaxed);
+    return victim;
+}
+//-------------------------------------------------------------------------------
+VoiceID Mixer::startVoice(Command& cmd, std::shared_ptr<const SampleBuffer> buffer,
+                          std::shared_ptr<PcmRing> ring)
+{
+    bool stolen = false;
+    const uint32_t index = acquireSlot(cmd.params.priority, stolen);
+    if (index >= mMaxVoices)
+        return 0;
+
+    Slot& slot = mSlots[index];
+    uint32_t generation = (slot.generation + 1) & 0xFFFF;
+    if (generation == 0)
+        generation = 1;
+
+    cmd.type = CommandType::Play;
+    cmd.slot = index;
+    cmd.id = (generation << 16) | index;
+
+    if (!pushCommand(cmd)) {
+        if (!stolen)
+            mFreeSlots.push_back(index);
+        return 0;
+    }
+
+    // the audio thread may still read the stolen sources until the play is applied
+    if (stolen)
+        mGraveyard.push_back({ mCmdSeq, std::move(slot.buffer), std::move(slot.ring) });
+
+    slot.id = cmd.id;
+    slot.generation = generation;
+    slot.priority = cmd.params.priority;
+    slot.started = ++mStartCounter;
+    slot.stopping = false;
+    slot.buffer = std::move(buffer);
+    slot.ring = std::move(ring);
+    return cmd.id;
+}
+//-------------------------------------------------------------------------------
+bool Mixer::lookup(VoiceID id, uint32_t& slot)
+{
+    slot = id & 0xFFFF;
+    return id != 0 && slot < mMaxVoices && mSlots[slot].id == id && !mSlots[slot].stopping;
+}
+//-------------------------------------------------------------------------------
+void Mixer::sendVoiceCommand(VoiceID id, CommandType type, float value)
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    uint32_t slot;
+    if (!lookup(id, slot))
+        return;
+    Command cmd;
+    cmd.type = type;
+    cmd.slot = slot;
+    cmd.id = id;
+    cmd.value = value;
+    pushCommand(cmd);
+}
+//-------------------------------------------------------------------------------
+VoiceID Mixer::play(std::shared_ptr<const SampleBuffer> buffer, const VoiceParams& params)
+{
+    if (!buffer || buffer->frames == 0 || buffer->channels < 1 || buffer->channels > 2 || buffer->sampleRate == 0)
+        return 0;
+
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    Command cmd;
+    cmd.params = params;
+    cmd.source = SourceType::Buffer;
+    cmd.buffer = buffer.get();
+    return startVoice(cmd, std::move(buffer), nullptr);
+}
+//-------------------------------------------------------------------------------
+VoiceID Mixer::playStream(std::shared_ptr<PcmRing> ring, uint32_t sampleRate, const VoiceParams& params)
+{
+    if (!ring || ring->getChannels() > 2 || sampleRate == 0)
+        return 0;
+
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    Command cmd;
+    cmd.params = params;
+    cmd.params.loop = false; // looping is up to the producer
+    cmd.source = SourceType::Stream;
+    cmd.ring = ring.get();
+    cmd.ringRate = sampleRate;
+    return startVoice(cmd, nullptr, std::move(ring));
+}
+//-------------------------------------------------------------------------------
+void Mixer::stop(VoiceID id)
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    uint32_t slot;
+    if (!lookup(id, slot))
+        return;
+    Command cmd;
+    cmd.type = CommandType::Stop;
+    cmd.slot = slot;
+    cmd.id = id;
+    // the voice fades out for one block, the slot is freed when it is released
+    if (pushCommand(cmd))
+        mSlots[slot].stopping = true;
+}
+//-------------------------------------------------------------------------------
+bool Mixer::isPlaying(VoiceID id)
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    collectReleased();
+    uint32_t slot;
+    return lookup(id, slot);
+}
+//-------------------------------------------------------------------------------
+void Mixer::setGain(VoiceID id, float gain)   { sendVoiceCommand(id, CommandType::SetGain, std::max(0.f, gain)); }
+void Mixer::setPan(VoiceID id, float pan)     { sendVoiceCommand(id, CommandType::SetPan, std::clamp(pan, -1.f, 1.f)); }
+void Mixer::setPitch(VoiceID id, float pitch) { sendVoiceCommand(id, CommandType::SetPitch, std::max(0.01f, pitch)); }
+void Mixer::setLoop(VoiceID id, bool loop)    { sendVoiceCommand(id, CommandType::SetLoop, loop ? 1.f : 0.f); }
+void Mixer::setPaused(VoiceID id, bool paused){ sendVoiceCommand(id, CommandType::SetPaused, paused ? 1.f : 0.f); }
+//-------------------------------------------------------------------------------
+void Mixer::setSend(VoiceID id, uint8_t bus, float level)
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    uint32_t slot;
+    if (!lookup(id, slot) || bus >= MAX_BUSES)
+        return;
+    Command cmd;
+    cmd.type = CommandType::SetSend;
+    cmd.slot = slot;
+    cmd.id = id;
+    cmd.value = std::max(0.f, level);
+    cmd.params.sendBus = bus;
+    pushCommand(cmd);
+}
+//-------------------------------------------------------------------------------
+void Mixer::setPosition(VoiceID id, float x, float y)
+{
+    setPositions(&id, &x, &y, 1);
+}
+//-------------------------------------------------------------------------------
+void Mixer::setPositions(const VoiceID* ids, const float* x, const float* y, uint32_t count)
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    Command cmd;
+    cmd.type = CommandType::SetPosition;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!lookup(ids[i], cmd.slot))
+            continue;
+        cmd.id = ids[i];
+        cmd.x = x[i];
+        cmd.y = y[i];
+        if (!pushCommand(cmd))
+            return;
+    }
+}
+//-------------------------------------------------------------------------------
+void Mixer::setListener(float x, float y, float range, float gain)
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    range = std::max(0.f, range);
+    gain = std::max(0.f, gain);
+    if (x == mSentListener.x && y == mSentListener.y
+        && range == mSentListener.range && gain == mSentListener.gain)
+        return;
+
+    Command cmd;
+    cmd.type = CommandType::SetListener;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.value = range;
+    cmd.params.gain = gain;
+    if (pushCommand(cmd))
+        mSentListener = { x, y, range, gain };
+}
+//-------------------------------------------------------------------------------
+uint8_t Mixer::addBus(DSP::EffectsManager* effects)
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    for (uint8_t b = 1; b < MAX_BUSES; b++) {
+        if (mBusAllocated[b])
+            continue;
+        // the audio thread mixes the bus once SetBus arrives
+        Command cmd;
+        cmd.type = CommandType::SetBus;
+        cmd.slot = b;
+        cmd.effects = effects;
+        if (!pushCommand(cmd))
+            return 0;
+        mBusAllocated[b] = true;
+        return b;
+    }
+    Log("[error] Mixer::addBus: all %u buses are used", MAX_BUSES - 1);
+    return 0;
+}
+//-------------------------------------------------------------------------------
+void Mixer::setBusEffects(uint8_t bus, DSP::EffectsManager* effects)
+{
+    if (bus >= MAX_BUSES)
+        return;
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    if (!mBusAllocated[bus])
+        return;
+    Command cmd;
+    cmd.type = CommandType::SetBus;
+    cmd.slot = bus;
+    cmd.effects = effects;
+    pushCommand(cmd);
+}
+//-------------------------------------------------------------------------------
+void Mixer::setMasterGain(float gain)
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    Command cmd;
+    cmd.type = CommandType::SetMasterGain;
+    cmd.value = std::max(0.f, gain);
+    pushCommand(cmd);
+}
+//-------------------------------------------------------------------------------
+void Mixer::update()
+{
+    std::lock_guard<std::recursive_mutex> lock(mApiMutex);
+    collectReleased();
+    buryGraves();
+}
+//-------------------------------------------------------------------------------
+Mixer::Stats Mixer::getStats() const
+{
+    Stats stats;
+    stats.activeVoices = mStatActive.load(std::memory_order_relaxed);
+    stats.peakVoices = mStatPeak.load(std::memory_order_relaxed);
+    stats.stolen = mStatStolen.load(std::memory_order_relaxed);
+    stats.rejected = mStatRejected.load(std::memory_order_relaxed);
+    stats.streamUnderruns = mStatUnderruns.load(std::memory_order_relaxed);
+    stats.virtualVoices = mStatVirtual.load(std::memory_order_relaxed);
+    stats.load = mStatLoad.load(std::memory_order_relaxed);
+    return stats;
+}
+//-------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------
+// audio thread
+//-------------------------------------------------------------------------------
+void Mixer::applyCommand(const Command& cmd)
+{
+    switch (cmd.type) {
+        case CommandType::SetBus:
+            mBusEffects[cmd.slot] = cmd.effects;
+            mBusUsed[cmd.slot] = true;
+            return;
+        case CommandType::SetMasterGain:
+            mMasterGain = cmd.value;
+            return;
+        case CommandType::SetListener:
+            mListener = { cmd.x, cmd.y, cmd.value, cmd.params.gain };
+            return;
+        default:
+            break;
+    }
+
+    Voice& voice = mVoices[cmd.slot];
+    if (cmd.type == CommandType::Play) {
+        // a stolen voice is simply overwritten
+        const bool listed = voice.listed;
+        removeSpatial(voice);
+        voice = Voice();
+        voice.id = cmd.id;
+        voice.source = cmd.source;
+        voice.buffer = cmd.buffer;
+        voice.ring = cmd.ring;
+        voice.params = cmd.params;
+        voice.params.pitch = std::max(0.01f, voice.params.pitch);
+        if (cmd.source == SourceType::Buffer) {
+            voice.channels = cmd.buffer->channels;
+            voice.srcRate = (float)cmd.buffer->sampleRate;
+        } else {
+            voice.channels = cmd.ring->getChannels();
+            voice.srcRate = (float)cmd.ringRate;
+        }
+        voice.step = std::min(MAX_STEP, (double)voice.srcRate / (double)mSampleRate * voice.params.pitch);
+        if (voice.params.positional)
+            addSpatial(voice, cmd.slot); // fades in from silence
+        else
+            panGains(voice.params, voice.channels, voice.curL, voice.curR);
+        voice.listed = listed;
+        if (!voice.listed) {
+            voice.listed = true;
+            mActive.push_back(cmd.slot);
+        }
+        return;
+    }
+
+    if (voice.id != cmd.id || voice.source == SourceType::None)
+        return;
+
+    switch (cmd.type) {
+        case CommandType::Stop:     voice.stopping = true; break;
+        case CommandType::SetPaused: voice.paused = cmd.value != 0.f; break;
+        case CommandType::SetGain:
+            voice.params.gain = cmd.value;
+            if (voice.spatial >= 0)
+                mSpatial.gain[voice.spatial] = cmd.value;
+            break;
+        case CommandType::SetPosition:
+            voice.params.positional = true;
+            voice.params.x = cmd.x;
+            voice.params.y = cmd.y;
+            if (voice.spatial < 0)
+                addSpatial(voice, cmd.slot);
+            mSpatial.x[voice.spatial] = cmd.x;
+            mSpatial.y[voice.spatial] = cmd.y;
+            break;
+        case CommandType::SetPan:   voice.params.pan = cmd.value; break;
+        case CommandType::SetLoop:  voice.params.loop = cmd.value != 0.f; break;
+        case CommandType::SetPitch:
+            voice.params.pitch = cmd.value;
+            voice.step = std::min(MAX_STEP, (double)voice.srcRate / (double)mSampleRate * cmd.value);
+            break;
+        case CommandType::SetSend:
+            voice.params.sendBus = cmd.params.sendBus;
+            voice.params.sendLevel = cmd.value;
+            break;
+        default:
+            break;
+    }
+}
+//-------------------------------------------------------------------------------
+void Mixer::applyCommands()
+{
+    uint32_t r = mCmdRead.load(std::memory_order_relaxed);
+    const uint32_t w = mCmdWrite.load(std::memory_order_acquire);
+    const uint32_t count = w - r;
+    for (; r != w; r++)
+        applyCommand(mCommands[r & (COMMAND_CAPACITY - 1)]);
+    mCmdRead.store(r, std::memory_order_release);
+    if (count)
+        mCmdProcessed.fetch_add(count, std::memory_order_release);
+}
+//-------------------------------------------------------------------------------
+bool Mixer::pushReleased(const Released& rel)
+{
+    const uint32_t mask = (uint32_t)mReleased.size() - 1;
+    const uint32_t w = mRelWrite.load(std::memory_order_relaxed);
+    if (w - mRelRead.load(std::memory_order_acquire) > mask)
+        return false;
+    mReleased[w & mask] = rel;
+    mRelWrite.store(w + 1, std::memory_order_release);
+    return true;
+}
+//-------------------------------------------------------------------------------
+// retried every block, the main thread frees the slot a little later
+void Mixer::flushPendingReleases()
+{
+    size_t done = 0;
+    while (done < mReleasePending.size() && pushReleased(mReleasePending[done]))
+        done++;
+    if (done)
+        mReleasePending.erase(mReleasePending.begin(), mReleasePending.begin() + done);
+}
+//-------------------------------------------------------------------------------
+void Mixer::releaseVoice(Voice& voice, uint32_t slot)
+{
+    // ring full (main thread did not collect for a while): keep it, a slot
+    // that is not released would be lost until it gets stolen
+    const Released rel = { slot, voice.id };
+    if (!mReleasePending.empty() || !pushReleased(rel)) {
+        auto it = std::find_if(mReleasePending.begin(), mReleasePending.end(),
+                               [slot](const Released& p) { return p.slot == slot; });
+        if (it != mReleasePending.end()) *it = rel;
+        else mReleasePending.push_back(rel); // capacity mMaxVoices, no allocation
+    }
+    removeSpatial(voice);
+    voice.source = SourceType::None;
+    voice.buffer = nullptr;
+    voice.ring = nullptr;
+    voice.listed = false;
+}
+//-------------------------------------------------------------------------------
+// fills mTmpL (and mTmpR for stereo), returns the frames produced. Less than
+// frames means the voice ended, the rest is silence.
+uint32_t Mixer::renderBuffer(Voice& voice, uint32_t frames)
+{
+    const SampleBuffer* buffer = voice.buffer;
+    const float* data = buffer->data.data();
+    const uint32_t length = buffer->frames;
+    const uint32_t ch = voice.channels;
+    float* outL = mTmpL.data();
+    float* outR = mTmpR.data();
+
+    uint32_t i = 0;
+    if (voice.step == 1.0 && voice.pos == std::floor(voice.pos)) {
+        // no resampling, plain copy
+        uint32_t pos = (uint32_t)voice.pos;
+        while (i < frames) {
+            if (pos >= length) {
+                if (!voice.params.loop)
+                    break;
+                pos = 0;
+            }
+            const uint32_t count = std::min(frames - i, length - pos);
+            const float* src = data + (size_t)pos * ch;
+            if (ch == 1) {
+                std::memcpy(outL + i, src, count * sizeof(float));
+            } else {
+                for (uint32_t k = 0; k < count; k++) {
+                    outL[i + k] = src[k * 2];
+                    outR[i + k] = src[k * 2 + 1];
+                }
+            }
+            i += count;
+            pos += count;
+        }
+        voice.pos = pos;
+    } else {
+        // linear interpolation
+        double pos = voice.pos;
+        const double step = voice.step;
+        for (; i < frames; i++) {
+            if (pos >= length) {
+                if (!voice.params.loop)
+                    break;
+                pos = std::fmod(pos, (double)length);
+            }
+            const uint32_t index = (uint32_t)pos;
+            const float t = (float)(pos - index);
+            uint32_t next = index + 1;
+            if (next >= length)
+                next = voice.params.loop ? 0 : index;
+            const float* s0 = data + (size_t)index * ch;
+            const float* s1 = data + (size_t)next * ch;
+            outL[i] = s0[0] + (s1[0] - s0[0]) * t;
+            if (ch > 1)
+                outR[i] = s0[1] + (s1[1] - s0[1]) * t;
+            pos += step;
+        }
+        voice.pos = pos;
+    }
+
+    if (i < frames) {
+        std::fill(outL + i, outL + frames, 0.f);
+        if (ch > 1)
+            std::fill(outR + i, outR + frames, 0.f);
+    }
+    return i;
+}
+//-------------------------------------------------------------------------------
+// The last source frame of a block is kept in voice.carry so the interpolation
+// across blocks does not need to look ahead in the ring.
+uint32_t Mixer::renderStream(Voice& voice, uint32_t frames)
+{
+    PcmRing* ring = voice.ring;
+    const uint32_t ch = voice.channels;
+    float* tmp = mStreamTmp.data();
+    float* outL = mTmpL.data();
+    float* outR = mTmpR.data();
+
+    if (!voice.primed) {
+        if (ring->read(voice.carry, 1) == 0) {
+            if (ring->isFinished())
+                return 0;
+            // producer did not deliver yet
+            std::fill(outL, outL + frames, 0.f);
+            std::fill(outR, outR + frames, 0.f);
+            return frames;
+        }
+        voice.primed = true;
+        voice.pos = 0.0;
+    }
+
+    const double frac = voice.pos;
+    const double step = voice.step;
+    const double end = frac + frames * step;
+    const uint32_t need = std::max((uint32_t)(frac + (frames - 1) * step) + 1, (uint32_t)end);
+
+    std::memcpy(tmp, voice.carry, ch * sizeof(float));
+    const uint32_t got = ring->read(tmp + ch, need);
+    bool finished = false;
+    if (got < need) {
+        finished = ring->isFinished();
+        if (!finished) {
+            mStatUnderruns.fetch_add(1, std::memory_order_relaxed);
+            ring->noteUnderrun();
+        }
+        std::fill(tmp + (size_t)(got + 1) * ch, tmp + (size_t)(need + 1) * ch, 0.f);
+    }
+
+    uint32_t i = 0;
+    for (; i < frames; i++) {
+        const double pos = frac + i * step;
+        const uint32_t index = (uint32_t)pos;
+        if (finished && index + 1 > got)
+            break;
+        const float t = (float)(pos - index);
+        const float* s0 = tmp + (size_t)index * ch;
+        const float* s1 = s0 + ch;
+        outL[i] = s0[0] + (s1[0] - s0[0]) * t;
+        if (ch > 1)
+            outR[i] = s0[1] + (s1[1] - s0[1]) * t;
+    }
+
+    if (i < frames) {
+        std::fill(outL + i, outL + frames, 0.f);
+        std::fill(outR + i, outR + frames, 0.f);
+        return i;
+    }
+
+    const uint32_t consumed = (uint32_t)end;
+    std::memcpy(voice.carry, tmp + (size_t)consumed * ch, ch * sizeof(float));
+    voice.pos = end - consumed;
+    return frames;
+}
+//-------------------------------------------------------------------------------
+void Mixer::addSpatial(Voice& voice, uint32_t slot)
+{
+    if (voice.spatial >= 0)
+        return;
+    const uint32_t index = mSpatial.count++;
+    mSpatial.x[index] = voice.params.x;
+    mSpatial.y[index] = voice.params.y;
+    mSpatial.gain[index] = voice.params.gain;
+    mSpatial.stereo[index] = voice.channels > 1 ? 1.f : 0.f;
+    mSpatial.left[index] = 0.f;
+    mSpatial.right[index] = 0.f;
+    mSpatial.slot[index] = slot;
+    voice.spatial = (int32_t)index;
+}
+//-------------------------------------------------------------------------------
+void Mixer::removeSpatial(Voice& voice)
+{
+    if (voice.spatial < 0)
+        return;
+    const uint32_t index = (uint32_t)voice.spatial;
+    const uint32_t last = --mSpatial.count;
+    if (index != last) {
+        mSpatial.x[index] = mSpatial.x[last];
+        mSpatial.y[index] = mSpatial.y[last];
+        mSpatial.gain[index] = mSpatial.gain[last];
+        mSpatial.stereo[index] = mSpatial.stereo[last];
+        mSpatial.left[index] = mSpatial.left[last];
+        mSpatial.right[index] = mSpatial.right[last];
+        mSpatial.slot[index] = mSpatial.slot[last];
+        mVoices[mSpatial.slot[index]].spatial = (int32_t)index;
+    }
+    voice.spatial = -1;
+}
+//-------------------------------------------------------------------------------
+// Target gains of all positioned voices:
+//   falloff = (1 - dist / range)^2, 0 outside the range
+//   mono    = equal power pan, sqrt((1 -+ pan) / 2)
+//   stereo  = balance, min(1, 1 -+ pan)
+// with pan = dx / range. The set is padded to four, the extra lanes are junk.
+void Mixer::updateSpatial()
+{
+    const uint32_t count = (mSpatial.count + 3) & ~3u;
+    const float invRange = mListener.range > 0.f ? 1.f / mListener.range : 0.f;
+    const float* x = mSpatial.x.data();
+    const float* y = mSpatial.y.data();
+    const float* gain = mSpatial.gain.data();
+    const float* stereo = mSpatial.stereo.data();
+    float* left = mSpatial.left.data();
+    float* right = mSpatial.right.data();
+
+    uint32_t i = 0;
+#ifdef FLUX_MIXER_SSE
+    const __m128 lx = _mm_set1_ps(mListener.x);
+    const __m128 ly = _mm_set1_ps(mListener.y);
+    const __m128 inv = _mm_set1_ps(invRange);
+    const __m128 lgain = _mm_set1_ps(mListener.gain);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 minusOne = _mm_set1_ps(-1.f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i < count; i += 4) {
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), lx);
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), ly);
+        const __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 fall = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(dist, inv)));
+        fall = _mm_mul_ps(_mm_mul_ps(fall, fall), _mm_mul_ps(_mm_loadu_ps(gain + i), lgain));
+
+        const __m128 pan = _mm_min_ps(one, _mm_max_ps(minusOne, _mm_mul_ps(dx, inv)));
+        const __m128 monoL = _mm_sqrt_ps(_mm_mul_ps(half, _mm_sub_ps(one, pan)));
+        const __m128 monoR = _mm_sqrt_ps(_mm_mul_ps(half, _mm_add_ps(one, pan)));
+        const __m128 balL = _mm_min_ps(one, _mm_sub_ps(one, pan));
+        const __m128 balR = _mm_min_ps(one, _mm_add_ps(one, pan));
+        const __m128 st = _mm_loadu_ps(stereo + i);
+        const __m128 l = _mm_add_ps(monoL, _mm_mul_ps(st, _mm_sub_ps(balL, monoL)));
+        const __m128 r = _mm_add_ps(monoR, _mm_mul_ps(st, _mm_sub_ps(balR, monoR)));
+        _mm_storeu_ps(left + i, _mm_mul_ps(l, fall));
+        _mm_storeu_ps(right + i, _mm_mul_ps(r, fall));
+    }
+#endif
+    for (; i < count; i++) {
+        const float dx = x[i] - mListener.x;
+        const float dy = y[i] - mListener.y;
+        const float dist = std::sqrt(dx * dx + dy * dy);
+        float fall = std::max(0.f, 1.f - dist * invRange);
+        fall = fall * fall * gain[i] * mListener.gain;
+
+        const float pan = std::clamp(dx * invRange, -1.f, 1.f);
+        const float monoL = std::sqrt(0.5f * (1.f - pan));
+        const float monoR = std::sqrt(0.5f * (1.f + pan));
+        const float l = monoL + stereo[i] * (std::min(1.f, 1.f - pan) - monoL);
+        const float r = monoR + stereo[i] * (std::min(1.f, 1.f + pan) - monoR);
+        left[i] = l * fall;
+        right[i] = r * fall;
+    }
+}
+//-------------------------------------------------------------------------------
+bool Mixer::advanceVirtual(Voice& voice, uint32_t frames)
+{
+    const double end = voice.pos + frames * voice.step;
+
+    if (voice.source == SourceType::Buffer) {
+        const double length = (double)voice.buffer->frames;
+        if (end < length) {
+            voice.pos = end;
+        } else {
+            if (!voice.params.loop)
+                return false;
+            voice.pos = std::fmod(end, length);
+        }
+        return true;
+    }
+
+    // streams: the producer keeps filling the ring, the data is dropped unheard.
+    // Unprimed, the next audible block starts with a fresh carry frame.
+    const uint32_t consumed = (uint32_t)end;
+    voice.pos = end - consumed;
+    voice.primed = false;
+    const uint32_t dropped = voice.ring->skip(consumed);
+    return !(dropped < consumed && voice.ring->isFinished() && voice.ring->availableRead() == 0);
+}
+//-------------------------------------------------------------------------------
+void Mixer::mixBlock(float* out, uint32_t frames)
+{
+    for (uint32_t b = 0; b < MAX_BUSES; b++) {
+        if (!mBusUsed[b])
+            continue;
+        std::fill(mBusL[b].begin(), mBusL[b].begin() + frames, 0.f);
+        std::fill(mBusR[b].begin(), mBusR[b].begin() + frames, 0.f);
+    }
+
+    if (!mReleasePending.empty())
+        flushPendingReleases();
+
+    mVirtualCount = 0;
+    if (mSpatial.count)
+        updateSpatial();
+
+    const float invFrames = 1.f / (float)frames;
+    float* masterL = mBusL[0].data();
+    float* masterR = mBusR[0].data();
+
+    for (size_t k = 0; k < mActive.size();) {
+        const uint32_t slot = mActive[k];
+        Voice& voice = mVoices[slot];
+        if (voice.source == SourceType::None) {
+            voice.listed = false;
+            mActive[k] = mActive.back();
+            mActive.pop_back();
+            continue;
+        }
+
+        const bool silent = voice.curL == 0.f && voice.curR == 0.f;
+
+        // paused: fade out for one block, then skip it until resumed
+        if (voice.paused && silent && !voice.stopping) {
+            k++;
+            continue;
+        }
+        // nothing left to fade out
+        if (voice.stopping && silent) {
+            releaseVoice(voice, slot);
+            mActive[k] = mActive.back();
+            mActive.pop_back();
+            continue;
+        }
+
+        float targetL = 0.f, targetR = 0.f;
+        if (!voice.stopping && !voice.paused) {
+            if (voice.spatial >= 0) {
+                targetL = mSpatial.left[voice.spatial];
+                targetR = mSpatial.right[voice.spatial];
+            } else {
+                panGains(voice.params, voice.channels, targetL, targetR);
+            }
+        }
+
+        // out of range and faded out: virtual, only the time advances
+        if (voice.spatial >= 0 && silent && targetL == 0.f && targetR == 0.f && !voice.stopping) {
+            mVirtualCount++;
+            if (!advanceVirtual(voice, frames)) {
+                releaseVoice(voice, slot);
+                mActive[k] = mActive.back();
+                mActive.pop_back();
+                continue;
+            }
+            k++;
+            continue;
+        }
+
+        const uint32_t produced = (voice.source == SourceType::Buffer)
+            ? renderBuffer(voice, frames) : renderStream(voice, frames);
+
+        const float deltaL = (targetL - voice.curL) * invFrames;
+        const float deltaR = (targetR - voice.curR) * invFrames;
+
+        const float* srcR = (voice.channels == 1) ? mTmpL.data() : mTmpR.data();
+        mixRamp(masterL, mTmpL.data(), voice.curL, deltaL, frames);
+        mixRamp(masterR, srcR, voice.curR, deltaR, frames);
+
+        const uint8_t bus = voice.params.sendBus;
+        if (bus > 0 && bus < MAX_BUSES && mBusUsed[bus] && voice.params.sendLevel > 0.f) {
+            const float level = voice.params.sendLevel;
+            mixRamp(mBusL[bus].data(), mTmpL.data(), voice.curL * level, deltaL * level, frames);
+            mixRamp(mBusR[bus].data(), srcR, voice.curR * level, deltaR * level, frames);
+        }
+
+        voice.curL = targetL;
+        voice.curR = targetR;
+
+        if (voice.stopping || produced < frames) {
+            releaseVoice(voice, slot);
+            mActive[k] = mActive.back();
+            mActive.pop_back();
+            continue;
+        }
+        k++;
+    }
+
+    // send buses through their effects into the master
+    float* inter = mInterleaved.data();
+    for (uint32_t b = 1; b < MAX_BUSES; b++) {
+        if (!mBusUsed[b])
+            continue;
+        const float* busL = mBusL[b].data();
+        const float* busR = mBusR[b].data();
+        if (mBusEffects[b]) {
+            for (uint32_t i = 0; i < frames; i++) {
+                inter[i * 2] = busL[i];
+                inter[i * 2 + 1] = busR[i];
+            }
+            mBusEffects[b]->process(inter, (int)(frames * 2), 2);
+            for (uint32_t i = 0; i < frames; i++) {
+                masterL[i] += inter[i * 2];
+                masterR[i] += inter[i * 2 + 1];
+            }
+        } else {
+            for (uint32_t i = 0; i < frames; i++) {
+                masterL[i] += busL[i];
+                masterR[i] += busR[i];
+            }
+        }
+    }
+
+    const float gain = mMasterGain;
+    for (uint32_t i = 0; i < frames; i++) {
+        out[i * 2] = masterL[i] * gain;
+        out[i * 2 + 1] = masterR[i] * gain;
+    }
+}
+//-------------------------------------------------------------------------------
+void Mixer::mix(float* out, uint32_t frames)
+{
+    if (mMaxVoices == 0) {
+        std::memset(out, 0, (size_t)frames * 2 * sizeof(float));
+        return;
+    }
+
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const uint32_t total = frames;
+
+    applyCommands();
+
+    while (frames > 0) {
+        const uint32_t count = std::min(frames, BLOCK_FRAMES);
+        mixBlock(out, count);
+        out += count * 2;
+        frames -= count;
+    }
+
+    const uint32_t active = (uint32_t)mActive.size();
+    mStatActive.store(active, std::memory_order_relaxed);
+    mStatVirtual.store(mVirtualCount, std::memory_order_relaxed);
+    if (active > mStatPeak.load(std::memory_order_relaxed))
+        mStatPeak.store(active, std::memory_order_relaxed);
+
+    const double elapsed = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    const double blockTime = (double)total / (double)mSampleRate;
+    mStatLoad.store((float)(elapsed / blockTime), std::memory_order_relaxed);
+}
+//-------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------
+// helper
+//-------------------------------------------------------------------------------
+std::shared_ptr<SampleBuffer> Mixer::fromSpec(const SDL_AudioSpec& spec, const uint8_t* data, uint32_t len)
+{
+    SDL_AudioSpec dstSpec;
+    dstSpec.format = SDL_AUDIO_F32;
+    dstSpec.channels = std::min(spec.channels, 2);
+    dstSpec.freq = spec.freq;
+
+    Uint8* converted = nullptr;
+    int convertedLen = 0;
+    if (!SDL_ConvertAudioSamples(&spec, data, (int)len, &dstSpec, &converted, &convertedLen)) {
+        Log("[error] Mixer::fromSpec: conversion failed: %s", SDL_GetError());
+        return nullptr;
+    }
+
+    auto buffer = std::make_shared<SampleBuffer>();
+    buffer->channels = (uint32_t)dstSpec.channels;
+    buffer->sampleRate = (uint32_t)dstSpec.freq;
+    buffer->frames = (uint32_t)(convertedLen / (int)(sizeof(float) * dstSpec.channels));
+    const float* samples = reinterpret_cast<const float*>(converted);
+    buffer->data.assign(samples, samples + (size_t)buffer->frames * buffer->channels);
+    SDL_free(converted);
+    return buffer;
+}
+//-------------------------------------------------------------------------------
+std::shared_ptr<SampleBuffer> Mixer::loadWAV(const char* fileName)
+{
+    SDL_AudioSpec spec;
+    Uint8* data = nullptr;
+    Uint32 len = 0;
+    if (!SDL_LoadWAV(fileName, &spec, &data, &len)) {
+        Log("[error] Mixer::loadWAV: failed to load %s: %s", fileName, SDL_GetError());
+        return nullptr;
+    }
+    auto buffer = fromSpec(spec, data, len);
+    SDL_free(data);
+    return buffer;
+}
+//-------------------------------------------------------------------------------
+void Mixer::benchmark(uint32_t voiceCount, float seconds)
+{
+    const uint32_t rate = 48000;
+    Mixer lMixer;
+    if (!lMixer.init(rate, voiceCount))
+        return;
+
+    // half the voices need resampling (44.1k mono), half are copied (48k stereo)
+    uint32_t seed = 0x9E3779B9u;
+    auto noise = [&seed]() {
+        seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+        return (float)(seed & 0xFFFF) / 32768.f - 1.f;
+    };
+
+    auto mono = std::make_shared<SampleBuffer>();
+    mono->channels = 1;
+    mono->sampleRate = 44100;
+    mono->frames = 44100;
+    mono->data.resize(mono->frames);
+    for (float& s : mono->data) s = noise() * 0.1f;
+
+    auto stereo = std::make_shared<SampleBuffer>();
+    stereo->channels = 2;
+    stereo->sampleRate = rate;
+    stereo->frames = rate;
+    stereo->data.resize((size_t)stereo->frames * 2);
+    for (float& s : stereo->data) s = noise() * 0.1f;
+
+    for (uint32_t i = 0; i < voiceCount; i++) {
+        VoiceParams params;
+        params.loop = true;
+        params.gain = 1.f / (float)voiceCount;
+        params.pan = noise();
+        lMixer.play((i & 1) ? stereo : mono, params);
+    }
+
+    // typical device period
+    const uint32_t period = 256;
+    std::vector<float> out(period * 2);
+    const uint32_t totalFrames = (uint32_t)(seconds * (float)rate);
+
+    const Uint64 start = SDL_GetPerformanceCounter();
+    for (uint32_t done = 0; done < totalFrames; done += period)
+        lMixer.mix(out.data(), period);
+    const double elapsed = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+
+    Stats stats = lMixer.getStats();
+    Log("Mixer benchmark: %u voices, %.1fs audio mixed in %.1fms => %.2f%% of one core (active %u, peak %u)",
+        voiceCount, seconds, elapsed * 1000.0, elapsed / seconds * 100.0, stats.activeVoices, stats.peakVoices);
+}
+//-------------------------------------------------------------------------------
+void Mixer::benchmarkSpatial(uint32_t emitterCount, float seconds)
+{
+    const uint32_t rate = 48000;
+    Mixer lMixer;
+    if (!lMixer.init(rate, emitterCount))
+        return;
+
+    uint32_t seed = 0x2545F491u;
+    auto random = [&seed]() {
+        seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+        return (float)(seed & 0xFFFF) / 32768.f - 1.f;
+    };
+
+    auto mono = std::make_shared<SampleBuffer>();
+    mono->channels = 1;
+    mono->sampleRate = 44100;
+    mono->frames = 44100;
+    mono->data.resize(mono->frames);
+    for (float& s : mono->data) s = random() * 0.1f;
+
+    // emitters spread over a 10000 x 10000 world, the listener hears 1500 around it
+    const float world = 5000.f;
+    const float range = 1500.f;
+    std::vector<VoiceID> ids(emitterCount);
+    std::vector<float> posX(emitterCount), posY(emitterCount), velX(emitterCount), velY(emitterCount);
+    for (uint32_t i = 0; i < emitterCount; i++) {
+        posX[i] = random() * world;
+        posY[i] = random() * world;
+        velX[i] = random() * 200.f;
+        velY[i] = random() * 200.f;
+
+        VoiceParams params;
+        params.loop = true;
+        params.gain = 0.05f;
+        params.positional = true;
+        params.x = posX[i];
+        params.y = posY[i];
+        ids[i] = lMixer.play(mono, params);
+    }
+
+    // positions are sent once per 60 Hz frame, the device period is 256
+    const uint32_t period = 256;
+    const uint32_t frameFrames = rate / 60;
+    std::vector<float> out(period * 2);
+    const uint32_t totalFrames = (uint32_t)(seconds * (float)rate);
+    const float dt = 1.f / 60.f;
+
+    uint64_t virtualSum = 0;
+    uint32_t blocks = 0;
+    double mixTime = 0.0;
+    const double freq = (double)SDL_GetPerformanceFrequency();
+
+    uint32_t nextFrame = 0;
+    for (uint32_t done = 0; done < totalFrames; done += period) {
+        if (done >= nextFrame) {
+            nextFrame += frameFrames;
+            for (uint32_t i = 0; i < emitterCount; i++) {
+                posX[i] += velX[i] * dt;
+                posY[i] += velY[i] * dt;
+                if (std::fabs(posX[i]) > world) velX[i] = -velX[i];
+                if (std::fabs(posY[i]) > world) velY[i] = -velY[i];
+            }
+            const float t = (float)done / (float)rate;
+            lMixer.setListener(std::sin(t * 0.3f) * world * 0.5f, std::cos(t * 0.2f) * world * 0.5f, range);
+            lMixer.setPositions(ids.data(), posX.data(), posY.data(), emitterCount);
+            lMixer.update();
+        }
+
+        const Uint64 start = SDL_GetPerformanceCounter();
+        lMixer.mix(out.data(), period);
+        mixTime += (double)(SDL_GetPerformanceCounter() - start) / freq;
+
+        virtualSum += lMixer.getStats().virtualVoices;
+        blocks++;
+    }
+
+    Stats stats = lMixer.getStats();
+    const double avgVirtual = blocks ? (double)virtualSum / blocks : 0.0;
+    Log("Mixer spatial benchmark: %u emitters, %.1fs audio mixed in %.1fms => %.2f%% of one core "
+        "(avg audible %.0f, virtual %.0f, active %u)",
+        emitterCount, seconds, mixTime * 1000.0, mixTime / seconds * 100.0,
+        stats.activeVoices - avgVirtual, avgVirtual, stats.activeVoices);
+}
+//-------------------------------------------------------------------------------
+
+} // namespace FluxAudio
@@ -0,0 +1,310 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Software mixer with a fixed voice pool
+//
+// Owned by FluxAudio::Manager, all voices are mixed into one float bus which
+// feeds a single SDL_AudioStream bound to the device. The main thread only
+// sends commands, the audio callback does the mixing. When the pool is full
+// the voice with the lowest priority (oldest on a tie) is stolen.
+//
+// Positioned voices (VoiceParams::positional / setPosition) are attenuated
+// and panned relative to the 2D listener in the audio callback, all of them
+// in one pass per block. A positioned voice out of range is virtual: it is
+// not rendered, only its position advances.
+//
+// Example usage:
+// =============
+//
+// auto sample = FluxAudio::Mixer::loadWAV("assets/sounds/shot.wav");
+// FluxAudio::VoiceParams params;
+// params.pan = -0.5f;
+// FluxAudio::VoiceID id = AudioManager.getMixer().play(sample, params);
+// ...
+// AudioManager.getMixer().setGain(id, 0.5f);
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "audio/fluxPcmRing.h"
+
+namespace DSP { class EffectsManager; } //fwd
+
+namespace FluxAudio {
+
+    // 0 is never a valid voice
+    typedef uint32_t VoiceID;
+
+    // decoded PCM, interleaved float. Immutable once handed to the mixer.
+    struct SampleBuffer {
+        std::vector<float> data;
+        uint32_t frames = 0;
+        uint32_t channels = 0;
+        uint32_t sampleRate = 0;
+    };
+
+    struct VoiceParams {
+        float gain = 1.f;
+        float pan = 0.f;        // -1 left .. 1 right
+        float pitch = 1.f;      // playback rate
+        uint8_t priority = 128; // higher wins when stealing
+        bool loop = false;
+        uint8_t sendBus = 0;    // 0 = no send, see addBus
+        float sendLevel = 0.f;
+        bool positional = false; // gain and pan follow the listener, pan is ignored
+        float x = 0.f;           // world position
+        float y = 0.f;
+    };
+
+    class Mixer {
+    public:
+        static constexpr uint32_t BLOCK_FRAMES = 512;   // internal mix block
+        static constexpr uint32_t MAX_BUSES = 8;        // incl. master (0)
+        static constexpr uint32_t COMMAND_CAPACITY = 4096;
+        static constexpr double MAX_STEP = 16.0;        // pitch * rate ratio limit
+
+        struct Stats {
+            uint32_t activeVoices = 0;
+            uint32_t peakVoices = 0;
+            uint32_t stolen = 0;
+            uint32_t rejected = 0;
+            uint32_t streamUnderruns = 0;
+            uint32_t virtualVoices = 0; // positioned, out of range, not rendered
+            float load = 0.f; // mix time / block time of the last callback
+        };
+
+    private:
+        enum class SourceType : uint8_t { None, Buffer, Stream };
+
+        enum class CommandType : uint8_t {
+            Play, Stop, SetPaused, SetGain, SetPan, SetPitch, SetLoop, SetSend, SetBus, SetMasterGain,
+            SetPosition, SetListener
+        };
+
+        struct Command {
+            CommandType type;
+            uint32_t slot = 0;
+            VoiceID id = 0;
+            float value = 0.f;
+            float x = 0.f, y = 0.f;     // position, listener: value is the range
+            VoiceParams params;
+            SourceType source = SourceType::None;
+            const SampleBuffer* buffer = nullptr;
+            PcmRing* ring = nullptr;
+            uint32_t ringRate = 0;
+            DSP::EffectsManager* effects = nullptr;
+        };
+
+        // audio thread side
+        struct Voice {
+            VoiceID id = 0;
+            SourceType source = SourceType::None;
+            const SampleBuffer* buffer = nullptr;
+            PcmRing* ring = nullptr;
+            uint32_t channels = 0;
+            double pos = 0.0;       // buffer: frame position
+            double step = 1.0;      // source frames per output frame
+            float srcRate = 0.f;
+            float carry[2] = {};    // stream: last frame of the previous block
+            bool primed = false;
+            bool stopping = false;
+            bool paused = false;
+            bool listed = false;
+            int32_t spatial = -1;   // index in mSpatial, -1 if not positioned
+            VoiceParams params;
+            float curL = 0.f, curR = 0.f; // gains of the last block, ramped
+        };
+
+        // positioned voices as structure of arrays, sized to a multiple of
+        // four so the gain pass needs no tail handling. Audio thread only.
+        struct SpatialSet {
+            std::vector<float> x, y, gain;
+            std::vector<float> stereo;          // 1 for stereo sources (balance)
+            std::vector<float> left, right;     // target gains of the block
+            std::vector<uint32_t> slot;
+            uint32_t count = 0;
+        };
+
+        struct Listener {
+            float x = 0.f, y = 0.f;
+            float range = 0.f;  // 0 = no attenuation
+            float gain = 1.f;
+        };
+
+        // main thread side
+        struct Slot {
+            VoiceID id = 0;
+            uint8_t priority = 0;
+            uint32_t generation = 0;
+            uint64_t started = 0;
+            bool stopping = false;  // stop sent, slot is freed on release
+            std::shared_ptr<const SampleBuffer> buffer;
+            std::shared_ptr<PcmRing> ring;
+        };
+
+        struct Released {
+            uint32_t slot;
+            VoiceID id;
+        };
+
+        // kept alive until the audio thread processed the command which
+        // dropped them, so nothing is freed in the callback
+        struct Grave {
+            uint64_t seq;
+            std::shared_ptr<const SampleBuffer> buffer;
+            std::shared_ptr<PcmRing> ring;
+        };
+
+        uint32_t mSampleRate = 48000;
+        uint32_t mMaxVoices = 0;
+
+        std::vector<Voice> mVoices;
+        std::vector<uint32_t> mActive; // slots mixed by the audio thread
+
+        std::vector<Slot> mSlots;
+        std::vector<uint32_t> mFreeSlots;
+        std::vector<Grave> mGraveyard;
+        uint64_t mStartCounter = 0;
+
+        // main -> audio, single producer guarded by mApiMutex
+        std::vector<Command> mCommands;
+        alignas(64) std::atomic<uint32_t> mCmdWrite{0};
+        alignas(64) std::atomic<uint32_t> mCmdRead{0};
+        uint64_t mCmdSeq = 0;                      // main: commands pushed
+        std::atomic<uint64_t> mCmdProcessed{0};    // audio: commands applied
+
+        // audio -> main
+        std::vector<Released> mReleased;
+        alignas(64) std::atomic<uint32_t> mRelWrite{0};
+        alignas(64) std::atomic<uint32_t> mRelRead{0};
+        // audio thread: releases which did not fit into the ring, one per
+        // slot (a newer id replaces the older one), reserved for mMaxVoices
+        std::vector<Released> mReleasePending;
+
+        std::recursive_mutex mApiMutex;
+
+        // buses, planar. 0 is the master
+        DSP::EffectsManager* mBusEffects[MAX_BUSES] = {};
+        bool mBusAllocated[MAX_BUSES] = {}; // api side, addBus
+        bool mBusUsed[MAX_BUSES] = {};      // audio thread, set by SetBus
+        std::vector<float> mBusL[MAX_BUSES];
+        std::vector<float> mBusR[MAX_BUSES];
+        std::vector<float> mTmpL, mTmpR;
+        std::vector<float> mStreamTmp;
+        std::vector<float> mInterleaved;
+        std::vector<float> mDeviceBuffer;
+        float mMasterGain = 1.f;
+
+        SpatialSet mSpatial;
+        Listener mListener;         // audio thread
+        Listener mSentListener;     // main thread, last one sent
+        uint32_t mVirtualCount = 0;
+
+        std::atomic<uint32_t> mStatActive{0};
+        std::atomic<uint32_t> mStatPeak{0};
+        std::atomic<uint32_t> mStatStolen{0};
+        std::atomic<uint32_t> mStatRejected{0};
+        std::atomic<uint32_t> mStatUnderruns{0};
+        std::atomic<uint32_t> mStatVirtual{0};
+        std::atomic<float> mStatLoad{0.f};
+
+        SDL_AudioStream* mDeviceStream = nullptr;
+
+        static void SDLCALL deviceCallback(void* userdata, SDL_AudioStream* stream, int additional, int total);
+
+        // main thread
+        bool pushCommand(const Command& cmd);
+        void collectReleased();
+        void buryGraves();
+        uint32_t acquireSlot(uint8_t priority, bool& stolen);
+        VoiceID startVoice(Command& cmd, std::shared_ptr<const SampleBuffer> buffer,
+                           std::shared_ptr<PcmRing> ring);
+        bool lookup(VoiceID id, uint32_t& slot);
+        void sendVoiceCommand(VoiceID id, CommandType type, float value);
+
+        // audio thread
+        void applyCommands();
+        void applyCommand(const Command& cmd);
+        void releaseVoice(Voice& voice, uint32_t slot);
+        bool pushReleased(const Released& rel);
+        void flushPendingReleases();
+        uint32_t renderBuffer(Voice& voice, uint32_t frames);
+        uint32_t renderStream(Voice& voice, uint32_t frames);
+        void addSpatial(Voice& voice, uint32_t slot);
+        void removeSpatial(Voice& voice);
+        void updateSpatial();
+        // moves a virtual voice ahead without rendering, false when it ended
+        bool advanceVirtual(Voice& voice, uint32_t frames);
+        void mixBlock(float* out, uint32_t frames);
+
+    public:
+        Mixer() = default;
+        ~Mixer() { shutdown(); }
+
+        Mixer(const Mixer&) = delete;
+        void operator=(const Mixer&) = delete;
+
+        bool init(uint32_t sampleRate, uint32_t maxVoices = 512);
+        void shutdown();
+
+        // creates the device stream, without it mix() can be called directly
+        bool attach(SDL_AudioDeviceID device);
+        void detach();
+        bool isAttached() const { return mDeviceStream != nullptr; }
+
+        uint32_t getSampleRate() const { return mSampleRate; }
+        uint32_t getMaxVoices() const { return mMaxVoices; }
+
+        //---------------- main thread ----------------
+        VoiceID play(std::shared_ptr<const SampleBuffer> buffer, const VoiceParams& params = VoiceParams());
+        // ring is filled by the caller, the voice ends when it is finished and empty
+        VoiceID playStream(std::shared_ptr<PcmRing> ring, uint32_t sampleRate, const VoiceParams& params = VoiceParams());
+
+        void stop(VoiceID id);
+        bool isPlaying(VoiceID id);
+        // a paused voice keeps its slot and position
+        void setPaused(VoiceID id, bool paused);
+        void setGain(VoiceID id, float gain);
+        void setPan(VoiceID id, float pan);
+        void setPitch(VoiceID id, float pitch);
+        void setLoop(VoiceID id, bool loop);
+        void setSend(VoiceID id, uint8_t bus, float level);
+        // makes the voice positional
+        void setPosition(VoiceID id, float x, float y);
+        void setPositions(const VoiceID* ids, const float* x, const float* y, uint32_t count);
+        // range: distance where positioned voices fade to silence, 0 disables
+        // the attenuation. Only sent when it changed.
+        void setListener(float x, float y, float range, float gain = 1.f);
+
+        // effects of a send bus, returns the bus index or 0 if all are used
+        uint8_t addBus(DSP::EffectsManager* effects);
+        void setBusEffects(uint8_t bus, DSP::EffectsManager* effects);
+        void setMasterGain(float gain);
+
+        // drains finished voices, called by Manager::update
+        void update();
+
+        Stats getStats() const;
+
+        //---------------- audio thread ----------------
+        // stereo interleaved float at getSampleRate()
+        void mix(float* out, uint32_t frames);
+
+        //---------------- helper ----------------
+        static std::shared_ptr<SampleBuffer> loadWAV(const char* fileName);
+        static std::shared_ptr<SampleBuffer> fromSpec(const SDL_AudioSpec& spec, const uint8_t* data, uint32_t len);
+
+        // headless: mixes seconds of audio with voiceCount looping voices
+        static void benchmark(uint32_t voiceCount = 512, float seconds = 10.f);
+        // headless: emitterCount moving positioned voices around a moving listener
+        static void benchmarkSpatial(uint32_t emitterCount = 2000, float seconds = 10.f);
+    };
+
+} // namespace FluxAudio
@@ -4,7 +4,6 @@
 //-----------------------------------------------------------------------------
 #include "audio/fluxAudioStream.h"
 #include "utils/errorlog.h"
-#include "render/fluxRender2D.h"
 #include "audio/fluxAudio.h"
 
 #include <algorithm>
@@ -12,6 +11,45 @@
 #undef STB_VORBIS_HEADER_ONLY
 #include <stb_vorbis.c>
 //-----------------------------------------------------------------------------
+// runs on the decode thread, keeps the file mapping alive by itself
+class VorbisStreamDecoder : public FluxAudio::DecodeService::Decoder
+{
+private:
+    std::shared_ptr<FluxMappedFile> mFile;
+    stb_vorbis* mVorbis = nullptr;
+    uint32_t mChannels = 0;
+    uint32_t mSampleRate = 0;
+
+public:
+    VorbisStreamDecoder(std::shared_ptr<FluxMappedFile> file) : mFile(std::move(file)) {
+        // stb_vorbis wants it contiguous, unmapped files are read once here
+        const uint8_t* data = mFile->data();
+        if (!data)
+            return;
+        int error;
+        mVorbis = stb_vorbis_open_memory(data, (int)mFile->size(), &error, nullptr);
+        if (mVorbis) {
+            stb_vorbis_info info = stb_vorbis_get_info(mVorbis);
+            mChannels = (uint32_t)info.channels;
+            mSampleRate = info.sample_rate;
+        }
+    }
+    ~VorbisStreamDecoder() override {
+        if (mVorbis) stb_vorbis_close(mVorbis);
+    }
+
+    bool isValid() const { return mVorbis != nullptr; }
+
+    uint32_t getChannels() const override { return mChannels; }
+    uint32_t getSampleRate() const override { return mSampleRate; }
+
+    uint32_t read(float* out, uint32_t frames) override {
+        int read = stb_vorbis_get_samples_float_interleaved(mVorbis, (int)mChannels, out, (int)(frames * mChannels));
+        return read > 0 ? (uint32_t)read : 0;
+    }
+    bool rewind() override { return stb_vorbis_seek_start(mVorbis) != 0; }
+};
+//-----------------------------------------------------------------------------
 FluxAudioStream::FluxAudioStream( const char* lFilename)
 {
     setVisible(false); //sound does not need draw
@@ -56,46 +94,22 @@ FluxAudioStream::~FluxAudioStream()
 //-----------------------------------------------------------------------------
 void FluxAudioStream::clearResources()
 {
-    if (mStream) { SDL_DestroyAudioStream(mStream); mStream = nullptr; }
-    if (mWavData) { SDL_free(mWavData); mWavData = nullptr; }
-    if (mVorbis) { stb_vorbis_close(mVorbis); mVorbis = nullptr; }
-    if (mRawFileData) SDL_free(mRawFileData);
+    if (mVoice) { AudioManager.getMixer().stop(mVoice); mVoice = 0; }
+    mPlaying = false;
+    mPaused = false;
+    mSample.reset();
+    closeDecodeStream();
+    mFile.reset(); // running decoders keep their own reference
 
     mInitDone = false;
     mIsOgg = false;
 }
 //-----------------------------------------------------------------------------
-void FluxAudioStream::FillOggBuffer()
+void FluxAudioStream::closeDecodeStream()
 {
-    if (!mIsOgg || !mVorbis || !mStream) return;
-    // 500ms
-    int targetBytes = mSpec.freq * sizeof(float) * mSpec.channels / 2;
-
-    while ((SDL_GetAudioStreamAvailable(mStream) + SDL_GetAudioStreamQueued(mStream)) < targetBytes)
-    {
-        const int samplesToRead = 4096;
-        const int totalFloats = samplesToRead * mSpec.channels;
-
-        if (mConversionBuffer.size() < (size_t)totalFloats) {
-            mConversionBuffer.resize(totalFloats);
-        }
-
-        int samplesRead = stb_vorbis_get_samples_float_interleaved(
-            mVorbis, mSpec.channels, mConversionBuffer.data(), totalFloats
-        );
-
-        if (samplesRead > 0) {
-            SDL_PutAudioStreamData(mStream, mConversionBuffer.data(),
-                                   samplesRead * mSpec.channels * sizeof(float));
-        }
-        else {
-            if (mLooping) {
-                stb_vorbis_seek_start(mVorbis);
-            } else {
-                SDL_FlushAudioStream(mStream);
-                break;
-            }
-        }
+    if (mDecodeStream) {
+        AudioManager.getDecodeService().close(mDecodeStream);
+        mDecodeStream = 0;
     }
 }
 //-----------------------------------------------------------------------------
@@ -103,64 +117,23 @@ void FluxAudioStream::Update(const double& dt)
 {
     if (!mInitDone || !mPlaying) return;
 
-    if (mUsePosition) {
-        // FIXME Point3F
-        auto camera = Render2D.getCamera();
-        RectF view = camera->getVisibleWorldRect(false);
-        float zoom = camera->getZoom(); // 1.0 = Default, 0.1 = Far, 5.0 = Close
-
-        Point2F camCenter = { view.x + (view.w * 0.5f), view.y + (view.h * 0.5f) };
-
-        // Calculate the "Hearing Range" based on the current view
-        // As you zoom out, view.w increases, naturally expanding the hearing area.
-        float maxDist = (view.w * 0.5f) * 1.5f;
-        float distSq = camCenter.distSq({mPosition.x, mPosition.y});
-        float maxDistSq = maxDist * maxDist;
-
-        if (distSq > maxDistSq) {
-            SDL_SetAudioStreamGain(mStream, 0.0f);
-            return;
-        }
-
-        // Calculate Distance Falloff (0.0 to 1.0)
-        float dist = std::sqrt(distSq);
-        float falloff = 1.0f - (dist / maxDist);
-        falloff = falloff * falloff; // Exponential curve for smoother fading
-
-        float zoomEffect = std::clamp(zoom, 0.f, 1.0f);
-        float finalGain = mGain * falloff * zoomEffect;
+    FluxAudio::Mixer& mixer = AudioManager.getMixer();
 
-        SDL_SetAudioStreamGain(mStream, std::clamp(finalGain, 0.0f, mGain));
+    // attenuation and pan relative to the listener are done by the mixer
+    if (mUsePosition && (mPosition.x != mSentPosition.x || mPosition.y != mSentPosition.y)) {
+        mixer.setPosition(mVoice, mPosition.x, mPosition.y);
+        mSentPosition = mPosition;
     }
 
 
     // <<<<<<<<<<<<<<
 
-    if (mIsOgg) {
-        FillOggBuffer();
-        if (!mLooping) {
-            int totalBuffered = SDL_GetAudioStreamAvailable(mStream) + SDL_GetAudioStreamQueued(mStream);
-            if (totalBuffered <= 0) {
-                mPlaying = false;
-                // dLog("[info] OGG song:%s stopped.", mFileName.c_str());
-            }
-        }
-    } else {
-        int totalRemaining = SDL_GetAudioStreamQueued(mStream) + SDL_GetAudioStreamAvailable(mStream);
-        if (totalRemaining <= 0)
-        {
-            if (mLooping) {
-                SDL_ClearAudioStream(mStream);
-                SDL_PutAudioStreamData(mStream, mWavData, (int)mWaveDataLen);
-                SDL_FlushAudioStream(mStream);
-            } else {
-                if (mPlaying) {
-                    mPlaying = false;
-                    // dLog("[info] song:%s finished playback.", mFileName.c_str());
-                    AudioManager.unBindStream(mStream);
-                }
-            }
-        }
+    // WAV looping is done by the mixer, OGG by the decode service
+    if (!mixer.isPlaying(mVoice)) {
+        mPlaying = false;
+        mVoice = 0;
+        closeDecodeStream();
+        // dLog("[info] song:%s finished playback.", mFileName.c_str());
     }
 }
 
@@ -169,27 +142,28 @@ bool FluxAudioStream::loadOGG(const char* lFilename)
 {
     clearResources(); // clear old data if any
 
-    int error;
-    size_t fileSize;
-    mRawFileData = SDL_LoadFile(lFilename, &fileSize);
-    if (!mRawFileData) {
+    // pages are loaded when the decoder touches them
+    mFile = FluxMappedFile::open(lFilename);
+    if (!mFile) {
         Log("Failed to open OGG: %s", lFilename);
         return false;
     }
-    mVorbis = stb_vorbis_open_memory((unsigned char*)mRawFileData, (int)fileSize, &error, nullptr);
-    if (!mVorbis) {
+
+    // only to validate and read the format, playback uses its own decoder
+    VorbisStreamDecoder probe(mFile);
+    if (!probe.isValid()) {
         Log("Failed to open OGG: %s", lFilename);
         return false;
     }
 
-    stb_vorbis_info info = stb_vorbis_get_info(mVorbis);
-
     mSpec.format = SDL_AUDIO_F32; // stb_vorbis outputs floats easily
-    mSpec.channels = info.channels;
-    mSpec.freq = info.sample_rate;
+    mSpec.channels = (int)probe.getChannels();
+    mSpec.freq = (int)probe.getSampleRate();
 
-    mStream = SDL_CreateAudioStream(&mSpec, nullptr);
-    AudioManager.bindStream(mStream);
+    if (mSpec.channels < 1 || mSpec.channels > 2) {
+        Log("Unsupported OGG channel count %d: %s", mSpec.channels, lFilename);
+        return false;
+    }
 
     mIsOgg = true;
     mInitDone = true;
@@ -205,35 +179,10 @@ bool FluxAudioStream::loadWAV(const char * lFilename)
     clearResources();
     mInitDone = false;
 
-    if (mStream) {
-        SDL_DestroyAudioStream(mStream);
-        mStream = nullptr;
-    }
-
-    if (mWavData) {
-        SDL_free(mWavData);
-        mWavData = nullptr;
-        mWaveDataLen = 0;
-    }
-
-
-    SDL_AudioSpec spec;
     /* Load the .wav file from wherever the app is being run from. */
-    if (!SDL_LoadWAV(lFilename, &spec, &mWavData, &mWaveDataLen)) {
-        Log("Couldn't load .wav file: %s", SDL_GetError());
-        return false;
-    }
-
-    mStream = SDL_CreateAudioStream(&spec, nullptr);
-    if (!mStream) {
-        Log("Couldn't create audio stream: %s", SDL_GetError());
-        return false;
-    }
-
-    if (!AudioManager.bindStream(mStream)) {
-        Log("Failed to bind '%s' stream to device: %s", lFilename, SDL_GetError());
-        SDL_DestroyAudioStream(mStream);
-        mStream = nullptr;
+    mSample = FluxAudio::Mixer::loadWAV(lFilename);
+    if (!mSample) {
+        Log("Couldn't load .wav file: %s", lFilename);
         return false;
     }
 
@@ -243,32 +192,42 @@ bool FluxAudioStream::loadWAV(const char * lFilename)
 //-----------------------------------------------------------------------------
 bool FluxAudioStream::play()
 {
-    if (!mInitDone || !mStream) {
-        dLog("Cant play audio Stream. initDone:%d, stream:%d", mInitDone, mStream != 0 );
+    if (!mInitDone) {
+        dLog("Cant play audio Stream. initDone:%d", mInitDone);
         return false;
     }
 
-    SDL_SetAudioStreamGain(mStream, mGain);
-
-    mPlaying = true;
-    SDL_ClearAudioStream(mStream);
-
-    if (mIsOgg && mVorbis) {
-        stb_vorbis_seek_start(mVorbis);
-        this->FillOggBuffer();
+    FluxAudio::Mixer& mixer = AudioManager.getMixer();
+    if (mVoice) mixer.stop(mVoice);
+    closeDecodeStream();
+
+    FluxAudio::VoiceParams params;
+    params.gain = mGain;
+    params.loop = mLooping;
+    params.positional = mUsePosition;
+    params.x = mPosition.x;
+    params.y = mPosition.y;
+    mSentPosition = mPosition;
+
+    if (mIsOgg && mFile) {
+        // 500ms
+        auto stream = AudioManager.getDecodeService().open(
+            std::make_unique<VorbisStreamDecoder>(mFile), mLooping, 0.5f);
+        mDecodeStream = stream.id;
+        if (stream.ring)
+            mVoice = mixer.playStream(stream.ring, (uint32_t)mSpec.freq, params);
+        if (!mVoice)
+            closeDecodeStream();
     }
-    else if (mWavData) {
-        AudioManager.bindStream(mStream); //make sure it's bound
-        if (!SDL_PutAudioStreamData(mStream, mWavData, (int)mWaveDataLen)) {
-            Log("Failed to put WAV data: %s", SDL_GetError());
-            return false;
-        }
-        // if (! mLooping ) {
-            return SDL_FlushAudioStream(mStream);
-        // }
+    else if (mSample) {
+        mVoice = mixer.play(mSample, params);
     }
 
-    return SDL_ResumeAudioStreamDevice(mStream);
+    mPaused = false;
+    mPlaying = mVoice != 0;
+    if (!mPlaying)
+        Log("Failed to play %s, no free voice.", mFileName.c_str());
+    return mPlaying;
 }
 //-----------------------------------------------------------------------------
 bool FluxAudioStream::stop()
@@ -276,25 +235,38 @@ bool FluxAudioStream::stop()
     if (!mInitDone)
         return false;
 
+    // paused, resume continues at the same position
     mPlaying = false;
-
-    AudioManager.unBindStream(mStream);
+    mPaused = true;
+    AudioManager.getMixer().setPaused(mVoice, true);
     return true;
 }
 //-----------------------------------------------------------------------------
 bool FluxAudioStream::resume()
 {
-    if (!mInitDone || mPlaying)
+    if (!mInitDone || mPlaying || !mPaused)
         return false;
 
-    mPlaying=true;
-    return AudioManager.bindStream(mStream);
+    mPaused = false;
+    mPlaying = AudioManager.getMixer().isPlaying(mVoice);
+    AudioManager.getMixer().setPaused(mVoice, false);
+    return mPlaying;
+}
+//-----------------------------------------------------------------------------
+void FluxAudioStream::setLooping(bool value)
+{
+    mLooping = value;
+    if (mIsOgg)
+        AudioManager.getDecodeService().setLoop(mDecodeStream, value);
+    else
+        AudioManager.getMixer().setLoop(mVoice, value);
 }
 //-----------------------------------------------------------------------------
 bool FluxAudioStream::setGain(float value) {
     mGain = std::clamp(value, 0.0f, 1.0f);
-    if (mStream) {
-        return SDL_SetAudioStreamGain(mStream, mGain);
+    if (mVoice) {
+        AudioManager.getMixer().setGain(mVoice, mGain);
+        return true;
     }
     return false;
 }//-----------------------------------------------------------------------------
@@ -14,10 +14,11 @@
 #include "core/fluxGlobals.h"
 #include "core/fluxBaseObject.h"
 #include "utils/errorlog.h"
+#include "utils/fluxMappedFile.h"
+#include "audio/fluxAudioMixer.h"
+#include "audio/fluxDecodeService.h"
 
 
-struct stb_vorbis; //FWD
-
 class FluxAudioStream : public FluxBaseObject
 {
 private:
@@ -25,22 +26,23 @@ private:
     bool mInitDone = false;
     bool mPlaying = false;
 
-    SDL_AudioStream *mStream = nullptr;
-    Uint8 *mWavData = nullptr;
-    Uint32 mWaveDataLen = 0;
-
+    // played by the mixer of AudioManager
+    FluxAudio::VoiceID mVoice = 0;
+    bool mPaused = false;
+    Point3F mSentPosition = { 0.f, 0.f, 0.f };
 
+    //WAV
+    std::shared_ptr<FluxAudio::SampleBuffer> mSample;
 
-    //OGG
-    stb_vorbis* mVorbis = nullptr;
-    void* mRawFileData = nullptr;  //for SDL_LoadFile
+    //OGG, decoded by the decode service, a new decoder per play
+    std::shared_ptr<FluxMappedFile> mFile;  //shared with the decoders
+    FluxAudio::DecodeService::StreamID mDecodeStream = 0;
 
     SDL_AudioSpec mSpec;
     bool mIsOgg = false;
-    std::vector<float> mConversionBuffer;
 
     void clearResources();
-    void FillOggBuffer();
+    void closeDecodeStream();
 
 protected:
     bool loadWAV(const char * lFilename);
@@ -65,7 +67,7 @@ public:
     bool resume();
     void Update(const double& dt) override;
     bool isPlaying() {return mPlaying;}
-    void setLooping(bool value) {mLooping = value;}
+    void setLooping(bool value);
     bool setGain(float value);
     float getGain() { return mGain; }
 
@@ -80,13 +82,8 @@ public:
 
     std::string  getFileName() { return mFileName; }
 
-    bool getWaveData(Uint8 *data, Uint32& len ) {
-        if (mWaveDataLen == 0)
-            return false;
-        data = mWavData;
-        len = mWaveDataLen;
-        return true;
-    }
+    // decoded WAV data, nullptr for OGG
+    std::shared_ptr<const FluxAudio::SampleBuffer> getSampleBuffer() const { return mSample; }
 
 
 }; //class
@@ -0,0 +1,331 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "audio/fluxDecodeService.h"
+#include <DSP_Denormal.h>
+#include "utils/errorlog.h"
+
+namespace FluxAudio {
+
+//-------------------------------------------------------------------------------
+static inline float elapsedMs(uint64_t since, uint64_t now)
+{
+    return (float)((double)(now - since) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+//-------------------------------------------------------------------------------
+static inline void storeMax(std::atomic<float>& target, float value)
+{
+    if (value > target.load(std::memory_order_relaxed))
+        target.store(value, std::memory_order_relaxed);
+}
+//-------------------------------------------------------------------------------
+bool DecodeService::init()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mRunning)
+        return true;
+
+    mRunning = true;
+    mStatMinHeadroomMs.store(-1.f);
+#ifdef FLUX_ASYNC_DECODE
+    mThread = std::thread(&DecodeService::threadMain, this);
+#endif
+    dLog("DecodeService started.");
+    return true;
+}
+//-------------------------------------------------------------------------------
+void DecodeService::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mRunning)
+            return;
+        mRunning = false;
+    }
+    mWake.notify_all();
+    mApplied.notify_all();
+    if (mThread.joinable())
+        mThread.join();
+
+    // voices still reading a ring end instead of starving
+    for (auto& job : mJobs)
+        job->ring->setFinished(true);
+    mJobs.clear();
+    mPending.clear();
+    mStatStreams.store(0);
+}
+//-------------------------------------------------------------------------------
+uint64_t DecodeService::post(Command&& cmd)
+{
+    uint64_t seq;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        seq = ++mPostedSeq;
+        cmd.seq = seq;
+        cmd.posted = SDL_GetPerformanceCounter();
+        mPending.push_back(std::move(cmd));
+    }
+    mWake.notify_one();
+    return seq;
+}
+//-------------------------------------------------------------------------------
+DecodeService::Stream DecodeService::open(std::unique_ptr<Decoder> decoder, bool loop, float bufferSec)
+{
+    Stream result;
+    if (!decoder)
+        return result;
+
+    const uint32_t channels = decoder->getChannels();
+    const uint32_t rate = decoder->getSampleRate();
+    if (channels < 1 || channels > 2 || rate == 0) {
+        Log("[error] DecodeService::open: unsupported stream (%u channels, %u Hz)", channels, rate);
+        return result;
+    }
+
+    auto job = std::make_unique<Job>();
+    job->decoder = std::move(decoder);
+    job->ring = std::make_shared<PcmRing>((uint32_t)(rate * std::max(0.05f, bufferSec)), channels);
+    job->sampleRate = rate;
+    job->lowFrames = (uint32_t)(job->ring->getCapacity() * LOW_WATERMARK);
+    job->loop = loop;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mRunning) {
+            Log("[error] DecodeService::open: service is not running");
+            return result;
+        }
+        job->id = mNextID++;
+        if (mNextID == 0) mNextID = 1;
+    }
+
+    result.id = job->id;
+    result.ring = job->ring;
+
+    Command cmd;
+    cmd.type = CommandType::Open;
+    cmd.id = result.id;
+    cmd.job = std::move(job);
+    post(std::move(cmd));
+
+#ifndef FLUX_ASYNC_DECODE
+    // prefill, otherwise the first block is silent
+    pump();
+#endif
+    return result;
+}
+//-------------------------------------------------------------------------------
+void DecodeService::close(StreamID id, bool wait)
+{
+    if (id == 0)
+        return;
+
+    Command cmd;
+    cmd.type = CommandType::Close;
+    cmd.id = id;
+    const uint64_t seq = post(std::move(cmd));
+
+    if (!wait)
+        return;
+#ifdef FLUX_ASYNC_DECODE
+    std::unique_lock<std::mutex> lock(mMutex);
+    mApplied.wait(lock, [this, seq] { return mAppliedSeq >= seq || !mRunning; });
+#else
+    pump();
+#endif
+}
+//-------------------------------------------------------------------------------
+void DecodeService::setLoop(StreamID id, bool loop)
+{
+    if (id == 0)
+        return;
+    Command cmd;
+    cmd.type = CommandType::SetLoop;
+    cmd.id = id;
+    cmd.loop = loop;
+    post(std::move(cmd));
+}
+//-------------------------------------------------------------------------------
+void DecodeService::update()
+{
+#ifndef FLUX_ASYNC_DECODE
+    pump();
+#endif
+}
+//-------------------------------------------------------------------------------
+DecodeService::Stats DecodeService::getStats() const
+{
+    Stats stats;
+    stats.streams = mStatStreams.load(std::memory_order_relaxed);
+    stats.framesDecoded = mStatFrames.load(std::memory_order_relaxed);
+    stats.wakeups = mStatWakeups.load(std::memory_order_relaxed);
+    stats.underruns = mStatUnderruns.load(std::memory_order_relaxed);
+    stats.minHeadroomMs = std::max(0.f, mStatMinHeadroomMs.load(std::memory_order_relaxed));
+    stats.maxFillMs = mStatMaxFillMs.load(std::memory_order_relaxed);
+    stats.maxCommandMs = mStatMaxCommandMs.load(std::memory_order_relaxed);
+    return stats;
+}
+//-------------------------------------------------------------------------------
+void DecodeService::resetStats()
+{
+    mStatFrames.store(0);
+    mStatWakeups.store(0);
+    mStatUnderruns.store(0);
+    mStatMinHeadroomMs.store(-1.f);
+    mStatMaxFillMs.store(0.f);
+    mStatMaxCommandMs.store(0.f);
+}
+//-------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------
+// worker
+//-------------------------------------------------------------------------------
+void DecodeService::applyCommands(std::vector<Command>& commands)
+{
+    const uint64_t now = SDL_GetPerformanceCounter();
+    for (Command& cmd : commands) {
+        storeMax(mStatMaxCommandMs, elapsedMs(cmd.posted, now));
+
+        if (cmd.type == CommandType::Open) {
+            mJobs.push_back(std::move(cmd.job));
+            continue;
+        }
+
+        auto it = std::find_if(mJobs.begin(), mJobs.end(),
+                               [&cmd](const std::unique_ptr<Job>& job) { return job->id == cmd.id; });
+        if (it == mJobs.end())
+            continue; // already reaped
+
+        if (cmd.type == CommandType::Close) {
+            (*it)->ring->setFinished(true);
+            mJobs.erase(it); // the decoder is destroyed here
+        } else if (cmd.type == CommandType::SetLoop) {
+            (*it)->loop = cmd.loop;
+        }
+    }
+    commands.clear();
+    mStatStreams.store((uint32_t)mJobs.size(), std::memory_order_relaxed);
+}
+//-------------------------------------------------------------------------------
+void DecodeService::fill(Job& job)
+{
+    const uint64_t start = SDL_GetPerformanceCounter();
+    PcmRing& ring = *job.ring;
+    const uint32_t channels = ring.getChannels();
+    const uint32_t chunk = std::min(CHUNK_FRAMES, std::max<uint32_t>(1, ring.getCapacity() / 2));
+    if (mChunk.size() < (size_t)chunk * channels)
+        mChunk.resize((size_t)chunk * channels);
+
+    bool rewound = false;
+    while (ring.availableWrite() >= chunk) {
+        uint32_t frames = job.decoder->read(mChunk.data(), chunk);
+        if (frames == 0) {
+            // only one rewind per empty read, an empty stream would spin
+            if (job.loop && !rewound && job.decoder->rewind()) {
+                rewound = true;
+                continue;
+            }
+            job.eof = true;
+            ring.setFinished(true);
+            break;
+        }
+        rewound = false;
+        ring.write(mChunk.data(), frames);
+        mStatFrames.fetch_add(frames, std::memory_order_relaxed);
+    }
+
+    storeMax(mStatMaxFillMs, elapsedMs(start, SDL_GetPerformanceCounter()));
+}
+//-------------------------------------------------------------------------------
+double DecodeService::serviceJobs()
+{
+    double next = MAX_WAIT_SEC;
+
+    for (size_t i = 0; i < mJobs.size();) {
+        Job& job = *mJobs[i];
+
+        // neither the owner nor a voice holds the ring anymore
+        if (job.ring.use_count() == 1) {
+            mJobs.erase(mJobs.begin() + i);
+            continue;
+        }
+
+        const uint32_t underruns = job.ring->getUnderruns();
+        if (underruns != job.underruns) {
+            mStatUnderruns.fetch_add(underruns - job.underruns, std::memory_order_relaxed);
+            job.underruns = underruns;
+        }
+
+        if (!job.eof) {
+            uint32_t available = job.ring->availableRead();
+            if (available <= job.lowFrames) {
+                if (job.primed) {
+                    const float headroom = (float)available * 1000.f / (float)job.sampleRate;
+                    const float current = mStatMinHeadroomMs.load(std::memory_order_relaxed);
+                    if (current < 0.f || headroom < current)
+                        mStatMinHeadroomMs.store(headroom, std::memory_order_relaxed);
+                }
+                fill(job);
+                job.primed = true;
+                available = job.ring->availableRead();
+            }
+            // predicted time until the low watermark, assumes up to twice
+            // the source rate since the voice may be pitched up
+            if (!job.eof && available > job.lowFrames)
+                next = std::min(next, (double)(available - job.lowFrames) / (2.0 * job.sampleRate));
+        }
+        i++;
+    }
+
+    mStatStreams.store((uint32_t)mJobs.size(), std::memory_order_relaxed);
+    return next;
+}
+//-------------------------------------------------------------------------------
+void DecodeService::pump()
+{
+    uint64_t seq;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWorkCommands.swap(mPending);
+        seq = mPostedSeq;
+    }
+    applyCommands(mWorkCommands);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mAppliedSeq = seq;
+    }
+    serviceJobs();
+}
+//-------------------------------------------------------------------------------
+void DecodeService::threadMain()
+{
+    DSP::ScopedDenormalGuard denormalGuard;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (mRunning) {
+        mWorkCommands.swap(mPending);
+        const uint64_t seq = mPostedSeq;
+        lock.unlock();
+
+        applyCommands(mWorkCommands);
+
+        lock.lock();
+        mAppliedSeq = seq;
+        lock.unlock();
+        mApplied.notify_all();
+
+        const double wait = serviceJobs();
+
+        lock.lock();
+        if (mRunning && mPending.empty())
+            mWake.wait_for(lock, std::chrono::duration<double>(wait));
+        mStatWakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+//-------------------------------------------------------------------------------
+
+} // namespace FluxAudio
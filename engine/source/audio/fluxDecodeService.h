@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Background decoding of streamed audio
+//
+// One worker thread owns all open decoders and keeps the PcmRing of each
+// stream filled. A stream is refilled when its fill level drops to the low
+// watermark, the worker sleeps on a condition variable until the earliest
+// stream is predicted to get there or a command arrives. The main thread only
+// posts commands (open / close / loop), the mixer reads the rings.
+//
+// Emscripten builds are not threaded, there update() decodes on the main
+// thread.
+//
+// Example usage:
+// =============
+//
+// auto stream = AudioManager.getDecodeService().open(std::move(decoder), true);
+// VoiceID id = AudioManager.getMixer().playStream(stream.ring, rate);
+// ...
+// AudioManager.getDecodeService().close(stream.id);
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "audio/fluxPcmRing.h"
+
+#ifndef __EMSCRIPTEN__
+#define FLUX_ASYNC_DECODE
+#endif
+
+namespace FluxAudio {
+
+    class DecodeService {
+    public:
+        // implemented per format, only used by the worker after open()
+        class Decoder {
+        public:
+            virtual ~Decoder() = default;
+            virtual uint32_t getChannels() const = 0;
+            virtual uint32_t getSampleRate() const = 0;
+            // interleaved float, returns the frames decoded, 0 at the end
+            virtual uint32_t read(float* out, uint32_t frames) = 0;
+            // back to the first frame, used for looping
+            virtual bool rewind() = 0;
+        };
+
+        // 0 is never a valid stream
+        typedef uint32_t StreamID;
+
+        struct Stream {
+            StreamID id = 0;
+            std::shared_ptr<PcmRing> ring;
+        };
+
+        struct Stats {
+            uint32_t streams = 0;
+            uint64_t framesDecoded = 0;
+            uint32_t wakeups = 0;
+            uint32_t underruns = 0;        // summed over the rings
+            float minHeadroomMs = 0.f;     // least audio left in a ring when it was refilled
+            float maxFillMs = 0.f;         // longest refill of one stream
+            float maxCommandMs = 0.f;      // longest time from post to apply
+        };
+
+        static constexpr uint32_t CHUNK_FRAMES = 4096;
+        static constexpr float LOW_WATERMARK = 0.5f;   // of the ring capacity
+        static constexpr float MAX_WAIT_SEC = 0.25f;
+
+    private:
+        struct Job {
+            StreamID id = 0;
+            std::unique_ptr<Decoder> decoder;
+            std::shared_ptr<PcmRing> ring;
+            uint32_t sampleRate = 0;
+            uint32_t lowFrames = 0;
+            uint32_t underruns = 0;
+            bool loop = false;
+            bool eof = false;
+            bool primed = false;
+        };
+
+        enum class CommandType : uint8_t { Open, Close, SetLoop };
+
+        struct Command {
+            CommandType type;
+            StreamID id = 0;
+            bool loop = false;
+            uint64_t seq = 0;
+            uint64_t posted = 0;    // SDL performance counter
+            std::unique_ptr<Job> job;
+        };
+
+        std::mutex mMutex;
+        std::condition_variable mWake;
+        std::condition_variable mApplied;
+        std::vector<Command> mPending;
+        uint64_t mPostedSeq = 0;
+        uint64_t mAppliedSeq = 0;
+        StreamID mNextID = 1;
+        bool mRunning = false;
+        std::thread mThread;
+
+        // worker only
+        std::vector<std::unique_ptr<Job>> mJobs;
+        std::vector<Command> mWorkCommands;
+        std::vector<float> mChunk;
+
+        std::atomic<uint32_t> mStatStreams{0};
+        std::atomic<uint64_t> mStatFrames{0};
+        std::atomic<uint32_t> mStatWakeups{0};
+        std::atomic<uint32_t> mStatUnderruns{0};
+        std::atomic<float> mStatMinHeadroomMs{0.f};
+        std::atomic<float> mStatMaxFillMs{0.f};
+        std::atomic<float> mStatMaxCommandMs{0.f};
+
+        uint64_t post(Command&& cmd);
+        void applyCommands(std::vector<Command>& commands);
+        void fill(Job& job);
+        // returns the seconds until the next stream needs data
+        double serviceJobs();
+        void pump();
+        void threadMain();
+
+    public:
+        DecodeService() = default;
+        ~DecodeService() { shutdown(); }
+
+        DecodeService(const DecodeService&) = delete;
+        void operator=(const DecodeService&) = delete;
+
+        bool init();
+        void shutdown();
+
+        // bufferSec is the ring size, the decoder is owned by the service from now on
+        Stream open(std::unique_ptr<Decoder> decoder, bool loop, float bufferSec = 0.5f);
+        // wait: return only after the worker dropped the decoder, needed when
+        // it reads memory the caller is about to free
+        void close(StreamID id, bool wait = false);
+        void setLoop(StreamID id, bool loop);
+
+        // main thread, once per frame (decodes here without threads)
+        void update();
+
+        Stats getStats() const;
+        void resetStats();
+    };
+
+} // namespace FluxAudio
@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Least recently used cache of decoded PCM with a byte budget
+//
+// Meant for short sounds which are triggered often, they are decoded once and
+// then played from memory. Evicted buffers stay valid as long as a voice or
+// decoder still holds them.
+//
+// Example usage:
+// =============
+//
+// FluxAudio::PcmCache cache(16 * 1024 * 1024);
+// auto buffer = cache.get("shot.ogg");
+// if (!buffer) {
+//     buffer = decodeAll("shot.ogg");
+//     cache.put("shot.ogg", buffer);
+// }
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "audio/fluxAudioMixer.h"
+
+namespace FluxAudio {
+
+    class PcmCache {
+    public:
+        struct Stats {
+            uint32_t entries = 0;
+            size_t bytes = 0;
+            size_t budget = 0;
+            uint32_t hits = 0;
+            uint32_t misses = 0;
+            uint32_t evictions = 0;
+        };
+
+    private:
+        struct Entry {
+            std::string key;
+            std::shared_ptr<const SampleBuffer> buffer;
+            size_t bytes = 0;
+        };
+
+        std::list<Entry> mEntries; // front is the most recently used
+        std::unordered_map<std::string, std::list<Entry>::iterator> mIndex;
+        size_t mBudget = 0;
+        size_t mBytes = 0;
+        uint32_t mHits = 0;
+        uint32_t mMisses = 0;
+        uint32_t mEvictions = 0;
+        mutable std::mutex mMutex;
+
+        void evict(size_t budget) {
+            while (mBytes > budget && !mEntries.empty()) {
+                mBytes -= mEntries.back().bytes;
+                mIndex.erase(mEntries.back().key);
+                mEntries.pop_back();
+                mEvictions++;
+            }
+        }
+
+    public:
+        explicit PcmCache(size_t budgetBytes = 0) : mBudget(budgetBytes) {}
+
+        PcmCache(const PcmCache&) = delete;
+        void operator=(const PcmCache&) = delete;
+
+        static size_t getBytes(const SampleBuffer& buffer) {
+            return buffer.data.capacity() * sizeof(float);
+        }
+
+        // 0 disables the cache
+        void setBudget(size_t budgetBytes) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mBudget = budgetBytes;
+            evict(mBudget);
+        }
+        size_t getBudget() const {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mBudget;
+        }
+        bool isEnabled() const { return getBudget() > 0; }
+
+        std::shared_ptr<const SampleBuffer> get(const std::string& key) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mIndex.find(key);
+            if (it == mIndex.end()) {
+                mMisses++;
+                return nullptr;
+            }
+            mHits++;
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+            return it->second->buffer;
+        }
+
+        // false if the buffer alone does not fit into the budget
+        bool put(const std::string& key, std::shared_ptr<const SampleBuffer> buffer) {
+            if (!buffer)
+                return false;
+            const size_t bytes = getBytes(*buffer);
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (bytes > mBudget)
+                return false;
+
+            auto it = mIndex.find(key);
+            if (it != mIndex.end()) {
+                mBytes -= it->second->bytes;
+                mEntries.erase(it->second);
+                mIndex.erase(it);
+            }
+            evict(mBudget - bytes);
+            mEntries.push_front({ key, std::move(buffer), bytes });
+            mIndex[key] = mEntries.begin();
+            mBytes += bytes;
+            return true;
+        }
+
+        void remove(const std::string& key) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mIndex.find(key);
+            if (it == mIndex.end())
+                return;
+            mBytes -= it->second->bytes;
+            mEntries.erase(it->second);
+            mIndex.erase(it);
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mEntries.clear();
+            mIndex.clear();
+            mBytes = 0;
+        }
+
+        Stats getStats() const {
+            std::lock_guard<std::mutex> lock(mMutex);
+            Stats stats;
+            stats.entries = (uint32_t)mEntries.size();
+            stats.bytes = mBytes;
+            stats.budget = mBudget;
+            stats.hits = mHits;
+            stats.misses = mMisses;
+            stats.evictions = mEvictions;
+            return stats;
+        }
+    };
+
+} // namespace FluxAudio
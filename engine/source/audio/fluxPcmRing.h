@@ -0,0 +1,123 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Lock free single producer / single consumer ring of interleaved float PCM
+//
+// The producer (decoder) writes, the consumer (mixer in the audio callback)
+// reads. Sizes are in frames, a frame has getChannels() floats.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+namespace FluxAudio {
+
+    class PcmRing {
+    private:
+        std::vector<float> mData;
+        uint32_t mCapacity = 0;   // frames, power of two
+        uint32_t mMask = 0;
+        uint32_t mChannels = 0;
+
+        alignas(64) std::atomic<uint32_t> mWrite{0};
+        alignas(64) std::atomic<uint32_t> mRead{0};
+
+        // producer: no more data will follow
+        std::atomic<bool> mFinished{false};
+
+        // consumer ran dry before the producer finished
+        std::atomic<uint32_t> mUnderruns{0};
+
+    public:
+        PcmRing(uint32_t capacityFrames = 0, uint32_t channels = 2) {
+            if (capacityFrames) init(capacityFrames, channels);
+        }
+
+        PcmRing(const PcmRing&) = delete;
+        void operator=(const PcmRing&) = delete;
+
+        // not thread safe, call before producer and consumer start
+        void init(uint32_t capacityFrames, uint32_t channels) {
+            uint32_t cap = 1;
+            while (cap < capacityFrames) cap <<= 1;
+            mCapacity = cap;
+            mMask = cap - 1;
+            mChannels = std::max<uint32_t>(1, channels);
+            mData.assign((size_t)mCapacity * mChannels, 0.f);
+            mWrite.store(0, std::memory_order_relaxed);
+            mRead.store(0, std::memory_order_relaxed);
+            mFinished.store(false, std::memory_order_relaxed);
+            mUnderruns.store(0, std::memory_order_relaxed);
+        }
+
+        uint32_t getChannels() const { return mChannels; }
+        uint32_t getCapacity() const { return mCapacity; }
+
+        uint32_t availableRead() const {
+            return mWrite.load(std::memory_order_acquire) - mRead.load(std::memory_order_relaxed);
+        }
+        // frames consumed since init, wraps at 2^32
+        uint32_t getReadCount() const { return mRead.load(std::memory_order_acquire); }
+        uint32_t getUnderruns() const { return mUnderruns.load(std::memory_order_relaxed); }
+
+        uint32_t availableWrite() const {
+            return mCapacity - (mWrite.load(std::memory_order_relaxed) - mRead.load(std::memory_order_acquire));
+        }
+
+        //--------------------------------------------------------------------------
+        // producer side
+        uint32_t write(const float* frames, uint32_t count) {
+            uint32_t w = mWrite.load(std::memory_order_relaxed);
+            uint32_t r = mRead.load(std::memory_order_acquire);
+            count = std::min(count, mCapacity - (w - r));
+            if (count == 0) return 0;
+
+            uint32_t start = w & mMask;
+            uint32_t first = std::min(count, mCapacity - start);
+            std::memcpy(&mData[(size_t)start * mChannels], frames, (size_t)first * mChannels * sizeof(float));
+            if (count > first)
+                std::memcpy(mData.data(), frames + (size_t)first * mChannels, (size_t)(count - first) * mChannels * sizeof(float));
+
+            mWrite.store(w + count, std::memory_order_release);
+            return count;
+        }
+
+        void setFinished(bool value) { mFinished.store(value, std::memory_order_release); }
+        bool isFinished() const { return mFinished.load(std::memory_order_acquire); }
+
+        //--------------------------------------------------------------------------
+        // consumer side
+        uint32_t read(float* frames, uint32_t count) {
+            uint32_t r = mRead.load(std::memory_order_relaxed);
+            uint32_t w = mWrite.load(std::memory_order_acquire);
+            count = std::min(count, w - r);
+            if (count == 0) return 0;
+
+            uint32_t start = r & mMask;
+            uint32_t first = std::min(count, mCapacity - start);
+            std::memcpy(frames, &mData[(size_t)start * mChannels], (size_t)first * mChannels * sizeof(float));
+            if (count > first)
+                std::memcpy(frames + (size_t)first * mChannels, mData.data(), (size_t)(count - first) * mChannels * sizeof(float));
+
+            mRead.store(r + count, std::memory_order_release);
+            return count;
+        }
+
+        // drops up to count frames, returns the frames dropped
+        uint32_t skip(uint32_t count) {
+            uint32_t r = mRead.load(std::memory_order_relaxed);
+            uint32_t w = mWrite.load(std::memory_order_acquire);
+            count = std::min(count, w - r);
+            mRead.store(r + count, std::memory_order_release);
+            return count;
+        }
+
+        void noteUnderrun() { mUnderruns.fetch_add(1, std::memory_order_relaxed); }
+    };
+
+} // namespace FluxAudio
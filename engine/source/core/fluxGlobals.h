@@ -30,7 +30,7 @@
 #ifdef FLUX_GLES2
 #define MAX_LIGHTS 4 // Maximum number of 2D lights supported by the shader
 #else
-#define MAX_LIGHTS 16 // Maximum number of 2D lights supported by the shader
+#define MAX_LIGHTS 4096 // Maximum number of visible 2D lights, tiled see render/fluxLightTiles.h
 #endif
 
 
@@ -23,7 +23,9 @@
 #include "render/fluxRender2D.h"
 #include "particle/fluxParticleManager.h"
 #include "utils/fluxScheduler.h"
+#include "utils/fluxProfiler.h"
 #include "lights/fluxLightManager.h"
+#include "audio/fluxAudio.h"
 
 double gFrameTime = 0.f; // we need that Global for timming
 double gGameTime  = 0.f;
@@ -358,7 +360,19 @@ bool FluxMain::toggleFullScreen()
 //--------------------------------------------------------------------------------------
 void FluxMain::Update(const double& dt)
 {
-	FluxSchedule.update(dt);
+	FLUX_PROFILE_SCOPE("FluxMain::Update");
+	{
+		FLUX_PROFILE_SCOPE("FluxSchedule.update");
+		FluxSchedule.update(dt);
+	}
+	{
+		// the 2D listener follows the camera, the hearing range grows when zooming out
+		auto camera = Render2D.getCamera();
+		RectF view = camera->getVisibleWorldRect(false);
+		AudioManager.getMixer().setListener(view.x + view.w * 0.5f, view.y + view.h * 0.5f,
+			view.w * 0.5f * 1.5f, std::clamp(camera->getZoom(), 0.f, 1.f));
+	}
+	AudioManager.update();
 
 	for (U32 i = 0; i < mQueueObjects.size(); )
 	{
@@ -370,12 +384,14 @@ void FluxMain::Update(const double& dt)
 		if (i < mQueueObjects.size() && mQueueObjects[i] == obj)
 			++i;
 	}
+	FLUX_PROFILE_SCOPE("ParticleManager.Update");
 	ParticleManager.Update(dt);
 }
 //--------------------------------------------------------------------------------------
 
 //--------------------------------------------------------------------------------------
 void FluxMain::Draw() {
+	FLUX_PROFILE_SCOPE("FluxMain::Draw");
 	assert(getScreen());
     /* layers ... init */
 	// disabled for batch rendering
@@ -400,11 +416,17 @@ void FluxMain::Draw() {
 	}
 
 	onDraw();
-	ParticleManager.Draw();
+	{
+		FLUX_PROFILE_SCOPE("ParticleManager.Draw");
+		ParticleManager.Draw();
+	}
 	/* layers ... end */ 
 	Render2D.renderBatch();
 
-	onDrawTopMost();
+	{
+		FLUX_PROFILE_SCOPE("onDrawTopMost");
+		onDrawTopMost();
+	}
 
 	// disabled for batch rendering
     // glClear(GL_DEPTH_BUFFER_BIT);
@@ -528,6 +550,7 @@ void FluxMain::setupWorldMousePositions(  )
 //--------------------------------------------------------------------------------------
 void FluxMain::IterateFrame()
 {
+	FLUX_PROFILE_BEGIN_FRAME();
 	SDL_Event E;
 
 	//  Process ALL pending events in a loop to avoid input lag
@@ -707,7 +730,10 @@ void FluxMain::IterateFrame()
 
 	//  Render
 	if ( gAppStatus.Visible ) {
+		FLUX_PROFILE_GPU_BEGIN();
 		Draw();
+		FLUX_PROFILE_GPU_END();
+		FLUX_PROFILE_SCOPE("SDL_GL_SwapWindow");
 		SDL_GL_SwapWindow(getScreen()->getWindow());
 	} else if (mSettings.frameLimiter < 32.f){
 		#ifndef __EMSCRIPTEN__
@@ -745,6 +771,7 @@ void FluxMain::IterateFrame()
 		}
 		mDeletePending.clear();
 	}
+	FLUX_PROFILE_END_FRAME();
 }
 
 
@@ -39,6 +39,7 @@ bool FluxLabel::setFont(FluxTTFont* ttfont) {
         return false;
     }
     mTTFont = ttfont;
+    invalidateLayout();
 
     return  setTexture(mTTFont->getTexture());
 }
@@ -63,15 +64,23 @@ void FluxLabel::setCaption(const char *szFormat, ...)
 //-----------------------------------------------------------------------------
 Point2F FluxLabel::getStringSize(const char* text) const {
     Point2F result = {0.f, 0.f};
+    if (!mTTFont || !mTTFont->getFont()) return result;
+
+    // the size does not depend on the align
+    const size_t lHash = hashText(text);
+    for (const TextLayout& layout : mLayouts)
+        if (layoutMatches(layout, text, lHash))
+            return layout.stringSize;
+
     Point2F cur = {0.f, 0.f};
     STB_Internal::stbtt_aligned_quad q;
-    FontData fontData = *mTTFont->getFont();
+    const FontData& fontData = *mTTFont->getFont();
 
     for (int i = 0; text[i] != '\0'; i++) {
         if (text[i] < 32 || text[i] > 126) continue;
 
         STB_Internal::stbtt_GetBakedQuad(
-            reinterpret_cast<STB_Internal::stbtt_bakedchar*>(fontData.chardata),
+            reinterpret_cast<const STB_Internal::stbtt_bakedchar*>(fontData.chardata),
                                          fontData.textureSize, fontData.textureSize, text[i] - 32, &cur.x, &cur.y, &q, 1);
 
 
@@ -84,33 +93,43 @@ Point2F FluxLabel::getStringSize(const char* text) const {
     return result;
 }
 //-----------------------------------------------------------------------------
-const Point2F FluxLabel::Print(const char* text, Point2F pos, FontAlign align, Color4F color , bool shadow)
+const FluxLabel::TextLayout& FluxLabel::layoutText(const char* text, FontAlign align)
 {
-    // FIXME for performance this should be cached to a texture !!!
-
-    Point2F result = Point2F(0.f,0.f);
-    if (text[0] == '\0') return result;
-    if (!mTTFont || !mTTFont->getFont()) return result;
-    FontData fontData = *mTTFont->getFont();
-
-    if ( color == cl_NONE ) color = mColor;
+    const size_t lHash = hashText(text);
+    TextLayout* lSlot = &mLayouts[0];
+    for (TextLayout& layout : mLayouts) {
+        if (layout.align == align && layoutMatches(layout, text, lHash)) {
+            layout.lastUse = ++mLayoutClock;
+            return layout;
+        }
+        if (layout.lastUse < lSlot->lastUse)
+            lSlot = &layout;
+    }
 
-    float startX = pos.x;
-    float startY = pos.y;
+    const FontData& fontData = *mTTFont->getFont();
 
-    result = getStringSize(text); //FIXME cache this
+    TextLayout& lLayout = *lSlot;
+    lLayout.font = nullptr; // getStringSize must not use the old layout
+    lLayout.stringSize = getStringSize(text);
+    lLayout.font = mTTFont;
+    lLayout.hash = lHash;
+    lLayout.lastUse = ++mLayoutClock;
+    lLayout.text = text;
+    lLayout.scale = mScale;
+    lLayout.align = align;
+    lLayout.quads.clear();
 
+    float startX = 0.f;
     if ( align == FontAlign_Center ) {
-        startX -= result.x / 2.f;
+        startX -= lLayout.stringSize.x / 2.f;
     }
     else if ( align == FontAlign_Right )
     {
-        startX -= result.x;
+        startX -= lLayout.stringSize.x;
     }
 
     float currentX = startX;
-    float currentY = startY += result.y * 0.5f;
-
+    float currentY = lLayout.stringSize.y * 0.5f;
 
     S32 lMaxHeight = 0;
     for (int i = 0; text[i]; ++i)
@@ -121,48 +140,74 @@ const Point2F FluxLabel::Print(const char* text, Point2F pos, FontAlign align, C
             STB_Internal::stbtt_aligned_quad q;
             float nextX = 0, nextY = 0;
             STB_Internal::stbtt_GetBakedQuad(
-                reinterpret_cast<STB_Internal::stbtt_bakedchar*>(fontData.chardata),
+                reinterpret_cast<const STB_Internal::stbtt_bakedchar*>(fontData.chardata),
                                              fontData.textureSize, fontData.textureSize, text[i] - 32, &nextX, &nextY, &q, 1);
 
-            DrawParams2D dp;
-            dp.useUV = true;
-            dp.image = getTexture();
-            dp.z = getLayer();
-            dp.color = color;
-            dp.isGuiElement = mIsGuiElement;
-
             // Apply Scale to Dimensions
-            dp.w = ((q.x1 - q.x0) * mScale);
-            dp.h = ((q.y1 - q.y0) * mScale);
+            F32 w = (q.x1 - q.x0) * mScale;
+            F32 h = (q.y1 - q.y0) * mScale;
 
-            if ( dp.h > lMaxHeight )
-                lMaxHeight = dp.h;
+            if ( h > lMaxHeight )
+                lMaxHeight = h;
 
-            // Apply Scale to Position
             // q.x0/y0 are offsets from the baseline. We scale the offset and add to current position.
-            dp.x = currentX + (q.x0 * mScale) + (dp.w * 0.5f);
-            dp.y = currentY + (q.y0 * mScale) + (dp.h * 0.5f);
+            GlyphQuad& gq = lLayout.quads.emplace_back();
+            gq.x0 = currentX + (q.x0 * mScale);
+            gq.y0 = currentY + (q.y0 * mScale);
+            gq.x1 = gq.x0 + w;
+            gq.y1 = gq.y0 + h;
 
             // UVs remain the same regardless of scale
-            dp.u0 = q.s0; dp.v0 = q.t0;
-            dp.u1 = q.s1; dp.v1 = q.t1;
-
-            Render2D.drawSprite(dp);
-
-            if ( shadow ) {
-                dp.color = mShadowColor;
-                dp.x += mShadowOffset * mScale;
-                dp.y += mShadowOffset * mScale;
-                dp.z = getLayer() + 0.001f;
-                Render2D.drawSprite(dp);
-            }
+            gq.u0 = q.s0; gq.v0 = q.t0;
+            gq.u1 = q.s1; gq.v1 = q.t1;
+
             currentX += (nextX * mScale);
         }
     }
-    //updateSize
-    result.x = currentX - startX;
-    result.y = lMaxHeight;
-    return result;
+
+    lLayout.printSize.x = currentX - startX;
+    lLayout.printSize.y = lMaxHeight;
+    return lLayout;
+}
+//-----------------------------------------------------------------------------
+void FluxLabel::appendGlyphQuads(const TextLayout& layout, F32 x, F32 y, F32 z, const Color4F& color)
+{
+    size_t start = mRunBuffer.size();
+    mRunBuffer.resize(start + layout.quads.size() * 4);
+    Vertex2D* v = mRunBuffer.data() + start;
+
+    for (const GlyphQuad& gq : layout.quads) {
+        v[0] = { { x + gq.x0, y + gq.y0, -z }, { gq.u0, gq.v0 }, color }; // Top Left
+        v[1] = { { x + gq.x1, y + gq.y0, -z }, { gq.u1, gq.v0 }, color }; // Top Right
+        v[2] = { { x + gq.x1, y + gq.y1, -z }, { gq.u1, gq.v1 }, color }; // Bottom Right
+        v[3] = { { x + gq.x0, y + gq.y1, -z }, { gq.u0, gq.v1 }, color }; // Bottom Left
+        v += 4;
+    }
+}
+//-----------------------------------------------------------------------------
+const Point2F FluxLabel::Print(const char* text, Point2F pos, FontAlign align, Color4F color , bool shadow)
+{
+    Point2F result = Point2F(0.f,0.f);
+    if (text[0] == '\0') return result;
+    if (!mTTFont || !mTTFont->getFont() || !getTexture()) return result;
+
+    if ( color == cl_NONE ) color = mColor;
+
+    const TextLayout& layout = layoutText(text, align);
+    if (layout.quads.empty()) return layout.printSize;
+
+    // the whole text is one glyph run => one sort entry instead of one per char
+    mRunBuffer.clear();
+    if ( shadow ) {
+        F32 lOffset = mShadowOffset * mScale;
+        appendGlyphQuads(layout, pos.x + lOffset, pos.y + lOffset, getLayer() + 0.001f, mShadowColor);
+    }
+    appendGlyphQuads(layout, pos.x, pos.y, getLayer(), color);
+
+    Render2D.submitQuadRun(mRunBuffer.data(), (U32)mRunBuffer.size(),
+                           getTexture()->getHandle(), mIsGuiElement, getLayer());
+
+    return layout.printSize;
 }
 
 void FluxLabel::Draw()
@@ -6,7 +6,9 @@
 
 #include <SDL3/SDL.h>
 #include <format>
+#include <string>
 #include <string_view>
+#include <vector>
 
 
 #include "core/fluxRenderObject.h"
@@ -22,12 +24,45 @@ protected:
     bool mIsGuiElement = true;
 
     FluxTTFont* mTTFont = nullptr;
+
+    // Layouts of the last printed texts. Quads are scaled, aligned and relative
+    // to the print position. A label used as printer (several texts per
+    // frame, GameCtrl::writeText) keeps up to LAYOUT_CACHE of them, the least
+    // recently used one is rebuilt on a miss.
+    static constexpr int LAYOUT_CACHE = 8;
+    struct GlyphQuad {
+        F32 x0, y0, x1, y1;
+        F32 u0, v0, u1, v1;
+    };
+    struct TextLayout {
+        const FluxTTFont* font = nullptr;
+        size_t hash = 0;                   // of text, compared first
+        U32 lastUse = 0;
+        std::string text;
+        F32 scale = 0.f;
+        FontAlign align = FontAlign_Left;
+        Point2F stringSize = { 0.f, 0.f }; // see getStringSize
+        Point2F printSize = { 0.f, 0.f };  // returned by Print
+        std::vector<GlyphQuad> quads;
+    };
+    TextLayout mLayouts[LAYOUT_CACHE];
+    U32 mLayoutClock = 0;
+    std::vector<Vertex2D> mRunBuffer;
+
+    static size_t hashText(const char* text) { return std::hash<std::string_view>()(text); }
+    bool layoutMatches(const TextLayout& layout, const char* text, size_t hash) const {
+        return layout.font == mTTFont && layout.hash == hash && layout.scale == mScale && layout.text == text;
+    }
+    const TextLayout& layoutText(const char* text, FontAlign align);
+    void appendGlyphQuads(const TextLayout& layout, F32 x, F32 y, F32 z, const Color4F& color);
 private:
     using Parent::getDrawParams;
 
 public:
     FluxLabel(FluxTTFont* ttfont = nullptr);
     bool setFont(FluxTTFont* ttfont);
+    // force a new layout, eg. after the font was reloaded
+    void invalidateLayout() { for (TextLayout& layout : mLayouts) layout.font = nullptr; }
     bool isInitialized() { return mTTFont != nullptr; }
     ~FluxLabel();
 
@@ -27,6 +27,28 @@ namespace ImFlux {
         ImGui::Dummy(size);
     }
 
+    //------------------------------------------------------------------------------
+    // Waveform overview: one vertical line per column from min to max (-1..1).
+    // The draw cost depends on the number of columns, not on the samples.
+    inline void MinMaxWaveform(ImDrawList* dl, ImVec2 pos, ImVec2 size, const float* mins, const float* maxs,
+                               int columns, ImU32 col, float thickness = 1.0f) {
+        if (!dl || columns < 1) return;
+        const float midY = pos.y + size.y * 0.5f;
+        const float yScale = size.y * 0.45f;
+        const float xStep = columns > 1 ? size.x / (float)(columns - 1) : 0.f;
+        float prevLo = mins[0];
+        float prevHi = maxs[0];
+        for (int i = 0; i < columns; i++) {
+            // overlap with the previous column so the trace stays connected
+            const float lo = std::clamp(std::min(mins[i], prevHi), -1.f, 1.f);
+            const float hi = std::clamp(std::max(maxs[i], prevLo), -1.f, 1.f);
+            prevLo = mins[i];
+            prevHi = maxs[i];
+            const float x = pos.x + (float)i * xStep;
+            dl->AddLine(ImVec2(x, midY - hi * yScale), ImVec2(x, midY - lo * yScale + 1.0f), col, thickness);
+        }
+    }
+
     //------------------------------------------------------------------------------
     // old school VU Meter 70th
     // value is 0.0 to 1.0
@@ -12,7 +12,6 @@ private:
 public:
     static FluxLightManager& getInstance() {
         static FluxLightManager instance;
-        instance.mLights.reserve(MAX_LIGHTS);
         return instance;
     }
 
@@ -40,7 +39,7 @@ public:
         mLights.clear();
     }
 
-    const std::vector<FluxLight*> getLights()  {
+    const std::vector<FluxLight*>& getLights() const {
         return mLights;
     }
 
@@ -50,7 +49,7 @@ public:
 
 
 private:
-    FluxLightManager() {}
+    FluxLightManager() { mLights.reserve(MAX_LIGHTS); }
 };
 
 #define LightManager FluxLightManager::getInstance()
@@ -0,0 +1,194 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+#include <glad/glad.h>
+
+#include <cmath>
+#include <algorithm>
+
+#include "render/fluxLightTiles.h"
+#include "core/fluxMath.h"
+#include "utils/errorlog.h"
+
+//-------------------------------------------------------------------------------
+GLuint FluxLightTiles::createFloatTexture(GLint internalFormat, GLenum format, S32 width, S32 height)
+{
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, nullptr);
+    // float textures are not filterable on GLES3, we only use texelFetch
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return tex;
+}
+//-------------------------------------------------------------------------------
+bool FluxLightTiles::init()
+{
+#ifdef FLUX_GLES2
+    return false;
+#else
+    glActiveTexture(GL_TEXTURE0 + UNIT_LIGHT_DATA);
+    mLightDataRows = 3;
+    mLightDataTex = createFloatTexture(GL_RGBA32F, GL_RGBA, TEX_WIDTH, mLightDataRows);
+
+    glActiveTexture(GL_TEXTURE0 + UNIT_TILE_GRID);
+    mTileGridTex = createFloatTexture(GL_RG32F, GL_RG, TILES_X, TILES_Y);
+
+    glActiveTexture(GL_TEXTURE0 + UNIT_LIGHT_INDEX);
+    mLightIndexRows = 1;
+    mLightIndexTex = createFloatTexture(GL_R32F, GL_RED, TEX_WIDTH, mLightIndexRows);
+
+    glActiveTexture(GL_TEXTURE0);
+
+    mTileGrid.assign(TILES_X * TILES_Y * 2, 0.f);
+    mTileCounts.assign(TILES_X * TILES_Y, 0);
+
+    dLog("FluxLightTiles: %dx%d tiles, max %u lights.", TILES_X, TILES_Y, MAX_TILED_LIGHTS);
+    return true;
+#endif
+}
+//-------------------------------------------------------------------------------
+void FluxLightTiles::shutdown()
+{
+    GLuint textures[3] = { mLightDataTex, mTileGridTex, mLightIndexTex };
+    if (mLightDataTex || mTileGridTex || mLightIndexTex)
+        glDeleteTextures(3, textures);
+    mLightDataTex = mTileGridTex = mLightIndexTex = 0;
+}
+//-------------------------------------------------------------------------------
+// data is padded to full TEX_WIDTH rows, the texture only grows
+void FluxLightTiles::uploadRows(GLuint tex, GLint internalFormat, GLenum format, S32 components,
+                                std::vector<F32>& data, S32& allocatedRows)
+{
+    const size_t rowFloats = (size_t)TEX_WIDTH * components;
+    S32 rows = std::max<S32>(1, (S32)((data.size() + rowFloats - 1) / rowFloats));
+    data.resize(rows * rowFloats, 0.f);
+
+    glBindTexture(GL_TEXTURE_2D, tex);
+    if (rows > allocatedRows) {
+        allocatedRows = rows;
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, TEX_WIDTH, rows, 0, format, GL_FLOAT, data.data());
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TEX_WIDTH, rows, format, GL_FLOAT, data.data());
+    }
+}
+//-------------------------------------------------------------------------------
+S32 FluxLightTiles::update(const std::vector<FluxLight*>& lights, const RectF& view)
+{
+    if (!mLightDataTex)
+        return -1;
+    // empty (or NaN) view: tile size 0 would make the tile casts below UB,
+    // nothing is visible anyway
+    if (!(view.w > 0.f) || !(view.h > 0.f))
+        return -1;
+
+    mView = view;
+    const F32 tileW = view.w / (F32)TILES_X;
+    const F32 tileH = view.h / (F32)TILES_Y;
+
+    mLightData.clear();
+    mLightTileRange.clear();
+    std::fill(mTileCounts.begin(), mTileCounts.end(), 0);
+
+    // 1. cull, pack the light data and count the lights per tile
+    U32 visible = 0;
+    for (const FluxLight* light : lights) {
+        if (visible >= MAX_TILED_LIGHTS)
+            break;
+        if (!checkAABBIntersectionF(view, light->getRectF()))
+            continue;
+
+        // light i occupies texel (i % TEX_WIDTH) in the rows (i / TEX_WIDTH) * 3 + 0..2
+        U32 block = visible / TEX_WIDTH;
+        U32 column = visible % TEX_WIDTH;
+        size_t needed = (size_t)(block + 1) * 3 * TEX_WIDTH * 4;
+        if (mLightData.size() < needed)
+            mLightData.resize(needed, 0.f);
+
+        F32* row0 = &mLightData[((block * 3 + 0) * TEX_WIDTH + column) * 4];
+        F32* row1 = &mLightData[((block * 3 + 1) * TEX_WIDTH + column) * 4];
+        F32* row2 = &mLightData[((block * 3 + 2) * TEX_WIDTH + column) * 4];
+        row0[0] = light->position.x; row0[1] = light->position.y; row0[2] = light->position.z; row0[3] = light->radius;
+        row1[0] = light->color.r;    row1[1] = light->color.g;    row1[2] = light->color.b;    row1[3] = light->color.a;
+        row2[0] = light->direction.x; row2[1] = light->direction.y; row2[2] = light->cutoff;   row2[3] = 0.f;
+
+        S32 x0 = std::clamp((S32)std::floor((light->position.x - light->radius - view.x) / tileW), 0, TILES_X - 1);
+        S32 y0 = std::clamp((S32)std::floor((light->position.y - light->radius - view.y) / tileH), 0, TILES_Y - 1);
+        S32 x1 = std::clamp((S32)std::floor((light->position.x + light->radius - view.x) / tileW), 0, TILES_X - 1);
+        S32 y1 = std::clamp((S32)std::floor((light->position.y + light->radius - view.y) / tileH), 0, TILES_Y - 1);
+        mLightTileRange.insert(mLightTileRange.end(), { x0, y0, x1, y1 });
+
+        for (S32 ty = y0; ty <= y1; ty++)
+            for (S32 tx = x0; tx <= x1; tx++)
+                mTileCounts[ty * TILES_X + tx]++;
+
+        visible++;
+    }
+
+    // 2. prefix sum into the tile grid
+    U32 total = 0;
+    for (S32 t = 0; t < TILES_X * TILES_Y; t++) {
+        U32 count = std::min(mTileCounts[t], MAX_LIGHTS_PER_TILE);
+        mTileGrid[t * 2 + 0] = (F32)total;
+        mTileGrid[t * 2 + 1] = (F32)count;
+        mTileCounts[t] = 0; // reused as fill cursor
+        total += count;
+    }
+
+    // 3. fill the index list
+    mLightIndex.assign(std::max<U32>(total, 1), 0.f);
+    for (U32 i = 0; i < visible; i++) {
+        const S32* range = &mLightTileRange[i * 4];
+        for (S32 ty = range[1]; ty <= range[3]; ty++) {
+            for (S32 tx = range[0]; tx <= range[2]; tx++) {
+                S32 t = ty * TILES_X + tx;
+                if (mTileCounts[t] >= (U32)mTileGrid[t * 2 + 1])
+                    continue; // tile is full
+                mLightIndex[(U32)mTileGrid[t * 2 + 0] + mTileCounts[t]++] = (F32)i;
+            }
+        }
+    }
+
+    // 4. upload
+    glActiveTexture(GL_TEXTURE0 + UNIT_LIGHT_DATA);
+    if (mLightData.empty())
+        mLightData.assign((size_t)3 * TEX_WIDTH * 4, 0.f);
+    uploadRows(mLightDataTex, GL_RGBA32F, GL_RGBA, 4, mLightData, mLightDataRows);
+
+    glActiveTexture(GL_TEXTURE0 + UNIT_TILE_GRID);
+    glBindTexture(GL_TEXTURE_2D, mTileGridTex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TILES_X, TILES_Y, GL_RG, GL_FLOAT, mTileGrid.data());
+
+    glActiveTexture(GL_TEXTURE0 + UNIT_LIGHT_INDEX);
+    uploadRows(mLightIndexTex, GL_R32F, GL_RED, 1, mLightIndex, mLightIndexRows);
+
+    glActiveTexture(GL_TEXTURE0);
+
+    return (S32)visible;
+}
+//-------------------------------------------------------------------------------
+void FluxLightTiles::bind(FluxShader& shader)
+{
+    if (!mLightDataTex)
+        return;
+
+    glActiveTexture(GL_TEXTURE0 + UNIT_LIGHT_DATA);
+    glBindTexture(GL_TEXTURE_2D, mLightDataTex);
+    glActiveTexture(GL_TEXTURE0 + UNIT_TILE_GRID);
+    glBindTexture(GL_TEXTURE_2D, mTileGridTex);
+    glActiveTexture(GL_TEXTURE0 + UNIT_LIGHT_INDEX);
+    glBindTexture(GL_TEXTURE_2D, mLightIndexTex);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.setInt("uLightData", UNIT_LIGHT_DATA);
+    shader.setInt("uTileGrid", UNIT_TILE_GRID);
+    shader.setInt("uLightIndex", UNIT_LIGHT_INDEX);
+    shader.setVec2("uTileOrigin", mView.x, mView.y);
+    shader.setVec2("uTileSize", mView.w / (F32)TILES_X, mView.h / (F32)TILES_Y);
+    shader.setVec2("uTileCount", (F32)TILES_X, (F32)TILES_Y);
+}
+//-------------------------------------------------------------------------------
@@ -0,0 +1,78 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Tiled light culling for FluxRender2D
+//
+// The visible world rect is split into TILES_X * TILES_Y tiles. Each frame the
+// CPU bins the visible lights into the tiles and uploads three float textures:
+//   - light data : 3 texels per light (pos.xyz + radius | color | dir.xy + cutoff)
+//   - tile grid  : per tile first index and count into the index list
+//   - index list : light indices of all tiles
+// The fragment shader only loops the lights of its own tile.
+//
+// Not available with FLUX_GLES2 (no float textures / texelFetch), the renderer
+// keeps the uniform array path there.
+//-----------------------------------------------------------------------------
+#pragma once
+#ifndef _FLUXLIGHTTILES_H_
+#define _FLUXLIGHTTILES_H_
+
+#include "platform/fluxGL.h"
+#include "core/fluxGlobals.h"
+#include "render/fluxShader.h"
+#include "lights/fluxLight.h"
+
+#include <vector>
+
+class FluxLightTiles {
+public:
+    static constexpr S32 TILES_X = 16;
+    static constexpr S32 TILES_Y = 16;
+    static constexpr S32 TEX_WIDTH = 1024;          // must match LIGHT_TEX_WIDTH in the shader
+    static constexpr U32 MAX_TILED_LIGHTS = MAX_LIGHTS;
+    static constexpr U32 MAX_LIGHTS_PER_TILE = 64;
+
+    // texture units used, unit 0 is the sprite texture
+    static constexpr S32 UNIT_LIGHT_DATA = 1;
+    static constexpr S32 UNIT_TILE_GRID = 2;
+    static constexpr S32 UNIT_LIGHT_INDEX = 3;
+
+    FluxLightTiles() = default;
+    ~FluxLightTiles() { shutdown(); }
+
+    FluxLightTiles(const FluxLightTiles&) = delete;
+    void operator=(const FluxLightTiles&) = delete;
+
+    bool init();
+    void shutdown();
+
+    // bin the lights intersecting view, returns the number of visible lights,
+    // -1 if nothing was uploaded (no textures, empty view)
+    S32 update(const std::vector<FluxLight*>& lights, const RectF& view);
+
+    // bind the textures and set the uniforms, shader must be in use
+    void bind(FluxShader& shader);
+
+private:
+    GLuint mLightDataTex = 0;
+    GLuint mTileGridTex = 0;
+    GLuint mLightIndexTex = 0;
+    S32 mLightDataRows = 0;
+    S32 mLightIndexRows = 0;
+
+    RectF mView = {};
+
+    // CPU side, reused every frame
+    std::vector<F32> mLightData;
+    std::vector<F32> mTileGrid;     // TILES_X * TILES_Y * 2
+    std::vector<F32> mLightIndex;
+    std::vector<U32> mTileCounts;   // TILES_X * TILES_Y
+    std::vector<S32> mLightTileRange; // x0,y0,x1,y1 per visible light
+
+    GLuint createFloatTexture(GLint internalFormat, GLenum format, S32 width, S32 height);
+    void uploadRows(GLuint tex, GLint internalFormat, GLenum format, S32 components,
+                    std::vector<F32>& data, S32& allocatedRows);
+};
+
+#endif
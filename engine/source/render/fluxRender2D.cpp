@@ -18,6 +18,7 @@
 #include "core/fluxMath.h"
 #include "utils/errorlog.h"
 #include "lights/fluxLightManager.h"
+#include "utils/fluxProfiler.h"
 //-------------------------------------------------------------------------------
 bool FluxRender2D::init(U32 maxSprites)
 {
@@ -108,6 +109,12 @@ bool FluxRender2D::init(U32 maxSprites)
 
     //<<<< whitePixel trick
 
+#ifndef FLUX_GLES2
+    if (!mLightTiles.init()) {
+        Log("[error] FluxRender2D: Failed to create the light tile textures!");
+    }
+#endif
+
     mShaderFailed = false;
     Log("FluxRender2D: Initialized successfully.");
     return true;
@@ -130,6 +137,8 @@ void FluxRender2D::shutdown()
         // If you added a line mesh later:
         mLineMesh.unload();
 
+        mLightTiles.shutdown();
+
         SAFE_DELETE(mDefaultCamera);
         mActiveCamera = nullptr;
 
@@ -171,14 +180,15 @@ void FluxRender2D::executeDrawLine(const PrimitiveCommand& cmd)
     mDefaultShader.setMat4("view", mActiveCamera ? mActiveCamera->getViewMatrix() : IDENTITY_MATRIX);
 
     // 3. Bind the White Texture so the shader doesn't render black
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mWhiteTextureHandle);
+    bindTexture(mWhiteTextureHandle);
 
     // 4. Update the VBO and Draw
     mLineMesh.updateDynamic(lineVerts, 2);
 
     // false = no indices, GL_LINES = primitive type
     mLineMesh.draw(2, false, GL_LINES);
+    mStats.drawCalls++;
+    mStats.vertices += 2;
 }
 
 
@@ -251,8 +261,7 @@ void FluxRender2D::executeDrawCircle(const PrimitiveCommand& cmd)
     mDefaultShader.setMat4("projection", mOrtho);
     mDefaultShader.setMat4("view", mActiveCamera ? mActiveCamera->getViewMatrix() : IDENTITY_MATRIX);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mWhiteTextureHandle);
+    bindTexture(mWhiteTextureHandle);
 
     //  Update VBO and Draw
     // Note: We use mLineMesh which was reserved for 10,000 vertices
@@ -260,6 +269,8 @@ void FluxRender2D::executeDrawCircle(const PrimitiveCommand& cmd)
 
     // Use glDrawArrays (false) with GL_LINE_LOOP
     mLineMesh.draw((U32)circleVerts.size(), false, GL_LINE_LOOP);
+    mStats.drawCalls++;
+    mStats.vertices += (U32)circleVerts.size();
 }
 //-------------------------------------------------------------------------------
 void FluxRender2D::drawTriangle(Point3F p1, Point3F p2, Point3F p3, const Color4F& color, bool filled) {
@@ -288,8 +299,7 @@ void FluxRender2D::executeDrawTriangle(const PrimitiveCommand& cmd) {
     mDefaultShader.setMat4("projection", mOrtho);
     mDefaultShader.setMat4("view", mActiveCamera ? mActiveCamera->getViewMatrix() : IDENTITY_MATRIX);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mWhiteTextureHandle);
+    bindTexture(mWhiteTextureHandle);
 
     mLineMesh.updateDynamic(triVerts, 3);
 
@@ -300,6 +310,8 @@ void FluxRender2D::executeDrawTriangle(const PrimitiveCommand& cmd) {
         // Outline: Draw as a connected loop
         mLineMesh.draw(3, false, GL_LINE_LOOP);
     }
+    mStats.drawCalls++;
+    mStats.vertices += 3;
 }
 
 //-------------------------------------------------------------------------------
@@ -410,7 +422,8 @@ bool FluxRender2D::uglyDraw2DStretch (
 //-------------------------------------------------------------------------------
 void FluxRender2D::renderLights()
 {
-    const std::vector<FluxLight*> lights = LightManager.getLights();
+    FLUX_PROFILE_SCOPE("FluxRender2D::renderLights");
+    const std::vector<FluxLight*>& lights = LightManager.getLights();
     RectF view = Render2D.getCamera()->getVisibleWorldRect(false);
 
     bool lSceneHaveLights = lights.size() > 0;
@@ -444,25 +457,18 @@ void FluxRender2D::renderLights()
 
 
 #else
-
-    for (size_t i = 0; i < lights.size(); ++i) {
-        if (activeLightCount >= MAX_LIGHTS) {
-            break;
+    //  culling and binning into screen tiles, the shader only loops the
+    //  lights of the tile the fragment is in
+    if (lSceneHaveLights) {
+        activeLightCount = mLightTiles.update(lights, view);
+        if (activeLightCount < 0) {
+            // nothing uploaded, the tiles are from an older frame: the
+            // shader must not take the tiled branch (uNumLights -1 below)
+            lSceneHaveLights = false;
+            activeLightCount = 0;
+        } else {
+            mLightTiles.bind(mDefaultShader);
         }
-        //  Frustum/Visibility Culling
-        if (!checkAABBIntersectionF(view, lights[i]->getRectF())) {
-            continue;
-        }
-        //  Pass data using the activeLightCount index, NOT the loop index i
-        std::string lightPrefix = "uLights[" + std::to_string(activeLightCount) + "]";
-
-        mDefaultShader.setVec3((lightPrefix + ".position").c_str(), lights[i]->position.x, lights[i]->position.y, lights[i]->position.z);
-        mDefaultShader.setVec4((lightPrefix + ".color").c_str(), lights[i]->color);
-        mDefaultShader.setFloat((lightPrefix + ".radius").c_str(), lights[i]->radius);
-        mDefaultShader.setVec2((lightPrefix + ".direction").c_str(), lights[i]->direction.x, lights[i]->direction.y);
-        mDefaultShader.setFloat((lightPrefix + ".cutoff").c_str(), lights[i]->cutoff);
-
-        activeLightCount++;
     }
 #endif
 
@@ -486,6 +492,10 @@ void FluxRender2D::renderLights()
 //-------------------------------------------------------------------------------
 void FluxRender2D::beginFrame() //FluxCamera* cam)
 {
+    mLastStats = mStats;
+    mStats = {};
+    mBoundTexture = 0;
+
     if (mActiveCamera) {
         mActiveCamera->update();
         setViewMatrix(mActiveCamera->getViewMatrix());
@@ -549,6 +559,47 @@ bool FluxRender2D::drawSprite(const DrawParams2D& dp)
     return true;
 }
 //-------------------------------------------------------------------------------
+void FluxRender2D::submitQuadRun(const Vertex2D* vertices, U32 count, GLuint texture, bool isGui, F32 z)
+{
+    if (!vertices || count < 4 || mShaderFailed) return;
+
+    if ( !isGui && mUseCulling )
+    {
+        RectF bounds = { vertices[0].pos.x, vertices[0].pos.y, 0.f, 0.f };
+        F32 maxX = bounds.x, maxY = bounds.y;
+        for (U32 i = 1; i < count; i++) {
+            bounds.x = std::min(bounds.x, vertices[i].pos.x);
+            bounds.y = std::min(bounds.y, vertices[i].pos.y);
+            maxX = std::max(maxX, vertices[i].pos.x);
+            maxY = std::max(maxY, vertices[i].pos.y);
+        }
+        bounds.w = maxX - bounds.x;
+        bounds.h = maxY - bounds.y;
+
+        RectF view = Render2D.getCamera()->getVisibleWorldRect(false);
+        if ( !checkAABBIntersectionF (view, bounds) )
+            return;
+    }
+
+    // a run larger than one flush is split into several commands
+    const U32 lMaxRun = getBatchVertexLimit() / 4 * 4;
+    count -= count % 4;
+    for (U32 lOffset = 0; lOffset < count; lOffset += lMaxRun) {
+        if (mCommandList.size() >= mMaxSprites) {
+            renderBatch();
+        }
+
+        RenderCommand cmd;
+        cmd.textureHandle = texture;
+        cmd.isGui = isGui;
+        cmd.params.z = z;
+        cmd.runStart = (U32)mRunVertices.size();
+        cmd.runCount = std::min(lMaxRun, count - lOffset);
+        mRunVertices.insert(mRunVertices.end(), vertices + lOffset, vertices + lOffset + cmd.runCount);
+        mCommandList.push_back(cmd);
+    }
+}
+//-------------------------------------------------------------------------------
 
 void FluxRender2D::renderCurrentBuffer(std::vector<Vertex2D>& vertexBuffer, GLuint texture, bool isGui) {
     if (vertexBuffer.empty()) return;
@@ -562,13 +613,26 @@ void FluxRender2D::renderCurrentBuffer(std::vector<Vertex2D>& vertexBuffer, GLui
     mQuadMesh.updateDynamic(vertexBuffer.data(), (U32)vertexBuffer.size());
 
     // 2. State & Texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    bindTexture(texture);
 
     // 3. The Clean Draw
     // We pass true for indices and GL_TRIANGLES is the default
     U32 indicesToDraw = (U32)(vertexBuffer.size() / 4) * 6;
     mQuadMesh.draw(indicesToDraw, true);
+
+    mStats.drawCalls++;
+    mStats.batchFlushes++;
+    mStats.vertices += (U32)vertexBuffer.size();
+}
+//-------------------------------------------------------------------------------
+void FluxRender2D::bindTexture(GLuint texture)
+{
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (texture != mBoundTexture) {
+        mBoundTexture = texture;
+        mStats.textureBinds++;
+    }
 }
 
 //-------------------------------------------------------------------------------
@@ -664,6 +728,8 @@ void FluxRender2D::renderBatch()
     // pre view filtering.
     if (mCommandList.empty()) return;
 
+    FLUX_PROFILE_SCOPE("Render2D::renderBatch");
+
     std::sort(mCommandList.begin(), mCommandList.end(), [](const RenderCommand& a, const RenderCommand& b) {
         if (a.isGui != b.isGui) return a.isGui < b.isGui;
 
@@ -696,7 +762,7 @@ void FluxRender2D::renderBatch()
         bool isCustom = (cmd.customRenderCallback != nullptr);
         bool textureChanged = (cmd.textureHandle != currentTex);
         bool guiChanged = (cmd.isGui != currentGuiMode);
-        bool bufferFull = (_VertexBuffer.size() >= 16000);
+        bool bufferFull = (_VertexBuffer.size() + std::max<U32>(cmd.runCount, 4) > getBatchVertexLimit());
 
         if (isCustom || textureChanged || guiChanged || bufferFull)
         {
@@ -717,6 +783,12 @@ void FluxRender2D::renderBatch()
             // Execute the particle system draw call directly
             cmd.customRenderCallback(cmd);
         }
+        else if (cmd.runCount > 0)
+        {
+            // pre-built quads, eg. all glyphs of a label
+            auto lRun = mRunVertices.begin() + cmd.runStart;
+            _VertexBuffer.insert(_VertexBuffer.end(), lRun, lRun + cmd.runCount);
+        }
         else
         {
             // It's a normal sprite, add it to the buffer
@@ -727,6 +799,7 @@ void FluxRender2D::renderBatch()
     // Final flush
     renderCurrentBuffer(_VertexBuffer, currentTex, currentGuiMode);
     mCommandList.clear();
+    mRunVertices.clear();
 
     // ------------ Primitives ------------------
     // Render all Scheduled Primitives (Lines, Circles)
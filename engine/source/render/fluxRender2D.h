@@ -14,6 +14,7 @@
 #include "core/fluxTexture.h"
 #include "render/fluxShader.h"
 #include "render/fluxMesh.h"
+#include "render/fluxLightTiles.h"
 #include "core/fluxCamera.h"
 
 
@@ -112,6 +113,10 @@ struct RenderCommand {
     // particle performance. add a customRenderCallback
     void (*customRenderCallback)(const RenderCommand& cmd) = nullptr;
     void* userData = nullptr;
+
+    // quad run (eg. a label): vertices in FluxRender2D::mRunVertices
+    U32 runStart = 0;
+    U32 runCount = 0;
 };
 
 struct PrimitiveCommand {
@@ -137,6 +142,15 @@ static const F32 IDENTITY_MATRIX[16] = {
 
 
 class FluxRender2D {
+public:
+    // per frame counters, see getStats
+    struct RenderStats {
+        U32 drawCalls = 0;
+        U32 vertices = 0;
+        U32 textureBinds = 0;
+        U32 batchFlushes = 0;
+    };
+
 private:
     bool mShaderFailed;
 
@@ -169,13 +183,22 @@ private:
 
     GLuint mWhiteTextureHandle;
     std::vector<Vertex2D> _VertexBuffer; //
+    std::vector<Vertex2D> mRunVertices; // submitQuadRun data of this frame
+    // vertices of one flush: the 16000 vertex batch, but never more than the vbo
+    U32 getBatchVertexLimit() const { return std::min<U32>(16000, mMaxSprites * 4); }
 
     // Lights
     Color4F mAmbientColor = { 0.1f,0.1f,0.1f, 1.f}; // cl_White; //only have effect when lights in scene
     F32 mLightExposure = 1.f; //only have effect when lights in scene
     // S32 mToneMappingType = 2; //default=none, 1=Reinhard, 2=Filmic
+    FluxLightTiles mLightTiles; // unused with FLUX_GLES2
     void renderLights();
 
+    RenderStats mStats;
+    RenderStats mLastStats;
+    GLuint mBoundTexture = 0;
+    void bindTexture(GLuint texture);
+
 public:
     static FluxRender2D& getInstance() {
         static FluxRender2D instance;
@@ -226,6 +249,9 @@ public:
     void renderBatch();
     void renderCurrentBuffer(std::vector<Vertex2D>& vertexBuffer, GLuint texture, bool isGui);
     void submitCustomCommand(const RenderCommand& cmd) { mCommandList.push_back(cmd); }
+    // pre-built quads (4 vertices each) sorted as one command on layer z,
+    // they are batched with sprites of the same texture
+    void submitQuadRun(const Vertex2D* vertices, U32 count, GLuint texture, bool isGui, F32 z);
 
 
     // this render NOT centered it render directly to dstRect!
@@ -257,6 +283,11 @@ public:
         memcpy(mCurrentCameraViewMatrix, matrix, sizeof(F32) * 16);
     }
 
+    // counters of the last finished frame
+    const RenderStats& getStats() const { return mLastStats; }
+    // counters of the frame being drawn (reset in beginFrame)
+    const RenderStats& getFrameStats() const { return mStats; }
+
     void setCulling(bool value) { mUseCulling = value; }
     bool getCulling() { return mUseCulling; }
 
@@ -137,6 +137,7 @@ void main() {
 }
 )";
 #else
+    // Tiled lights, see render/fluxLightTiles.h
     inline const char* fragmentShaderSource = GLSL_VERSION FRAG_PRECISION R"(
     out vec4 FragColor;
 
@@ -147,16 +148,14 @@ void main() {
     uniform sampler2D texture1;
     uniform vec3 uAmbientColor; // New Uniform: RGB for color, Magnitude for intensity
 
-    struct Light {
-        vec3 position;
-        vec4 color;    // rgb, alpha for intensity
-        float radius;
-        vec2 direction;
-        float cutoff;
-    };
+    #define LIGHT_TEX_WIDTH 1024
+    uniform highp sampler2D uLightData;  // 3 texels per light: pos.xyz+radius, color, dir.xy+cutoff
+    uniform highp sampler2D uTileGrid;   // per tile: first index, count
+    uniform highp sampler2D uLightIndex; // light indices of all tiles
+    uniform vec2 uTileOrigin;
+    uniform vec2 uTileSize;
+    uniform vec2 uTileCount;
 
-    #define MAX_LIGHTS 16
-    uniform Light uLights[MAX_LIGHTS];
     uniform int uNumLights;
     uniform bool uIsGui;
     uniform float uExposure; // = 1.0;
@@ -177,32 +176,44 @@ void main() {
             texColor.rgb = pow(texColor.rgb, vec3(2.2));
             vec3 lightAccum = uAmbientColor;
 
-            for (int i = 0; i < MAX_LIGHTS; ++i) {
-                if (i >= uNumLights) break;
-                vec2 lightToFrag = fragWorldPos.xy - uLights[i].position.xy;
+            ivec2 tile = ivec2(floor((fragWorldPos.xy - uTileOrigin) / max(uTileSize, vec2(0.0001))));
+            tile = clamp(tile, ivec2(0), ivec2(uTileCount) - 1);
+            vec2 range = texelFetch(uTileGrid, tile, 0).rg;
+            int first = int(range.x);
+            int count = int(range.y);
+
+            for (int n = 0; n < count; ++n) {
+                int idx = first + n;
+                int li = int(texelFetch(uLightIndex, ivec2(idx % LIGHT_TEX_WIDTH, idx / LIGHT_TEX_WIDTH), 0).r);
+                ivec2 base = ivec2(li % LIGHT_TEX_WIDTH, (li / LIGHT_TEX_WIDTH) * 3);
+                vec4 posRadius = texelFetch(uLightData, base, 0);
+
+                vec2 lightToFrag = fragWorldPos.xy - posRadius.xy;
                 float dist = length(lightToFrag);
 
-                if (dist < uLights[i].radius) {
+                if (dist < posRadius.w) {
+                    vec4 color = texelFetch(uLightData, base + ivec2(0, 1), 0);
+                    vec4 dirCutoff = texelFetch(uLightData, base + ivec2(0, 2), 0);
                     float intensity = 1.0; // Default for Omni-lights
 
                     // Only calculate spotlight logic if it's NOT an Omni-light
                     // AND we aren't exactly on top of the light source
-                    if (uLights[i].cutoff > -0.99 && dist > 0.001) {
+                    if (dirCutoff.z > -0.99 && dist > 0.001) {
                         vec2 normLightToFrag = normalize(lightToFrag);
-                        float theta = dot(normLightToFrag, normalize(uLights[i].direction));
+                        float theta = dot(normLightToFrag, normalize(dirCutoff.xy));
 
-                        if (theta > uLights[i].cutoff) {
+                        if (theta > dirCutoff.z) {
                             // Smooth the edge of the spotlight cone
                             float epsilon = 0.1;
-                            intensity = clamp((theta - uLights[i].cutoff) / epsilon, 0.0, 1.0);
+                            intensity = clamp((theta - dirCutoff.z) / epsilon, 0.0, 1.0);
                         } else {
                             intensity = 0.0; // Outside the cone
                         }
                     }
 
                     if (intensity > 0.0) {
-                        float attenuation = 1.0 - (dist / uLights[i].radius);
-                        lightAccum += uLights[i].color.rgb * uLights[i].color.a * attenuation * intensity;
+                        float attenuation = 1.0 - (dist / posRadius.w);
+                        lightAccum += color.rgb * color.a * attenuation * intensity;
                     }
                 }
             } // Light loop
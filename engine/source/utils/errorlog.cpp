@@ -17,6 +17,9 @@
 ***************************************
 * XXTH 2012,2025:                     *
 * Some fixed and modernisations added *
+* XXTH 2026:                          *
+* Async writer thread, the caller     *
+* only formats into a per thread ring *
 **************************************/
 
 
@@ -26,43 +29,171 @@
 #include <stdarg.h>									// And The Standard Argument Header For va_list
 #include <errno.h>
 #include <ctime>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <string>
 
 // #include "core/fluxGlobals.h"
 #include <SDL3/SDL.h>
 #include "utils/errorlog.h"
 
+// Emscripten builds are not threaded (yet), they write synchronously
+#ifndef __EMSCRIPTEN__
+#define FLUX_ASYNC_LOG
+#endif
+
 // Globals
 static FILE *ErrorLog;								// The File For Error Logging
 static char gLogFilePath[512] = {0};                // Remember where we write
+
+std::atomic<int> gLogLevel{ LogLevel_Debug };
+
 //-----------------------------------------------------------------------------
-int Log(const char *szFormat, ...)
-{
-	if (!szFormat) return -1;
+// Per thread ring of pre formatted records.
+// Single producer (the owning thread), single consumer (the writer thread).
+// When the ring is full a realtime thread (SetLogThreadRealtime, the audio
+// callbacks) drops the record and never blocks, every other thread waits
+// for the writer.
+// A ring outlives its thread: on exit it is marked free and the next new
+// thread takes it over. Realtime threads claim one of the preallocated
+// gRealtimeRings, no allocation and no lock on the audio thread.
+//-----------------------------------------------------------------------------
+static constexpr U32 LOG_RECORD_SIZE = 1024;
+static constexpr U32 LOG_RING_SIZE   = 128; // power of two
+static constexpr U32 LOG_REALTIME_RINGS = 4;
 
-	char targetStr[1024];
-	char timeStr[20]; // Buffer for "YY-MM-DD HH:MM:S"
+struct LogRecord {
+	Uint64 ticks;			// SDL_GetTicks of the call
+	char   text[LOG_RECORD_SIZE];
+};
 
-	std::time_t now = std::time(nullptr);
-	std::tm* localTime = std::localtime(&now);
+struct LogRing {
+	LogRecord records[LOG_RING_SIZE];
+	std::atomic<U32> write{0};
+	std::atomic<U32> read{0};
+	std::atomic<bool> inUse{false};	// owned by a living thread
 
-	std::strftime(timeStr, sizeof(timeStr), "%y%m%d %H:%M:%S", localTime);
+	// rate limit, only touched by the owning thread
+	const char* lastFormat = nullptr;
+	Uint64 windowStart = 0;
+	U32 windowCount = 0;
+	U32 suppressed = 0;
+};
 
-	va_list Arg;
-	va_start(Arg, szFormat);
-	int offset = SDL_snprintf(targetStr, sizeof(targetStr), "[%s] ", timeStr);
-	SDL_vsnprintf(targetStr + offset, sizeof(targetStr) - offset, szFormat, Arg);
-	va_end(Arg);
+// hands the ring back when the thread exits
+struct LogRingOwner {
+	LogRing* ring = nullptr;
+	~LogRingOwner() {
+		if (ring)
+			ring->inUse.store(false, std::memory_order_release);
+	}
+};
 
-	targetStr[sizeof(targetStr) - 1] = '\0';
+static std::mutex gRingMutex;						// only taken when a thread registers
+static std::vector<LogRing*> gRings;
+static LogRing gRealtimeRings[LOG_REALTIME_RINGS];	// claimed lock free, not in gRings
+static thread_local LogRingOwner tLogRing;
+static thread_local bool tLogRealtime = false;
+static std::mutex gDrainMutex;						// writer thread vs synchronous drain
 
+static std::atomic<U32> gDropped{0};				// since the last drain
+static std::atomic<U32> gDroppedTotal{0};
+static std::atomic<U32> gRateLimitRepeats{10};
+static std::atomic<U32> gRateLimitWindowMs{1000};
 
-	if (ErrorLog)
-	{
-		if (fprintf(ErrorLog, "%s\n", targetStr) < 0) {
-			fclose(ErrorLog);
-			ErrorLog = nullptr;
-		}
-		fflush(ErrorLog);
+#ifdef FLUX_ASYNC_LOG
+static std::thread gWriterThread;
+static std::atomic<bool> gWriterRunning{false};
+static std::mutex gWriterMutex;
+static std::condition_variable gWriterCv;
+static std::atomic<U32> gFlushRequest{0};
+static std::atomic<U32> gFlushDone{0};
+
+static void stopWriterThread();
+// a process that exits without CloseErrorLog must not destroy a joinable
+// std::thread, declared after everything the writer touches
+static struct LogWriterExitGuard {
+	~LogWriterExitGuard() { stopWriterThread(); }
+} gWriterExitGuard;
+#endif
+
+// wall clock of SDL_GetTicks() == 0, the timestamp is derived from the ticks
+static std::time_t gBaseTime = 0;
+static Uint64 gBaseTicks = 0;
+
+//-----------------------------------------------------------------------------
+// takes over a free ring, the records the last owner left are still drained
+static bool claimLogRing(LogRing* ring)
+{
+	bool lFree = false;
+	if (!ring->inUse.compare_exchange_strong(lFree, true, std::memory_order_acq_rel))
+		return false;
+	ring->lastFormat = nullptr;
+	ring->windowCount = 0;
+	ring->suppressed = 0;
+	tLogRing.ring = ring;
+	return true;
+}
+//-----------------------------------------------------------------------------
+static LogRing* getLogRing()
+{
+	if (tLogRing.ring)
+		return tLogRing.ring;
+
+	if (tLogRealtime) {
+		for (LogRing& ring : gRealtimeRings)
+			if (claimLogRing(&ring))
+				return tLogRing.ring;
+	}
+
+	std::lock_guard<std::mutex> lock(gRingMutex);
+	for (LogRing* ring : gRings)
+		if (claimLogRing(ring))
+			return tLogRing.ring;
+
+	LogRing* ring = new LogRing();
+	claimLogRing(ring);
+	gRings.push_back(ring);
+	return ring;
+}
+//-----------------------------------------------------------------------------
+// level by the tag convention used all over the engine: "[error] ..."
+static int getFormatLevel(const char* szFormat)
+{
+	if (szFormat[0] != '[')
+		return LogLevel_Info;
+	if (strncmp(szFormat, "[error]", 7) == 0) return LogLevel_Error;
+	if (strncmp(szFormat, "[warn]", 6) == 0) return LogLevel_Warn;
+	if (strncmp(szFormat, "[debug]", 7) == 0) return LogLevel_Debug;
+	return LogLevel_Info;
+}
+//-----------------------------------------------------------------------------
+// cached: strftime only runs when the second changes
+static const char* getTimeString(Uint64 ticks)
+{
+	static std::time_t lastTime = -1;
+	static char timeStr[20]; // Buffer for "YY-MM-DD HH:MM:S"
+
+	std::time_t now = gBaseTime + (std::time_t)((ticks - gBaseTicks) / 1000);
+	if (now != lastTime) {
+		lastTime = now;
+		std::tm* localTime = std::localtime(&now);
+		std::strftime(timeStr, sizeof(timeStr), "%y%m%d %H:%M:%S", localTime);
+	}
+	return timeStr;
+}
+//-----------------------------------------------------------------------------
+// writes one line to the log file and the console
+static void writeLine(std::string& fileBuffer, Uint64 ticks, const char* text)
+{
+	char targetStr[LOG_RECORD_SIZE + 32];
+	SDL_snprintf(targetStr, sizeof(targetStr), "[%s] %s", getTimeString(ticks), text);
+
+	if (ErrorLog) {
+		fileBuffer += targetStr;
+		fileBuffer += '\n';
 	}
 
 #ifdef __EMSCRIPTEN__
@@ -70,13 +201,232 @@ int Log(const char *szFormat, ...)
 #else
 	SDL_Log("%s", targetStr);
 #endif
+}
+//-----------------------------------------------------------------------------
+static void flushFileBuffer(std::string& fileBuffer)
+{
+	if (ErrorLog && !fileBuffer.empty()) {
+		if (fwrite(fileBuffer.data(), 1, fileBuffer.size(), ErrorLog) != fileBuffer.size()) {
+			fclose(ErrorLog);
+			ErrorLog = nullptr;
+		} else {
+			fflush(ErrorLog);
+		}
+	}
+	fileBuffer.clear();
+}
+//-----------------------------------------------------------------------------
+// drain all rings, sorted by time, one write per batch
+static void drainRings(std::vector<LogRecord*>& batch, std::string& fileBuffer)
+{
+	// writer thread and the synchronous fallback may overlap on close
+	std::lock_guard<std::mutex> drainLock(gDrainMutex);
+
+	batch.clear();
+	std::vector<std::pair<LogRing*, U32>> consumed;
+	auto collect = [&](LogRing* ring) {
+		U32 lRead = ring->read.load(std::memory_order_relaxed);
+		U32 lWrite = ring->write.load(std::memory_order_acquire);
+		for (U32 i = lRead; i != lWrite; i++)
+			batch.push_back(&ring->records[i & (LOG_RING_SIZE - 1)]);
+		consumed.push_back({ring, lWrite});
+	};
+	for (LogRing& ring : gRealtimeRings)
+		collect(&ring);
+	{
+		std::lock_guard<std::mutex> lock(gRingMutex);
+		for (LogRing* ring : gRings)
+			collect(ring);
+	}
+
+	std::stable_sort(batch.begin(), batch.end(),
+					 [](const LogRecord* a, const LogRecord* b) { return a->ticks < b->ticks; });
+
+	for (LogRecord* rec : batch)
+		writeLine(fileBuffer, rec->ticks, rec->text);
+
+	// hand the slots back to the producers
+	for (auto& [ring, lWrite] : consumed)
+		ring->read.store(lWrite, std::memory_order_release);
+
+	U32 lDropped = gDropped.exchange(0, std::memory_order_relaxed);
+	if (lDropped > 0) {
+		char msg[64];
+		SDL_snprintf(msg, sizeof(msg), "[warn] Log: %u messages dropped (ring full)", lDropped);
+		writeLine(fileBuffer, SDL_GetTicks(), msg);
+	}
+
+	flushFileBuffer(fileBuffer);
+}
+//-----------------------------------------------------------------------------
+#ifdef FLUX_ASYNC_LOG
+static void LogWriterWorker()
+{
+	std::vector<LogRecord*> batch;
+	std::string fileBuffer;
+	batch.reserve(LOG_RING_SIZE * 4);
+
+	while (gWriterRunning.load()) {
+		{
+			std::unique_lock<std::mutex> lock(gWriterMutex);
+			gWriterCv.wait_for(lock, std::chrono::milliseconds(20), [] {
+				return !gWriterRunning.load() || gFlushRequest.load() != gFlushDone.load();
+			});
+		}
+		U32 lRequest = gFlushRequest.load();
+		drainRings(batch, fileBuffer);
+		gFlushDone.store(lRequest);
+		gWriterCv.notify_all();
+	}
+	drainRings(batch, fileBuffer);
+}
+//-----------------------------------------------------------------------------
+static void stopWriterThread()
+{
+	if (gWriterRunning.load()) {
+		gWriterRunning.store(false);
+		gWriterCv.notify_all();
+	}
+	if (gWriterThread.joinable())
+		gWriterThread.join();
+}
+#endif
+//-----------------------------------------------------------------------------
+// no writer thread (not initialized, closed or emscripten): write now
+static void drainNow()
+{
+	static std::vector<LogRecord*> batch;	// only used under gDrainMutex
+	static std::string fileBuffer;
+	drainRings(batch, fileBuffer);
+}
+//-----------------------------------------------------------------------------
+static bool isWriterRunning()
+{
+#ifdef FLUX_ASYNC_LOG
+	return gWriterRunning.load(std::memory_order_relaxed);
+#else
+	return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+// returns false if the message is swallowed by the rate limit
+static bool checkRateLimit(LogRing* ring, const char* szFormat, Uint64 ticks)
+{
+	U32 lMaxRepeats = gRateLimitRepeats.load(std::memory_order_relaxed);
+	if (lMaxRepeats == 0)
+		return true;
+
+	if (ring->lastFormat == szFormat && ticks - ring->windowStart < gRateLimitWindowMs.load(std::memory_order_relaxed)) {
+		if (++ring->windowCount > lMaxRepeats) {
+			ring->suppressed++;
+			return false;
+		}
+		return true;
+	}
+
+	ring->lastFormat = szFormat;
+	ring->windowStart = ticks;
+	ring->windowCount = 1;
+	return true;
+}
+//-----------------------------------------------------------------------------
+static void pushRecord(LogRing* ring, Uint64 ticks, const char* text, const char* szFormat, va_list* args)
+{
+	U32 lWrite = ring->write.load(std::memory_order_relaxed);
+	if (lWrite - ring->read.load(std::memory_order_acquire) >= LOG_RING_SIZE && !tLogRealtime) {
+		// wait for the writer, FlushErrorLog gives up after 500ms
+		if (isWriterRunning()) FlushErrorLog();
+		else drainNow();
+	}
+	if (lWrite - ring->read.load(std::memory_order_acquire) >= LOG_RING_SIZE) {
+		gDropped.fetch_add(1, std::memory_order_relaxed);
+		gDroppedTotal.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	LogRecord& rec = ring->records[lWrite & (LOG_RING_SIZE - 1)];
+	rec.ticks = ticks;
+	if (args)
+		SDL_vsnprintf(rec.text, sizeof(rec.text), szFormat, *args);
+	else
+		SDL_strlcpy(rec.text, text, sizeof(rec.text));
+	ring->write.store(lWrite + 1, std::memory_order_release);
+}
+//-----------------------------------------------------------------------------
+// rateKey is the format string of the call site
+static int logImpl(int level, const char* rateKey, const char* szFormat, va_list* args)
+{
+	if (level < gLogLevel.load(std::memory_order_relaxed))
+		return 0;
+
+	Uint64 ticks = SDL_GetTicks();
+	LogRing* ring = getLogRing();
+
+	if (!checkRateLimit(ring, rateKey, ticks))
+		return 0;
+
+	if (ring->suppressed > 0) {
+		char msg[64];
+		SDL_snprintf(msg, sizeof(msg), "... last message repeated %u times", ring->suppressed);
+		ring->suppressed = 0;
+		pushRecord(ring, ticks, msg, nullptr, nullptr);
+	}
+
+	pushRecord(ring, ticks, szFormat, szFormat, args);
+
+	// a realtime thread never does the file I/O, the next drain picks it up
+	if (!isWriterRunning() && !tLogRealtime)
+		drainNow();
 
 	return 0;
 }
+//-----------------------------------------------------------------------------
+int Log(const char *szFormat, ...)
+{
+	if (!szFormat) return -1;
 
+	va_list Arg;
+	va_start(Arg, szFormat);
+	int result = logImpl(getFormatLevel(szFormat), szFormat, szFormat, &Arg);
+	va_end(Arg);
+
+	return result;
+}
+//-----------------------------------------------------------------------------
+void FlushErrorLog(void)
+{
+#ifdef FLUX_ASYNC_LOG
+	if (gWriterRunning.load()) {
+		U32 lRequest = gFlushRequest.fetch_add(1) + 1;
+		std::unique_lock<std::mutex> lock(gWriterMutex);
+		gWriterCv.notify_all();
+		gWriterCv.wait_for(lock, std::chrono::milliseconds(500), [lRequest] {
+			return (S32)(gFlushDone.load() - lRequest) >= 0;
+		});
+	}
+#endif
+}
+//-----------------------------------------------------------------------------
+void SetLogLevel(FluxLogLevel level)
+{
+	gLogLevel.store(level);
+}
+//-----------------------------------------------------------------------------
+FluxLogLevel GetLogLevel()
+{
+	return (FluxLogLevel)gLogLevel.load();
+}
+//-----------------------------------------------------------------------------
+void SetLogRateLimit(U32 lMaxRepeats, U32 lWindowMs)
+{
+	gRateLimitRepeats.store(lMaxRepeats);
+	gRateLimitWindowMs.store(lWindowMs);
+}
 //-----------------------------------------------------------------------------
 bool InitErrorLog(const char* log_file, const char* app_name, const char* app_version)
 {
+	gBaseTicks = SDL_GetTicks();
+	gBaseTime = std::time(nullptr);
+
 	// try current working directory first
 	ErrorLog = fopen(log_file, "w");
 	if (!ErrorLog) {
@@ -99,6 +449,13 @@ bool InitErrorLog(const char* log_file, const char* app_name, const char* app_ve
 		snprintf(gLogFilePath, sizeof(gLogFilePath), "%s", log_file);
 	}
 
+#ifdef FLUX_ASYNC_LOG
+	if (!gWriterRunning.load()) {
+		gWriterRunning.store(true);
+		gWriterThread = std::thread(LogWriterWorker);
+	}
+#endif
+
 	Log("%s V%s -- Log Init...",
 		app_name, app_version);
 	if (gLogFilePath[0])
@@ -109,18 +466,41 @@ bool InitErrorLog(const char* log_file, const char* app_name, const char* app_ve
 //-----------------------------------------------------------------------------
 void CloseErrorLog(void)
 {
+	Log("-- Closing Log...");
+
+#ifdef FLUX_ASYNC_LOG
+	stopWriterThread();
+#endif
+
 	if(ErrorLog)
 	{
-		Log("-- Closing Log...");
 		fclose(ErrorLog);
 		ErrorLog = nullptr; // Safety: prevent further write attempts
 	}
 }
 //-----------------------------------------------------------------------------
+void SetLogThreadRealtime(bool value)
+{
+	tLogRealtime = value;
+	// claim the ring now, not on the first Log of the audio thread
+	if (value)
+		getLogRing();
+}
+//-----------------------------------------------------------------------------
+U32 GetLogDroppedCount(void)
+{
+	return gDroppedTotal.load();
+}
+//-----------------------------------------------------------------------------
 int _LogFMT(std::string_view fmt, std::format_args args) {
+	if (fmt.empty()) return -1;
+	// filter before formatting, fmt is the call site literal
+	int level = getFormatLevel(fmt.data());
+	if (level < gLogLevel.load(std::memory_order_relaxed))
+		return 0;
 	try {
 		std::string s = std::vformat(fmt, args);
-		return Log("%s", s.c_str());
+		return logImpl(level, fmt.data(), s.c_str(), nullptr);
 	} catch (const std::format_error& e) {
 		return Log("LogFMT Error: %s", e.what());
 	}
@@ -14,6 +14,18 @@
 
 #include <format>
 #include <string_view>
+#include <atomic>
+
+// Log levels, Log() picks the level from the tag at the start of the
+// format string: "[error]", "[warn]", "[debug]", everything else is info.
+enum FluxLogLevel {
+    LogLevel_Debug = 0,
+    LogLevel_Info,
+    LogLevel_Warn,
+    LogLevel_Error,
+    LogLevel_None
+};
+extern std::atomic<int> gLogLevel;
 
 
 // dLog
@@ -23,9 +35,23 @@
 #define dLog(fmt, ...) ((void)0)
 #endif
 
+// filtered at the call site, the arguments are not evaluated when disabled
+#define LogAt(level, fmt, ...) do { if ((level) >= gLogLevel.load(std::memory_order_relaxed)) Log(fmt, ##__VA_ARGS__); } while (0)
+
 bool InitErrorLog(const char* log_file, const char* app_name, const char* app_version) ;	// Initializes The Error Log
 void CloseErrorLog(void);									// Closes The Error Log
 int  Log(const char *, ...) PRINTF_CHECK(1, 2);										// Uses The Error Log :)
+void FlushErrorLog(void);									// Wait until the writer thread wrote everything
+
+void SetLogLevel(FluxLogLevel level);
+FluxLogLevel GetLogLevel();
+// swallow a message (same call site) repeated more than lMaxRepeats times
+// within lWindowMs, 0 disables the rate limit
+void SetLogRateLimit(U32 lMaxRepeats, U32 lWindowMs = 1000);
+// realtime threads (audio callbacks) drop a message when their ring is full,
+// all other threads wait for the writer thread instead
+void SetLogThreadRealtime(bool value);
+U32  GetLogDroppedCount(void);								// messages lost by realtime threads
 int _LogFMT(std::string_view fmt, std::format_args args);
 
 template<typename... Args>
@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+#include "utils/fluxMappedFile.h"
+#include "utils/errorlog.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef FLUX_MMAP
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<FluxMappedFile> FluxMappedFile::open(const std::string& fileName)
+{
+    std::shared_ptr<FluxMappedFile> file(new FluxMappedFile());
+    file->mFileName = fileName;
+
+    if (file->map())
+        return file;
+
+    // read on demand
+    file->mIO = SDL_IOFromFile(fileName.c_str(), "rb");
+    if (!file->mIO) {
+        Log("[error] FluxMappedFile: Can't open %s (%s)", fileName.c_str(), SDL_GetError());
+        return nullptr;
+    }
+    Sint64 size = SDL_GetIOSize(file->mIO);
+    if (size < 0) {
+        Log("[error] FluxMappedFile: Can't get the size of %s", fileName.c_str());
+        return nullptr;
+    }
+    file->mSize = (size_t)size;
+    return file;
+}
+//-----------------------------------------------------------------------------
+FluxMappedFile::~FluxMappedFile()
+{
+    unmap();
+    if (mIO) {
+        SDL_CloseIO(mIO);
+        mIO = nullptr;
+    }
+}
+//-----------------------------------------------------------------------------
+bool FluxMappedFile::map()
+{
+#ifndef FLUX_MMAP
+    return false;
+#elif defined(_WIN32)
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, mFileName.c_str(), -1, nullptr, 0);
+    if (wlen <= 0)
+        return false;
+    std::wstring wname((size_t)wlen, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, mFileName.c_str(), -1, wname.data(), wlen);
+
+    HANDLE file = CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    mFileHandle = file;
+    mMapHandle = mapping;
+    mMapped = (const uint8_t*)view;
+    mSize = (size_t)size.QuadPart;
+    return true;
+#else
+    int fd = ::open(mFileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    mMapped = (const uint8_t*)view;
+    mSize = (size_t)st.st_size;
+    return true;
+#endif
+}
+//-----------------------------------------------------------------------------
+void FluxMappedFile::unmap()
+{
+    if (!mMapped)
+        return;
+#if defined(FLUX_MMAP) && defined(_WIN32)
+    UnmapViewOfFile(mMapped);
+    CloseHandle((HANDLE)mMapHandle);
+    CloseHandle((HANDLE)mFileHandle);
+    mMapHandle = nullptr;
+    mFileHandle = nullptr;
+#elif defined(FLUX_MMAP)
+    munmap((void*)mMapped, mSize);
+#endif
+    mMapped = nullptr;
+}
+//-----------------------------------------------------------------------------
+const uint8_t* FluxMappedFile::data()
+{
+    if (mMapped)
+        return mMapped;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFullyLoaded) {
+        mLoaded.resize(mSize);
+        if (SDL_SeekIO(mIO, 0, SDL_IO_SEEK_SET) < 0
+            || SDL_ReadIO(mIO, mLoaded.data(), mSize) != mSize) {
+            Log("[error] FluxMappedFile: Failed to read %s", mFileName.c_str());
+            mLoaded.clear();
+            return nullptr;
+        }
+        mFullyLoaded = true;
+        // everything is in memory now, the file is not needed anymore
+        SDL_CloseIO(mIO);
+        mIO = nullptr;
+    }
+    return mLoaded.data();
+}
+//-----------------------------------------------------------------------------
+size_t FluxMappedFile::read(size_t offset, void* dst, size_t len)
+{
+    if (offset >= mSize)
+        return 0;
+    len = std::min(len, mSize - offset);
+
+    if (mMapped) {
+        std::memcpy(dst, mMapped + offset, len);
+        return len;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFullyLoaded) {
+        std::memcpy(dst, mLoaded.data() + offset, len);
+        return len;
+    }
+    if (SDL_SeekIO(mIO, (Sint64)offset, SDL_IO_SEEK_SET) < 0)
+        return 0;
+    return SDL_ReadIO(mIO, dst, len);
+}
@@ -0,0 +1,76 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Read only file mapped into memory
+//
+// Desktop builds map the file (mmap / MapViewOfFile), pages are loaded by the
+// OS when they are touched and can be dropped again under memory pressure.
+// Emscripten and Android (assets live inside the APK) have no usable mmap,
+// there the file stays open and read() fetches ranges on demand. data() is
+// still available everywhere, on the fallback it reads the whole file once.
+//
+// Example usage:
+// =============
+//
+// auto file = FluxMappedFile::open("assets/music/theme.ogg");
+// if (file) {
+//     uint8_t header[12];
+//     file->read(0, header, sizeof(header));
+//     const uint8_t* all = file->data(); // contiguous, e.g. for stb_vorbis
+// }
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if !defined(__EMSCRIPTEN__) && !defined(__ANDROID__)
+#define FLUX_MMAP
+#endif
+
+class FluxMappedFile {
+private:
+    std::string mFileName;
+    size_t mSize = 0;
+
+    // mapped
+    const uint8_t* mMapped = nullptr;
+#ifdef _WIN32
+    void* mFileHandle = nullptr;
+    void* mMapHandle = nullptr;
+#endif
+
+    // fallback, guarded by mMutex since decoders read from other threads
+    SDL_IOStream* mIO = nullptr;
+    std::vector<uint8_t> mLoaded;
+    bool mFullyLoaded = false;
+    std::mutex mMutex;
+
+    FluxMappedFile() = default;
+    bool map();
+    void unmap();
+
+public:
+    ~FluxMappedFile();
+
+    FluxMappedFile(const FluxMappedFile&) = delete;
+    void operator=(const FluxMappedFile&) = delete;
+
+    // nullptr if the file can't be opened
+    static std::shared_ptr<FluxMappedFile> open(const std::string& fileName);
+
+    const std::string& getFileName() const { return mFileName; }
+    size_t size() const { return mSize; }
+    bool isMapped() const { return mMapped != nullptr; }
+
+    // whole file, nullptr on a read error. Thread safe.
+    const uint8_t* data();
+
+    // copies up to len bytes from offset, returns the bytes copied. Thread safe.
+    size_t read(size_t offset, void* dst, size_t len);
+};
@@ -0,0 +1,359 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+#include <glad/glad.h>
+#include <cstdio>
+#include <imgui.h>
+
+#include "utils/fluxProfiler.h"
+#include "utils/errorlog.h"
+#include "render/fluxRender2D.h"
+
+static thread_local FluxProfiler::ThreadRing* tThreadRing = nullptr;
+
+// marks the ring of an exiting thread, endFrame drains and frees it
+struct ThreadRingRelease {
+    ~ThreadRingRelease() {
+        if (tThreadRing)
+            tThreadRing->retired.store(true, std::memory_order_release);
+    }
+};
+static thread_local ThreadRingRelease tThreadRingRelease;
+
+//-------------------------------------------------------------------------
+// json string without the quotes, names come from __func__ and user code
+static void writeJsonString(FILE* f, const char* str)
+{
+    for (const char* c = str; c && *c; c++) {
+        const unsigned char ch = (unsigned char)*c;
+        switch (ch) {
+            case '"':  fputs("\\\"", f); break;
+            case '\\': fputs("\\\\", f); break;
+            case '\n': fputs("\\n", f); break;
+            case '\r': fputs("\\r", f); break;
+            case '\t': fputs("\\t", f); break;
+            default:
+                if (ch < 0x20) fprintf(f, "\\u%04x", ch);
+                else fputc(ch, f);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+FluxProfiler& FluxProfiler::get()
+{
+    static FluxProfiler instance;
+    return instance;
+}
+//-------------------------------------------------------------------------
+FluxProfiler::FluxProfiler()
+{
+    mTicksToMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+//-------------------------------------------------------------------------
+FluxProfiler::~FluxProfiler()
+{
+    // rings are owned here, threads may already be gone
+    for (ThreadRing* ring : mRings)
+        delete ring;
+    mRings.clear();
+}
+//-------------------------------------------------------------------------
+FluxProfiler::ThreadRing* FluxProfiler::registerThread()
+{
+    ThreadRing* ring = new ThreadRing();
+    std::lock_guard<std::mutex> lock(mRingMutex);
+    ring->index = mNextRingIndex++;
+    ring->name = ring->index == 0 ? "main" : "thread " + std::to_string(ring->index);
+    mRings.push_back(ring);
+    return ring;
+}
+//-------------------------------------------------------------------------
+FluxProfiler::ThreadRing* FluxProfiler::getThreadRing()
+{
+    if (!tThreadRing) {
+        (void)&tThreadRingRelease; // odr-use, so its destructor runs at thread exit
+        tThreadRing = registerThread();
+    }
+    return tThreadRing;
+}
+//-------------------------------------------------------------------------
+void FluxProfiler::setThreadName(const char* name)
+{
+    ThreadRing* ring = getThreadRing();
+    std::lock_guard<std::mutex> lock(mRingMutex);
+    ring->name = name ? name : "";
+}
+//-------------------------------------------------------------------------
+void FluxProfiler::beginFrame()
+{
+    // make sure the main thread is ring 0
+    getThreadRing();
+
+    mCurrent = &mFrames[mFrameHead];
+    mCurrent->events.clear();
+    mCurrent->gpuMs = -1.0;
+    mCurrent->counters = {};
+    mCurrent->start = SDL_GetPerformanceCounter();
+}
+//-------------------------------------------------------------------------
+void FluxProfiler::endFrame()
+{
+    if (!mCurrent)
+        return;
+
+    mCurrent->end = SDL_GetPerformanceCounter();
+
+    drainRings();
+
+    // endFrame runs after Draw, so these are the counters of this frame
+    const FluxRender2D::RenderStats& lStats = Render2D.getFrameStats();
+    mCurrent->counters.drawCalls    = lStats.drawCalls;
+    mCurrent->counters.vertices     = lStats.vertices;
+    mCurrent->counters.textureBinds = lStats.textureBinds;
+    mCurrent->counters.batchFlushes = lStats.batchFlushes;
+
+    collectGpu();
+
+    if (!mPaused) {
+        for (const Event& e : mCurrent->events) {
+            mScopes[e.name].push((float)ticksToMs(e.end - e.start));
+        }
+        mFrameHead = (mFrameHead + 1) % FRAME_HISTORY;
+        // keep one slot free for the frame being recorded
+        mFrameCount = std::min(mFrameCount + 1, FRAME_HISTORY - 1);
+    }
+    mCurrent = nullptr;
+}
+//-------------------------------------------------------------------------
+// collect all thread rings into the current frame, rings of exited threads
+// are freed after their last events are in
+void FluxProfiler::drainRings()
+{
+    std::lock_guard<std::mutex> lock(mRingMutex);
+    for (size_t i = 0; i < mRings.size(); ) {
+        ThreadRing* ring = mRings[i];
+        const bool lRetired = ring->retired.load(std::memory_order_acquire);
+        Uint32 lRead = ring->read.load(std::memory_order_relaxed);
+        Uint32 lWrite = ring->write.load(std::memory_order_acquire);
+        for (; lRead != lWrite; lRead++) {
+            mCurrent->events.push_back(ring->events[lRead & (ThreadRing::CAPACITY - 1)]);
+        }
+        ring->read.store(lRead, std::memory_order_release);
+
+        if (lRetired && ring != tThreadRing) {
+            delete ring;
+            mRings[i] = mRings.back();
+            mRings.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+//-------------------------------------------------------------------------
+const FluxProfiler::Frame* FluxProfiler::getFrame(int age) const
+{
+    if (age < 0 || age >= mFrameCount)
+        return nullptr;
+    int idx = (mFrameHead - 1 - age + FRAME_HISTORY) % FRAME_HISTORY;
+    return &mFrames[idx];
+}
+//-------------------------------------------------------------------------
+// GPU timer queries (GL_TIME_ELAPSED) need desktop GL 3.3
+void FluxProfiler::gpuBegin()
+{
+#if !defined(__EMSCRIPTEN__) && !defined(__ANDROID__) && !defined(FLUX_GLES2)
+    if (!mGpuInit) {
+        mGpuInit = true;
+        mGpuSupported = GLAD_GL_VERSION_3_3 != 0;
+        if (mGpuSupported)
+            glGenQueries(GPU_QUERIES, mGpuQueries);
+    }
+    if (!mGpuSupported || mGpuPending >= GPU_QUERIES)
+        return;
+
+    glBeginQuery(GL_TIME_ELAPSED, mGpuQueries[mGpuWrite]);
+    mGpuQueryFrame[mGpuWrite] = mFrameHead;
+    mGpuActive = true;
+#endif
+}
+//-------------------------------------------------------------------------
+void FluxProfiler::gpuEnd()
+{
+#if !defined(__EMSCRIPTEN__) && !defined(__ANDROID__) && !defined(FLUX_GLES2)
+    if (!mGpuActive)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    mGpuActive = false;
+    mGpuWrite = (mGpuWrite + 1) % GPU_QUERIES;
+    mGpuPending++;
+#endif
+}
+//-------------------------------------------------------------------------
+// results arrive a few frames later, they are written to the frame which
+// issued the query
+void FluxProfiler::collectGpu()
+{
+#if !defined(__EMSCRIPTEN__) && !defined(__ANDROID__) && !defined(FLUX_GLES2)
+    while (mGpuPending > 0) {
+        int lRead = (mGpuWrite - mGpuPending + GPU_QUERIES) % GPU_QUERIES;
+        GLint lAvailable = 0;
+        glGetQueryObjectiv(mGpuQueries[lRead], GL_QUERY_RESULT_AVAILABLE, &lAvailable);
+        if (!lAvailable)
+            break;
+        GLuint64 lNs = 0;
+        glGetQueryObjectui64v(mGpuQueries[lRead], GL_QUERY_RESULT, &lNs);
+        mFrames[mGpuQueryFrame[lRead]].gpuMs = (double)lNs / 1000000.0;
+        mGpuPending--;
+    }
+#endif
+}
+//-------------------------------------------------------------------------
+bool FluxProfiler::exportChromeTrace(const char* fileName)
+{
+    FILE* f = fopen(fileName, "w");
+    if (!f) {
+        Log("[error] FluxProfiler: can't write %s", fileName);
+        return false;
+    }
+
+    const Frame* lOldest = getFrame(mFrameCount - 1);
+    Uint64 lBase = lOldest ? lOldest->start : 0;
+    auto toUs = [&](Uint64 ticks) { return ticksToMs(ticks - lBase) * 1000.0; };
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    bool lFirst = true;
+    {
+        std::lock_guard<std::mutex> lock(mRingMutex);
+        for (const ThreadRing* ring : mRings) {
+            fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                    lFirst ? "" : ",\n", ring->index);
+            writeJsonString(f, ring->name.c_str());
+            fputs("\"}}", f);
+            lFirst = false;
+        }
+    }
+
+    for (int age = mFrameCount - 1; age >= 0; age--) {
+        const Frame* frame = getFrame(age);
+        if (frame->start < lBase)
+            continue;
+        for (const Event& e : frame->events) {
+            if (e.start < lBase)
+                continue;
+            fputs(",\n{\"name\":\"", f);
+            writeJsonString(f, e.name);
+            fprintf(f, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    e.thread, toUs(e.start), ticksToMs(e.end - e.start) * 1000.0);
+        }
+        fprintf(f, ",\n{\"name\":\"render\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,"
+                   "\"args\":{\"drawCalls\":%u,\"vertices\":%u,\"textureBinds\":%u,\"batchFlushes\":%u}}",
+                toUs(frame->start),
+                frame->counters.drawCalls, frame->counters.vertices,
+                frame->counters.textureBinds, frame->counters.batchFlushes);
+        if (frame->gpuMs >= 0.0) {
+            fprintf(f, ",\n{\"name\":\"gpu\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"ms\":%.3f}}",
+                    toUs(frame->start), frame->gpuMs);
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+
+    Log("FluxProfiler: wrote %d frames to %s", mFrameCount, fileName);
+    return true;
+}
+//-------------------------------------------------------------------------
+void FluxProfiler::drawOverlay(bool* open)
+{
+    if (open && !*open)
+        return;
+
+    ImGui::SetNextWindowSize(ImVec2(640.f, 420.f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+
+    const Frame* frame = getFrame(0);
+    if (!frame) {
+        ImGui::TextDisabled("no frames recorded");
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::Button(mPaused ? "Resume" : "Pause"))
+        mPaused = !mPaused;
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace.json"))
+        exportChromeTrace("trace.json");
+
+    const float lFrameMs = (float)ticksToMs(frame->end - frame->start);
+    ImGui::Text("frame %.2f ms", lFrameMs);
+    if (frame->gpuMs >= 0.0) {
+        ImGui::SameLine();
+        ImGui::Text("| gpu %.2f ms", frame->gpuMs);
+    }
+    ImGui::Text("draw calls %u | vertices %u | texture binds %u | batch flushes %u",
+                frame->counters.drawCalls, frame->counters.vertices,
+                frame->counters.textureBinds, frame->counters.batchFlushes);
+
+    // ---- flame graph of the main thread
+    const float lRowHeight = ImGui::GetTextLineHeight() + 4.f;
+    Uint32 lMaxDepth = 0;
+    for (const Event& e : frame->events)
+        if (e.thread == 0) lMaxDepth = std::max(lMaxDepth, e.depth);
+
+    ImVec2 lPos = ImGui::GetCursorScreenPos();
+    const float lWidth = ImGui::GetContentRegionAvail().x;
+    const float lHeight = lRowHeight * (float)(lMaxDepth + 1);
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+    dl->AddRectFilled(lPos, ImVec2(lPos.x + lWidth, lPos.y + lHeight), IM_COL32(30, 30, 30, 255));
+
+    const double lScale = lFrameMs > 0.f ? lWidth / lFrameMs : 0.0;
+    for (const Event& e : frame->events) {
+        if (e.thread != 0 || e.start < frame->start)
+            continue;
+        float x0 = lPos.x + (float)(ticksToMs(e.start - frame->start) * lScale);
+        float x1 = lPos.x + (float)(ticksToMs(e.end - frame->start) * lScale);
+        float y0 = lPos.y + lRowHeight * (float)e.depth;
+        if (x1 - x0 < 1.f) x1 = x0 + 1.f;
+
+        Uint32 lHash = (Uint32)std::hash<std::string_view>()(e.name);
+        ImU32 lCol = IM_COL32(90 + (lHash & 0x7F), 90 + ((lHash >> 8) & 0x7F), 60 + ((lHash >> 16) & 0x3F), 255);
+        dl->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y0 + lRowHeight - 1.f), lCol);
+        dl->PushClipRect(ImVec2(x0, y0), ImVec2(x1, y0 + lRowHeight), true);
+        dl->AddText(ImVec2(x0 + 2.f, y0 + 2.f), IM_COL32(0, 0, 0, 255), e.name);
+        dl->PopClipRect();
+
+        if (ImGui::IsMouseHoveringRect(ImVec2(x0, y0), ImVec2(x1, y0 + lRowHeight)))
+            ImGui::SetTooltip("%s\n%.3f ms", e.name, ticksToMs(e.end - e.start));
+    }
+    ImGui::Dummy(ImVec2(lWidth, lHeight));
+
+    // ---- per scope histograms
+    if (ImGui::BeginTable("##scopes", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("last ms");
+        ImGui::TableSetupColumn("avg ms");
+        ImGui::TableSetupColumn("max ms");
+        ImGui::TableSetupColumn("history", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableHeadersRow();
+        for (const auto& [name, stats] : mScopes) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(name.data(), name.data() + name.size());
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.lastMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.calls ? stats.totalMs / (double)stats.calls : 0.0);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.maxMs);
+            ImGui::TableNextColumn();
+            ImGui::PushID(name.data());
+            ImGui::PlotHistogram("##h", stats.history, ScopeStats::HISTORY, stats.head, nullptr,
+                                 0.f, stats.maxMs, ImVec2(-1.f, lRowHeight));
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+//-------------------------------------------------------------------------
@@ -0,0 +1,217 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2026 Thomas Hühn (XXTH)
+// SPDX-License-Identifier: MIT
+//-----------------------------------------------------------------------------
+// Frame profiler
+//
+// Scopes are recorded into a per thread ring buffer (single producer, the
+// main thread collects them at endFrame). Enabled in debug builds or with
+// -DFLUX_PROFILE, otherwise the macros compile to nothing.
+//
+// Example usage:
+// =============
+//
+// void MyGame::Update(const double& dt) {
+//     FLUX_PROFILE_SCOPE("MyGame::Update");
+//     ...
+// }
+//
+// in onDrawTopMost between the imgui begin/end:
+//     FluxProfile.drawOverlay(&mShowProfiler);
+//
+// FluxProfile.exportChromeTrace("trace.json"); // open in chrome://tracing
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(FLUX_DEBUG) && !defined(FLUX_NO_PROFILE) && !defined(FLUX_PROFILE)
+#define FLUX_PROFILE
+#endif
+
+//-----------------------------------------------------------------------------
+// Global shorthand macro
+#define FluxProfile FluxProfiler::get()
+
+#ifdef FLUX_PROFILE
+#define FLUX_PROFILE_CONCAT_(a, b) a##b
+#define FLUX_PROFILE_CONCAT(a, b) FLUX_PROFILE_CONCAT_(a, b)
+// name must be a string literal (only the pointer is stored)
+#define FLUX_PROFILE_SCOPE(name) FluxProfileScope FLUX_PROFILE_CONCAT(_fluxProfileScope, __LINE__)(name)
+#define FLUX_PROFILE_FUNCTION() FLUX_PROFILE_SCOPE(__func__)
+#define FLUX_PROFILE_BEGIN_FRAME() FluxProfile.beginFrame()
+#define FLUX_PROFILE_END_FRAME() FluxProfile.endFrame()
+#define FLUX_PROFILE_GPU_BEGIN() FluxProfile.gpuBegin()
+#define FLUX_PROFILE_GPU_END() FluxProfile.gpuEnd()
+#else
+#define FLUX_PROFILE_SCOPE(name) ((void)0)
+#define FLUX_PROFILE_FUNCTION() ((void)0)
+#define FLUX_PROFILE_BEGIN_FRAME() ((void)0)
+#define FLUX_PROFILE_END_FRAME() ((void)0)
+#define FLUX_PROFILE_GPU_BEGIN() ((void)0)
+#define FLUX_PROFILE_GPU_END() ((void)0)
+#endif
+
+//-----------------------------------------------------------------------------
+class FluxProfiler
+{
+public:
+    struct Event {
+        const char* name;
+        Uint64 start;
+        Uint64 end;
+        Uint32 depth;
+        Uint32 thread;
+    };
+
+    // counters pulled from FluxRender2D at the end of a frame
+    struct FrameCounters {
+        Uint32 drawCalls = 0;
+        Uint32 vertices = 0;
+        Uint32 textureBinds = 0;
+        Uint32 batchFlushes = 0;
+    };
+
+    struct Frame {
+        Uint64 start = 0;
+        Uint64 end = 0;
+        double gpuMs = -1.0; // -1 = no timer query available
+        FrameCounters counters;
+        std::vector<Event> events;
+    };
+
+    struct ScopeStats {
+        static constexpr int HISTORY = 120;
+        float history[HISTORY] = {};
+        int head = 0;
+        float lastMs = 0.f;
+        float maxMs = 0.f;
+        double totalMs = 0.0;
+        Uint64 calls = 0;
+        void push(float ms) {
+            history[head] = ms;
+            head = (head + 1) % HISTORY;
+            lastMs = ms;
+            maxMs = std::max(maxMs, ms);
+            totalMs += ms;
+            calls++;
+        }
+    };
+
+    // lock free single producer / single consumer ring, one per thread
+    struct ThreadRing {
+        static constexpr Uint32 CAPACITY = 4096; // power of two
+        Event events[CAPACITY];
+        std::atomic<Uint32> write{0};
+        std::atomic<Uint32> read{0};
+        std::atomic<Uint32> dropped{0};
+        std::atomic<bool> retired{false}; // owner thread is gone, freed in endFrame
+        Uint32 depth = 0;
+        Uint32 index = 0;
+        std::string name;
+    };
+
+    static constexpr int FRAME_HISTORY = 240;
+
+private:
+    FluxProfiler();
+    ~FluxProfiler();
+    FluxProfiler(const FluxProfiler&) = delete;
+    void operator=(const FluxProfiler&) = delete;
+
+    std::mutex mRingMutex; // only taken when a thread registers or exits
+    std::vector<ThreadRing*> mRings;
+    Uint32 mNextRingIndex = 0;
+
+    Frame mFrames[FRAME_HISTORY];
+    int mFrameHead = 0;   // next frame to write
+    int mFrameCount = 0;
+    Frame* mCurrent = nullptr;
+
+    std::unordered_map<std::string_view, ScopeStats> mScopes;
+
+    double mTicksToMs = 0.0;
+    bool mPaused = false;
+
+    // gpu timer queries, small ring to not stall waiting for results
+    static constexpr int GPU_QUERIES = 4;
+    unsigned int mGpuQueries[GPU_QUERIES] = {};
+    int mGpuQueryFrame[GPU_QUERIES] = {};
+    int mGpuWrite = 0;
+    int mGpuPending = 0;
+    bool mGpuInit = false;
+    bool mGpuSupported = false;
+    bool mGpuActive = false;
+
+    ThreadRing* registerThread();
+    void drainRings();
+    void collectGpu();
+
+public:
+    static FluxProfiler& get();
+
+    // per thread ring, created on first use
+    ThreadRing* getThreadRing();
+    // name the calling thread for the trace export
+    void setThreadName(const char* name);
+
+    void beginFrame();
+    void endFrame();
+
+    // wrap the gpu work of a frame (desktop GL >= 3.3 only)
+    void gpuBegin();
+    void gpuEnd();
+
+    void setPaused(bool value) { mPaused = value; }
+    bool getPaused() const { return mPaused; }
+
+    double ticksToMs(Uint64 ticks) const { return (double)ticks * mTicksToMs; }
+    const Frame* getFrame(int age) const; // 0 = last finished frame
+    const std::unordered_map<std::string_view, ScopeStats>& getScopes() const { return mScopes; }
+
+    bool exportChromeTrace(const char* fileName);
+
+    void drawOverlay(bool* open = nullptr);
+};
+
+//-----------------------------------------------------------------------------
+class FluxProfileScope
+{
+private:
+    FluxProfiler::ThreadRing* mRing;
+    const char* mName;
+    Uint64 mStart;
+
+public:
+    explicit FluxProfileScope(const char* name)
+    : mRing(FluxProfile.getThreadRing()), mName(name)
+    {
+        mRing->depth++;
+        mStart = SDL_GetPerformanceCounter();
+    }
+
+    ~FluxProfileScope()
+    {
+        Uint64 lEnd = SDL_GetPerformanceCounter();
+        mRing->depth--;
+
+        Uint32 lWrite = mRing->write.load(std::memory_order_relaxed);
+        if (lWrite - mRing->read.load(std::memory_order_acquire) >= FluxProfiler::ThreadRing::CAPACITY) {
+            mRing->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        mRing->events[lWrite & (FluxProfiler::ThreadRing::CAPACITY - 1)] =
+            { mName, mStart, lEnd, mRing->depth, mRing->index };
+        mRing->write.store(lWrite + 1, std::memory_order_release);
+    }
+
+    FluxProfileScope(const FluxProfileScope&) = delete;
+    void operator=(const FluxProfileScope&) = delete;
+};
@@ -1,5 +1,5 @@
 //-----------------------------------------------------------------------------
-// Copyright (c) 2025 Thomas Hühn (XXTH) 
+// Copyright (c) 2025 Thomas Hühn (XXTH)
 // SPDX-License-Identifier: MIT
 //-----------------------------------------------------------------------------
 #include <vector>
@@ -19,16 +19,106 @@ FluxScheduler& FluxScheduler::get()
     return instance;
 }
 //-------------------------------------------------------------------------
+FluxScheduler::FluxScheduler() : mNextId(0)
+{
+    mPostHead.store(&mPostStub, std::memory_order_relaxed);
+    mPostTail = &mPostStub;
+}
+//-------------------------------------------------------------------------
+FluxScheduler::~FluxScheduler()
+{
+    while (PostedNode* node = popPosted())
+        delete node;
+}
+//-------------------------------------------------------------------------
+uint32_t FluxScheduler::acquireSlot()
+{
+    if (!mFreeSlots.empty()) {
+        uint32_t slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        return slot;
+    }
+    mTasks.emplace_back();
+    return static_cast<uint32_t>(mTasks.size() - 1);
+}
+//-------------------------------------------------------------------------
+void FluxScheduler::releaseSlot(uint32_t slot)
+{
+    ScheduledTask& task = mTasks[slot];
+
+    // unlink from the owner list
+    if (task.owner) {
+        if (task.ownerPrev != NO_SLOT) {
+            mTasks[task.ownerPrev].ownerNext = task.ownerNext;
+        } else {
+            auto it = mOwnerHead.find(task.owner);
+            if (it != mOwnerHead.end()) {
+                if (task.ownerNext != NO_SLOT) it->second = task.ownerNext;
+                else mOwnerHead.erase(it);
+            }
+        }
+        if (task.ownerNext != NO_SLOT)
+            mTasks[task.ownerNext].ownerPrev = task.ownerPrev;
+    }
+
+    mIdToSlot.erase(task.id);
+    task = ScheduledTask();
+    mFreeSlots.push_back(slot);
+}
+//-------------------------------------------------------------------------
+void FluxScheduler::pushHeap(uint32_t slot)
+{
+    ScheduledTask& task = mTasks[slot];
+    mHeap.push_back({task.deadline, task.id, slot, ++task.heapGen});
+    std::push_heap(mHeap.begin(), mHeap.end(), HeapCompare());
+}
+//-------------------------------------------------------------------------
+// cancel and extend leave stale entries in the heap, rebuild it when they
+// start to dominate.
+void FluxScheduler::compactHeap()
+{
+    if (mHeap.size() < 64 || mHeap.size() < 2 * mIdToSlot.size())
+        return;
+
+    mHeap.erase(std::remove_if(mHeap.begin(), mHeap.end(),
+                               [this](const HeapEntry& e) {
+                                   const ScheduledTask& t = mTasks[e.slot];
+                                   return t.id != e.id || t.heapGen != e.gen;
+                               }),
+                mHeap.end());
+    std::make_heap(mHeap.begin(), mHeap.end(), HeapCompare());
+}
+//-------------------------------------------------------------------------
 FluxScheduler::TaskID FluxScheduler::add(double lDelaySeconds, FluxBaseObject* lOwner, std::function<void()> lAction, bool ticker )
 {
     std::lock_guard<std::recursive_mutex> lock(mMutex);
     if (mIsShutdown) return 0; // Don't add tasks during shutdown
     TaskID lNewId = ++mNextId;
-    mTasks.push_back({lNewId, lDelaySeconds, std::move(lAction), lOwner, ticker, lDelaySeconds});
 
+    uint32_t slot = acquireSlot();
+    ScheduledTask& task = mTasks[slot];
+    task.id = lNewId;
+    task.deadline = mNow + lDelaySeconds;
+    task.action = std::move(lAction);
+    task.owner = lOwner;
+    task.isTicker = ticker;
+    task.timeInterval = lDelaySeconds;
+
+    mIdToSlot[lNewId] = slot;
+    pushHeap(slot);
 
     if (lOwner != nullptr )
     {
+        // link in front of the owner list
+        auto it = mOwnerHead.find(lOwner);
+        if (it != mOwnerHead.end()) {
+            task.ownerNext = it->second;
+            mTasks[it->second].ownerPrev = slot;
+            it->second = slot;
+        } else {
+            mOwnerHead.emplace(lOwner, slot);
+        }
+
         lOwner->setScheduleUsed(true);
     }
 
@@ -43,37 +133,109 @@ FluxScheduler::TaskID FluxScheduler::addTicker(double lDelaySeconds, FluxBaseObj
     return add(lDelaySeconds, lOwner, lAction, true);
 }
 //-------------------------------------------------------------------------
+// Vyukov intrusive MPSC queue
+void FluxScheduler::pushPosted(PostedNode* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    PostedNode* prev = mPostHead.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+//-------------------------------------------------------------------------
+FluxScheduler::PostedNode* FluxScheduler::popPosted()
+{
+    PostedNode* tail = mPostTail;
+    PostedNode* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &mPostStub) {
+        if (!next)
+            return nullptr;
+        mPostTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        mPostTail = next;
+        return tail;
+    }
+
+    // a producer is in the middle of a push, get it next update
+    if (tail != mPostHead.load(std::memory_order_acquire))
+        return nullptr;
+
+    pushPosted(&mPostStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        mPostTail = next;
+        return tail;
+    }
+    return nullptr;
+}
+//-------------------------------------------------------------------------
+void FluxScheduler::post(double lDelaySeconds, std::function<void()> lAction)
+{
+    PostedNode* node = new PostedNode();
+    node->delay = lDelaySeconds;
+    node->action = std::move(lAction);
+    pushPosted(node);
+}
+//-------------------------------------------------------------------------
+void FluxScheduler::drainPosted()
+{
+    while (PostedNode* node = popPosted()) {
+        add(node->delay, nullptr, std::move(node->action), false);
+        delete node;
+    }
+}
+//-------------------------------------------------------------------------
 bool FluxScheduler::extend(TaskID id, double lDelaySeconds) {
     if ( id == 0 ) return false;
     std::lock_guard<std::recursive_mutex> lock(mMutex);
-    for (auto it = mTasks.begin(); it != mTasks.end(); it++ ) {
-        if (it->id == id) {
-                it->timeRemaining = lDelaySeconds;
-                return true;
-        }
-    }
-    return false;
+    auto it = mIdToSlot.find(id);
+    if (it == mIdToSlot.end())
+        return false;
+
+    ScheduledTask& task = mTasks[it->second];
+    const double deadline = mNow + lDelaySeconds;
+    if (task.deadline == deadline)
+        return true;
+
+    // the new entry bumps heapGen, the old one becomes stale
+    task.deadline = deadline;
+    pushHeap(it->second);
+    compactHeap();
+    return true;
 }
 //-------------------------------------------------------------------------
 
 bool FluxScheduler::isPending(TaskID id){
     if (id == 0) return false;
     std::lock_guard<std::recursive_mutex> lock(mMutex);
-    return std::any_of(mTasks.begin(), mTasks.end(),
-                        [id](const ScheduledTask& t) { return t.id == id; });
+    return mIdToSlot.find(id) != mIdToSlot.end();
 }
 //-------------------------------------------------------------------------
 void FluxScheduler::cancel(TaskID id){
     if (id == 0) return;
     std::lock_guard<std::recursive_mutex> lock(mMutex);
-    mTasks.erase(std::remove_if(mTasks.begin(), mTasks.end(),
-                                [id](const ScheduledTask& t) { return t.id == id; }),
-                mTasks.end());
+    auto it = mIdToSlot.find(id);
+    if (it == mIdToSlot.end())
+        return;
+    releaseSlot(it->second);
+    compactHeap();
 }
 //-------------------------------------------------------------------------
 void FluxScheduler::clear(){
     std::lock_guard<std::recursive_mutex> lock(mMutex);
     mTasks.clear();
+    mFreeSlots.clear();
+    mHeap.clear();
+    mIdToSlot.clear();
+    mOwnerHead.clear();
+}
+//-------------------------------------------------------------------------
+size_t FluxScheduler::getPendingCount() {
+    std::lock_guard<std::recursive_mutex> lock(mMutex);
+    return mIdToSlot.size();
 }
 //-------------------------------------------------------------------------
 void FluxScheduler::listPending() {
@@ -81,9 +243,11 @@ void FluxScheduler::listPending() {
     Log("%-5s %-10s %-14s %-8s %-10s", "ID", "TimeRem", "Owner", "Ticker", "Interval");
 
     for (const auto& task : mTasks) {
+        if (task.id == 0)
+            continue;
         Log("%-5d %-10.2f %-14p %-8s %-10.2f",
             (int)task.id,
-            task.timeRemaining,
+            task.deadline - mNow,
             task.owner,
             task.isTicker ? "Yes" : "No",
             task.timeInterval);
@@ -96,42 +260,77 @@ void FluxScheduler::update(double dt)
     if (mIsShutdown)
         return;
 
-    std::vector<std::function<void()>> actionsToRun;
+    drainPosted();
+
+    // an action may run update() again (modal loaders), so the due list is
+    // local to this call; mDue only keeps the capacity around
+    std::vector<DueAction> lDue;
+    lDue.swap(mDue);
+    lDue.clear();
     {
         std::lock_guard<std::recursive_mutex> lock(mMutex);
-        for (auto it = mTasks.begin(); it != mTasks.end(); ) {
-            // Convert millisecond dt to seconds for comparison with timeRemaining
-            it->timeRemaining -= (dt );
-
-            if (it->timeRemaining <= 0.0) {
-                if (it->action) {
-                    actionsToRun.push_back(it->isTicker ? it->action : std::move(it->action));
-                }
-                if (it->isTicker) {
-                    it->timeRemaining += it->timeInterval;
-                    if (it->timeRemaining <= 0.0) {
-                        it->timeRemaining = it->timeInterval;
-                    }
-
-                    ++it;
-                } else {
-                    it = mTasks.erase(it);
-                }
-            } else {
-                ++it;
+        mNow += dt;
+
+        while (!mHeap.empty() && mHeap.front().deadline <= mNow) {
+            std::pop_heap(mHeap.begin(), mHeap.end(), HeapCompare());
+            HeapEntry entry = mHeap.back();
+            mHeap.pop_back();
+
+            ScheduledTask& task = mTasks[entry.slot];
+            if (task.id != entry.id || task.heapGen != entry.gen)
+                continue; // cancelled or extended
+
+            lDue.push_back({task.id, task.isTicker, std::move(task.action)});
+            if (!task.isTicker)
+                releaseSlot(entry.slot);
+        }
+
+        // reschedule tickers after the loop, so a zero interval can not
+        // fire twice within the same update
+        for (const auto& due : lDue) {
+            if (!due.isTicker)
+                continue;
+            uint32_t slot = mIdToSlot[due.id];
+            ScheduledTask& task = mTasks[slot];
+            task.deadline += task.timeInterval;
+            if (task.deadline <= mNow) {
+                task.deadline = mNow + task.timeInterval;
             }
+            pushHeap(slot);
         }
     }
 
     // Execute actions after the lock is released
-    for (auto& action : actionsToRun) {
-        action();
+    bool hasTicker = false;
+    for (auto& due : lDue) {
+        if (due.action) {
+            due.action();
+        }
+        hasTicker |= due.isTicker;
     }
+
+    // hand the ticker actions back, unless they got cancelled meanwhile
+    if (hasTicker) {
+        std::lock_guard<std::recursive_mutex> lock(mMutex);
+        for (auto& due : lDue) {
+            if (!due.isTicker)
+                continue;
+            auto it = mIdToSlot.find(due.id);
+            if (it != mIdToSlot.end() && !mTasks[it->second].action) {
+                mTasks[it->second].action = std::move(due.action);
+            }
+        }
+    }
+    lDue.clear();
+    if (lDue.capacity() > mDue.capacity())
+        mDue.swap(lDue);
 }
 //-------------------------------------------------------------------------
 void FluxScheduler::shutdown(){
     std::lock_guard<std::recursive_mutex> lock(mMutex);
-    mTasks.clear(); // Clear all std::function objects
+    clear(); // Clear all std::function objects
+    while (PostedNode* node = popPosted())
+        delete node;
     mIsShutdown = true;
     Log("FluxScheduler: Shutdown complete.");
 }
@@ -144,10 +343,17 @@ void FluxScheduler::cleanByOwner(void* lOwner)
 
     if (lOwner == nullptr) return; // Safety: Never clear tasks with nullptr lOwner accidentally
 
-    auto it = std::remove_if(mTasks.begin(), mTasks.end(),
-                            [lOwner](const ScheduledTask& task) {
-                                return task.owner == lOwner;
-                            });
-    mTasks.erase(it, mTasks.end());
+    auto it = mOwnerHead.find(lOwner);
+    if (it == mOwnerHead.end())
+        return;
+
+    uint32_t slot = it->second;
+    while (slot != NO_SLOT) {
+        uint32_t next = mTasks[slot].ownerNext;
+        releaseSlot(slot);
+        slot = next;
+    }
+    mOwnerHead.erase(lOwner);
+    compactHeap();
 }
 //-------------------------------------------------------------------------
@@ -31,44 +31,107 @@
 #include <vector>
 #include <functional>
 #include <mutex>
+#include <atomic>
 #include <algorithm>
+#include <unordered_map>
+#include <cstdint>
 //-----------------------------------------------------------------------------
 // Global shorthand macro
 #define FluxSchedule FluxScheduler::get()
 // Forward:
 class FluxBaseObject;
 //-----------------------------------------------------------------------------
+// Tasks live in a slot pool and are ordered by a binary min-heap keyed on the
+// absolute deadline (mNow). update() only touches the tasks which are due.
+// cancel/extend are lazy: the heap entry is left behind and skipped when it
+// is popped (entry id/gen no longer match the slot).
+//
+// Worker threads must not call add(): use post() which pushes onto a lock
+// free MPSC queue that is drained by the main thread in update().
+//-----------------------------------------------------------------------------
 class FluxScheduler
 {
 public:
     using TaskID = size_t;
 
-private:
-    FluxScheduler() : mNextId(0) {}
-    ~FluxScheduler() = default;
+public:
+    // the app uses the global instance (get()), a local one is only meant
+    // for benchmarks and tests which must not touch the live timers
+    FluxScheduler();
+    ~FluxScheduler();
 
-    // Delete copy/move to enforce Singleton
     FluxScheduler(const FluxScheduler&) = delete;
     void operator=(const FluxScheduler&) = delete;
 
+private:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
     struct ScheduledTask {
-        TaskID id;
-        double timeRemaining;
+        TaskID id = 0;              // 0 == free slot
+        double deadline = 0.0;      // absolute time on the mNow clock
         std::function<void()> action;
-        void* owner;
+        void* owner = nullptr;
+        bool isTicker = false;
+        double timeInterval = 0.0;
+        uint32_t heapGen = 0;       // only the heap entry with this gen is live
+        // intrusive per owner list for cleanByOwner
+        uint32_t ownerPrev = NO_SLOT;
+        uint32_t ownerNext = NO_SLOT;
+    };
+
+    struct HeapEntry {
+        double deadline;
+        TaskID id;
+        uint32_t slot;
+        uint32_t gen;
+    };
+    struct HeapCompare {
+        bool operator()(const HeapEntry& a, const HeapEntry& b) const {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    struct DueAction {
+        TaskID id;
         bool isTicker;
-        double timeInterval;
+        std::function<void()> action;
+    };
+
+    // node of the MPSC queue used by post()
+    struct PostedNode {
+        std::atomic<PostedNode*> next{nullptr};
+        double delay = 0.0;
+        std::function<void()> action;
     };
 
     std::vector<ScheduledTask> mTasks;
+    std::vector<uint32_t> mFreeSlots;
+    std::vector<HeapEntry> mHeap;
+    std::unordered_map<TaskID, uint32_t> mIdToSlot;
+    std::unordered_map<void*, uint32_t> mOwnerHead;
+    std::vector<DueAction> mDue;    // spare buffer, update swaps it out
     TaskID mNextId;
+    double mNow = 0.0;
 
     // IMPORTANT: Recursive mutex allows a task to call .add()
     // or .cancel() without deadlocking the thread.
     std::recursive_mutex mMutex;
 
+    // MPSC queue (Vyukov) producers: any thread, consumer: update()
+    std::atomic<PostedNode*> mPostHead;
+    PostedNode* mPostTail;
+    PostedNode mPostStub;
+
     bool mIsShutdown = false;
 
+    uint32_t acquireSlot();
+    void releaseSlot(uint32_t slot);
+    void pushHeap(uint32_t slot);
+    void compactHeap();
+    void pushPosted(PostedNode* node);
+    PostedNode* popPosted();
+    void drainPosted();
+
 
 public:
 
@@ -86,6 +149,10 @@ public:
 
     TaskID addTicker(double lDelaySeconds, FluxBaseObject* lOwner, std::function<void()> lAction);
 
+    // Thread safe and lock free: schedule an action from a worker thread.
+    // It is added on the main thread at the next update (without owner).
+    void post(double lDelaySeconds, std::function<void()> lAction);
+
     // extend the time of a running schedule, if not found false is returned
     bool extend(TaskID id, double lDelaySeconds);
 
@@ -110,4 +177,7 @@ public:
     // list the pending events
     void listPending();
 
+    // number of pending tasks
+    size_t getPendingCount();
+
 };